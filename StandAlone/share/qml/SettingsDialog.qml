@@ -94,6 +94,9 @@ Dialog {
                         height: updates.isEnabled? undefined: 0
                         visible: updates.isEnabled
                     }
+                    ItemDelegate {
+                        text: qsTr("Frame Statistics")
+                    }
                     ItemDelegate {
                         text: qsTr("Debug Log")
                     }
@@ -138,6 +141,7 @@ Dialog {
             GeneralConfig { }
             PluginConfig { }
             UpdatesConfig { }
+            VideoSinksStats { }
             DebugLog { }
         }
     }
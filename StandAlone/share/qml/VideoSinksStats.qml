@@ -0,0 +1,193 @@
+/* Webcamoid, camera capture application.
+ * Copyright (C) 2026  Gonzalo Exequiel Pedone
+ *
+ * Webcamoid is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Webcamoid is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Webcamoid. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Web-Site: http://webcamoid.github.io/
+ */
+import QtQuick
+import QtQuick.Controls
+import QtQuick.Layouts
+import Ak
+
+Page {
+    ScrollView {
+        id: scrollView
+        anchors.fill: parent
+        contentHeight: layout.height
+        clip: true
+
+        readonly property var sinkNames: ({
+            "preview": qsTr("Preview"),
+            "recording": qsTr("Recording"),
+            "virtualCamera": qsTr("Virtual camera")
+        })
+
+        function updateStats()
+        {
+            sinks.model = frameFanout.sinksStats()
+            elements.model = AkElementProfiler.enabled?
+                                 AkElementProfiler.stats():
+                                 []
+        }
+
+        Timer {
+            interval: 1000
+            repeat: true
+            running: scrollView.visible
+            triggeredOnStart: true
+
+            onTriggered: scrollView.updateStats()
+        }
+
+        ColumnLayout {
+            id: layout
+            width: scrollView.width
+
+            Repeater {
+                id: sinks
+
+                GridLayout {
+                    columns: 2
+                    Layout.fillWidth: true
+
+                    Label {
+                        text: scrollView.sinkNames[modelData.name] || modelData.name
+                        font.bold: true
+                        Layout.columnSpan: 2
+                    }
+                    Label {
+                        text: qsTr("Latency")
+                        Layout.fillWidth: true
+                    }
+                    Label {
+                        text: qsTr("%1 ms").arg(modelData.latency.toFixed(1))
+                    }
+                    Label {
+                        text: qsTr("Maximum latency")
+                        Layout.fillWidth: true
+                    }
+                    Label {
+                        text: qsTr("%1 ms").arg(modelData.maxLatency.toFixed(1))
+                    }
+                    Label {
+                        text: qsTr("Queued frames")
+                        Layout.fillWidth: true
+                    }
+                    Label {
+                        text: modelData.queued
+                    }
+                    Label {
+                        text: qsTr("Delivered frames")
+                        Layout.fillWidth: true
+                    }
+                    Label {
+                        text: modelData.delivered
+                    }
+                    Label {
+                        text: qsTr("Dropped frames")
+                        Layout.fillWidth: true
+                    }
+                    Label {
+                        text: modelData.dropped
+                    }
+                    Item {
+                        height: AkUnit.create(16 * AkTheme.controlScale, "dp").pixels
+                        Layout.fillWidth: true
+                        Layout.columnSpan: 2
+                    }
+                }
+            }
+            RowLayout {
+                Layout.fillWidth: true
+
+                Label {
+                    id: txtProfileElements
+                    text: qsTr("Profile the effects and codecs")
+                    Layout.fillWidth: true
+                }
+                Switch {
+                    Accessible.name: txtProfileElements.text
+                    checked: AkElementProfiler.enabled
+
+                    onToggled: {
+                        AkElementProfiler.enabled = checked
+                        AkElementProfiler.reset()
+                        scrollView.updateStats()
+                    }
+                }
+            }
+            Button {
+                text: qsTr("Save trace")
+                visible: AkTracer.enabled && AkTracer.traceFile != ""
+                Accessible.description:
+                    qsTr("Save the timeline of the pipelines to %1").arg(AkTracer.traceFile)
+
+                onClicked: AkTracer.save()
+            }
+            Repeater {
+                id: elements
+
+                GridLayout {
+                    columns: 2
+                    Layout.fillWidth: true
+
+                    Label {
+                        text: modelData.element
+                        font.bold: true
+                        Layout.columnSpan: 2
+                    }
+                    Label {
+                        text: qsTr("Packets")
+                        Layout.fillWidth: true
+                    }
+                    Label {
+                        text: modelData.calls
+                    }
+                    Label {
+                        text: qsTr("Time per packet")
+                        Layout.fillWidth: true
+                    }
+                    Label {
+                        text: qsTr("%1 ms").arg(modelData.calls > 0?
+                                                    (modelData.time / modelData.calls).toFixed(2):
+                                                    0)
+                    }
+                    Label {
+                        text: qsTr("Allocations per packet")
+                        Layout.fillWidth: true
+                    }
+                    Label {
+                        text: modelData.allocationsPerPacket.toFixed(1)
+                    }
+                    Label {
+                        text: qsTr("Queue wait")
+                        Layout.fillWidth: true
+                        visible: modelData.queueWaits > 0
+                    }
+                    Label {
+                        text: qsTr("%1 ms").arg((modelData.queueWaitTime
+                                                 / modelData.queueWaits).toFixed(1))
+                        visible: modelData.queueWaits > 0
+                    }
+                    Item {
+                        height: AkUnit.create(16 * AkTheme.controlScale, "dp").pixels
+                        Layout.fillWidth: true
+                        Layout.columnSpan: 2
+                    }
+                }
+            }
+        }
+    }
+}
@@ -32,6 +32,15 @@ class CliOptionsPrivate
         QCommandLineOption m_pluginPathsOpt {{"p", "paths"}};
         QCommandLineOption m_blackListOpt {{"b", "no-load"}};
         QCommandLineOption m_newInstance {"new-instance"};
+        QCommandLineOption m_traceOpt {"trace"};
+        QCommandLineOption m_traceBufferSizeOpt {"trace-buffer-size"};
+        QCommandLineOption m_headlessOpt {"headless"};
+        QCommandLineOption m_pipelineOpt {"pipeline"};
+        QCommandLineOption m_inputOpt {"input"};
+        QCommandLineOption m_effectsOpt {"effects"};
+        QCommandLineOption m_outputOpt {"output"};
+        QCommandLineOption m_realTimeOpt {"real-time"};
+        QCommandLineOption m_statsOpt {"stats"};
 
         QString convertToAbsolute(const QString &path) const;
 };
@@ -74,6 +83,57 @@ CliOptions::CliOptions()
                 QObject::tr("Open a new instance of %1.").arg(QApplication::applicationName()));
     this->addOption(this->d->m_newInstance);
 
+    this->d->m_traceOpt.setDescription(
+                QObject::tr("Record a timeline of the pipelines and save it to "
+                            "FILE, in Chrome trace format, when closing the "
+                            "program."));
+    this->d->m_traceOpt.setValueName(QObject::tr("FILE"));
+    this->addOption(this->d->m_traceOpt);
+
+    this->d->m_traceBufferSizeOpt.setDescription(
+                QObject::tr("Keep the last EVENTS events of each thread in "
+                            "the trace."));
+    this->d->m_traceBufferSizeOpt.setValueName(QObject::tr("EVENTS"));
+    this->addOption(this->d->m_traceBufferSizeOpt);
+
+    this->d->m_headlessOpt.setDescription(
+                QObject::tr("Run a pipeline without the user interface, print "
+                            "its statistics and exit."));
+    this->addOption(this->d->m_headlessOpt);
+
+    this->d->m_pipelineOpt.setDescription(
+                QObject::tr("Read the headless pipeline from a JSON file."));
+    this->d->m_pipelineOpt.setValueName(QObject::tr("FILE"));
+    this->addOption(this->d->m_pipelineOpt);
+
+    this->d->m_inputOpt.setDescription(
+                QObject::tr("Media file or URL to read in headless mode."));
+    this->d->m_inputOpt.setValueName(QObject::tr("MEDIA"));
+    this->addOption(this->d->m_inputOpt);
+
+    this->d->m_effectsOpt.setDescription(
+                QObject::tr("Semi-colon separated list of effects to apply in "
+                            "headless mode."));
+    this->d->m_effectsOpt.setValueName(QObject::tr("EFFECT1;EFFECT2;EFFECT3;..."));
+    this->addOption(this->d->m_effectsOpt);
+
+    this->d->m_outputOpt.setDescription(
+                QObject::tr("Where to send the frames in headless mode: null, "
+                            "file:PATH or virtualcamera[:ID]."));
+    this->d->m_outputOpt.setValueName(QObject::tr("OUTPUT"));
+    this->addOption(this->d->m_outputOpt);
+
+    this->d->m_realTimeOpt.setDescription(
+                QObject::tr("Play the input at its normal speed in headless "
+                            "mode, instead of as fast as possible."));
+    this->addOption(this->d->m_realTimeOpt);
+
+    this->d->m_statsOpt.setDescription(
+                QObject::tr("Also write the statistics of the headless mode to "
+                            "FILE as JSON."));
+    this->d->m_statsOpt.setValueName(QObject::tr("FILE"));
+    this->addOption(this->d->m_statsOpt);
+
     this->process(*QCoreApplication::instance());
 
     // Set path for loading user settings.
@@ -122,6 +182,51 @@ QCommandLineOption CliOptions::newInstance() const
     return this->d->m_newInstance;
 }
 
+QCommandLineOption CliOptions::traceOpt() const
+{
+    return this->d->m_traceOpt;
+}
+
+QCommandLineOption CliOptions::traceBufferSizeOpt() const
+{
+    return this->d->m_traceBufferSizeOpt;
+}
+
+QCommandLineOption CliOptions::headlessOpt() const
+{
+    return this->d->m_headlessOpt;
+}
+
+QCommandLineOption CliOptions::pipelineOpt() const
+{
+    return this->d->m_pipelineOpt;
+}
+
+QCommandLineOption CliOptions::inputOpt() const
+{
+    return this->d->m_inputOpt;
+}
+
+QCommandLineOption CliOptions::effectsOpt() const
+{
+    return this->d->m_effectsOpt;
+}
+
+QCommandLineOption CliOptions::outputOpt() const
+{
+    return this->d->m_outputOpt;
+}
+
+QCommandLineOption CliOptions::realTimeOpt() const
+{
+    return this->d->m_realTimeOpt;
+}
+
+QCommandLineOption CliOptions::statsOpt() const
+{
+    return this->d->m_statsOpt;
+}
+
 QString CliOptionsPrivate::convertToAbsolute(const QString &path) const
 {
     if (!QDir::isRelativePath(path))
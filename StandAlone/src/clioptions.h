@@ -35,6 +35,15 @@ class CliOptions: public QCommandLineParser
         QCommandLineOption pluginPathsOpt() const;
         QCommandLineOption blackListOpt() const;
         QCommandLineOption newInstance() const;
+        QCommandLineOption traceOpt() const;
+        QCommandLineOption traceBufferSizeOpt() const;
+        QCommandLineOption headlessOpt() const;
+        QCommandLineOption pipelineOpt() const;
+        QCommandLineOption inputOpt() const;
+        QCommandLineOption effectsOpt() const;
+        QCommandLineOption outputOpt() const;
+        QCommandLineOption realTimeOpt() const;
+        QCommandLineOption statsOpt() const;
 
     private:
         CliOptionsPrivate *d;
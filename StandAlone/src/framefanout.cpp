@@ -0,0 +1,344 @@
+/* Webcamoid, camera capture application.
+ * Copyright (C) 2026  Gonzalo Exequiel Pedone
+ *
+ * Webcamoid is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Webcamoid is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Webcamoid. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Web-Site: http://webcamoid.github.io/
+ */
+
+#include <QElapsedTimer>
+#include <QFuture>
+#include <QMutex>
+#include <QQmlApplicationEngine>
+#include <QQmlContext>
+#include <QQueue>
+#include <QSharedPointer>
+#include <QThread>
+#include <QThreadPool>
+#include <QVariantMap>
+#include <QWaitCondition>
+#include <QtConcurrent>
+#include <akvideopacket.h>
+
+#include "framefanout.h"
+
+#define MAX_PLANES 4
+
+// Weight of the last frame in the latency average.
+#define LATENCY_SMOOTHING 0.1
+
+template <typename T>
+inline void waitLoop(const QFuture<T> &loop)
+{
+    while (!loop.isFinished()) {
+        auto eventDispatcher = QThread::currentThread()->eventDispatcher();
+
+        if (eventDispatcher)
+            eventDispatcher->processEvents(QEventLoop::AllEvents);
+    }
+}
+
+struct FrameFanoutFrame
+{
+    AkPacket packet;
+    qint64 time;
+};
+
+class FrameFanoutSink
+{
+    public:
+        QString m_name;
+        QObject *m_sink {nullptr};
+        FrameFanout::SinkPolicy m_policy {FrameFanout::SinkPolicyDropOldest};
+        int m_maxFrames {1};
+        QMutex m_mutex;
+        QWaitCondition m_frameAvailable;
+        QWaitCondition m_spaceAvailable;
+        QQueue<FrameFanoutFrame> m_frames;
+        QFuture<void> m_loopResult;
+        bool m_run {true};
+
+        // Stats
+        quint64 m_delivered {0};
+        quint64 m_dropped {0};
+        qreal m_latency {0.0};
+        qint64 m_maxLatency {0};
+
+        void push(const AkPacket &packet, qint64 time);
+        void loop(const QElapsedTimer *timer);
+        void stop();
+        QVariantMap stats();
+};
+
+using FrameFanoutSinkPtr = QSharedPointer<FrameFanoutSink>;
+
+class FrameFanoutPrivate
+{
+    public:
+        FrameFanout *self;
+        QQmlApplicationEngine *m_engine {nullptr};
+        QThreadPool m_threadPool;
+        QElapsedTimer m_timer;
+        QMutex m_sinksMutex;
+        QVector<FrameFanoutSinkPtr> m_sinks;
+
+        explicit FrameFanoutPrivate(FrameFanout *self);
+        static AkPacket share(const AkPacket &packet);
+};
+
+FrameFanout::FrameFanout(QQmlApplicationEngine *engine, QObject *parent):
+    QObject(parent)
+{
+    this->d = new FrameFanoutPrivate(this);
+    this->setQmlEngine(engine);
+}
+
+FrameFanout::~FrameFanout()
+{
+    this->removeAllSinks();
+    delete this->d;
+}
+
+QVariantList FrameFanout::sinksStats() const
+{
+    this->d->m_sinksMutex.lock();
+    auto sinks = this->d->m_sinks;
+    this->d->m_sinksMutex.unlock();
+
+    QVariantList stats;
+
+    for (auto &sink: sinks)
+        stats << sink->stats();
+
+    return stats;
+}
+
+bool FrameFanout::addSink(const QString &name,
+                          QObject *sink,
+                          SinkPolicy policy,
+                          int maxFrames)
+{
+    if (!sink || maxFrames < 1)
+        return false;
+
+    auto fanoutSink = FrameFanoutSinkPtr::create();
+    fanoutSink->m_name = name;
+    fanoutSink->m_sink = sink;
+    fanoutSink->m_policy = policy;
+    fanoutSink->m_maxFrames = maxFrames;
+
+    this->d->m_sinksMutex.lock();
+
+    for (auto &other: this->d->m_sinks)
+        if (other->m_sink == sink) {
+            this->d->m_sinksMutex.unlock();
+
+            return false;
+        }
+
+    // Every sink loop keeps one thread busy.
+    this->d->m_threadPool.setMaxThreadCount(qMax(this->d->m_threadPool.maxThreadCount(),
+                                                 this->d->m_sinks.size() + 1));
+    fanoutSink->m_loopResult =
+            QtConcurrent::run(&this->d->m_threadPool,
+                              &FrameFanoutSink::loop,
+                              fanoutSink.data(),
+                              &this->d->m_timer);
+    this->d->m_sinks << fanoutSink;
+    this->d->m_sinksMutex.unlock();
+
+    return true;
+}
+
+void FrameFanout::removeSink(QObject *sink)
+{
+    FrameFanoutSinkPtr fanoutSink;
+
+    this->d->m_sinksMutex.lock();
+
+    for (int i = 0; i < this->d->m_sinks.size(); i++)
+        if (this->d->m_sinks[i]->m_sink == sink) {
+            fanoutSink = this->d->m_sinks.takeAt(i);
+
+            break;
+        }
+
+    this->d->m_sinksMutex.unlock();
+
+    if (fanoutSink)
+        fanoutSink->stop();
+}
+
+void FrameFanout::removeAllSinks()
+{
+    this->d->m_sinksMutex.lock();
+    auto sinks = this->d->m_sinks;
+    this->d->m_sinks.clear();
+    this->d->m_sinksMutex.unlock();
+
+    for (auto &sink: sinks)
+        sink->stop();
+}
+
+void FrameFanout::setQmlEngine(QQmlApplicationEngine *engine)
+{
+    if (this->d->m_engine == engine)
+        return;
+
+    this->d->m_engine = engine;
+
+    if (engine)
+        engine->rootContext()->setContextProperty("frameFanout", this);
+}
+
+AkPacket FrameFanout::iStream(const AkPacket &packet)
+{
+    if (packet.type() != AkPacket::PacketVideo)
+        return {};
+
+    this->d->m_sinksMutex.lock();
+    auto sinks = this->d->m_sinks;
+    this->d->m_sinksMutex.unlock();
+
+    if (sinks.isEmpty())
+        return {};
+
+    auto frame = FrameFanoutPrivate::share(packet);
+    auto time = this->d->m_timer.nsecsElapsed();
+
+    for (auto &sink: sinks)
+        sink->push(frame, time);
+
+    return {};
+}
+
+FrameFanoutPrivate::FrameFanoutPrivate(FrameFanout *self):
+    self(self)
+{
+    this->m_timer.start();
+}
+
+AkPacket FrameFanoutPrivate::share(const AkPacket &packet)
+{
+    // This is the only copy of the frame, the sinks will reference it.
+    auto owner = new AkVideoPacket(packet);
+
+    if (!*owner || owner->isForeign()) {
+        delete owner;
+
+        return packet;
+    }
+
+    quint8 *planes[MAX_PLANES];
+    size_t lineSizes[MAX_PLANES];
+
+    for (size_t plane = 0; plane < owner->planes(); plane++) {
+        planes[plane] = const_cast<quint8 *>(owner->constPlane(int(plane)));
+        lineSizes[plane] = owner->lineSize(int(plane));
+    }
+
+    AkVideoPacket frame(owner->caps(),
+                        planes,
+                        lineSizes,
+                        owner->size(),
+                        [] (void *opaque) {
+                            delete reinterpret_cast<AkVideoPacket *>(opaque);
+                        },
+                        owner);
+    frame.copyMetadata(*owner);
+
+    return frame;
+}
+
+void FrameFanoutSink::push(const AkPacket &packet, qint64 time)
+{
+    QMutexLocker mutexLocker(&this->m_mutex);
+
+    if (this->m_policy == FrameFanout::SinkPolicyBlock) {
+        while (this->m_run && this->m_frames.size() >= this->m_maxFrames)
+            this->m_spaceAvailable.wait(&this->m_mutex);
+
+        if (!this->m_run)
+            return;
+    } else {
+        while (this->m_frames.size() >= this->m_maxFrames) {
+            this->m_frames.removeFirst();
+            this->m_dropped++;
+        }
+    }
+
+    this->m_frames << FrameFanoutFrame {packet, time};
+    this->m_frameAvailable.wakeAll();
+}
+
+void FrameFanoutSink::loop(const QElapsedTimer *timer)
+{
+    this->m_mutex.lock();
+
+    forever {
+        while (this->m_run && this->m_frames.isEmpty())
+            this->m_frameAvailable.wait(&this->m_mutex);
+
+        if (!this->m_run)
+            break;
+
+        auto frame = this->m_frames.dequeue();
+        this->m_spaceAvailable.wakeAll();
+        this->m_mutex.unlock();
+
+        QMetaObject::invokeMethod(this->m_sink,
+                                  "iStream",
+                                  Qt::DirectConnection,
+                                  Q_ARG(AkPacket, frame.packet));
+        auto latency = timer->nsecsElapsed() - frame.time;
+
+        this->m_mutex.lock();
+        this->m_delivered++;
+        this->m_latency = this->m_delivered > 1?
+                              LATENCY_SMOOTHING * latency
+                              + (1.0 - LATENCY_SMOOTHING) * this->m_latency:
+                              latency;
+        this->m_maxLatency = qMax(this->m_maxLatency, latency);
+    }
+
+    this->m_frames.clear();
+    this->m_mutex.unlock();
+}
+
+void FrameFanoutSink::stop()
+{
+    this->m_mutex.lock();
+    this->m_run = false;
+    this->m_frameAvailable.wakeAll();
+    this->m_spaceAvailable.wakeAll();
+    this->m_mutex.unlock();
+
+    waitLoop(this->m_loopResult);
+}
+
+QVariantMap FrameFanoutSink::stats()
+{
+    QMutexLocker mutexLocker(&this->m_mutex);
+
+    return {
+        {"name"      , this->m_name                  },
+        {"queued"    , int(this->m_frames.size())    },
+        {"delivered" , this->m_delivered             },
+        {"dropped"   , this->m_dropped               },
+        {"latency"   , this->m_latency / 1e6         },
+        {"maxLatency", qreal(this->m_maxLatency) / 1e6},
+    };
+}
+
+#include "moc_framefanout.cpp"
@@ -0,0 +1,82 @@
+/* Webcamoid, camera capture application.
+ * Copyright (C) 2026  Gonzalo Exequiel Pedone
+ *
+ * Webcamoid is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Webcamoid is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Webcamoid. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Web-Site: http://webcamoid.github.io/
+ */
+
+#ifndef FRAMEFANOUT_H
+#define FRAMEFANOUT_H
+
+#include <QVariantList>
+#include <akpacket.h>
+
+class FrameFanoutPrivate;
+class FrameFanout;
+class QQmlApplicationEngine;
+
+using FrameFanoutPtr = QSharedPointer<FrameFanout>;
+
+/* Delivers the processed video frames to the preview, the recording and the
+ * virtual camera.
+ *
+ * The frame is wrapped once in a read-only shared buffer, so every copy made
+ * by the sinks just references it instead of copying the pixels. Each sink
+ * has its own queue and thread. A slow DropOldest sink loses frames without
+ * delaying the others, but a full Block sink stalls iStream, and with it the
+ * capture and every other sink, until it catches up.
+ */
+class FrameFanout: public QObject
+{
+    Q_OBJECT
+
+    public:
+        enum SinkPolicy
+        {
+            // Wait until the sink has room for the frame, this throttles the
+            // whole fan-out
+            SinkPolicyBlock,
+            // Discard the oldest queued frame
+            SinkPolicyDropOldest
+        };
+        Q_ENUM(SinkPolicy)
+
+        FrameFanout(QQmlApplicationEngine *engine=nullptr,
+                    QObject *parent=nullptr);
+        ~FrameFanout();
+
+        // Statistics of each sink, as a list of maps with the keys: name,
+        // queued, delivered, dropped, latency and maxLatency (in ms).
+        Q_INVOKABLE QVariantList sinksStats() const;
+
+    private:
+        FrameFanoutPrivate *d;
+
+    public slots:
+        // 'sink' must have an iStream(AkPacket) slot, and it's called from
+        // the thread of the sink.
+        bool addSink(const QString &name,
+                     QObject *sink,
+                     SinkPolicy policy,
+                     int maxFrames);
+        void removeSink(QObject *sink);
+        void removeAllSinks();
+        void setQmlEngine(QQmlApplicationEngine *engine=nullptr);
+        AkPacket iStream(const AkPacket &packet);
+};
+
+Q_DECLARE_METATYPE(FrameFanout::SinkPolicy)
+
+#endif // FRAMEFANOUT_H
@@ -0,0 +1,762 @@
+/* Webcamoid, camera capture application.
+ * Copyright (C) 2026  Gonzalo Exequiel Pedone
+ *
+ * Webcamoid is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Webcamoid is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Webcamoid. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Web-Site: http://webcamoid.github.io/
+ */
+
+#include <iostream>
+#include <QElapsedTimer>
+#include <QEventLoop>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QMutex>
+#include <QVariantMap>
+#include <ak.h>
+#include <akcompressedcaps.h>
+#include <akelementprofiler.h>
+#include <akplugininfo.h>
+#include <akpluginmanager.h>
+#include <akvideocaps.h>
+#include <akvideopacket.h>
+#include <iak/akelement.h>
+#include <iak/akvideoencoder.h>
+#include <iak/akvideomuxer.h>
+
+#include "headlessrunner.h"
+#include "clioptions.h"
+#include "pluginconfigs.h"
+
+struct HeadlessEffect
+{
+    QString id;
+    QVariantMap properties;
+};
+
+class HeadlessRunnerPrivate
+{
+    public:
+        enum OutputType
+        {
+            OutputNull,
+            OutputFile,
+            OutputVirtualCamera
+        };
+
+        HeadlessRunner *self;
+        PluginConfigsPtr m_pluginConfigs;
+
+        // Pipeline description
+        QString m_input;
+        QVector<HeadlessEffect> m_effectsDescription;
+        OutputType m_outputType {OutputNull};
+        QString m_outputLocation;
+        QString m_outputFormat;
+        QString m_outputCodec;
+        int m_outputBitrate {0};
+        bool m_realTime {false};
+        QString m_statsFile;
+
+        // Pipeline elements
+        AkElementPtr m_source;
+        QList<AkElementPtr> m_effects;
+        AkElementPtr m_virtualCamera;
+        AkVideoMuxerPtr m_muxer;
+        AkVideoEncoderPtr m_videoEncoder;
+        QMetaObject::Connection m_headersChangedConnection;
+        bool m_outputStarted {false};
+        bool m_outputFailed {false};
+
+        // Statistics
+        QMutex m_mutex;
+        QElapsedTimer m_timer;
+        quint64 m_framesIn {0};
+        quint64 m_framesOut {0};
+        qint64 m_runTime {0};
+        qreal m_firstPts {-1.0};
+        qreal m_lastPts {0.0};
+        QVector<qint64> m_latencies;
+
+        explicit HeadlessRunnerPrivate(HeadlessRunner *self);
+        bool readPipeline(const CliOptions &cliOptions);
+        bool readPipelineFile(const QString &fileName);
+        void setOutput(const QVariant &output);
+        bool createElements();
+        AkVideoMuxerPtr createMuxer() const;
+        AkVideoEncoderPtr createVideoEncoder() const;
+        static QStringList pluginsByPriority(const QString &pattern);
+        void processFrame(const AkPacket &packet);
+        void writeFrame(const AkPacket &packet);
+        bool startFileOutput(const AkVideoCaps &caps);
+        void stopOutput();
+        QVariantMap stats();
+        void printStats(const QVariantMap &stats) const;
+        bool saveStats(const QVariantMap &stats) const;
+};
+
+HeadlessRunner::HeadlessRunner(QObject *parent):
+    QObject(parent)
+{
+    this->d = new HeadlessRunnerPrivate(this);
+}
+
+HeadlessRunner::~HeadlessRunner()
+{
+    delete this->d;
+}
+
+int HeadlessRunner::run(const CliOptions &cliOptions)
+{
+    Ak::registerTypes();
+    this->d->m_pluginConfigs =
+            PluginConfigsPtr(new PluginConfigs(cliOptions));
+
+    if (!this->d->readPipeline(cliOptions) || !this->d->createElements())
+        return -1;
+
+    QEventLoop eventLoop;
+    bool failed = false;
+
+    // The source goes back to the null state when the input ends.
+    QObject::connect(this->d->m_source.data(),
+                     &AkElement::stateChanged,
+                     &eventLoop,
+                     [&eventLoop] (AkElement::ElementState state) {
+                        if (state == AkElement::ElementStateNull)
+                            eventLoop.quit();
+                     },
+                     Qt::QueuedConnection);
+    QObject::connect(this->d->m_source.data(),
+                     SIGNAL(error(QString)),
+                     &eventLoop,
+                     SLOT(quit()),
+                     Qt::QueuedConnection);
+    QObject::connect(this->d->m_source.data(),
+                     &AkElement::oStream,
+                     [this] (const AkPacket &packet) {
+                        this->d->processFrame(packet);
+                     });
+
+    qInfo() << "Processing" << this->d->m_input;
+    this->d->m_timer.start();
+
+    if (this->d->m_source->setState(AkElement::ElementStatePlaying))
+        eventLoop.exec();
+    else
+        failed = true;
+
+    this->d->m_source->setState(AkElement::ElementStateNull);
+
+    this->d->m_mutex.lock();
+    this->d->m_runTime = this->d->m_timer.nsecsElapsed();
+    failed |= this->d->m_framesIn < 1 || this->d->m_outputFailed;
+    this->d->m_mutex.unlock();
+
+    this->d->stopOutput();
+
+    for (auto &effect: this->d->m_effects)
+        effect->setState(AkElement::ElementStateNull);
+
+    auto stats = this->d->stats();
+    this->d->printStats(stats);
+
+    if (!this->d->m_statsFile.isEmpty() && !this->d->saveStats(stats))
+        qCritical() << "Failed to write the statistics to"
+                    << this->d->m_statsFile;
+
+    if (failed)
+        qCritical() << "Failed to process" << this->d->m_input;
+
+    return failed? -1: 0;
+}
+
+AkPacket HeadlessRunner::iStream(const AkPacket &packet)
+{
+    this->d->writeFrame(packet);
+
+    return {};
+}
+
+HeadlessRunnerPrivate::HeadlessRunnerPrivate(HeadlessRunner *self):
+    self(self)
+{
+}
+
+bool HeadlessRunnerPrivate::readPipeline(const CliOptions &cliOptions)
+{
+    if (cliOptions.isSet(cliOptions.pipelineOpt())
+        && !this->readPipelineFile(cliOptions.value(cliOptions.pipelineOpt())))
+        return false;
+
+    if (cliOptions.isSet(cliOptions.inputOpt()))
+        this->m_input = cliOptions.value(cliOptions.inputOpt());
+
+    if (cliOptions.isSet(cliOptions.effectsOpt())) {
+        this->m_effectsDescription.clear();
+
+        for (auto &effect: cliOptions.value(cliOptions.effectsOpt()).split(';'))
+            if (!effect.trimmed().isEmpty())
+                this->m_effectsDescription << HeadlessEffect {effect.trimmed(), {}};
+    }
+
+    if (cliOptions.isSet(cliOptions.outputOpt()))
+        this->setOutput(cliOptions.value(cliOptions.outputOpt()));
+
+    if (cliOptions.isSet(cliOptions.realTimeOpt()))
+        this->m_realTime = true;
+
+    if (cliOptions.isSet(cliOptions.statsOpt()))
+        this->m_statsFile = cliOptions.value(cliOptions.statsOpt());
+
+    if (this->m_input.isEmpty()) {
+        qCritical() << "No input was given to the pipeline";
+
+        return false;
+    }
+
+    if (this->m_outputType == OutputFile && this->m_outputLocation.isEmpty()) {
+        qCritical() << "No output file was given to the pipeline";
+
+        return false;
+    }
+
+    return true;
+}
+
+bool HeadlessRunnerPrivate::readPipelineFile(const QString &fileName)
+{
+    QFile file(fileName);
+
+    if (!file.open(QIODevice::ReadOnly)) {
+        qCritical() << "Can't open the pipeline file:" << fileName;
+
+        return false;
+    }
+
+    QJsonParseError error;
+    auto document = QJsonDocument::fromJson(file.readAll(), &error);
+
+    if (error.error != QJsonParseError::NoError || !document.isObject()) {
+        qCritical() << "Invalid pipeline file:" << fileName
+                    << error.errorString();
+
+        return false;
+    }
+
+    auto pipeline = document.object();
+    this->m_input = pipeline.value("input").toString();
+    this->m_realTime = pipeline.value("realTime").toBool();
+    this->m_statsFile = pipeline.value("stats").toString();
+    this->m_effectsDescription.clear();
+
+    for (auto effect: pipeline.value("effects").toArray())
+        if (effect.isObject()) {
+            auto effectObject = effect.toObject();
+            this->m_effectsDescription
+                    << HeadlessEffect {effectObject.value("id").toString(),
+                                       effectObject.value("properties").toObject().toVariantMap()};
+        } else {
+            this->m_effectsDescription << HeadlessEffect {effect.toString(), {}};
+        }
+
+    if (pipeline.contains("output"))
+        this->setOutput(pipeline.value("output").toVariant());
+
+    return true;
+}
+
+void HeadlessRunnerPrivate::setOutput(const QVariant &output)
+{
+    QString type;
+    QString location;
+
+    if (output.userType() == QMetaType::QVariantMap) {
+        auto outputMap = output.toMap();
+        type = outputMap.value("type").toString();
+        location = outputMap.value("location",
+                                   outputMap.value("device")).toString();
+        this->m_outputFormat = outputMap.value("format").toString();
+        this->m_outputCodec = outputMap.value("codec").toString();
+        this->m_outputBitrate = outputMap.value("bitrate").toInt();
+    } else {
+        auto outputStr = output.toString();
+        auto separator = outputStr.indexOf(':');
+        type = outputStr.left(separator);
+        location = separator < 0? QString(): outputStr.mid(separator + 1);
+    }
+
+    type = type.toLower();
+
+    if (type.isEmpty() || type == "null") {
+        this->m_outputType = OutputNull;
+    } else if (type == "virtualcamera") {
+        this->m_outputType = OutputVirtualCamera;
+    } else if (type == "file") {
+        this->m_outputType = OutputFile;
+    } else {
+        // Anything else is the path of the file, like C:\video.mp4.
+        this->m_outputType = OutputFile;
+        location = output.toString();
+    }
+
+    this->m_outputLocation = location;
+}
+
+bool HeadlessRunnerPrivate::createElements()
+{
+    this->m_source =
+            akPluginManager->create<AkElement>("MultimediaSource/MultiSrc");
+
+    if (!this->m_source) {
+        qCritical() << "The media source plugin is not available";
+
+        return false;
+    }
+
+    this->m_source->setProperty("media", this->m_input);
+    this->m_source->setProperty("loop", false);
+    this->m_source->setProperty("sync", this->m_realTime);
+
+    // Only the video is processed.
+    int videoStream = -1;
+    QMetaObject::invokeMethod(this->m_source.data(),
+                              "defaultStream",
+                              Q_RETURN_ARG(int, videoStream),
+                              Q_ARG(AkCaps::CapsType, AkCaps::CapsVideo));
+
+    if (videoStream < 0) {
+        qCritical() << "The input has no video:" << this->m_input;
+
+        return false;
+    }
+
+    QMetaObject::invokeMethod(this->m_source.data(),
+                              "setStreams",
+                              Q_ARG(QList<int>, QList<int> {videoStream}));
+
+    for (auto &effectDescription: this->m_effectsDescription) {
+        auto id = effectDescription.id;
+
+        if (!id.contains('/'))
+            id = "VideoFilter/" + id;
+
+        auto effect = akPluginManager->create<AkElement>(id);
+
+        if (!effect) {
+            qCritical() << "Can't create the effect:" << id;
+
+            return false;
+        }
+
+        for (auto it = effectDescription.properties.begin();
+             it != effectDescription.properties.end();
+             it++)
+            if (!effect->setProperty(it.key().toStdString().c_str(),
+                                     it.value()))
+                qWarning() << "Invalid property for" << id << ':' << it.key();
+
+        if (!this->m_effects.isEmpty())
+            this->m_effects.last()->link(effect, Qt::DirectConnection);
+
+        this->m_effects << effect;
+    }
+
+    if (!this->m_effects.isEmpty()) {
+        this->m_effects.last()->link(self, Qt::DirectConnection);
+        this->m_source->setPreferredVideoFormat(AkElement::negotiateVideoFormats(this->m_effects));
+    }
+
+    switch (this->m_outputType) {
+    case OutputFile:
+        this->m_muxer = this->createMuxer();
+
+        if (!this->m_muxer) {
+            qCritical() << "No muxer found for" << this->m_outputLocation;
+
+            return false;
+        }
+
+        this->m_videoEncoder = this->createVideoEncoder();
+
+        if (!this->m_videoEncoder) {
+            qCritical() << "No video encoder found for" << this->m_outputLocation;
+
+            return false;
+        }
+
+        break;
+
+    case OutputVirtualCamera: {
+        this->m_virtualCamera =
+                akPluginManager->create<AkElement>("VideoSink/VirtualCamera");
+
+        if (!this->m_virtualCamera) {
+            qCritical() << "The virtual camera plugin is not available";
+
+            return false;
+        }
+
+        auto device = this->m_outputLocation;
+
+        if (device.isEmpty())
+            device = this->m_virtualCamera->property("medias").toStringList().value(0);
+
+        if (device.isEmpty()) {
+            qCritical() << "There are no virtual cameras";
+
+            return false;
+        }
+
+        this->m_virtualCamera->setProperty("media", device);
+
+        if (!this->m_virtualCamera->setState(AkElement::ElementStatePlaying)) {
+            qCritical() << "Can't start the virtual camera:" << device;
+
+            return false;
+        }
+
+        break;
+    }
+
+    default:
+        break;
+    }
+
+    return true;
+}
+
+AkVideoMuxerPtr HeadlessRunnerPrivate::createMuxer() const
+{
+    if (!this->m_outputFormat.isEmpty()) {
+        auto formatParts = this->m_outputFormat.split(':');
+        auto muxer = akPluginManager->create<AkVideoMuxer>(formatParts.value(0));
+
+        if (muxer)
+            muxer->setMuxer(formatParts.value(1));
+
+        return muxer;
+    }
+
+    // Guess the format from the extension of the file.
+    auto suffix = QFileInfo(this->m_outputLocation).suffix().toLower();
+
+    for (auto &muxerPluginId:
+         pluginsByPriority("^VideoMuxer([/]([0-9a-zA-Z_])+)+$")) {
+        auto muxer = akPluginManager->create<AkVideoMuxer>(muxerPluginId);
+
+        if (!muxer)
+            continue;
+
+        for (auto &name: muxer->muxers())
+            if (muxer->extension(name) == suffix) {
+                muxer->setMuxer(name);
+
+                return muxer;
+            }
+    }
+
+    return {};
+}
+
+AkVideoEncoderPtr HeadlessRunnerPrivate::createVideoEncoder() const
+{
+    if (!this->m_outputCodec.isEmpty()) {
+        auto codecParts = this->m_outputCodec.split(':');
+        auto encoder =
+                akPluginManager->create<AkVideoEncoder>(codecParts.value(0));
+
+        if (encoder)
+            encoder->setCodec(codecParts.value(1));
+
+        return encoder;
+    }
+
+    // Use the default codec of the format, or else any codec it supports.
+    auto muxer = this->m_muxer->muxer();
+    auto defaultCodec =
+            this->m_muxer->defaultCodec(muxer,
+                                        AkCompressedCaps::CapsType_Video);
+    auto supportedCodecs =
+            this->m_muxer->supportedCodecs(muxer,
+                                           AkCompressedCaps::CapsType_Video);
+    AkVideoEncoderPtr fallback;
+
+    for (auto &encoderPluginId:
+         pluginsByPriority("^VideoEncoder([/]([0-9a-zA-Z_])+)+$")) {
+        auto encoder = akPluginManager->create<AkVideoEncoder>(encoderPluginId);
+
+        if (!encoder)
+            continue;
+
+        for (auto &codec: encoder->codecs()) {
+            auto codecID = encoder->codecID(codec);
+
+            if (codecID == defaultCodec) {
+                encoder->setCodec(codec);
+
+                return encoder;
+            }
+
+            if (!fallback && supportedCodecs.contains(codecID)) {
+                encoder->setCodec(codec);
+                fallback = encoder;
+
+                break;
+            }
+        }
+    }
+
+    return fallback;
+}
+
+QStringList HeadlessRunnerPrivate::pluginsByPriority(const QString &pattern)
+{
+    auto plugins =
+            akPluginManager->listPlugins(pattern,
+                                         {},
+                                         AkPluginManager::FilterEnabled
+                                         | AkPluginManager::FilterRegexp);
+    std::sort(plugins.begin(),
+              plugins.end(),
+              [] (const QString &plugin1, const QString &plugin2) {
+        return akPluginManager->pluginInfo(plugin1).priority()
+               > akPluginManager->pluginInfo(plugin2).priority();
+    });
+
+    return plugins;
+}
+
+void HeadlessRunnerPrivate::processFrame(const AkPacket &packet)
+{
+    if (packet.type() != AkPacket::PacketVideo)
+        return;
+
+    // The effects are linked with direct connections, so the frame reaches
+    // the output before iStream returns.
+    auto startTime = this->m_timer.nsecsElapsed();
+
+    if (this->m_effects.isEmpty())
+        self->iStream(packet);
+    else
+        this->m_effects.first()->iStream(packet);
+
+    auto latency = this->m_timer.nsecsElapsed() - startTime;
+
+    this->m_mutex.lock();
+    this->m_framesIn++;
+    this->m_latencies << latency;
+    this->m_mutex.unlock();
+}
+
+void HeadlessRunnerPrivate::writeFrame(const AkPacket &packet)
+{
+    AkVideoPacket frame(packet);
+
+    if (!frame)
+        return;
+
+    auto pts = qreal(frame.pts()) * frame.timeBase().value();
+
+    this->m_mutex.lock();
+    this->m_framesOut++;
+
+    if (this->m_firstPts < 0)
+        this->m_firstPts = pts;
+
+    this->m_lastPts = pts;
+    this->m_mutex.unlock();
+
+    switch (this->m_outputType) {
+    case OutputFile:
+        if (!this->m_outputStarted && !this->m_outputFailed) {
+            this->m_outputStarted = this->startFileOutput(frame.caps());
+            this->m_outputFailed = !this->m_outputStarted;
+        }
+
+        if (this->m_outputStarted)
+            this->m_videoEncoder->iStream(packet);
+
+        break;
+
+    case OutputVirtualCamera:
+        this->m_virtualCamera->iStream(packet);
+
+        break;
+
+    default:
+        break;
+    }
+}
+
+bool HeadlessRunnerPrivate::startFileOutput(const AkVideoCaps &caps)
+{
+    this->m_muxer->setLocation(this->m_outputLocation);
+    this->m_videoEncoder->setInputCaps(caps);
+
+    if (this->m_outputBitrate > 0)
+        this->m_videoEncoder->setBitrate(this->m_outputBitrate);
+
+    this->m_videoEncoder->setFillGaps(!this->m_muxer->gapsAllowed(AkCompressedCaps::CapsType_Video));
+    this->m_muxer->setStreamCaps(this->m_videoEncoder->outputCaps());
+    this->m_muxer->setStreamBitrate(AkCompressedCaps::CapsType_Video,
+                                    this->m_videoEncoder->bitrate());
+    this->m_videoEncoder->link(this->m_muxer, Qt::DirectConnection);
+    auto muxer = this->m_muxer;
+    this->m_headersChangedConnection =
+            QObject::connect(this->m_videoEncoder.data(),
+                             &AkVideoEncoder::headersChanged,
+                             [muxer] (const QByteArray &headers) {
+                                muxer->setStreamHeaders(AkCompressedCaps::CapsType_Video,
+                                                        headers);
+                             });
+
+    if (!this->m_videoEncoder->setState(AkElement::ElementStatePaused)) {
+        qCritical() << "Can't start the video encoder";
+
+        return false;
+    }
+
+    this->m_muxer->setStreamHeaders(AkCompressedCaps::CapsType_Video,
+                                    this->m_videoEncoder->headers());
+
+    if (!this->m_muxer->setState(AkElement::ElementStatePlaying)) {
+        qCritical() << "Can't write to" << this->m_outputLocation;
+        this->m_videoEncoder->setState(AkElement::ElementStateNull);
+
+        return false;
+    }
+
+    this->m_videoEncoder->setState(AkElement::ElementStatePlaying);
+    qInfo() << "Writing to" << this->m_outputLocation;
+
+    return true;
+}
+
+void HeadlessRunnerPrivate::stopOutput()
+{
+    if (this->m_outputStarted) {
+        this->m_videoEncoder->setState(AkElement::ElementStateNull);
+        QObject::disconnect(this->m_headersChangedConnection);
+        auto duration = this->m_videoEncoder->encodedTimePts();
+
+        if (duration > 0)
+            this->m_muxer->setStreamDuration(AkCompressedCaps::CapsType_Video,
+                                             duration);
+
+        this->m_muxer->setState(AkElement::ElementStateNull);
+        this->m_outputStarted = false;
+    }
+
+    if (this->m_virtualCamera)
+        this->m_virtualCamera->setState(AkElement::ElementStateNull);
+}
+
+QVariantMap HeadlessRunnerPrivate::stats()
+{
+    QMutexLocker mutexLocker(&this->m_mutex);
+
+    auto latencies = this->m_latencies;
+    std::sort(latencies.begin(), latencies.end());
+    qreal totalLatency = 0;
+
+    for (auto &latency: latencies)
+        totalLatency += latency;
+
+    auto percentile = [&latencies] (qreal p) -> qreal {
+        if (latencies.isEmpty())
+            return 0.0;
+
+        auto i = qBound(0,
+                        qRound(p * (latencies.size() - 1)),
+                        int(latencies.size() - 1));
+
+        return latencies[i] / 1e6;
+    };
+
+    auto runTime = qreal(this->m_runTime) / 1e9;
+    auto mediaTime = this->m_firstPts < 0?
+                         0.0:
+                         this->m_lastPts - this->m_firstPts;
+
+    QVariantMap stats {
+        {"input"        , this->m_input                                },
+        {"realTime"     , this->m_realTime                             },
+        {"framesIn"     , this->m_framesIn                             },
+        {"framesOut"    , this->m_framesOut                            },
+        {"runTime"      , runTime                                      },
+        {"mediaTime"    , mediaTime                                    },
+        {"fps"          , runTime > 0? this->m_framesOut / runTime: 0.0},
+        {"speed"        , runTime > 0? mediaTime / runTime: 0.0        },
+        {"latency"      , latencies.isEmpty()?
+                              0.0:
+                              totalLatency / latencies.size() / 1e6    },
+        {"latencyMedian", percentile(0.5)                              },
+        {"latency95"    , percentile(0.95)                             },
+        {"latency99"    , percentile(0.99)                             },
+        {"maxLatency"   , percentile(1.0)                              },
+    };
+
+    QStringList effects;
+
+    for (auto &effect: this->m_effectsDescription)
+        effects << effect.id;
+
+    stats["effects"] = effects;
+
+    if (AkElementProfiler::isEnabled())
+        stats["elements"] = akElementProfiler->stats();
+
+    return stats;
+}
+
+void HeadlessRunnerPrivate::printStats(const QVariantMap &stats) const
+{
+    auto line = [] (const QString &name, const QString &value) {
+        std::cout << QString("%1: %2").arg(name, -24).arg(value).toStdString()
+                  << std::endl;
+    };
+
+    line("Frames processed",
+         QString("%1 (%2 received)")
+            .arg(stats["framesOut"].toULongLong())
+            .arg(stats["framesIn"].toULongLong()));
+    line("Run time", QString("%1 s").arg(stats["runTime"].toReal(), 0, 'f', 3));
+    line("Media time", QString("%1 s").arg(stats["mediaTime"].toReal(), 0, 'f', 3));
+    line("Throughput", QString("%1 fps (%2x)")
+                        .arg(stats["fps"].toReal(), 0, 'f', 2)
+                        .arg(stats["speed"].toReal(), 0, 'f', 2));
+    line("Latency", QString("%1 ms").arg(stats["latency"].toReal(), 0, 'f', 3));
+    line("Latency (median)", QString("%1 ms").arg(stats["latencyMedian"].toReal(), 0, 'f', 3));
+    line("Latency (95%)", QString("%1 ms").arg(stats["latency95"].toReal(), 0, 'f', 3));
+    line("Latency (99%)", QString("%1 ms").arg(stats["latency99"].toReal(), 0, 'f', 3));
+    line("Latency (maximum)", QString("%1 ms").arg(stats["maxLatency"].toReal(), 0, 'f', 3));
+}
+
+bool HeadlessRunnerPrivate::saveStats(const QVariantMap &stats) const
+{
+    QFile file(this->m_statsFile);
+
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+        return false;
+
+    file.write(QJsonDocument(QJsonObject::fromVariantMap(stats)).toJson());
+
+    return true;
+}
+
+#include "moc_headlessrunner.cpp"
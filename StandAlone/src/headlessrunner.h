@@ -0,0 +1,68 @@
+/* Webcamoid, camera capture application.
+ * Copyright (C) 2026  Gonzalo Exequiel Pedone
+ *
+ * Webcamoid is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Webcamoid is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Webcamoid. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Web-Site: http://webcamoid.github.io/
+ */
+
+#ifndef HEADLESSRUNNER_H
+#define HEADLESSRUNNER_H
+
+#include <QObject>
+#include <akpacket.h>
+
+class HeadlessRunnerPrivate;
+class CliOptions;
+
+/* Plays a media file through a chain of video effects without the user
+ * interface, and prints how fast it went when the file ends.
+ *
+ * The pipeline is read from a JSON file like:
+ *
+ * {
+ *     "input": "video.mp4",
+ *     "realTime": false,
+ *     "effects": [
+ *         "VideoFilter/Blur",
+ *         {"id": "VideoFilter/Warhol", "properties": {"nFrames": 4}}
+ *     ],
+ *     "output": "file:processed.webm",
+ *     "stats": "stats.json"
+ * }
+ *
+ * and any field can be set or overridden from the command line. The output is
+ * one of "null" (discard the frames), "file:PATH" and "virtualcamera[:ID]". A
+ * file output can also be an object with the keys: type, location, format
+ * ("pluginId:muxer"), codec ("pluginId:codec") and bitrate.
+ */
+class HeadlessRunner: public QObject
+{
+    Q_OBJECT
+
+    public:
+        HeadlessRunner(QObject *parent=nullptr);
+        ~HeadlessRunner();
+
+        // Returns the exit code of the program.
+        int run(const CliOptions &cliOptions);
+
+    private:
+        HeadlessRunnerPrivate *d;
+
+    public slots:
+        AkPacket iStream(const AkPacket &packet);
+};
+
+#endif // HEADLESSRUNNER_H
@@ -25,6 +25,7 @@
 #include <QSysInfo>
 #include <QTranslator>
 #include <aksimd.h>
+#include <aktracer.h>
 
 #ifdef OPENMP_ENABLED
 #include <omp.h>
@@ -35,6 +36,7 @@
 #endif
 
 #include "clioptions.h"
+#include "headlessrunner.h"
 #include "mediatools.h"
 
 int main(int argc, char *argv[])
@@ -53,9 +55,36 @@ int main(int argc, char *argv[])
     QApplication::setOrganizationDomain(ORGANIZATION_DOMAIN);
     qInstallMessageHandler(MediaTools::messageHandler);
 
+    // The headless mode must work without a display.
+    for (int i = 1; i < argc; i++)
+        if (qstrcmp(argv[i], "--headless") == 0) {
+            if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM"))
+                qputenv("QT_QPA_PLATFORM", "offscreen");
+
+            break;
+        }
+
     QApplication app(argc, argv);
     CliOptions cliOptions;
 
+    if (cliOptions.isSet(cliOptions.traceOpt())) {
+        if (cliOptions.isSet(cliOptions.traceBufferSizeOpt()))
+            akTracer->setBufferSize(cliOptions.value(cliOptions.traceBufferSizeOpt()).toInt());
+
+        akTracer->setTraceFile(cliOptions.value(cliOptions.traceOpt()));
+        akTracer->setEnabled(true);
+    }
+
+    if (cliOptions.isSet(cliOptions.headlessOpt())) {
+        HeadlessRunner headlessRunner;
+        auto result = headlessRunner.run(cliOptions);
+
+        if (AkTracer::isEnabled())
+            akTracer->save();
+
+        return result;
+    }
+
     // Install translations.
 
     QTranslator translator;
@@ -43,6 +43,7 @@
 #include <akaudiocaps.h>
 #include <akvideocaps.h>
 #include <akpluginmanager.h>
+#include <aktracer.h>
 
 #ifdef Q_OS_ANDROID
 #include <QJniEnvironment>
@@ -55,6 +56,7 @@
 #include "audiolayer.h"
 #include "clioptions.h"
 #include "downloadmanager.h"
+#include "framefanout.h"
 #include "iconsprovider.h"
 #include "pluginconfigs.h"
 #include "recording.h"
@@ -129,6 +131,7 @@ class MediaToolsPrivate
         UpdatesPtr m_updates;
         VideoEffectsPtr m_videoEffects;
         VideoLayerPtr m_videoLayer;
+        FrameFanoutPtr m_frameFanout;
         DownloadManagerPtr m_downloadManager;
         QMutex m_logMutex;
         QString m_documentsDirectory;
@@ -189,6 +192,13 @@ MediaTools::~MediaTools()
 {
     this->saveConfigs();
 
+    // Stop sending frames before the preview is destroyed.
+    if (this->d->m_frameFanout)
+        this->d->m_frameFanout->removeAllSinks();
+
+    if (AkTracer::isEnabled())
+        akTracer->save();
+
     if (this->d->m_engine)
         delete this->d->m_engine;
 
@@ -643,6 +653,8 @@ bool MediaTools::init(const CliOptions &cliOptions)
     this->d->m_videoEffects =
             VideoEffectsPtr(new VideoEffects(this->d->m_engine));
     this->d->m_recording = RecordingPtr(new Recording(this->d->m_engine));
+    this->d->m_frameFanout =
+            FrameFanoutPtr(new FrameFanout(this->d->m_engine));
     this->d->m_updates = UpdatesPtr(new Updates(this->d->m_engine));
     this->d->m_downloadManager =
             DownloadManagerPtr(new DownloadManager(this->d->m_engine));
@@ -672,11 +684,16 @@ bool MediaTools::init(const CliOptions &cliOptions)
                     this->d->m_audioLayer.data(),
                     Qt::DirectConnection);
     AkElement::link(this->d->m_videoEffects.data(),
-                    this->d->m_recording.data(),
-                    Qt::DirectConnection);
-    AkElement::link(this->d->m_videoEffects.data(),
-                    this->d->m_videoLayer.data(),
+                    this->d->m_frameFanout.data(),
                     Qt::DirectConnection);
+    this->d->m_frameFanout->addSink("recording",
+                                    this->d->m_recording.data(),
+                                    FrameFanout::SinkPolicyBlock,
+                                    8);
+    this->d->m_frameFanout->addSink("virtualCamera",
+                                    this->d->m_videoLayer.data(),
+                                    FrameFanout::SinkPolicyDropOldest,
+                                    2);
     AkElement::link(this->d->m_audioLayer.data(),
                     this->d->m_recording.data(),
                     Qt::DirectConnection);
@@ -684,6 +701,11 @@ bool MediaTools::init(const CliOptions &cliOptions)
                      &VideoLayer::stateChanged,
                      this->d->m_videoEffects.data(),
                      &VideoEffects::setState);
+    QObject::connect(this->d->m_videoEffects.data(),
+                     &VideoEffects::preferredInputFormatChanged,
+                     this->d->m_videoLayer.data(),
+                     &VideoLayer::setPreferredInputFormat);
+    this->d->m_videoLayer->setPreferredInputFormat(this->d->m_videoEffects->preferredInputFormat());
     QObject::connect(this->d->m_videoLayer.data(),
                      &VideoLayer::stateChanged,
                      this->d->m_audioLayer.data(),
@@ -852,9 +874,10 @@ void MediaTools::show()
         if (!videoDisplay)
             continue;
 
-        AkElement::link(this->d->m_videoEffects.data(),
-                        videoDisplay,
-                        Qt::DirectConnection);
+        this->d->m_frameFanout->addSink("preview",
+                                        videoDisplay,
+                                        FrameFanout::SinkPolicyDropOldest,
+                                        1);
 
         break;
     }
@@ -22,6 +22,7 @@
 #include <QClipboard>
 #include <QDateTime>
 #include <QDir>
+#include <QElapsedTimer>
 #include <QFile>
 #include <QImage>
 #include <QImageWriter>
@@ -33,6 +34,7 @@
 #include <QSettings>
 #include <QStandardPaths>
 #include <QThread>
+#include <QTimer>
 #include <QtConcurrent>
 #include <QtGlobal>
 
@@ -62,11 +64,13 @@
 #include <iak/akvideomuxer.h>
 
 #include "recording.h"
+#include "thumbnailer.h"
 
 #define DEFAULT_AUDIO_BITRATE 128000
 #define DEFAULT_VIDEO_BITRATE 1500000
 #define DEFAULT_VIDEO_GOP 1000
 #define DEFAULT_RECORD_AUDIO true
+#define PHOTO_LATCH_TIMEOUT 1000
 
 struct CodecInfo
 {
@@ -98,6 +102,7 @@ struct PluginPriority
 };
 
 using ObjectPtr = QSharedPointer<QObject>;
+using AkVideoPacketPtr = QSharedPointer<AkVideoPacket>;
 
 class RecordingPrivate
 {
@@ -128,12 +133,33 @@ class RecordingPrivate
         QString m_lastPhotoPreview;
         QString m_latestVideoUri;
         QString m_latestPhotoUri;
+        Thumbnailer m_videoThumbnailer;
+        QString m_thumbnailMedia;
+
+        // Slow path for the media sources that can't read thumbnails.
         AkElementPtr m_thumbnailer {akPluginManager->create<AkElement>("MultimediaSource/MultiSrc")};
-        QMutex m_mutex;
         QReadWriteLock m_thumbnailMutex;
         QMutex m_thumbnailerMutex;
         QThreadPool m_threadPool;
-        AkVideoPacket m_curPacket;
+        QThreadPool m_photoThreadPool;
+        std::atomic<int> m_latchRequests {0};
+
+        // Only used from the capture thread.
+        QElapsedTimer m_lastFrameTimer;
+
+        // Shared with the capture thread, protected by m_photoMutex.
+        QMutex m_photoMutex;
+        bool m_photoRequested {false};
+        AkVideoPacket m_lastFrame;
+        QString m_burstFileName;
+        int m_burstFrames {0};
+        int m_burstIndex {0};
+
+        // Only used from the GUI thread.
+        bool m_photoPending {false};
+        quint64 m_photoRequestId {0};
+        QStringList m_pendingPhotoPaths;
+        bool m_pendingClipboard {false};
         QImage m_photo;
         QImage m_thumbnail;
         QMap<QString, QString> m_imageFormats;
@@ -143,6 +169,7 @@ class RecordingPrivate
         bool m_isRecording {false};
         bool m_pause {false};
         AkVideoConverter m_videoConverter {{AkVideoCaps::Format_argbpack, 0, 0, {}}};
+        AkVideoConverter m_photoConverter {{AkVideoCaps::Format_argbpack, 0, 0, {}}};
 
         explicit RecordingPrivate(Recording *self);
         static bool canAccessStorage();
@@ -158,7 +185,26 @@ class RecordingPrivate
         void loadCodecOptions(AkCaps::CapsType type);
         void updatePreviews();
         void readThumbnail(const QString &videoFile);
+        void videoThumbnailReady(const QString &media,
+                                 const QString &thumbnail);
+        void videoThumbnailFailed(const QString &media);
         void thumbnailReady();
+        static QImage packetToImage(AkVideoConverter &converter,
+                                    const AkVideoPacket &packet);
+        static QString normalizePhotoPath(const QString &fileName);
+        static QString burstFileName(const QString &fileName, int index);
+        void latchFrame(const AkPacket &packet);
+        void keepLastFrame(const AkPacket &packet);
+        void photoLatchTimeout(quint64 requestId);
+        void convertPhoto(const AkVideoPacketPtr &frame);
+        void photoReady(const QImage &photo);
+        void savePhotoFrame(const AkVideoPacketPtr &frame,
+                            const QString &path,
+                            int quality);
+        void writePhoto(const QImage &photo,
+                        const QString &path,
+                        int quality);
+        void photoSaved(const QString &path);
 
 #ifdef Q_OS_ANDROID
         static QString androidCopyUriToTemp(const QString &uri,
@@ -206,6 +252,19 @@ Recording::Recording(QQmlApplicationEngine *engine, QObject *parent):
     this->d = new RecordingPrivate(this);
     this->setQmlEngine(engine);
 
+    QObject::connect(&this->d->m_videoThumbnailer,
+                     &Thumbnailer::thumbnailReady,
+                     this,
+                     [this] (const QString &media, const QString &thumbnail) {
+                        this->d->videoThumbnailReady(media, thumbnail);
+                     });
+    QObject::connect(&this->d->m_videoThumbnailer,
+                     &Thumbnailer::thumbnailFailed,
+                     this,
+                     [this] (const QString &media) {
+                        this->d->videoThumbnailFailed(media);
+                     });
+
     if (this->d->m_thumbnailer) {
         QObject::connect(this->d->m_thumbnailer.data(),
                          SIGNAL(oStream(AkPacket)),
@@ -225,6 +284,7 @@ Recording::Recording(QQmlApplicationEngine *engine, QObject *parent):
 Recording::~Recording()
 {
     this->setState(AkElement::ElementStateNull);
+    this->d->m_photoThreadPool.waitForDone();
     delete this->d;
 }
 
@@ -989,25 +1049,25 @@ void Recording::resetImageSaveQuality()
 
 void Recording::takePhoto()
 {
-    this->d->m_mutex.lock();
+    /* Instead of keeping a copy of every frame just in case a photo is
+     * requested, ask the capture thread to latch the next frame. The photo is
+     * ready when the frame arrives, the calls to savePhoto() and
+     * copyToClipboard() made in the meantime are run at that moment.
+     */
+    if (this->d->m_photoPending)
+        return;
 
-    this->d->m_videoConverter.begin();
-    auto src = this->d->m_videoConverter.convert(this->d->m_curPacket);
-    this->d->m_videoConverter.end();
+    this->d->m_photoPending = true;
+    auto requestId = ++this->d->m_photoRequestId;
 
-    this->d->m_photo = QImage(src.caps().width(),
-                              src.caps().height(),
-                              QImage::Format_ARGB32);
-    auto lineSize =
-            qMin<size_t>(src.lineSize(0), this->d->m_photo.bytesPerLine());
+    this->d->m_photoMutex.lock();
+    this->d->m_photoRequested = true;
+    this->d->m_latchRequests++;
+    this->d->m_photoMutex.unlock();
 
-    for (int y = 0; y < src.caps().height(); y++) {
-        auto srcLine = src.constLine(0, y);
-        auto dstLine = this->d->m_photo.scanLine(y);
-        memcpy(dstLine, srcLine, lineSize);
-    }
-
-    this->d->m_mutex.unlock();
+    QTimer::singleShot(PHOTO_LATCH_TIMEOUT, this, [this, requestId] () {
+        this->d->photoLatchTimeout(requestId);
+    });
 }
 
 void Recording::savePhoto(const QString &fileName)
@@ -1015,21 +1075,13 @@ void Recording::savePhoto(const QString &fileName)
     if (!this->d->canAccessStorage())
         return;
 
-    QString path = fileName;
-
-#ifdef Q_OS_WIN32
-    path.replace("file:///", "");
-#else
-    path.replace("file://", "");
-#endif
+    auto path = RecordingPrivate::normalizePhotoPath(fileName);
 
     if (path.isEmpty())
         return;
 
-    auto saveDirectory = QFileInfo(path).absolutePath();
-
-    if (!QDir().exists(saveDirectory) && !QDir().mkpath(saveDirectory)) {
-        qCritical() << "Failed creatng the Images directory" << saveDirectory;
+    if (this->d->m_photoPending) {
+        this->d->m_pendingPhotoPaths << path;
 
         return;
     }
@@ -1040,49 +1092,51 @@ void Recording::savePhoto(const QString &fileName)
         return;
     }
 
-    if (!this->d->m_photo.save(path, nullptr, this->d->m_imageSaveQuality)) {
-        qCritical() << "Failed saving the photo to" << path;
+    // Encode and write the photo in the background.
+    auto result =
+            QtConcurrent::run(&this->d->m_photoThreadPool,
+                              &RecordingPrivate::writePhoto,
+                              this->d,
+                              this->d->m_photo,
+                              path,
+                              this->d->m_imageSaveQuality);
+    Q_UNUSED(result)
+}
 
+void Recording::savePhotoBurst(const QString &fileName, int frames)
+{
+    if (frames < 1 || !this->d->canAccessStorage())
         return;
-    }
 
-#ifdef Q_OS_ANDROID
-    if (RecordingPrivate::saveMediaFileToGallery(path, false)) {
-        this->d->m_latestPhotoUri = RecordingPrivate::getLatestMediaUri(false);
-
-        if (!this->d->m_latestPhotoUri.isEmpty()) {
-            auto latestPhoto =
-                    RecordingPrivate::androidCopyUriToTemp(this->d->m_latestPhotoUri,
-                                                           "photo");
-
-            if (!latestPhoto.isEmpty()) {
-                this->d->m_lastPhotoPreview = latestPhoto;
-                emit this->lastPhotoPreviewChanged(latestPhoto);
-                emit this->latestPhotoUriChanged(this->d->m_latestPhotoUri);
-            } else {
-                this->d->m_lastPhotoPreview = {};
-                emit this->lastPhotoPreviewChanged(this->d->m_lastPhotoPreview);
-                this->d->m_latestPhotoUri = {};
-                emit this->latestPhotoUriChanged(this->d->m_latestPhotoUri);
-            }
-        }
-    } else {
-        this->d->m_lastPhotoPreview = {};
-        emit this->lastPhotoPreviewChanged(this->d->m_lastPhotoPreview);
-        this->d->m_latestPhotoUri = {};
-        emit this->latestPhotoUriChanged(this->d->m_latestPhotoUri);
+    auto path = RecordingPrivate::normalizePhotoPath(fileName);
+
+    if (path.isEmpty())
+        return;
+
+    this->d->m_photoMutex.lock();
+
+    if (this->d->m_burstFrames > 0) {
+        this->d->m_photoMutex.unlock();
+        qWarning() << "A photo burst is already in progress";
+
+        return;
     }
 
-    if (QFile::exists(path))
-        QFile::remove(path);
-#else
-    this->d->m_lastPhotoPreview = path;
-    emit this->lastPhotoPreviewChanged(path);
-#endif
+    this->d->m_burstFileName = path;
+    this->d->m_burstFrames = frames;
+    this->d->m_burstIndex = 0;
+    this->d->m_latchRequests += frames;
+    this->d->m_photoMutex.unlock();
 }
 
 bool Recording::copyToClipboard()
 {
+    if (this->d->m_photoPending) {
+        this->d->m_pendingClipboard = true;
+
+        return true;
+    }
+
     if (!this->d->m_photo.isNull()) {
         QApplication::clipboard()->setImage(this->d->m_photo, QClipboard::Clipboard);
 
@@ -1095,9 +1149,10 @@ bool Recording::copyToClipboard()
 AkPacket Recording::iStream(const AkPacket &packet)
 {
     if (packet.type() == AkPacket::PacketVideo) {
-        this->d->m_mutex.lock();
-        this->d->m_curPacket = packet;
-        this->d->m_mutex.unlock();
+        if (this->d->m_latchRequests > 0)
+            this->d->latchFrame(packet);
+        else
+            this->d->keepLastFrame(packet);
     }
 
     if (this->d->m_isRecording) {
@@ -1135,25 +1190,12 @@ void Recording::setQmlEngine(QQmlApplicationEngine *engine)
 
 void Recording::thumbnailUpdated(const AkPacket &packet)
 {
-    this->d->m_videoConverter.begin();
-    auto src = this->d->m_videoConverter.convert(packet);
-    this->d->m_videoConverter.end();
+    auto thumbnail =
+            RecordingPrivate::packetToImage(this->d->m_videoConverter, packet);
 
-    if (!src)
+    if (thumbnail.isNull())
         return;
 
-    QImage thumbnail(src.caps().width(),
-                     src.caps().height(),
-                     QImage::Format_ARGB32);
-    auto lineSize =
-            qMin<size_t>(src.lineSize(0), thumbnail.bytesPerLine());
-
-    for (int y = 0; y < src.caps().height(); y++) {
-        auto srcLine = src.constLine(0, y);
-        auto dstLine = thumbnail.scanLine(y);
-        memcpy(dstLine, srcLine, lineSize);
-    }
-
     this->d->m_thumbnailMutex.lockForWrite();
     this->d->m_thumbnail = thumbnail;
     this->d->m_thumbnailMutex.unlock();
@@ -1240,6 +1282,9 @@ RecordingPrivate::RecordingPrivate(Recording *self):
 
     this->initSupportedCodecs();
     this->initSupportedFormats();
+
+    // Photos are written in order, one at a time.
+    this->m_photoThreadPool.setMaxThreadCount(1);
 }
 
 bool RecordingPrivate::canAccessStorage()
@@ -2026,10 +2071,44 @@ void RecordingPrivate::updatePreviews()
 
 void RecordingPrivate::readThumbnail(const QString &videoFile)
 {
-    if (!this->m_thumbnailer || videoFile.isEmpty())
+    if (videoFile.isEmpty())
         return;
 
-    this->m_thumbnailer->setProperty("media", videoFile);
+    this->m_thumbnailMutex.lockForWrite();
+    this->m_thumbnailMedia = videoFile;
+    this->m_thumbnailMutex.unlock();
+
+    if (this->m_videoThumbnailer.isAvailable())
+        this->m_videoThumbnailer.request(videoFile);
+    else
+        this->videoThumbnailFailed(videoFile);
+}
+
+void RecordingPrivate::videoThumbnailReady(const QString &media,
+                                           const QString &thumbnail)
+{
+    this->m_thumbnailMutex.lockForRead();
+    auto thumbnailMedia = this->m_thumbnailMedia;
+    this->m_thumbnailMutex.unlock();
+
+    if (media != thumbnailMedia)
+        return;
+
+    this->m_lastVideoPreview = thumbnail;
+    emit self->lastVideoPreviewChanged(thumbnail);
+}
+
+void RecordingPrivate::videoThumbnailFailed(const QString &media)
+{
+    this->m_thumbnailMutex.lockForRead();
+    auto thumbnailMedia = this->m_thumbnailMedia;
+    this->m_thumbnailMutex.unlock();
+
+    if (!this->m_thumbnailer || media != thumbnailMedia)
+        return;
+
+    // Play the video until the first frame.
+    this->m_thumbnailer->setProperty("media", media);
     this->m_thumbnailer->setProperty("sync", false);
 }
 
@@ -2076,6 +2155,261 @@ void RecordingPrivate::thumbnailReady()
     emit self->lastVideoPreviewChanged(thumbnailPath);
 }
 
+QImage RecordingPrivate::packetToImage(AkVideoConverter &converter,
+                                       const AkVideoPacket &packet)
+{
+    converter.begin();
+    auto src = converter.convert(packet);
+    converter.end();
+
+    if (!src)
+        return {};
+
+    QImage image(src.caps().width(),
+                 src.caps().height(),
+                 QImage::Format_ARGB32);
+    auto lineSize =
+            qMin<size_t>(src.lineSize(0), image.bytesPerLine());
+
+    for (int y = 0; y < src.caps().height(); y++) {
+        auto srcLine = src.constLine(0, y);
+        auto dstLine = image.scanLine(y);
+        memcpy(dstLine, srcLine, lineSize);
+    }
+
+    return image;
+}
+
+QString RecordingPrivate::normalizePhotoPath(const QString &fileName)
+{
+    QString path = fileName;
+
+#ifdef Q_OS_WIN32
+    path.replace("file:///", "");
+#else
+    path.replace("file://", "");
+#endif
+
+    return path;
+}
+
+QString RecordingPrivate::burstFileName(const QString &fileName, int index)
+{
+    QFileInfo fileInfo(fileName);
+    auto suffix = fileInfo.suffix();
+    auto baseName = suffix.isEmpty()?
+                        fileName:
+                        fileName.left(fileName.size() - suffix.size() - 1);
+
+    return QString("%1 %2%3")
+            .arg(baseName)
+            .arg(index + 1, 3, 10, QChar('0'))
+            .arg(suffix.isEmpty()? QString(): '.' + suffix);
+}
+
+void RecordingPrivate::latchFrame(const AkPacket &packet)
+{
+    /* Only copy the frame when it was requested, either by takePhoto() or by
+     * a running burst. Burst frames are never dropped, they are queued to the
+     * photo worker as they come.
+     */
+    QMutexLocker mutexLocker(&this->m_photoMutex);
+
+    if (this->m_photoRequested) {
+        this->m_photoRequested = false;
+        this->m_latchRequests--;
+        auto result =
+                QtConcurrent::run(&this->m_photoThreadPool,
+                                  &RecordingPrivate::convertPhoto,
+                                  this,
+                                  AkVideoPacketPtr::create(packet));
+        Q_UNUSED(result)
+    }
+
+    if (this->m_burstFrames > 0) {
+        auto frame = AkVideoPacketPtr::create(packet);
+        auto path = burstFileName(this->m_burstFileName, this->m_burstIndex);
+        this->m_burstIndex++;
+        this->m_burstFrames--;
+        this->m_latchRequests--;
+        auto result =
+                QtConcurrent::run(&this->m_photoThreadPool,
+                                  &RecordingPrivate::savePhotoFrame,
+                                  this,
+                                  frame,
+                                  path,
+                                  this->m_imageSaveQuality);
+        Q_UNUSED(result)
+    }
+}
+
+void RecordingPrivate::keepLastFrame(const AkPacket &packet)
+{
+    /* Keep a frame from time to time, so a photo can still be taken when the
+     * source stops sending frames, without copying every frame.
+     */
+    if (this->m_lastFrameTimer.isValid()
+        && this->m_lastFrameTimer.elapsed() < PHOTO_LATCH_TIMEOUT)
+        return;
+
+    AkVideoPacket frame(packet);
+    this->m_photoMutex.lock();
+    this->m_lastFrame = frame;
+    this->m_photoMutex.unlock();
+    this->m_lastFrameTimer.start();
+}
+
+void RecordingPrivate::photoLatchTimeout(quint64 requestId)
+{
+    if (!this->m_photoPending || requestId != this->m_photoRequestId)
+        return;
+
+    this->m_photoMutex.lock();
+
+    // The frame was latched in time.
+    if (!this->m_photoRequested) {
+        this->m_photoMutex.unlock();
+
+        return;
+    }
+
+    this->m_photoRequested = false;
+    this->m_latchRequests--;
+    auto frame = this->m_lastFrame;
+    this->m_photoMutex.unlock();
+
+    if (!frame) {
+        qWarning() << "Timeout waiting for a frame to take the photo";
+        this->photoReady({});
+
+        return;
+    }
+
+    // No new frames, use the last one.
+    auto result =
+            QtConcurrent::run(&this->m_photoThreadPool,
+                              &RecordingPrivate::convertPhoto,
+                              this,
+                              AkVideoPacketPtr::create(frame));
+    Q_UNUSED(result)
+}
+
+void RecordingPrivate::convertPhoto(const AkVideoPacketPtr &frame)
+{
+    auto photo = packetToImage(this->m_photoConverter, *frame);
+
+    if (photo.isNull())
+        qCritical() << "The image to save is Null";
+
+    QMetaObject::invokeMethod(self, [this, photo] () {
+        this->photoReady(photo);
+    }, Qt::QueuedConnection);
+}
+
+void RecordingPrivate::photoReady(const QImage &photo)
+{
+    this->m_photoPending = false;
+    auto paths = this->m_pendingPhotoPaths;
+    auto toClipboard = this->m_pendingClipboard;
+    this->m_pendingPhotoPaths.clear();
+    this->m_pendingClipboard = false;
+
+    if (photo.isNull())
+        return;
+
+    this->m_photo = photo;
+
+    for (auto &path: paths) {
+        auto result =
+                QtConcurrent::run(&this->m_photoThreadPool,
+                                  &RecordingPrivate::writePhoto,
+                                  this,
+                                  photo,
+                                  path,
+                                  this->m_imageSaveQuality);
+        Q_UNUSED(result)
+    }
+
+    if (toClipboard)
+        QApplication::clipboard()->setImage(photo, QClipboard::Clipboard);
+}
+
+void RecordingPrivate::savePhotoFrame(const AkVideoPacketPtr &frame,
+                                      const QString &path,
+                                      int quality)
+{
+    auto photo = packetToImage(this->m_photoConverter, *frame);
+
+    if (photo.isNull()) {
+        qCritical() << "The image to save is Null";
+
+        return;
+    }
+
+    this->writePhoto(photo, path, quality);
+}
+
+void RecordingPrivate::writePhoto(const QImage &photo,
+                                  const QString &path,
+                                  int quality)
+{
+    auto saveDirectory = QFileInfo(path).absolutePath();
+
+    if (!QDir().exists(saveDirectory) && !QDir().mkpath(saveDirectory)) {
+        qCritical() << "Failed creatng the Images directory" << saveDirectory;
+
+        return;
+    }
+
+    if (!photo.save(path, nullptr, quality)) {
+        qCritical() << "Failed saving the photo to" << path;
+
+        return;
+    }
+
+    this->photoSaved(path);
+}
+
+void RecordingPrivate::photoSaved(const QString &path)
+{
+    // This runs in the photo worker, the previews are updated in the GUI thread.
+#ifdef Q_OS_ANDROID
+    QString preview;
+    QString uri;
+    bool update = true;
+
+    if (saveMediaFileToGallery(path, false)) {
+        uri = getLatestMediaUri(false);
+        update = !uri.isEmpty();
+
+        if (update) {
+            preview = androidCopyUriToTemp(uri, "photo");
+
+            if (preview.isEmpty())
+                uri = {};
+        }
+    }
+
+    if (QFile::exists(path))
+        QFile::remove(path);
+
+    if (!update)
+        return;
+
+    QMetaObject::invokeMethod(self, [this, preview, uri] () {
+        this->m_lastPhotoPreview = preview;
+        emit self->lastPhotoPreviewChanged(preview);
+        this->m_latestPhotoUri = uri;
+        emit self->latestPhotoUriChanged(uri);
+    }, Qt::QueuedConnection);
+#else
+    QMetaObject::invokeMethod(self, [this, path] () {
+        this->m_lastPhotoPreview = path;
+        emit self->lastPhotoPreviewChanged(path);
+    }, Qt::QueuedConnection);
+#endif
+}
+
 #ifdef Q_OS_ANDROID
 QString RecordingPrivate::androidCopyUriToTemp(const QString &uri,
                                                const QString &outputFileName)
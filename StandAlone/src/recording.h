@@ -253,6 +253,7 @@ class Recording: public QObject
 
         void takePhoto();
         void savePhoto(const QString &fileName);
+        void savePhotoBurst(const QString &fileName, int frames);
         bool copyToClipboard();
         AkPacket iStream(const AkPacket &packet);
         void setQmlEngine(QQmlApplicationEngine *engine=nullptr);
@@ -0,0 +1,294 @@
+/* Webcamoid, camera capture application.
+ * Copyright (C) 2026  Gonzalo Exequiel Pedone
+ *
+ * Webcamoid is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Webcamoid is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Webcamoid. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Web-Site: http://webcamoid.github.io/
+ */
+
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QImage>
+#include <QMutex>
+#include <QSet>
+#include <QStandardPaths>
+#include <QThreadPool>
+#include <QtConcurrent>
+#include <akpacket.h>
+#include <akpluginmanager.h>
+#include <akvideocaps.h>
+#include <akvideopacket.h>
+#include <iak/akelement.h>
+
+#include "thumbnailer.h"
+
+#define DEFAULT_THUMBNAIL_SIZE QSize(640, 480)
+
+// Position of the thumbnail, as a fraction of the video duration.
+#define THUMBNAIL_POSITION 0.1
+
+// Limits of the thumbnails cache.
+#define MAX_CACHE_SIZE (64 << 20)
+#define MAX_CACHE_AGE  30
+
+class ThumbnailerPrivate
+{
+    public:
+        Thumbnailer *self;
+        AkElementPtr m_mediaSource {akPluginManager->create<AkElement>("MultimediaSource/MultiSrc")};
+        QThreadPool m_threadPool;
+        QMutex m_mutex;
+        QSet<QString> m_pending;
+        QSize m_size {DEFAULT_THUMBNAIL_SIZE};
+        QMutex m_cacheMutex;
+
+        explicit ThumbnailerPrivate(Thumbnailer *self);
+        static QString cacheDir();
+        static QString cachePath(const QString &media, const QSize &size);
+        void readThumbnail(const QString &media, const QSize &size);
+        void pruneCache();
+        static QImage packetToImage(const AkVideoPacket &packet);
+};
+
+Thumbnailer::Thumbnailer(QObject *parent):
+    QObject(parent)
+{
+    this->d = new ThumbnailerPrivate(this);
+}
+
+Thumbnailer::~Thumbnailer()
+{
+    this->d->m_threadPool.waitForDone();
+    delete this->d;
+}
+
+QSize Thumbnailer::size() const
+{
+    return this->d->m_size;
+}
+
+bool Thumbnailer::isAvailable() const
+{
+    return !this->d->m_mediaSource.isNull();
+}
+
+QString Thumbnailer::cachedThumbnail(const QString &media) const
+{
+    this->d->m_mutex.lock();
+    auto size = this->d->m_size;
+    this->d->m_mutex.unlock();
+
+    auto thumbnail = ThumbnailerPrivate::cachePath(media, size);
+
+    return !thumbnail.isEmpty() && QFileInfo::exists(thumbnail)?
+                thumbnail: QString();
+}
+
+void Thumbnailer::request(const QString &media)
+{
+    if (!this->d->m_mediaSource || media.isEmpty())
+        return;
+
+    auto thumbnail = this->cachedThumbnail(media);
+
+    if (!thumbnail.isEmpty()) {
+        emit this->thumbnailReady(media, thumbnail);
+
+        return;
+    }
+
+    this->d->m_mutex.lock();
+
+    if (this->d->m_pending.contains(media)) {
+        this->d->m_mutex.unlock();
+
+        return;
+    }
+
+    this->d->m_pending << media;
+    auto size = this->d->m_size;
+    this->d->m_mutex.unlock();
+
+    auto result = QtConcurrent::run(&this->d->m_threadPool,
+                                    &ThumbnailerPrivate::readThumbnail,
+                                    this->d,
+                                    media,
+                                    size);
+    Q_UNUSED(result)
+}
+
+void Thumbnailer::request(const QStringList &medias)
+{
+    for (auto &media: medias)
+        this->request(media);
+}
+
+void Thumbnailer::setSize(const QSize &size)
+{
+    this->d->m_mutex.lock();
+
+    if (this->d->m_size == size) {
+        this->d->m_mutex.unlock();
+
+        return;
+    }
+
+    this->d->m_size = size;
+    this->d->m_mutex.unlock();
+    emit this->sizeChanged(size);
+}
+
+void Thumbnailer::resetSize()
+{
+    this->setSize(DEFAULT_THUMBNAIL_SIZE);
+}
+
+void Thumbnailer::clearCache()
+{
+    auto cacheDir = ThumbnailerPrivate::cacheDir();
+
+    if (!cacheDir.isEmpty())
+        QDir(cacheDir).removeRecursively();
+}
+
+ThumbnailerPrivate::ThumbnailerPrivate(Thumbnailer *self):
+    self(self)
+{
+    // Each thumbnail is decoded in a single thread, so read one file per
+    // core.
+    this->m_threadPool.setMaxThreadCount(qMax(2, QThread::idealThreadCount()));
+}
+
+QString ThumbnailerPrivate::cacheDir()
+{
+    auto cachePath =
+            QStandardPaths::writableLocation(QStandardPaths::CacheLocation);
+
+    return cachePath.isEmpty()? QString(): QDir(cachePath).filePath("thumbnails");
+}
+
+QString ThumbnailerPrivate::cachePath(const QString &media, const QSize &size)
+{
+    QFileInfo info(media);
+
+    if (!info.exists())
+        return {};
+
+    auto cacheDir = ThumbnailerPrivate::cacheDir();
+
+    if (cacheDir.isEmpty())
+        return {};
+
+    auto key = QString("%1:%2:%3:%4x%5")
+               .arg(info.absoluteFilePath())
+               .arg(info.lastModified().toMSecsSinceEpoch())
+               .arg(info.size())
+               .arg(size.width())
+               .arg(size.height());
+    auto hash = QCryptographicHash::hash(key.toUtf8(),
+                                         QCryptographicHash::Sha1).toHex();
+
+    /* NOTE: Saving in formats other than BMP can result in broken files that
+     * can cause Qml to crash the whole app.
+     */
+    return QDir(cacheDir).filePath(QString("%1.bmp").arg(QString(hash)));
+}
+
+void ThumbnailerPrivate::readThumbnail(const QString &media, const QSize &size)
+{
+    AkPacket packet;
+    QMetaObject::invokeMethod(this->m_mediaSource.data(),
+                              "thumbnail",
+                              Qt::DirectConnection,
+                              Q_RETURN_ARG(AkPacket, packet),
+                              Q_ARG(QString, media),
+                              Q_ARG(QSize, size),
+                              Q_ARG(qreal, THUMBNAIL_POSITION));
+    auto thumbnail = ThumbnailerPrivate::packetToImage(packet);
+    auto thumbnailPath = ThumbnailerPrivate::cachePath(media, size);
+    bool ok = false;
+
+    if (!thumbnail.isNull()
+        && !thumbnailPath.isEmpty()
+        && QDir().mkpath(ThumbnailerPrivate::cacheDir())) {
+        // Write to a temporary file first, so a thumbnail is never read
+        // half written.
+        auto tempPath = thumbnailPath + ".part";
+        QFile::remove(tempPath);
+        ok = thumbnail.save(tempPath, "BMP")
+             && (!QFile::exists(thumbnailPath) || QFile::remove(thumbnailPath))
+             && QFile::rename(tempPath, thumbnailPath);
+
+        if (!ok)
+            QFile::remove(tempPath);
+    }
+
+    if (ok)
+        this->pruneCache();
+
+    this->m_mutex.lock();
+    this->m_pending.remove(media);
+    this->m_mutex.unlock();
+
+    if (ok)
+        emit self->thumbnailReady(media, thumbnailPath);
+    else
+        emit self->thumbnailFailed(media);
+}
+
+void ThumbnailerPrivate::pruneCache()
+{
+    auto cacheDir = ThumbnailerPrivate::cacheDir();
+
+    if (cacheDir.isEmpty())
+        return;
+
+    QMutexLocker mutexLocker(&this->m_cacheMutex);
+
+    // Newest first, keep them while they fit in the cache.
+    auto thumbnails = QDir(cacheDir).entryInfoList({"*.bmp"},
+                                                   QDir::Files,
+                                                   QDir::Time);
+    auto oldest = QDateTime::currentDateTime().addDays(-MAX_CACHE_AGE);
+    qint64 cacheSize = 0;
+
+    for (auto &thumbnail: thumbnails) {
+        cacheSize += thumbnail.size();
+
+        if (cacheSize > MAX_CACHE_SIZE || thumbnail.lastModified() < oldest)
+            QFile::remove(thumbnail.absoluteFilePath());
+    }
+}
+
+QImage ThumbnailerPrivate::packetToImage(const AkVideoPacket &packet)
+{
+    if (!packet || packet.caps().format() != AkVideoCaps::Format_rgb24)
+        return {};
+
+    QImage image(packet.caps().width(),
+                 packet.caps().height(),
+                 QImage::Format_RGB888);
+    auto lineSize =
+            qMin<size_t>(image.bytesPerLine(), packet.lineSize(0));
+
+    for (int y = 0; y < image.height(); ++y)
+        memcpy(image.scanLine(y), packet.constLine(0, y), lineSize);
+
+    return image;
+}
+
+#include "moc_thumbnailer.cpp"
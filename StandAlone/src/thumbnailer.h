@@ -0,0 +1,74 @@
+/* Webcamoid, camera capture application.
+ * Copyright (C) 2026  Gonzalo Exequiel Pedone
+ *
+ * Webcamoid is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Webcamoid is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Webcamoid. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Web-Site: http://webcamoid.github.io/
+ */
+
+#ifndef THUMBNAILER_H
+#define THUMBNAILER_H
+
+#include <QObject>
+#include <QSize>
+
+class ThumbnailerPrivate;
+
+/* Creates the thumbnails of the video files.
+ *
+ * The thumbnails are read by the MultiSrc plugin from the key frame closest
+ * to the 10% of the video duration, several files at once, and stored in
+ * the cache directory. A thumbnail is reused until the path, the
+ * modification time or the size of the file change. The oldest thumbnails
+ * are removed when the cache grows too big, or when they are a month old.
+ */
+class Thumbnailer: public QObject
+{
+    Q_OBJECT
+    Q_PROPERTY(QSize size
+               READ size
+               WRITE setSize
+               RESET resetSize
+               NOTIFY sizeChanged)
+
+    public:
+        Thumbnailer(QObject *parent=nullptr);
+        ~Thumbnailer();
+
+        Q_INVOKABLE QSize size() const;
+        Q_INVOKABLE bool isAvailable() const;
+
+        // Returns the cached thumbnail of the media, or an empty string if
+        // there is no valid thumbnail for it.
+        Q_INVOKABLE QString cachedThumbnail(const QString &media) const;
+
+    private:
+        ThumbnailerPrivate *d;
+
+    signals:
+        void sizeChanged(const QSize &size);
+        void thumbnailReady(const QString &media, const QString &thumbnail);
+        void thumbnailFailed(const QString &media);
+
+    public slots:
+        void request(const QString &media);
+        void request(const QStringList &medias);
+        void setSize(const QSize &size);
+        void resetSize();
+        void clearCache();
+
+    friend class ThumbnailerPrivate;
+};
+
+#endif // THUMBNAILER_H
@@ -53,8 +53,10 @@ class VideoEffectsPrivate
         QMutex m_mutex;
         AkElement::ElementState m_state {AkElement::ElementStateNull};
         bool m_chainEffects {false};
+        AkVideoCaps::PixelFormat m_preferredInputFormat {AkVideoCaps::Format_none};
 
         explicit VideoEffectsPrivate(VideoEffects *self);
+        void negotiateFormats();
         void updateChainEffects();
         void updateEffects();
         void updateEffectsProperties();
@@ -69,6 +71,24 @@ VideoEffects::VideoEffects(QQmlApplicationEngine *engine, QObject *parent):
     QObject(parent)
 {
     this->d = new VideoEffectsPrivate(this);
+    QObject::connect(this,
+                     &VideoEffects::effectsChanged,
+                     this,
+                     [this] () {
+                        this->d->negotiateFormats();
+                     });
+    QObject::connect(this,
+                     &VideoEffects::previewChanged,
+                     this,
+                     [this] () {
+                        this->d->negotiateFormats();
+                     });
+    QObject::connect(this,
+                     &VideoEffects::chainEffectsChanged,
+                     this,
+                     [this] () {
+                        this->d->negotiateFormats();
+                     });
     this->setQmlEngine(engine);
     this->updateAvailableEffects();
     this->d->updateChainEffects();
@@ -133,6 +153,11 @@ bool VideoEffects::chainEffects() const
     return this->d->m_chainEffects;
 }
 
+AkVideoCaps::PixelFormat VideoEffects::preferredInputFormat() const
+{
+    return this->d->m_preferredInputFormat;
+}
+
 bool VideoEffects::embedControls(const QString &where,
                                  int effectIndex,
                                  const QString &name) const
@@ -725,6 +750,29 @@ VideoEffectsPrivate::VideoEffectsPrivate(VideoEffects *self):
 
 }
 
+void VideoEffectsPrivate::negotiateFormats()
+{
+    QList<AkElementPtr> chain;
+
+    this->m_mutex.lock();
+
+    for (auto &effect: this->m_effects)
+        chain << effect.element;
+
+    if (this->m_preview.element && (chain.isEmpty() || this->m_chainEffects))
+        chain << this->m_preview.element;
+
+    this->m_mutex.unlock();
+
+    auto format = AkElement::negotiateVideoFormats(chain);
+
+    if (this->m_preferredInputFormat == format)
+        return;
+
+    this->m_preferredInputFormat = format;
+    emit self->preferredInputFormatChanged(format);
+}
+
 void VideoEffectsPrivate::updateChainEffects()
 {
     QSettings config;
@@ -55,6 +55,9 @@ class VideoEffects: public QObject
                WRITE setChainEffects
                RESET resetChainEffects
                NOTIFY chainEffectsChanged)
+    Q_PROPERTY(AkVideoCaps::PixelFormat preferredInputFormat
+               READ preferredInputFormat
+               NOTIFY preferredInputFormatChanged)
 
     public:
         VideoEffects(QQmlApplicationEngine *engine=nullptr,
@@ -68,6 +71,7 @@ class VideoEffects: public QObject
         Q_INVOKABLE QString effectDescription(const QString &effectId) const;
         Q_INVOKABLE AkElement::ElementState state() const;
         Q_INVOKABLE bool chainEffects() const;
+        Q_INVOKABLE AkVideoCaps::PixelFormat preferredInputFormat() const;
         Q_INVOKABLE bool embedControls(const QString &where,
                                        int effectIndex,
                                        const QString &name={}) const;
@@ -85,6 +89,7 @@ class VideoEffects: public QObject
         void oStream(const AkPacket &packet);
         void stateChanged(AkElement::ElementState state);
         void chainEffectsChanged(bool chainEffects);
+        void preferredInputFormatChanged(AkVideoCaps::PixelFormat format);
 
     public slots:
         void setEffects(const QStringList &effects);
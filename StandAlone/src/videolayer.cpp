@@ -1181,6 +1181,12 @@ void VideoLayer::setRootMethod(const QString &rootMethod)
         this->d->m_cameraOutput->setProperty("rootMethod", rootMethod);
 }
 
+void VideoLayer::setPreferredInputFormat(AkVideoCaps::PixelFormat format)
+{
+    if (this->d->m_cameraCapture)
+        this->d->m_cameraCapture->setPreferredVideoFormat(format);
+}
+
 void VideoLayer::resetVideoInput()
 {
     this->setVideoInput({});
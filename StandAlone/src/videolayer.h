@@ -306,6 +306,7 @@ class VideoLayer: public QObject
         void setOutputsAsInputs(bool outputsAsInputs);
         void setPicture(const QString &picture);
         void setRootMethod(const QString &rootMethod);
+        void setPreferredInputFormat(AkVideoCaps::PixelFormat format);
         void resetVideoInput();
         void resetVideoOutput();
         void resetState();
@@ -40,6 +40,7 @@
 #include "akcompressedaudiopacket.h"
 #include "akcompressedvideocaps.h"
 #include "akcompressedvideopacket.h"
+#include "akelementprofiler.h"
 #include "akfrac.h"
 #include "akmenuoption.h"
 #include "akpacket.h"
@@ -48,6 +49,7 @@
 #include "akpropertyoption.h"
 #include "aksubtitlecaps.h"
 #include "aksubtitlepacket.h"
+#include "aktracer.h"
 #include "akunit.h"
 #include "akvideocaps.h"
 #include "akvideoconverter.h"
@@ -120,6 +122,7 @@ void Ak::registerTypes()
     AkCompressedVideoCaps::registerTypes();
     AkCompressedVideoPacket::registerTypes();
     AkElement::registerTypes();
+    AkElementProfiler::registerTypes();
     AkFontSettings::registerTypes();
     AkFrac::registerTypes();
     AkMenuOption::registerTypes();
@@ -132,6 +135,7 @@ void Ak::registerTypes()
     AkSubtitleCaps::registerTypes();
     AkSubtitlePacket::registerTypes();
     AkTheme::registerTypes();
+    AkTracer::registerTypes();
     AkUnit::registerTypes();
     AkUtils::registerTypes();
     AkVideoCaps::registerTypes();
@@ -27,6 +27,7 @@
 #include "akaudioconverter.h"
 #include "akaudiopacket.h"
 #include "akfrac.h"
+#include "aktracer.h"
 
 using AudioConvertFuntion =
     AkAudioPacket (*)(const AkAudioPacket &src);
@@ -904,6 +905,10 @@ AkAudioPacket AkAudioConverter::convert(const AkAudioPacket &packet)
     if (packet.size() < 1)
         return {};
 
+    AkTraceScope traceScope("converter",
+                            "AkAudioConverter::convert",
+                            packet.id(),
+                            packet.pts());
     this->d->m_mutex.lock();
 
     if (packet.caps() != this->d->m_previousCaps) {
@@ -19,6 +19,7 @@
 
 #include <QDebug>
 #include <QQmlEngine>
+#include <QSharedPointer>
 #include <QtEndian>
 
 #include "akaudiopacket.h"
@@ -26,10 +27,26 @@
 #include "akfrac.h"
 #include "akpacket.h"
 
+class AkAudioPacketForeignBuffer
+{
+    public:
+        QVector<quint8 *> m_planes;
+        AkAudioPacket::ReleaseCallback m_release {nullptr};
+        void *m_opaque {nullptr};
+
+        AkAudioPacketForeignBuffer(const QVector<quint8 *> &planes,
+                                   AkAudioPacket::ReleaseCallback release,
+                                   void *opaque);
+        ~AkAudioPacketForeignBuffer();
+};
+
+using AkAudioPacketForeignBufferPtr = QSharedPointer<AkAudioPacketForeignBuffer>;
+
 class AkAudioPacketPrivate
 {
     public:
         AkAudioCaps m_caps;
+        AkAudioPacketForeignBufferPtr m_foreignBuffer;
         quint8 *m_data {nullptr};
         size_t m_dataSize {0};
         size_t m_samples {0};
@@ -43,6 +60,9 @@ class AkAudioPacketPrivate
         void clearBuffers();
         void updateParams();
         inline void updatePlanes();
+        void copyData(const AkAudioPacketPrivate *other);
+        void releaseData();
+        inline void detach();
 
         template<typename T>
         inline static T from_(T value) {
@@ -166,6 +186,31 @@ AkAudioPacket::AkAudioPacket(size_t size,
     this->setTimeBase({1, this->d->m_caps.rate()});
 }
 
+AkAudioPacket::AkAudioPacket(const AkAudioCaps &caps,
+                             size_t samples,
+                             quint8 *const *planes,
+                             ReleaseCallback release,
+                             void *opaque):
+    AkPacketBase()
+{
+    this->d = new AkAudioPacketPrivate();
+    this->d->m_caps = caps;
+    this->d->m_samples = samples;
+    this->d->m_nPlanes = this->d->m_caps.planar()?
+                             this->d->m_caps.channels():
+                             1;
+    this->d->updateParams();
+    QVector<quint8 *> foreignPlanes(planes, planes + this->d->m_nPlanes);
+    this->d->m_foreignBuffer =
+            AkAudioPacketForeignBufferPtr::create(foreignPlanes,
+                                                  release,
+                                                  opaque);
+    this->d->m_data = this->d->m_nPlanes > 0? planes[0]: nullptr;
+    this->d->updatePlanes();
+    this->setDuration(this->d->m_samples);
+    this->setTimeBase({1, this->d->m_caps.rate()});
+}
+
 AkAudioPacket::AkAudioPacket(const AkPacket &other):
     AkPacketBase(other)
 {
@@ -175,10 +220,7 @@ AkAudioPacket::AkAudioPacket(const AkPacket &other):
         auto data = reinterpret_cast<AkAudioPacket *>(other.privateData());
         this->d->m_caps = data->d->m_caps;
 
-        if (data->d->m_data && data->d->m_dataSize > 0) {
-            this->d->m_data = new quint8 [data->d->m_dataSize];
-            memcpy(this->d->m_data, data->d->m_data, data->d->m_dataSize);
-        }
+        this->d->copyData(data->d);
 
         this->d->m_dataSize = data->d->m_dataSize;
         this->d->m_samples = data->d->m_samples;
@@ -202,10 +244,7 @@ AkAudioPacket::AkAudioPacket(const AkAudioPacket &other):
     this->d = new AkAudioPacketPrivate();
     this->d->m_caps = other.d->m_caps;
 
-    if (other.d->m_data && other.d->m_dataSize > 0) {
-        this->d->m_data = new quint8 [other.d->m_dataSize];
-        memcpy(this->d->m_data, other.d->m_data, other.d->m_dataSize);
-    }
+    this->d->copyData(other.d);
 
     this->d->m_dataSize = other.d->m_dataSize;
     this->d->m_samples = other.d->m_samples;
@@ -222,9 +261,7 @@ AkAudioPacket::AkAudioPacket(const AkAudioPacket &other):
 
 AkAudioPacket::~AkAudioPacket()
 {
-    if (this->d->m_data)
-        delete [] this->d->m_data;
-
+    this->d->releaseData();
     delete this->d;
 }
 
@@ -234,15 +271,8 @@ AkAudioPacket &AkAudioPacket::operator =(const AkPacket &other)
         auto data = reinterpret_cast<AkAudioPacket *>(other.privateData());
         this->d->m_caps = data->d->m_caps;
 
-        if (this->d->m_data) {
-            delete [] this->d->m_data;
-            this->d->m_data = nullptr;
-        }
-
-        if (data->d->m_data && data->d->m_dataSize > 0) {
-            this->d->m_data = new quint8 [data->d->m_dataSize];
-            memcpy(this->d->m_data, data->d->m_data, data->d->m_dataSize);
-        }
+        this->d->releaseData();
+        this->d->copyData(data->d);
 
         this->d->m_dataSize = data->d->m_dataSize;
         this->d->m_samples = data->d->m_samples;
@@ -260,10 +290,7 @@ AkAudioPacket &AkAudioPacket::operator =(const AkPacket &other)
     } else {
         this->d->m_caps = AkAudioCaps();
 
-        if (this->d->m_data) {
-            delete [] this->d->m_data;
-            this->d->m_data = nullptr;
-        }
+        this->d->releaseData();
 
         this->d->m_dataSize = 0;
         this->d->m_samples = 0;
@@ -283,15 +310,8 @@ AkAudioPacket &AkAudioPacket::operator =(const AkAudioPacket &other)
     if (this != &other) {
         this->d->m_caps = other.d->m_caps;
 
-        if (this->d->m_data) {
-            delete [] this->d->m_data;
-            this->d->m_data = nullptr;
-        }
-
-        if (other.d->m_data && other.d->m_dataSize > 0) {
-            this->d->m_data = new quint8 [other.d->m_dataSize];
-            memcpy(this->d->m_data, other.d->m_data, other.d->m_dataSize);
-        }
+        this->d->releaseData();
+        this->d->copyData(other.d);
 
         this->d->m_dataSize = other.d->m_dataSize;
         this->d->m_samples = other.d->m_samples;
@@ -419,6 +439,8 @@ const char *AkAudioPacket::constData() const
 
 char *AkAudioPacket::data()
 {
+    this->d->detach();
+
     return reinterpret_cast<char *>(this->d->m_data);
 }
 
@@ -429,6 +451,8 @@ const quint8 *AkAudioPacket::constPlane(int plane) const
 
 quint8 *AkAudioPacket::plane(int plane)
 {
+    this->d->detach();
+
     return this->d->m_planes[plane];
 }
 
@@ -446,6 +470,7 @@ const quint8 *AkAudioPacket::constSample(int channel, int i) const
 
 quint8 *AkAudioPacket::sample(int channel, int i)
 {
+    this->d->detach();
     auto bps = this->d->m_caps.bps();
 
     if (this->d->m_caps.planar())
@@ -496,6 +521,16 @@ AkAudioPacket AkAudioPacket::pop(int samples)
     return dst;
 }
 
+bool AkAudioPacket::isForeign() const
+{
+    return !this->d->m_foreignBuffer.isNull();
+}
+
+void AkAudioPacket::detach()
+{
+    this->d->detach();
+}
+
 AkAudioPacket AkAudioPacket::pop()
 {
     return this->pop(this->d->m_samples);
@@ -636,8 +671,77 @@ void AkAudioPacketPrivate::updateParams()
 
 void AkAudioPacketPrivate::updatePlanes()
 {
+    if (this->m_foreignBuffer) {
+        for (int i = 0; i < this->m_nPlanes; ++i)
+            this->m_planes[i] = this->m_foreignBuffer->m_planes.value(i);
+
+        return;
+    }
+
     for (int i = 0; i < this->m_nPlanes; ++i)
         this->m_planes[i] = this->m_data + this->m_planeOffset[i];
 }
 
+void AkAudioPacketPrivate::copyData(const AkAudioPacketPrivate *other)
+{
+    // Foreign buffers are read-only, so all copies can share them.
+    if (other->m_foreignBuffer) {
+        this->m_foreignBuffer = other->m_foreignBuffer;
+        this->m_data = other->m_data;
+
+        return;
+    }
+
+    if (other->m_data && other->m_dataSize > 0) {
+        this->m_data = new quint8 [other->m_dataSize];
+        memcpy(this->m_data, other->m_data, other->m_dataSize);
+    }
+}
+
+void AkAudioPacketPrivate::releaseData()
+{
+    if (this->m_foreignBuffer)
+        this->m_foreignBuffer.clear();
+    else if (this->m_data)
+        delete [] this->m_data;
+
+    this->m_data = nullptr;
+}
+
+void AkAudioPacketPrivate::detach()
+{
+    if (!this->m_foreignBuffer)
+        return;
+
+    auto data = this->m_dataSize > 0?
+                    new quint8 [this->m_dataSize]:
+                    nullptr;
+
+    for (int i = 0; i < this->m_nPlanes; ++i)
+        if (this->m_planeSize[i] > 0)
+            memcpy(data + this->m_planeOffset[i],
+                   this->m_planes[i],
+                   this->m_planeSize[i]);
+
+    // Drop our reference to the foreign buffer.
+    this->m_foreignBuffer.clear();
+    this->m_data = data;
+    this->updatePlanes();
+}
+
+AkAudioPacketForeignBuffer::AkAudioPacketForeignBuffer(const QVector<quint8 *> &planes,
+                                                       AkAudioPacket::ReleaseCallback release,
+                                                       void *opaque):
+    m_planes(planes),
+    m_release(release),
+    m_opaque(opaque)
+{
+}
+
+AkAudioPacketForeignBuffer::~AkAudioPacketForeignBuffer()
+{
+    if (this->m_release)
+        this->m_release(this->m_opaque);
+}
+
 #include "moc_akaudiopacket.cpp"
@@ -46,6 +46,8 @@ class AKCOMMONS_EXPORT AkAudioPacket: public AkPacketBase
                CONSTANT)
 
     public:
+        using ReleaseCallback = void (*)(void *opaque);
+
         AkAudioPacket(QObject *parent=nullptr);
         AkAudioPacket(const AkAudioCaps &caps,
                       size_t samples=0,
@@ -53,6 +55,20 @@ class AKCOMMONS_EXPORT AkAudioPacket: public AkPacketBase
         AkAudioPacket(size_t size,
                       const AkAudioCaps &caps,
                       bool initialized=false);
+
+        /* Wrap an externally owned buffer without copying it. 'release' is
+         * called with 'opaque' once the last packet sharing the buffer is
+         * destroyed or detached.
+         *
+         * The foreign buffer is read-only, the writable accessors (data(),
+         * plane(), sample(), setSample()) or detach() will copy the samples
+         * to memory owned by the packet first.
+         */
+        AkAudioPacket(const AkAudioCaps &caps,
+                      size_t samples,
+                      quint8 *const *planes,
+                      ReleaseCallback release,
+                      void *opaque);
         AkAudioPacket(const AkPacket &other);
         AkAudioPacket(const AkAudioPacket &other);
         ~AkAudioPacket();
@@ -78,6 +94,8 @@ class AKCOMMONS_EXPORT AkAudioPacket: public AkPacketBase
         Q_INVOKABLE AkAudioPacket pop(int samples);
         Q_INVOKABLE AkAudioPacket pop();
         Q_INVOKABLE qreal volume() const;
+        Q_INVOKABLE bool isForeign() const;
+        Q_INVOKABLE void detach();
 
     private:
         AkAudioPacketPrivate *d;
@@ -0,0 +1,465 @@
+/* Webcamoid, camera capture application.
+ * Copyright (C) 2026  Gonzalo Exequiel Pedone
+ *
+ * Webcamoid is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Webcamoid is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Webcamoid. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Web-Site: http://webcamoid.github.io/
+ */
+
+#include <atomic>
+#include <chrono>
+#include <QCoreApplication>
+#include <QDateTime>
+#include <QFile>
+#include <QHash>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QMutex>
+#include <QQmlEngine>
+#include <QTimer>
+#include <QVariantMap>
+
+#include "akelementprofiler.h"
+#include "akpacket.h"
+
+#define DEFAULT_DUMP_INTERVAL 1000
+
+enum AkElementProfilerPacketType
+{
+    PacketTypeAudio,
+    PacketTypeVideo,
+    PacketTypeOther,
+    PacketTypes
+};
+
+class AkElementProfilerCounters
+{
+    public:
+        quint64 m_id {0};
+        std::atomic<const char *> m_className {nullptr};
+        std::atomic<quint64> m_calls[PacketTypes] {};
+        std::atomic<quint64> m_time[PacketTypes] {};
+        std::atomic<quint64> m_bytesIn {0};
+        std::atomic<quint64> m_packetsOut {0};
+        std::atomic<quint64> m_bytesOut {0};
+        std::atomic<quint64> m_allocations {0};
+        std::atomic<quint64> m_allocatedBytes {0};
+        std::atomic<quint64> m_queueWaits {0};
+        std::atomic<quint64> m_queueWaitTime {0};
+
+        void reset();
+        QVariantMap stats() const;
+};
+
+class AkElementProfilerPrivate
+{
+    public:
+        AkElementProfiler *self;
+        QString m_dumpFile;
+        int m_dumpInterval {DEFAULT_DUMP_INTERVAL};
+        QTimer m_dumpTimer;
+
+        explicit AkElementProfilerPrivate(AkElementProfiler *self);
+        void updateDumpTimer();
+};
+
+class AkElementProfilerRegistry
+{
+    public:
+        QMutex m_mutex;
+        QHash<const QObject *, AkElementProfilerCounters *> m_elements;
+        quint64 m_lastId {0};
+};
+
+Q_GLOBAL_STATIC(AkElementProfiler, akElementProfilerGlobal)
+Q_GLOBAL_STATIC(AkElementProfilerRegistry, akElementProfilerRegistry)
+
+static std::atomic<bool> akElementProfilerEnabled {false};
+
+// The innermost iStream call being measured in this thread.
+static thread_local AkElementProfilerScope *akElementProfilerScope {nullptr};
+
+inline qint64 akElementProfilerTime()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+AkElementProfiler::AkElementProfiler(QObject *parent):
+    QObject(parent)
+{
+    this->d = new AkElementProfilerPrivate(this);
+
+    // The dumps are written from the main thread.
+    if (QCoreApplication::instance()) {
+        auto mainThread = QCoreApplication::instance()->thread();
+        this->moveToThread(mainThread);
+        this->d->m_dumpTimer.moveToThread(mainThread);
+    }
+
+    QObject::connect(&this->d->m_dumpTimer,
+                     &QTimer::timeout,
+                     this,
+                     &AkElementProfiler::dump);
+
+    auto dumpFile = qEnvironmentVariable("AK_PROFILER_DUMP");
+
+    if (!dumpFile.isEmpty()) {
+        bool ok = false;
+        auto interval = qEnvironmentVariableIntValue("AK_PROFILER_INTERVAL", &ok);
+
+        if (ok)
+            this->setDumpInterval(interval);
+
+        this->setDumpFile(dumpFile);
+        this->setEnabled(true);
+    }
+}
+
+AkElementProfiler::~AkElementProfiler()
+{
+    akElementProfilerEnabled = false;
+    delete this->d;
+}
+
+AkElementProfiler *AkElementProfiler::instance()
+{
+    return akElementProfilerGlobal;
+}
+
+bool AkElementProfiler::isEnabled()
+{
+    return akElementProfilerEnabled.load(std::memory_order_relaxed);
+}
+
+bool AkElementProfiler::enabled() const
+{
+    return akElementProfilerEnabled;
+}
+
+QString AkElementProfiler::dumpFile() const
+{
+    return this->d->m_dumpFile;
+}
+
+int AkElementProfiler::dumpInterval() const
+{
+    return this->d->m_dumpInterval;
+}
+
+QVariantList AkElementProfiler::stats() const
+{
+    QVector<QVariantMap> elements;
+    auto registry = akElementProfilerRegistry;
+
+    if (registry) {
+        QMutexLocker mutexLocker(&registry->m_mutex);
+
+        for (auto &counters: registry->m_elements)
+            if (counters->m_calls[PacketTypeAudio]
+                || counters->m_calls[PacketTypeVideo]
+                || counters->m_calls[PacketTypeOther]
+                || counters->m_queueWaits) {
+                elements << counters->stats();
+            }
+    }
+
+    std::sort(elements.begin(),
+              elements.end(),
+              [] (const QVariantMap &element1, const QVariantMap &element2) {
+        return element1["time"].toReal() > element2["time"].toReal();
+    });
+
+    QVariantList stats;
+
+    for (auto &element: elements)
+        stats << element;
+
+    return stats;
+}
+
+QByteArray AkElementProfiler::toJson() const
+{
+    QJsonObject snapshot {
+        {"time"    , QDateTime::currentMSecsSinceEpoch()           },
+        {"elements", QJsonArray::fromVariantList(this->stats())},
+    };
+
+    return QJsonDocument(snapshot).toJson(QJsonDocument::Compact);
+}
+
+AkElementProfilerCounters *AkElementProfiler::registerElement(const QObject *element)
+{
+    auto registry = akElementProfilerRegistry;
+
+    if (!registry)
+        return nullptr;
+
+    auto counters = new AkElementProfilerCounters;
+    QMutexLocker mutexLocker(&registry->m_mutex);
+    counters->m_id = ++registry->m_lastId;
+    registry->m_elements[element] = counters;
+
+    return counters;
+}
+
+void AkElementProfiler::unregisterElement(const QObject *element)
+{
+    auto registry = akElementProfilerRegistry;
+
+    if (!registry)
+        return;
+
+    QMutexLocker mutexLocker(&registry->m_mutex);
+    delete registry->m_elements.take(element);
+}
+
+void AkElementProfiler::addQueueWait(AkElementProfilerCounters *counters,
+                                     qint64 nsecs)
+{
+    if (!counters || !isEnabled())
+        return;
+
+    counters->m_queueWaits.fetch_add(1, std::memory_order_relaxed);
+    counters->m_queueWaitTime.fetch_add(quint64(qMax<qint64>(nsecs, 0)),
+                                        std::memory_order_relaxed);
+}
+
+void AkElementProfiler::addAllocation(size_t size)
+{
+    if (!isEnabled())
+        return;
+
+    auto scope = akElementProfilerScope;
+
+    if (!scope || !scope->m_counters)
+        return;
+
+    scope->m_counters->m_allocations.fetch_add(1, std::memory_order_relaxed);
+    scope->m_counters->m_allocatedBytes.fetch_add(size,
+                                                  std::memory_order_relaxed);
+}
+
+void AkElementProfiler::setEnabled(bool enabled)
+{
+    if (akElementProfilerEnabled == enabled)
+        return;
+
+    akElementProfilerEnabled = enabled;
+    this->d->updateDumpTimer();
+    emit this->enabledChanged(enabled);
+}
+
+void AkElementProfiler::setDumpFile(const QString &dumpFile)
+{
+    if (this->d->m_dumpFile == dumpFile)
+        return;
+
+    this->d->m_dumpFile = dumpFile;
+    this->d->updateDumpTimer();
+    emit this->dumpFileChanged(dumpFile);
+}
+
+void AkElementProfiler::setDumpInterval(int dumpInterval)
+{
+    dumpInterval = qMax(dumpInterval, 1);
+
+    if (this->d->m_dumpInterval == dumpInterval)
+        return;
+
+    this->d->m_dumpInterval = dumpInterval;
+    this->d->updateDumpTimer();
+    emit this->dumpIntervalChanged(dumpInterval);
+}
+
+void AkElementProfiler::resetEnabled()
+{
+    this->setEnabled(false);
+}
+
+void AkElementProfiler::resetDumpFile()
+{
+    this->setDumpFile({});
+}
+
+void AkElementProfiler::resetDumpInterval()
+{
+    this->setDumpInterval(DEFAULT_DUMP_INTERVAL);
+}
+
+void AkElementProfiler::reset()
+{
+    auto registry = akElementProfilerRegistry;
+
+    if (!registry)
+        return;
+
+    QMutexLocker mutexLocker(&registry->m_mutex);
+
+    for (auto &counters: registry->m_elements)
+        counters->reset();
+}
+
+bool AkElementProfiler::dump()
+{
+    if (this->d->m_dumpFile.isEmpty())
+        return false;
+
+    QFile file(this->d->m_dumpFile);
+
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Append))
+        return false;
+
+    file.write(this->toJson() + '\n');
+
+    return true;
+}
+
+void AkElementProfiler::registerTypes()
+{
+    qmlRegisterSingletonInstance<AkElementProfiler>("Ak",
+                                                    1,
+                                                    0,
+                                                    "AkElementProfiler",
+                                                    akElementProfilerGlobal);
+}
+
+AkElementProfilerPrivate::AkElementProfilerPrivate(AkElementProfiler *self):
+    self(self)
+{
+}
+
+void AkElementProfilerPrivate::updateDumpTimer()
+{
+    if (akElementProfilerEnabled && !this->m_dumpFile.isEmpty()) {
+        this->m_dumpTimer.setInterval(this->m_dumpInterval);
+
+        if (!this->m_dumpTimer.isActive())
+            this->m_dumpTimer.start();
+    } else {
+        this->m_dumpTimer.stop();
+    }
+}
+
+void AkElementProfilerCounters::reset()
+{
+    for (int i = 0; i < PacketTypes; i++) {
+        this->m_calls[i] = 0;
+        this->m_time[i] = 0;
+    }
+
+    this->m_bytesIn = 0;
+    this->m_packetsOut = 0;
+    this->m_bytesOut = 0;
+    this->m_allocations = 0;
+    this->m_allocatedBytes = 0;
+    this->m_queueWaits = 0;
+    this->m_queueWaitTime = 0;
+}
+
+QVariantMap AkElementProfilerCounters::stats() const
+{
+    quint64 calls = 0;
+    quint64 time = 0;
+
+    for (int i = 0; i < PacketTypes; i++) {
+        calls += this->m_calls[i];
+        time += this->m_time[i];
+    }
+
+    const char *className = this->m_className;
+    quint64 allocations = this->m_allocations;
+
+    return {
+        {"id"                  , this->m_id                                },
+        {"element"             , QString(className? className: "")         },
+        {"calls"               , calls                                     },
+        {"audioCalls"          , quint64(this->m_calls[PacketTypeAudio])   },
+        {"videoCalls"          , quint64(this->m_calls[PacketTypeVideo])   },
+        {"time"                , qreal(time) / 1e6                         },
+        {"audioTime"           , qreal(this->m_time[PacketTypeAudio]) / 1e6},
+        {"videoTime"           , qreal(this->m_time[PacketTypeVideo]) / 1e6},
+        {"bytesIn"             , quint64(this->m_bytesIn)                  },
+        {"packetsOut"          , quint64(this->m_packetsOut)               },
+        {"bytesOut"            , quint64(this->m_bytesOut)                 },
+        {"allocations"         , allocations                               },
+        {"allocationsPerPacket", calls > 0? qreal(allocations) / calls: 0.0},
+        {"allocatedBytes"      , quint64(this->m_allocatedBytes)           },
+        {"queueWaits"          , quint64(this->m_queueWaits)               },
+        {"queueWaitTime"       , qreal(this->m_queueWaitTime) / 1e6        },
+    };
+}
+
+AkElementProfilerScope::AkElementProfilerScope(AkElementProfilerCounters *counters,
+                                               const QObject *element,
+                                               const AkPacket &packet):
+    m_counters(counters),
+    m_parent(akElementProfilerScope),
+    m_startTime(akElementProfilerTime())
+{
+    switch (packet.type()) {
+    case AkPacket::PacketAudio:
+        this->m_packetType = PacketTypeAudio;
+
+        break;
+
+    case AkPacket::PacketVideo:
+        this->m_packetType = PacketTypeVideo;
+
+        break;
+
+    default:
+        this->m_packetType = PacketTypeOther;
+
+        break;
+    }
+
+    auto size = quint64(packet.size());
+
+    if (counters) {
+        if (!counters->m_className.load(std::memory_order_relaxed))
+            counters->m_className = element->metaObject()->className();
+
+        counters->m_calls[this->m_packetType].fetch_add(1, std::memory_order_relaxed);
+        counters->m_bytesIn.fetch_add(size, std::memory_order_relaxed);
+    }
+
+    // A packet received while other element is running in the same thread
+    // was sent downstream by it.
+    if (this->m_parent && this->m_parent->m_counters) {
+        auto parentCounters = this->m_parent->m_counters;
+        parentCounters->m_packetsOut.fetch_add(1, std::memory_order_relaxed);
+        parentCounters->m_bytesOut.fetch_add(size, std::memory_order_relaxed);
+    }
+
+    akElementProfilerScope = this;
+}
+
+AkElementProfilerScope::~AkElementProfilerScope()
+{
+    auto elapsed = akElementProfilerTime() - this->m_startTime;
+
+    if (this->m_counters)
+        this->m_counters->m_time[this->m_packetType]
+                .fetch_add(quint64(qMax<qint64>(elapsed - this->m_childrenTime, 0)),
+                           std::memory_order_relaxed);
+
+    if (this->m_parent)
+        this->m_parent->m_childrenTime += elapsed;
+
+    akElementProfilerScope = this->m_parent;
+}
+
+#include "moc_akelementprofiler.cpp"
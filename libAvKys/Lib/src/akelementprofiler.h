@@ -0,0 +1,136 @@
+/* Webcamoid, camera capture application.
+ * Copyright (C) 2026  Gonzalo Exequiel Pedone
+ *
+ * Webcamoid is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Webcamoid is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Webcamoid. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Web-Site: http://webcamoid.github.io/
+ */
+
+#ifndef AKELEMENTPROFILER_H
+#define AKELEMENTPROFILER_H
+
+#include <QObject>
+#include <QVariantList>
+
+#include "akcommons.h"
+
+#define akElementProfiler AkElementProfiler::instance()
+
+class AkElementProfilerPrivate;
+class AkElementProfilerCounters;
+class AkPacket;
+
+/* Collects where the time of the pipelines goes, per element.
+ *
+ * For every call to AkElement::iStream it counts the packets and bytes
+ * received, the time spent in the element itself (not counting the elements
+ * it sends packets to in the same thread), the packets it passed downstream,
+ * and the frame buffers allocated meanwhile. Elements with internal queues
+ * also report the time spent waiting in them.
+ *
+ * The counters are relaxed atomics owned by each element, and the nesting of
+ * the calls is tracked per thread, so there is no locking in the hot path.
+ * When disabled, the only cost is checking a flag.
+ *
+ * It can be enabled without the UI by setting AK_PROFILER_DUMP to a file,
+ * where a JSON snapshot is appended, one per line, every
+ * AK_PROFILER_INTERVAL milliseconds (1000 by default).
+ */
+class AKCOMMONS_EXPORT AkElementProfiler: public QObject
+{
+    Q_OBJECT
+    Q_PROPERTY(bool enabled
+               READ enabled
+               WRITE setEnabled
+               RESET resetEnabled
+               NOTIFY enabledChanged)
+    Q_PROPERTY(QString dumpFile
+               READ dumpFile
+               WRITE setDumpFile
+               RESET resetDumpFile
+               NOTIFY dumpFileChanged)
+    Q_PROPERTY(int dumpInterval
+               READ dumpInterval
+               WRITE setDumpInterval
+               RESET resetDumpInterval
+               NOTIFY dumpIntervalChanged)
+
+    public:
+        AkElementProfiler(QObject *parent=nullptr);
+        ~AkElementProfiler();
+
+        Q_INVOKABLE static AkElementProfiler *instance();
+        Q_INVOKABLE static bool isEnabled();
+        Q_INVOKABLE bool enabled() const;
+        Q_INVOKABLE QString dumpFile() const;
+        Q_INVOKABLE int dumpInterval() const;
+
+        // One map per element, sorted by the time spent in it, suitable as
+        // a QML model. The times are in milliseconds.
+        Q_INVOKABLE QVariantList stats() const;
+        Q_INVOKABLE QByteArray toJson() const;
+
+        // Used by AkElement.
+        static AkElementProfilerCounters *registerElement(const QObject *element);
+        static void unregisterElement(const QObject *element);
+
+        // Called by the elements, with their AkElement::profilerCounters(),
+        // for the time a packet or a sender waited in their queues.
+        static void addQueueWait(AkElementProfilerCounters *counters,
+                                 qint64 nsecs);
+
+        // Called by the allocators of the frame buffers.
+        static void addAllocation(size_t size);
+
+    private:
+        AkElementProfilerPrivate *d;
+
+    Q_SIGNALS:
+        void enabledChanged(bool enabled);
+        void dumpFileChanged(const QString &dumpFile);
+        void dumpIntervalChanged(int dumpInterval);
+
+    public Q_SLOTS:
+        void setEnabled(bool enabled);
+        void setDumpFile(const QString &dumpFile);
+        void setDumpInterval(int dumpInterval);
+        void resetEnabled();
+        void resetDumpFile();
+        void resetDumpInterval();
+        void reset();
+        bool dump();
+        static void registerTypes();
+};
+
+// Measures a call to AkElement::iStream, only created when the profiler is
+// enabled.
+class AKCOMMONS_EXPORT AkElementProfilerScope
+{
+    public:
+        AkElementProfilerScope(AkElementProfilerCounters *counters,
+                               const QObject *element,
+                               const AkPacket &packet);
+        ~AkElementProfilerScope();
+
+    private:
+        AkElementProfilerCounters *m_counters;
+        AkElementProfilerScope *m_parent;
+        qint64 m_startTime;
+        qint64 m_childrenTime {0};
+        int m_packetType;
+
+    friend class AkElementProfiler;
+};
+
+#endif // AKELEMENTPROFILER_H
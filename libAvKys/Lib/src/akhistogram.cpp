@@ -0,0 +1,417 @@
+/* Webcamoid, camera capture application.
+ * Copyright (C) 2026  Gonzalo Exequiel Pedone
+ *
+ * Webcamoid is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Webcamoid is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Webcamoid. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Web-Site: http://webcamoid.github.io/
+ */
+
+#include <QSemaphore>
+#include <QThreadPool>
+#include <QtEndian>
+#include <QtMath>
+
+#include "akhistogram.h"
+#include "akvideocaps.h"
+#include "akvideoformatspec.h"
+#include "akvideopacket.h"
+
+// Number of interleaved sub-histograms for the 256 bins histograms.
+#define SUB_HISTOGRAMS 4
+
+// Minimum number of sampled lines per band.
+#define MIN_BAND_LINES 32
+
+/* The bands run in their own pool, the histograms are usually computed from
+ * threads of the global pool, and waiting there for jobs queued in the same
+ * pool can deadlock when all of its threads are busy waiting.
+ */
+Q_GLOBAL_STATIC(QThreadPool, akHistogramThreadPool)
+
+class AkHistogramPrivate
+{
+    public:
+        qint64 m_maxSamples {0};
+        qreal m_smoothing {0.0};
+        qreal m_total {0.0};
+        QVector<qreal> m_histogram;
+
+        int stride(int width, int height) const;
+
+        // Calls countLine(y, stride, histograms) for the sampled lines, in
+        // parallel bands, and updates the histogram with the sum of all the
+        // bands and sub-histograms.
+        template <typename CountLineFunc>
+        void count(int width,
+                   int height,
+                   int bins,
+                   int subHistograms,
+                   CountLineFunc countLine)
+        {
+            if (width < 1 || height < 1) {
+                this->update(QVector<quint64>(bins, 0), 0, 0);
+
+                return;
+            }
+
+            auto stride = this->stride(width, height);
+            int lines = (height + stride - 1) / stride;
+            auto threadPool = akHistogramThreadPool();
+            int threads = qMax(1, threadPool->maxThreadCount());
+            int bands = qBound(1, lines / MIN_BAND_LINES, threads);
+            QVector<QVector<quint32>> bandCounts(bands);
+            QSemaphore done;
+
+            auto countBand = [&bandCounts,
+                              &countLine,
+                              bins,
+                              subHistograms,
+                              stride,
+                              lines,
+                              bands] (int band) {
+                auto &counts = bandCounts[band];
+                counts.fill(0, bins * subHistograms);
+                auto histograms = counts.data();
+                int lineStart = band * lines / bands;
+                int lineEnd = (band + 1) * lines / bands;
+
+                for (int line = lineStart; line < lineEnd; line++)
+                    countLine(line * stride, stride, histograms);
+            };
+
+            for (int band = 1; band < bands; band++)
+                threadPool->start([&countBand, &done, band] () {
+                    countBand(band);
+                    done.release();
+                });
+
+            countBand(0);
+            done.acquire(bands - 1);
+
+            QVector<quint64> counts(bins, 0);
+
+            for (auto &bandCount: bandCounts)
+                for (int i = 0; i < bins * subHistograms; i++)
+                    counts[i % bins] += bandCount[i];
+
+            quint64 samples = quint64(lines) * quint64((width + stride - 1) / stride);
+            this->update(counts, samples, quint64(width) * quint64(height));
+        }
+
+        void update(const QVector<quint64> &counts,
+                    quint64 samples,
+                    quint64 pixels);
+};
+
+AkHistogram::AkHistogram()
+{
+    this->d = new AkHistogramPrivate();
+}
+
+AkHistogram::AkHistogram(const AkHistogram &other)
+{
+    this->d = new AkHistogramPrivate();
+    *this->d = *other.d;
+}
+
+AkHistogram::~AkHistogram()
+{
+    delete this->d;
+}
+
+AkHistogram &AkHistogram::operator =(const AkHistogram &other)
+{
+    if (this != &other)
+        *this->d = *other.d;
+
+    return *this;
+}
+
+qint64 AkHistogram::maxSamples() const
+{
+    return this->d->m_maxSamples;
+}
+
+qreal AkHistogram::smoothing() const
+{
+    return this->d->m_smoothing;
+}
+
+int AkHistogram::bins() const
+{
+    return this->d->m_histogram.size();
+}
+
+const qreal *AkHistogram::data() const
+{
+    return this->d->m_histogram.constData();
+}
+
+qreal AkHistogram::total() const
+{
+    return this->d->m_total;
+}
+
+QVector<qreal> AkHistogram::cumulative() const
+{
+    QVector<qreal> cumulative(this->d->m_histogram.size());
+    qreal sum = 0;
+
+    for (int i = 0; i < this->d->m_histogram.size(); i++) {
+        sum += this->d->m_histogram[i];
+        cumulative[i] = sum;
+    }
+
+    return cumulative;
+}
+
+int AkHistogram::minimum() const
+{
+    for (int i = 0; i < this->d->m_histogram.size(); i++)
+        if (this->d->m_histogram[i] > 0.0)
+            return i;
+
+    return -1;
+}
+
+int AkHistogram::maximum() const
+{
+    for (int i = this->d->m_histogram.size() - 1; i >= 0; i--)
+        if (this->d->m_histogram[i] > 0.0)
+            return i;
+
+    return -1;
+}
+
+bool AkHistogram::compute(const AkVideoPacket &packet,
+                          AkColorComponent::ComponentType component)
+{
+    if (!packet)
+        return false;
+
+    auto specs = AkVideoCaps::formatSpecs(packet.caps().format());
+
+    if (!specs.contains(component))
+        return false;
+
+    auto comp = specs.component(component);
+    auto plane = specs.componentPlane(component);
+    auto planeData = packet.constPlane(plane);
+    auto lineSize = packet.lineSize(plane);
+    int width = packet.caps().width() >> comp.widthDiv();
+    int height = packet.caps().height() >> comp.heightDiv();
+    auto step = comp.step();
+    auto offset = comp.offset();
+
+    if (comp.byteDepth() == 1 && comp.depth() == 8 && comp.shift() == 0) {
+        this->d->count(width,
+                       height,
+                       256,
+                       SUB_HISTOGRAMS,
+                       [planeData, lineSize, width, step, offset] (int y,
+                                                                   int stride,
+                                                                   quint32 *histograms) {
+            auto h0 = histograms;
+            auto h1 = h0 + 256;
+            auto h2 = h1 + 256;
+            auto h3 = h2 + 256;
+            auto pixel = planeData + size_t(y) * lineSize + offset;
+            auto pixelStep = size_t(stride) * step;
+            int samples = (width + stride - 1) / stride;
+            int i = 0;
+
+            for (; i + 4 <= samples; i += 4) {
+                h0[pixel[0]]++;
+                h1[pixel[pixelStep]]++;
+                h2[pixel[2 * pixelStep]]++;
+                h3[pixel[3 * pixelStep]]++;
+                pixel += 4 * pixelStep;
+            }
+
+            for (; i < samples; i++) {
+                h0[*pixel]++;
+                pixel += pixelStep;
+            }
+        });
+
+        return true;
+    }
+
+    if (comp.byteDepth() != 1
+        && comp.byteDepth() != 2
+        && comp.byteDepth() != 4)
+        return false;
+
+    // Generic components, read them word by word and keep the 8 most
+    // significant bits.
+    int byteDepth = comp.byteDepth();
+    int shift = comp.shift();
+    int depth = comp.depth();
+    auto max = comp.max<quint32>();
+    bool swap = specs.endianness() != Q_BYTE_ORDER;
+
+    this->d->count(width,
+                   height,
+                   256,
+                   1,
+                   [=] (int y, int stride, quint32 *histogram) {
+        auto line = planeData + size_t(y) * lineSize + offset;
+
+        for (int x = 0; x < width; x += stride) {
+            auto pixel = line + size_t(x) * step;
+            quint32 value = 0;
+
+            switch (byteDepth) {
+            case 1:
+                value = *pixel;
+                break;
+            case 2:
+                value = *reinterpret_cast<const quint16 *>(pixel);
+                value = swap? qbswap(quint16(value)): value;
+                break;
+            default:
+                value = *reinterpret_cast<const quint32 *>(pixel);
+                value = swap? qbswap(value): value;
+                break;
+            }
+
+            value = (value >> shift) & max;
+            value = depth > 8? value >> (depth - 8): value << (8 - depth);
+            histogram[value & 0xff]++;
+        }
+    });
+
+    return true;
+}
+
+bool AkHistogram::computeRgb565(const AkVideoPacket &packet)
+{
+    if (!packet)
+        return false;
+
+    auto specs = AkVideoCaps::formatSpecs(packet.caps().format());
+
+    if (specs.type() != AkVideoFormatSpec::VFT_RGB)
+        return false;
+
+    auto compR = specs.component(AkColorComponent::CT_R);
+    auto compG = specs.component(AkColorComponent::CT_G);
+    auto compB = specs.component(AkColorComponent::CT_B);
+
+    for (auto &comp: {compR, compG, compB})
+        if (comp.byteDepth() != 1
+            || comp.depth() != 8
+            || comp.shift() != 0
+            || comp.widthDiv() != 0
+            || comp.heightDiv() != 0)
+            return false;
+
+    auto planeR = specs.componentPlane(AkColorComponent::CT_R);
+    auto planeG = specs.componentPlane(AkColorComponent::CT_G);
+    auto planeB = specs.componentPlane(AkColorComponent::CT_B);
+    int width = packet.caps().width();
+
+    // The 64K bins don't fit in the L1 cache, so there are no
+    // sub-histograms here, they would only add cache misses.
+    this->d->count(width,
+                   packet.caps().height(),
+                   1 << 16,
+                   1,
+                   [&] (int y, int stride, quint32 *histogram) {
+        auto lineR = packet.constLine(planeR, y) + compR.offset();
+        auto lineG = packet.constLine(planeG, y) + compG.offset();
+        auto lineB = packet.constLine(planeB, y) + compB.offset();
+        auto stepR = size_t(stride) * compR.step();
+        auto stepG = size_t(stride) * compG.step();
+        auto stepB = size_t(stride) * compB.step();
+
+        for (int x = 0; x < width; x += stride) {
+            auto color = ((*lineR >> 3) << 11)
+                       | ((*lineG >> 2) << 5)
+                       | (*lineB >> 3);
+            histogram[color]++;
+            lineR += stepR;
+            lineG += stepG;
+            lineB += stepB;
+        }
+    });
+
+    return true;
+}
+
+void AkHistogram::setMaxSamples(qint64 maxSamples)
+{
+    this->d->m_maxSamples = qMax<qint64>(maxSamples, 0);
+}
+
+void AkHistogram::setSmoothing(qreal smoothing)
+{
+    this->d->m_smoothing = qBound(0.0, smoothing, 0.99);
+}
+
+void AkHistogram::resetMaxSamples()
+{
+    this->setMaxSamples(0);
+}
+
+void AkHistogram::resetSmoothing()
+{
+    this->setSmoothing(0.0);
+}
+
+void AkHistogram::reset()
+{
+    this->d->m_histogram.clear();
+    this->d->m_total = 0.0;
+}
+
+int AkHistogramPrivate::stride(int width, int height) const
+{
+    auto pixels = qint64(width) * qint64(height);
+
+    if (this->m_maxSamples < 1 || pixels <= this->m_maxSamples)
+        return 1;
+
+    // Sample one of every stride x stride pixels.
+    return qMax(1, qCeil(qSqrt(qreal(pixels) / this->m_maxSamples)));
+}
+
+void AkHistogramPrivate::update(const QVector<quint64> &counts,
+                                quint64 samples,
+                                quint64 pixels)
+{
+    // Scale the sampled counts to the whole frame.
+    qreal scale = samples > 0? qreal(pixels) / qreal(samples): 0.0;
+    bool smooth = this->m_smoothing > 0.0
+                  && this->m_histogram.size() == counts.size();
+
+    if (!smooth) {
+        this->m_histogram.resize(counts.size());
+
+        for (int i = 0; i < counts.size(); i++)
+            this->m_histogram[i] = scale * counts[i];
+
+        this->m_total = pixels;
+
+        return;
+    }
+
+    auto k = this->m_smoothing;
+
+    for (int i = 0; i < counts.size(); i++)
+        this->m_histogram[i] = k * this->m_histogram[i]
+                             + (1.0 - k) * scale * counts[i];
+
+    this->m_total = k * this->m_total + (1.0 - k) * pixels;
+}
@@ -0,0 +1,86 @@
+/* Webcamoid, camera capture application.
+ * Copyright (C) 2026  Gonzalo Exequiel Pedone
+ *
+ * Webcamoid is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Webcamoid is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Webcamoid. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Web-Site: http://webcamoid.github.io/
+ */
+
+#ifndef AKHISTOGRAM_H
+#define AKHISTOGRAM_H
+
+#include <QVector>
+
+#include "akcolorcomponent.h"
+
+class AkHistogramPrivate;
+class AkVideoPacket;
+
+/* Frame histogram, shared by the effects that need image statistics.
+ *
+ * The frame is split in bands of lines counted in parallel, each band
+ * counts into several interleaved sub-histograms, so consecutive pixels
+ * with the same value don't serialize on the same counter.
+ *
+ * The histogram can be estimated from a subsample of the frame, and
+ * smoothed over time. In both cases the values are scaled to the number of
+ * pixels of the frame, so they can be used as if they were exact counts.
+ * By default all pixels are counted and there is no smoothing.
+ */
+class AKCOMMONS_EXPORT AkHistogram
+{
+    public:
+        AkHistogram();
+        AkHistogram(const AkHistogram &other);
+        ~AkHistogram();
+        AkHistogram &operator =(const AkHistogram &other);
+
+        // Maximum number of pixels counted per frame, 0 means all pixels.
+        qint64 maxSamples() const;
+
+        // Weight of the previous histogram, in the range [0, 1). 0 means no
+        // smoothing.
+        qreal smoothing() const;
+
+        int bins() const;
+        const qreal *data() const;
+        qreal total() const;
+        QVector<qreal> cumulative() const;
+
+        // First and last non empty bins, or -1 if the histogram is empty.
+        int minimum() const;
+        int maximum() const;
+
+        // Histogram of a color component, in 256 bins. Components deeper
+        // than 8 bits are reduced to their 8 most significant bits.
+        bool compute(const AkVideoPacket &packet,
+                     AkColorComponent::ComponentType component);
+
+        // Histogram of the RGB colors reduced to 16 bits (5-6-5), in 65536
+        // bins. The RGB components must be 8 bits.
+        bool computeRgb565(const AkVideoPacket &packet);
+
+        void setMaxSamples(qint64 maxSamples);
+        void setSmoothing(qreal smoothing);
+        void resetMaxSamples();
+        void resetSmoothing();
+
+        // Drops the histogram, the next frame won't be smoothed.
+        void reset();
+
+    private:
+        AkHistogramPrivate *d;
+};
+
+#endif // AKHISTOGRAM_H
@@ -0,0 +1,119 @@
+/* Webcamoid, camera capture application.
+ * Copyright (C) 2026  Gonzalo Exequiel Pedone
+ *
+ * Webcamoid is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Webcamoid is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Webcamoid. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Web-Site: http://webcamoid.github.io/
+ */
+
+#include <QVector>
+
+#include "aknoisetexture.h"
+#include "akrandom.h"
+
+class AkNoiseTexturePrivate
+{
+    public:
+        int m_width {0};
+        int m_height {0};
+        int m_lowest {0};
+        int m_highest {0};
+        size_t m_size {0};
+        size_t m_offset {0};
+
+        // The first line is repeated at the end, so a line starting at any
+        // offset can be read without wrapping.
+        QVector<quint8> m_data;
+};
+
+AkNoiseTexture::AkNoiseTexture()
+{
+    this->d = new AkNoiseTexturePrivate();
+}
+
+AkNoiseTexture::AkNoiseTexture(const AkNoiseTexture &other)
+{
+    this->d = new AkNoiseTexturePrivate();
+    *this->d = *other.d;
+}
+
+AkNoiseTexture::~AkNoiseTexture()
+{
+    delete this->d;
+}
+
+AkNoiseTexture &AkNoiseTexture::operator =(const AkNoiseTexture &other)
+{
+    if (this != &other)
+        *this->d = *other.d;
+
+    return *this;
+}
+
+int AkNoiseTexture::width() const
+{
+    return this->d->m_width;
+}
+
+int AkNoiseTexture::height() const
+{
+    return this->d->m_height;
+}
+
+void AkNoiseTexture::configure(int width, int height, int lowest, int highest)
+{
+    width = qMax(width, 0);
+    height = qMax(height, 0);
+
+    if (this->d->m_width == width
+        && this->d->m_height == height
+        && this->d->m_lowest == lowest
+        && this->d->m_highest == highest)
+        return;
+
+    this->d->m_width = width;
+    this->d->m_height = height;
+    this->d->m_lowest = lowest;
+    this->d->m_highest = highest;
+    this->d->m_size = size_t(width) * size_t(height);
+    this->d->m_offset = 0;
+    this->d->m_data.resize(int(this->d->m_size + size_t(width)));
+
+    if (this->d->m_size < 1)
+        return;
+
+    auto data = this->d->m_data.data();
+    AkRandom::local().fillBounded(data, this->d->m_size, lowest, highest);
+    memcpy(data + this->d->m_size, data, size_t(width));
+}
+
+void AkNoiseTexture::next()
+{
+    if (this->d->m_size < 1)
+        return;
+
+    auto offset = AkRandom::local().generate64();
+    this->d->m_offset = size_t(offset % this->d->m_size);
+}
+
+const quint8 *AkNoiseTexture::line(int y) const
+{
+    if (this->d->m_size < 1)
+        return nullptr;
+
+    auto offset = (this->d->m_offset + size_t(y) * size_t(this->d->m_width))
+                % this->d->m_size;
+
+    return this->d->m_data.constData() + offset;
+}
@@ -0,0 +1,58 @@
+/* Webcamoid, camera capture application.
+ * Copyright (C) 2026  Gonzalo Exequiel Pedone
+ *
+ * Webcamoid is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Webcamoid is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Webcamoid. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Web-Site: http://webcamoid.github.io/
+ */
+
+#ifndef AKNOISETEXTURE_H
+#define AKNOISETEXTURE_H
+
+#include "akcommons.h"
+
+class AkNoiseTexturePrivate;
+
+/* Cached field of uniform 8 bits noise.
+ *
+ * The noise is generated once for a given size and range, and animated by
+ * reading it from a different random offset on every frame, so per pixel
+ * noise costs a memory read instead of a random number.
+ */
+class AKCOMMONS_EXPORT AkNoiseTexture
+{
+    public:
+        AkNoiseTexture();
+        AkNoiseTexture(const AkNoiseTexture &other);
+        ~AkNoiseTexture();
+        AkNoiseTexture &operator =(const AkNoiseTexture &other);
+
+        int width() const;
+        int height() const;
+
+        // Regenerates the noise only if the size or the [lowest, highest)
+        // range changed.
+        void configure(int width, int height, int lowest, int highest);
+
+        // Moves the reading offset, call it once per frame.
+        void next();
+
+        // Returns width() noise values for the line y of the current frame.
+        const quint8 *line(int y) const;
+
+    private:
+        AkNoiseTexturePrivate *d;
+};
+
+#endif // AKNOISETEXTURE_H
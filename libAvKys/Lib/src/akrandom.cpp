@@ -0,0 +1,255 @@
+/* Webcamoid, camera capture application.
+ * Copyright (C) 2026  Gonzalo Exequiel Pedone
+ *
+ * Webcamoid is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Webcamoid is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Webcamoid. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Web-Site: http://webcamoid.github.io/
+ */
+
+#include <QRandomGenerator>
+#include <QtMath>
+
+#include "akrandom.h"
+
+#define AKRANDOM_LANES 64
+
+// Several independent xoshiro128++ generators stored as structure of
+// arrays. There are enough lanes for the compiler to keep the update as a
+// loop and vectorize it, instead of unrolling it into scalar code.
+class AkRandomLanes
+{
+    public:
+        quint32 m_s0[AKRANDOM_LANES];
+        quint32 m_s1[AKRANDOM_LANES];
+        quint32 m_s2[AKRANDOM_LANES];
+        quint32 m_s3[AKRANDOM_LANES];
+        quint32 m_output[AKRANDOM_LANES];
+        int m_outputIndex {AKRANDOM_LANES};
+
+        explicit AkRandomLanes(AkRandom *random);
+        void next();
+
+        // Fills the buffer with the outputs transformed by map(). The
+        // outputs left from the previous call are used first.
+        template <typename T, typename MapFunc>
+        inline void fill(T *buffer, size_t size, MapFunc map)
+        {
+            size_t i = 0;
+
+            for (; i < size && this->m_outputIndex < AKRANDOM_LANES; i++)
+                buffer[i] = map(this->m_output[this->m_outputIndex++]);
+
+            for (; i < size; i += AKRANDOM_LANES) {
+                this->next();
+                auto n = qMin<size_t>(AKRANDOM_LANES, size - i);
+                auto line = buffer + i;
+                auto output = this->m_output;
+
+                for (size_t j = 0; j < n; j++)
+                    line[j] = map(output[j]);
+
+                this->m_outputIndex = int(n);
+            }
+        }
+};
+
+AkRandom::AkRandom()
+{
+    this->seed(QRandomGenerator::global()->generate64());
+}
+
+AkRandom::AkRandom(quint64 seed)
+{
+    this->seed(seed);
+}
+
+AkRandom::AkRandom(const AkRandom &other)
+{
+    memcpy(this->m_state, other.m_state, sizeof(this->m_state));
+
+    if (other.m_lanes)
+        this->m_lanes = new AkRandomLanes(*other.m_lanes);
+}
+
+AkRandom::~AkRandom()
+{
+    if (this->m_lanes)
+        delete this->m_lanes;
+}
+
+AkRandom &AkRandom::operator =(const AkRandom &other)
+{
+    if (this != &other) {
+        memcpy(this->m_state, other.m_state, sizeof(this->m_state));
+
+        if (this->m_lanes) {
+            delete this->m_lanes;
+            this->m_lanes = nullptr;
+        }
+
+        if (other.m_lanes)
+            this->m_lanes = new AkRandomLanes(*other.m_lanes);
+    }
+
+    return *this;
+}
+
+void AkRandom::seed(quint64 seed)
+{
+    // The lanes will be seeded again from the new state.
+    if (this->m_lanes) {
+        delete this->m_lanes;
+        this->m_lanes = nullptr;
+    }
+
+    // Expand the seed with splitmix64, it never gives an all zeros state.
+    for (int i = 0; i < 4; i += 2) {
+        seed += 0x9e3779b97f4a7c15;
+        auto z = seed;
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111eb;
+        z ^= z >> 31;
+        this->m_state[i] = quint32(z);
+        this->m_state[i + 1] = quint32(z >> 32);
+    }
+}
+
+void AkRandom::fillBounded(quint8 *buffer,
+                           size_t size,
+                           int lowest,
+                           int highest)
+{
+    if (!buffer || size < 1)
+        return;
+
+    lowest = qBound(0, lowest, 255);
+    highest = qBound(0, highest, 256);
+
+    if (highest <= lowest) {
+        memset(buffer, lowest, size);
+
+        return;
+    }
+
+    // The range fits in 9 bits, so 16 bits of randomness are enough and
+    // the product stays in 32 bits.
+    quint32 range = quint32(highest - lowest);
+    this->lanes()->fill(buffer, size, [lowest, range] (quint32 value) {
+        return quint8(lowest + int(((value >> 16) * range) >> 16));
+    });
+}
+
+void AkRandom::fillBounded(int *buffer, size_t size, int lowest, int highest)
+{
+    if (!buffer || size < 1)
+        return;
+
+    if (highest <= lowest) {
+        for (size_t i = 0; i < size; i++)
+            buffer[i] = lowest;
+
+        return;
+    }
+
+    auto range = quint64(quint32(highest - lowest));
+    this->lanes()->fill(buffer, size, [lowest, range] (quint32 value) {
+        return lowest + int((value * range) >> 32);
+    });
+}
+
+void AkRandom::fillUniform(float *buffer,
+                           size_t size,
+                           float lowest,
+                           float highest)
+{
+    if (!buffer || size < 1)
+        return;
+
+    // 24 bits of randomness fill the float mantissa.
+    auto scale = (highest - lowest) / float(1 << 24);
+    this->lanes()->fill(buffer, size, [lowest, scale] (quint32 value) {
+        return lowest + float(value >> 8) * scale;
+    });
+}
+
+void AkRandom::fillGaussian(float *buffer,
+                            size_t size,
+                            float mean,
+                            float stddev)
+{
+    if (!buffer || size < 1)
+        return;
+
+    // The sum of 4 uniform values in [0, 1) has a mean of 2 and a variance
+    // of 1/3. Each byte of a 32 bits output is one of those values, taken at
+    // the middle of its interval.
+    auto scale = stddev * float(qSqrt(3.0)) / 256.0f;
+    auto offset = mean + (2.0f - 2.0f * 256.0f) * scale;
+    this->lanes()->fill(buffer, size, [offset, scale] (quint32 value) {
+        auto sum = (value & 0xff)
+                 + ((value >> 8) & 0xff)
+                 + ((value >> 16) & 0xff)
+                 + (value >> 24);
+
+        return offset + float(sum) * scale;
+    });
+}
+
+AkRandom &AkRandom::local()
+{
+    thread_local AkRandom random;
+
+    return random;
+}
+
+AkRandomLanes *AkRandom::lanes()
+{
+    if (!this->m_lanes)
+        this->m_lanes = new AkRandomLanes(this);
+
+    return this->m_lanes;
+}
+
+AkRandomLanes::AkRandomLanes(AkRandom *random)
+{
+    for (int i = 0; i < AKRANDOM_LANES; i++) {
+        this->m_s0[i] = random->generate();
+        this->m_s1[i] = random->generate();
+        this->m_s2[i] = random->generate();
+        this->m_s3[i] = random->generate();
+
+        if (!this->m_s0[i]
+            && !this->m_s1[i]
+            && !this->m_s2[i]
+            && !this->m_s3[i]) {
+            this->m_s0[i] = 1;
+        }
+    }
+}
+
+void AkRandomLanes::next()
+{
+    for (int i = 0; i < AKRANDOM_LANES; i++) {
+        auto sum = this->m_s0[i] + this->m_s3[i];
+        this->m_output[i] = ((sum << 7) | (sum >> 25)) + this->m_s0[i];
+        auto t = this->m_s1[i] << 9;
+
+        this->m_s2[i] ^= this->m_s0[i];
+        this->m_s3[i] ^= this->m_s1[i];
+        this->m_s1[i] ^= this->m_s2[i];
+        this->m_s0[i] ^= this->m_s3[i];
+        this->m_s2[i] ^= t;
+        this->m_s3[i] = (this->m_s3[i] << 11) | (this->m_s3[i] >> 21);
+    }
+}
@@ -0,0 +1,142 @@
+/* Webcamoid, camera capture application.
+ * Copyright (C) 2026  Gonzalo Exequiel Pedone
+ *
+ * Webcamoid is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Webcamoid is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Webcamoid. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Web-Site: http://webcamoid.github.io/
+ */
+
+#ifndef AKRANDOM_H
+#define AKRANDOM_H
+
+#include "akcommons.h"
+
+class AkRandomLanes;
+
+/* Fast, non cryptographic, pseudo random number generator (xoshiro128++).
+ *
+ * Meant for the video and audio effects hot paths, where the global
+ * QRandomGenerator is too slow and is shared between all threads. Each
+ * thread should use its own instance, AkRandom::local() returns one.
+ */
+class AKCOMMONS_EXPORT AkRandom
+{
+    public:
+        AkRandom();
+        explicit AkRandom(quint64 seed);
+        AkRandom(const AkRandom &other);
+        ~AkRandom();
+        AkRandom &operator =(const AkRandom &other);
+
+        void seed(quint64 seed);
+
+        inline quint32 generate()
+        {
+            auto result = rotl(this->m_state[0] + this->m_state[3], 7)
+                        + this->m_state[0];
+            auto t = this->m_state[1] << 9;
+
+            this->m_state[2] ^= this->m_state[0];
+            this->m_state[3] ^= this->m_state[1];
+            this->m_state[1] ^= this->m_state[2];
+            this->m_state[0] ^= this->m_state[3];
+            this->m_state[2] ^= t;
+            this->m_state[3] = rotl(this->m_state[3], 11);
+
+            return result;
+        }
+
+        inline quint64 generate64()
+        {
+            auto hi = quint64(this->generate());
+
+            return (hi << 32) | this->generate();
+        }
+
+        // Returns a value in [0, 1).
+        inline double generateDouble()
+        {
+            return double(this->generate64() >> 11) * 0x1.0p-53;
+        }
+
+        // Returns a value in [0, highest). The result has a negligible bias
+        // for ranges much smaller than 2^32, which is fine for effects.
+        inline quint32 bounded(quint32 highest)
+        {
+            return quint32((quint64(this->generate()) * highest) >> 32);
+        }
+
+        inline int bounded(int highest)
+        {
+            return highest > 0? int(this->bounded(quint32(highest))): 0;
+        }
+
+        inline qint64 bounded(qint64 highest)
+        {
+            return highest > 0? qint64(this->generate64() % quint64(highest)): 0;
+        }
+
+        // Returns a value in [lowest, highest).
+        inline int bounded(int lowest, int highest)
+        {
+            if (highest <= lowest)
+                return lowest;
+
+            return lowest + int(this->bounded(quint32(highest - lowest)));
+        }
+
+        inline double bounded(double highest)
+        {
+            return this->generateDouble() * highest;
+        }
+
+        inline double bounded(double lowest, double highest)
+        {
+            return lowest + this->generateDouble() * (highest - lowest);
+        }
+
+        // Bulk generation, using several generator lanes in parallel so the
+        // loops can be vectorized. The lanes are seeded from this generator
+        // on the first call and keep their state between calls. Ranges are
+        // [lowest, highest).
+        void fillBounded(quint8 *buffer, size_t size, int lowest, int highest);
+        void fillBounded(int *buffer, size_t size, int lowest, int highest);
+        void fillUniform(float *buffer,
+                         size_t size,
+                         float lowest=0.0f,
+                         float highest=1.0f);
+
+        // Approximately normal distribution, from the sum of 4 uniform
+        // values. Samples are limited to +-3.46 stddev.
+        void fillGaussian(float *buffer,
+                          size_t size,
+                          float mean=0.0f,
+                          float stddev=1.0f);
+
+        // Generator owned by the current thread, randomly seeded.
+        static AkRandom &local();
+
+    private:
+        quint32 m_state[4];
+        AkRandomLanes *m_lanes {nullptr};
+
+        AkRandomLanes *lanes();
+
+        inline static quint32 rotl(quint32 x, int k)
+        {
+            return (x << k) | (x >> (32 - k));
+        }
+};
+
+#endif // AKRANDOM_H
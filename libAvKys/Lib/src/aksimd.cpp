@@ -37,6 +37,7 @@
 #endif
 
 #include "aksimd.h"
+#include "akelementprofiler.h"
 #include "akpluginmanager.h"
 #include "iak/aksimdoptimizations.h"
 
@@ -409,6 +410,8 @@ void AkSimd::afree(void *ptr)
 
 void *AkSimd::amalloc(size_t size, int align)
 {
+    AkElementProfiler::addAllocation(size);
+
 #ifdef Q_OS_WIN32
     return _aligned_malloc(size, align);
 #else
@@ -0,0 +1,360 @@
+/* Webcamoid, camera capture application.
+ * Copyright (C) 2026  Gonzalo Exequiel Pedone
+ *
+ * Webcamoid is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Webcamoid is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Webcamoid. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Web-Site: http://webcamoid.github.io/
+ */
+
+#include <atomic>
+#include <chrono>
+#include <QCoreApplication>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QMutex>
+#include <QQmlEngine>
+#include <QSharedPointer>
+#include <QThread>
+#include <QVector>
+
+#include "aktracer.h"
+
+#define DEFAULT_BUFFER_SIZE 16384
+#define MIN_BUFFER_SIZE     64
+
+struct AkTracerEvent
+{
+    const char *category;
+    const char *name;
+    qint64 id;
+    qint64 pts;
+    qint64 startTime;
+    qint64 endTime;
+};
+
+// The ring buffer of a thread. Only the thread that owns it writes to it,
+// 'm_written' tells the readers how many events were published.
+class AkTracerThreadBuffer
+{
+    public:
+        quint64 m_tid {0};
+        QString m_threadName;
+        QVector<AkTracerEvent> m_events;
+        std::atomic<quint64> m_written {0};
+        std::atomic<quint64> m_cleared {0};
+};
+
+using AkTracerThreadBufferPtr = QSharedPointer<AkTracerThreadBuffer>;
+
+class AkTracerPrivate
+{
+    public:
+        AkTracer *self;
+        QString m_traceFile;
+
+        explicit AkTracerPrivate(AkTracer *self);
+        static AkTracerThreadBuffer *createBuffer();
+};
+
+// The buffers are never released while the program runs, the threads keep a
+// pointer to them and the events of the threads that already finished must
+// also be saved.
+class AkTracerRegistry
+{
+    public:
+        QMutex m_mutex;
+        QVector<AkTracerThreadBufferPtr> m_buffers;
+        quint64 m_lastTid {0};
+        int m_bufferSize {DEFAULT_BUFFER_SIZE};
+        qint64 m_startTime {AkTracer::currentTime()};
+};
+
+Q_GLOBAL_STATIC(AkTracer, akTracerGlobal)
+Q_GLOBAL_STATIC(AkTracerRegistry, akTracerRegistry)
+
+static std::atomic<bool> akTracerEnabled {false};
+static thread_local AkTracerThreadBuffer *akTracerBuffer {nullptr};
+
+AkTracer::AkTracer(QObject *parent):
+    QObject(parent)
+{
+    this->d = new AkTracerPrivate(this);
+}
+
+AkTracer::~AkTracer()
+{
+    akTracerEnabled = false;
+    delete this->d;
+}
+
+AkTracer *AkTracer::instance()
+{
+    return akTracerGlobal;
+}
+
+bool AkTracer::isEnabled()
+{
+    return akTracerEnabled.load(std::memory_order_relaxed);
+}
+
+bool AkTracer::enabled() const
+{
+    return akTracerEnabled;
+}
+
+int AkTracer::bufferSize() const
+{
+    auto registry = akTracerRegistry;
+
+    if (!registry)
+        return DEFAULT_BUFFER_SIZE;
+
+    QMutexLocker mutexLocker(&registry->m_mutex);
+
+    return registry->m_bufferSize;
+}
+
+QString AkTracer::traceFile() const
+{
+    return this->d->m_traceFile;
+}
+
+QByteArray AkTracer::toJson() const
+{
+    QJsonArray traceEvents;
+    auto registry = akTracerRegistry;
+
+    if (registry) {
+        registry->m_mutex.lock();
+        auto buffers = registry->m_buffers;
+        auto startTime = registry->m_startTime;
+        registry->m_mutex.unlock();
+
+        auto pid = QCoreApplication::applicationPid();
+
+        for (auto &buffer: buffers) {
+            auto size = quint64(buffer->m_events.size());
+            auto written = buffer->m_written.load(std::memory_order_acquire);
+            auto first = qMax(written > size? written - size: 0,
+                              buffer->m_cleared.load());
+            QVector<AkTracerEvent> events;
+            events.reserve(int(written - first));
+
+            for (auto i = first; i < written; i++)
+                events << buffer->m_events[int(i % size)];
+
+            // Discard the events the thread overwrote while copying them.
+            auto writtenAfter =
+                    buffer->m_written.load(std::memory_order_acquire);
+
+            if (writtenAfter + 1 > first + size)
+                events.remove(0,
+                              int(qMin<quint64>(writtenAfter + 1 - first - size,
+                                                quint64(events.size()))));
+
+            if (events.isEmpty())
+                continue;
+
+            traceEvents << QJsonObject {
+                {"name", "thread_name"                             },
+                {"ph"  , "M"                                       },
+                {"pid" , pid                                       },
+                {"tid" , qint64(buffer->m_tid)                     },
+                {"args", QJsonObject {{"name", buffer->m_threadName}}},
+            };
+
+            for (auto &event: events) {
+                QJsonObject args;
+
+                if (event.id >= 0)
+                    args["id"] = event.id;
+
+                if (event.pts >= 0)
+                    args["pts"] = event.pts;
+
+                traceEvents << QJsonObject {
+                    {"name", event.name                                },
+                    {"cat" , event.category                            },
+                    {"ph"  , "X"                                       },
+                    {"ts"  , qreal(event.startTime - startTime) / 1e3  },
+                    {"dur" , qreal(event.endTime - event.startTime) / 1e3},
+                    {"pid" , pid                                       },
+                    {"tid" , qint64(buffer->m_tid)                     },
+                    {"args", args                                      },
+                };
+            }
+        }
+    }
+
+    QJsonObject trace {
+        {"traceEvents"    , traceEvents},
+        {"displayTimeUnit", "ms"       },
+    };
+
+    return QJsonDocument(trace).toJson(QJsonDocument::Compact);
+}
+
+void AkTracer::addEvent(const char *category,
+                        const char *name,
+                        qint64 id,
+                        qint64 pts,
+                        qint64 startTime,
+                        qint64 endTime)
+{
+    auto buffer = akTracerBuffer;
+
+    if (!buffer) {
+        buffer = AkTracerPrivate::createBuffer();
+
+        if (!buffer)
+            return;
+
+        akTracerBuffer = buffer;
+    }
+
+    auto index = buffer->m_written.load(std::memory_order_relaxed);
+    buffer->m_events[int(index % quint64(buffer->m_events.size()))] =
+            {category, name, id, pts, startTime, endTime};
+    buffer->m_written.store(index + 1, std::memory_order_release);
+}
+
+qint64 AkTracer::currentTime()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void AkTracer::setEnabled(bool enabled)
+{
+    if (akTracerEnabled == enabled)
+        return;
+
+    akTracerEnabled = enabled;
+    emit this->enabledChanged(enabled);
+}
+
+void AkTracer::setBufferSize(int bufferSize)
+{
+    auto registry = akTracerRegistry;
+
+    if (!registry)
+        return;
+
+    bufferSize = qMax(bufferSize, MIN_BUFFER_SIZE);
+    registry->m_mutex.lock();
+
+    if (registry->m_bufferSize == bufferSize) {
+        registry->m_mutex.unlock();
+
+        return;
+    }
+
+    // The threads that are already recording keep their buffers.
+    registry->m_bufferSize = bufferSize;
+    registry->m_mutex.unlock();
+    emit this->bufferSizeChanged(bufferSize);
+}
+
+void AkTracer::setTraceFile(const QString &traceFile)
+{
+    if (this->d->m_traceFile == traceFile)
+        return;
+
+    this->d->m_traceFile = traceFile;
+    emit this->traceFileChanged(traceFile);
+}
+
+void AkTracer::resetEnabled()
+{
+    this->setEnabled(false);
+}
+
+void AkTracer::resetBufferSize()
+{
+    this->setBufferSize(DEFAULT_BUFFER_SIZE);
+}
+
+void AkTracer::resetTraceFile()
+{
+    this->setTraceFile({});
+}
+
+void AkTracer::clear()
+{
+    auto registry = akTracerRegistry;
+
+    if (!registry)
+        return;
+
+    QMutexLocker mutexLocker(&registry->m_mutex);
+
+    for (auto &buffer: registry->m_buffers)
+        buffer->m_cleared = buffer->m_written.load();
+}
+
+bool AkTracer::save(const QString &fileName)
+{
+    auto traceFile = fileName.isEmpty()? this->d->m_traceFile: fileName;
+
+    if (traceFile.isEmpty())
+        return false;
+
+    QFile file(traceFile);
+
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+        return false;
+
+    file.write(this->toJson());
+
+    return true;
+}
+
+void AkTracer::registerTypes()
+{
+    qmlRegisterSingletonInstance<AkTracer>("Ak", 1, 0, "AkTracer", akTracerGlobal);
+}
+
+AkTracerPrivate::AkTracerPrivate(AkTracer *self):
+    self(self)
+{
+}
+
+AkTracerThreadBuffer *AkTracerPrivate::createBuffer()
+{
+    auto registry = akTracerRegistry;
+
+    if (!registry)
+        return nullptr;
+
+    auto buffer = AkTracerThreadBufferPtr::create();
+    auto thread = QThread::currentThread();
+
+    if (thread)
+        buffer->m_threadName = thread->objectName();
+
+    QMutexLocker mutexLocker(&registry->m_mutex);
+    buffer->m_tid = ++registry->m_lastTid;
+
+    if (buffer->m_threadName.isEmpty())
+        buffer->m_threadName = QString("Thread %1").arg(buffer->m_tid);
+
+    buffer->m_events.resize(registry->m_bufferSize);
+    registry->m_buffers << buffer;
+
+    return buffer.data();
+}
+
+#include "moc_aktracer.cpp"
@@ -0,0 +1,138 @@
+/* Webcamoid, camera capture application.
+ * Copyright (C) 2026  Gonzalo Exequiel Pedone
+ *
+ * Webcamoid is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Webcamoid is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Webcamoid. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Web-Site: http://webcamoid.github.io/
+ */
+
+#ifndef AKTRACER_H
+#define AKTRACER_H
+
+#include <QObject>
+
+#include "akcommons.h"
+
+#define akTracer AkTracer::instance()
+
+class AkTracerPrivate;
+
+/* Records a timeline of what the pipelines are doing, per thread, and saves
+ * it in the Chrome trace format, so it can be opened in chrome://tracing or
+ * in Perfetto.
+ *
+ * Every thread writes its events to its own ring buffer, allocated the first
+ * time the thread records something while the tracer is enabled, so the
+ * buffers keep the last 'bufferSize' events of each thread and recording an
+ * event never locks nor allocates. When disabled, the only cost is checking
+ * a flag.
+ */
+class AKCOMMONS_EXPORT AkTracer: public QObject
+{
+    Q_OBJECT
+    Q_PROPERTY(bool enabled
+               READ enabled
+               WRITE setEnabled
+               RESET resetEnabled
+               NOTIFY enabledChanged)
+    Q_PROPERTY(int bufferSize
+               READ bufferSize
+               WRITE setBufferSize
+               RESET resetBufferSize
+               NOTIFY bufferSizeChanged)
+    Q_PROPERTY(QString traceFile
+               READ traceFile
+               WRITE setTraceFile
+               RESET resetTraceFile
+               NOTIFY traceFileChanged)
+
+    public:
+        AkTracer(QObject *parent=nullptr);
+        ~AkTracer();
+
+        Q_INVOKABLE static AkTracer *instance();
+        Q_INVOKABLE static bool isEnabled();
+        Q_INVOKABLE bool enabled() const;
+        Q_INVOKABLE int bufferSize() const;
+        Q_INVOKABLE QString traceFile() const;
+        Q_INVOKABLE QByteArray toJson() const;
+
+        // 'category' and 'name' must be static strings, only the pointers
+        // are stored.
+        static void addEvent(const char *category,
+                             const char *name,
+                             qint64 id,
+                             qint64 pts,
+                             qint64 startTime,
+                             qint64 endTime);
+        static qint64 currentTime();
+
+    private:
+        AkTracerPrivate *d;
+
+    Q_SIGNALS:
+        void enabledChanged(bool enabled);
+        void bufferSizeChanged(int bufferSize);
+        void traceFileChanged(const QString &traceFile);
+
+    public Q_SLOTS:
+        void setEnabled(bool enabled);
+        void setBufferSize(int bufferSize);
+        void setTraceFile(const QString &traceFile);
+        void resetEnabled();
+        void resetBufferSize();
+        void resetTraceFile();
+        void clear();
+        // Saves to 'traceFile' if 'fileName' is empty.
+        bool save(const QString &fileName={});
+        static void registerTypes();
+};
+
+// Records the time between its construction and its destruction as an event
+// of the current thread.
+class AKCOMMONS_EXPORT AkTraceScope
+{
+    public:
+        inline AkTraceScope(const char *category,
+                            const char *name,
+                            qint64 id=-1,
+                            qint64 pts=-1):
+            m_category(category),
+            m_name(name),
+            m_id(id),
+            m_pts(pts),
+            m_startTime(AkTracer::isEnabled()? AkTracer::currentTime(): -1)
+        {
+        }
+
+        inline ~AkTraceScope()
+        {
+            if (this->m_startTime >= 0)
+                AkTracer::addEvent(this->m_category,
+                                   this->m_name,
+                                   this->m_id,
+                                   this->m_pts,
+                                   this->m_startTime,
+                                   AkTracer::currentTime());
+        }
+
+    private:
+        const char *m_category;
+        const char *m_name;
+        qint64 m_id;
+        qint64 m_pts;
+        qint64 m_startTime;
+};
+
+#endif // AKTRACER_H
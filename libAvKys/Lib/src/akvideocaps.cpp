@@ -2546,6 +2546,54 @@ AkVideoFormatSpec AkVideoCaps::formatSpecs(PixelFormat pixelFormat)
     return VideoFormat::formatSpecs(pixelFormat);
 }
 
+int AkVideoCaps::conversionCost(PixelFormat from, PixelFormat to)
+{
+    if (from == to)
+        return 0;
+
+    auto fromSpecs = VideoFormat::formatSpecs(from);
+    auto toSpecs = VideoFormat::formatSpecs(to);
+
+    // Unknown formats can't be reasoned about, give them a flat high cost
+    // so any known path is preferred.
+    if (fromSpecs.type() == AkVideoFormatSpec::VFT_Unknown
+        || toSpecs.type() == AkVideoFormatSpec::VFT_Unknown)
+        return 1000;
+
+    // Every conversion reads and writes the whole frame at least once.
+    int cost = 10;
+
+    // Changing the color model requires a matrix transform per pixel.
+    if (fromSpecs.type() != toSpecs.type())
+        cost += 20;
+
+    // Packing or unpacking planes.
+    if (fromSpecs.planes() != toSpecs.planes())
+        cost += 5;
+
+    // Chroma resampling.
+    if (fromSpecs.type() == AkVideoFormatSpec::VFT_YUV
+        && toSpecs.type() == AkVideoFormatSpec::VFT_YUV) {
+        auto fromU = fromSpecs.component(AkColorComponent::CT_U);
+        auto toU = toSpecs.component(AkColorComponent::CT_U);
+
+        if (fromU.widthDiv() != toU.widthDiv()
+            || fromU.heightDiv() != toU.heightDiv())
+            cost += 5;
+    }
+
+    // Depth scaling.
+    if (fromSpecs.depth() != toSpecs.depth())
+        cost += 5;
+
+    // Adding or dropping the alpha channel.
+    if (fromSpecs.contains(AkColorComponent::CT_A)
+        != toSpecs.contains(AkColorComponent::CT_A))
+        cost += 2;
+
+    return cost;
+}
+
 void AkVideoCaps::setFormat(PixelFormat format)
 {
     if (this->d->m_format == format)
@@ -641,6 +641,8 @@ class AKCOMMONS_EXPORT AkVideoCaps: public QObject
         Q_INVOKABLE static int bitsPerPixel(AkVideoCaps::PixelFormat pixelFormat);
         Q_INVOKABLE static QString pixelFormatToString(AkVideoCaps::PixelFormat pixelFormat);
         Q_INVOKABLE static AkVideoFormatSpec formatSpecs(AkVideoCaps::PixelFormat pixelFormat);
+        Q_INVOKABLE static int conversionCost(AkVideoCaps::PixelFormat from,
+                                              AkVideoCaps::PixelFormat to);
 
     private:
         AkVideoCapsPrivate *d;
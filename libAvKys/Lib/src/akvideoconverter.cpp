@@ -29,6 +29,7 @@
 #include "akcpufeatures.h"
 #include "akfrac.h"
 #include "aksimd.h"
+#include "aktracer.h"
 #include "akvideocaps.h"
 #include "akvideoconverter.h"
 #include "akvideoformatspec.h"
@@ -309,6 +310,90 @@ using ConvertFast8bits1Ato1Type =
              const quint8 *src_line_a,
              quint8 *dst_line_x,
              int *x);
+using CreatePackedLayoutType =
+    void *(*)(const int *srcLayout,
+              const int *dstLayout);
+using ConvertFast8bitsPacked3to3Type =
+    void (*)(void *convertParameters,
+             void *packedLayout,
+             int xmax,
+             const quint8 *src_line_x,
+             const quint8 *src_line_y,
+             const quint8 *src_line_z,
+             quint8 *dst_line_x,
+             quint8 *dst_line_y,
+             quint8 *dst_line_z,
+             int *x);
+using ConvertFast8bitsPacked3to3AType =
+    void (*)(void *convertParameters,
+             void *packedLayout,
+             int xmax,
+             const quint8 *src_line_x,
+             const quint8 *src_line_y,
+             const quint8 *src_line_z,
+             quint8 *dst_line_x,
+             quint8 *dst_line_y,
+             quint8 *dst_line_z,
+             quint8 *dst_line_a,
+             int *x);
+using CreateConvertParameters16bitsType =
+    void *(*)(qint64 *colorMatrix,
+              qint64 *alphaMatrix,
+              qint64 *minValues,
+              qint64 *maxValues,
+              qint64 colorShift,
+              qint64 alphaShift,
+              const qint64 *layout);
+using ConvertFast16bits3to3Type =
+    void (*)(void *convertParameters,
+             const int *srcWidthOffsetX,
+             const int *srcWidthOffsetY,
+             const int *srcWidthOffsetZ,
+             const int *dstWidthOffsetX,
+             const int *dstWidthOffsetY,
+             const int *dstWidthOffsetZ,
+             const int *dstWidthOffsetA,
+             int xmax,
+             const quint8 *src_line_x,
+             const quint8 *src_line_y,
+             const quint8 *src_line_z,
+             quint8 *dst_line_x,
+             quint8 *dst_line_y,
+             quint8 *dst_line_z,
+             quint8 *dst_line_a,
+             int *x);
+using ConvertFast16bits3Ato3Type =
+    void (*)(void *convertParameters,
+             const int *srcWidthOffsetX,
+             const int *srcWidthOffsetY,
+             const int *srcWidthOffsetZ,
+             const int *srcWidthOffsetA,
+             const int *dstWidthOffsetX,
+             const int *dstWidthOffsetY,
+             const int *dstWidthOffsetZ,
+             int xmax,
+             const quint8 *src_line_x,
+             const quint8 *src_line_y,
+             const quint8 *src_line_z,
+             const quint8 *src_line_a,
+             quint8 *dst_line_x,
+             quint8 *dst_line_y,
+             quint8 *dst_line_z,
+             int *x);
+using ConvertFast16bits1to3Type =
+    void (*)(void *convertParameters,
+             const int *srcWidthOffsetX,
+             const int *dstWidthOffsetX,
+             const int *dstWidthOffsetY,
+             const int *dstWidthOffsetZ,
+             const int *dstWidthOffsetA,
+             int xmax,
+             const quint8 *src_line_x,
+             quint8 *dst_line_x,
+             quint8 *dst_line_y,
+             quint8 *dst_line_z,
+             quint8 *dst_line_a,
+             int *x);
 
 class FrameConvertParameters
 {
@@ -449,6 +534,27 @@ class FrameConvertParameters
         ConvertFast8bits1Ato3AType  convertSIMDFast8bits1Ato3A  {nullptr};
         ConvertFast8bits1Ato1Type   convertSIMDFast8bits1Ato1   {nullptr};
 
+        // Kernels for 16 bits inputs, the parameters are only created when
+        // the kernels can handle the current formats.
+        void *simdConvertParameters16bits {nullptr};
+
+        CreateConvertParameters16bitsType createSIMDConvertParameters16bits {nullptr};
+        FreeConvertParametersType         freeSIMDConvertParameters16bits   {nullptr};
+        ConvertFast16bits3to3Type         convertSIMDFast16bits3to3         {nullptr};
+        ConvertFast16bits3Ato3Type        convertSIMDFast16bits3Ato3        {nullptr};
+        ConvertFast16bits1to3Type         convertSIMDFast16bits1to3         {nullptr};
+
+        // Kernels for contiguous 8 bits layouts, used when the source
+        // columns are not scaled. The component masks are prepared once, in
+        // configure().
+        void *simdPackedLayout {nullptr};
+        bool packedLayout {false};
+
+        CreatePackedLayoutType          createSIMDPackedLayout          {nullptr};
+        FreeConvertParametersType       freeSIMDPackedLayout            {nullptr};
+        ConvertFast8bitsPacked3to3Type  convertSIMDFast8bitsPacked3to3  {nullptr};
+        ConvertFast8bitsPacked3to3AType convertSIMDFast8bitsPacked3to3A {nullptr};
+
         size_t parallelizationThreshold {0};
         bool paralelize {false};
 
@@ -1519,8 +1625,31 @@ class AkVideoConverterPrivate
                 auto dst_line_y = dst.line(fc.planeYo, y) + fc.yoOffset;
                 auto dst_line_z = dst.line(fc.planeZo, y) + fc.zoOffset;
 
+                int xs = fc.xmin;
+
+                if (sizeof(InputType) == 2
+                    && fc.simdConvertParameters16bits
+                    && fc.packedLayout)
+                    fc.convertSIMDFast16bits3to3(fc.simdConvertParameters16bits,
+                                                 fc.srcWidthOffsetX,
+                                                 fc.srcWidthOffsetY,
+                                                 fc.srcWidthOffsetZ,
+                                                 fc.dstWidthOffsetX,
+                                                 fc.dstWidthOffsetY,
+                                                 fc.dstWidthOffsetZ,
+                                                 fc.dstWidthOffsetA,
+                                                 fc.xmax,
+                                                 src_line_x,
+                                                 src_line_y,
+                                                 src_line_z,
+                                                 dst_line_x,
+                                                 dst_line_y,
+                                                 dst_line_z,
+                                                 nullptr,
+                                                 &xs);
+
                 #pragma omp simd if(fc.paralelize)
-                for (int x = fc.xmin; x < fc.xmax; ++x) {
+                for (int x = xs; x < fc.xmax; ++x) {
                     InputType xi;
                     InputType yi;
                     InputType zi;
@@ -1567,6 +1696,18 @@ class AkVideoConverterPrivate
 
                 int x = fc.xmin;
 
+                if (fc.simdPackedLayout && fc.packedLayout)
+                    fc.convertSIMDFast8bitsPacked3to3(fc.simdConvertParameters,
+                                                      fc.simdPackedLayout,
+                                                      fc.xmax,
+                                                      src_line_x,
+                                                      src_line_y,
+                                                      src_line_z,
+                                                      dst_line_x,
+                                                      dst_line_y,
+                                                      dst_line_z,
+                                                      &x);
+
                 if (fc.convertSIMDFast8bits3to3)
                     fc.convertSIMDFast8bits3to3(fc.simdConvertParameters,
                                                 fc.srcWidthOffsetX,
@@ -1619,8 +1760,31 @@ class AkVideoConverterPrivate
                 auto dst_line_z = dst.line(fc.planeZo, y) + fc.zoOffset;
                 auto dst_line_a = dst.line(fc.planeAo, y) + fc.aoOffset;
 
+                int xs = fc.xmin;
+
+                if (sizeof(InputType) == 2
+                    && fc.simdConvertParameters16bits
+                    && fc.packedLayout)
+                    fc.convertSIMDFast16bits3to3(fc.simdConvertParameters16bits,
+                                                 fc.srcWidthOffsetX,
+                                                 fc.srcWidthOffsetY,
+                                                 fc.srcWidthOffsetZ,
+                                                 fc.dstWidthOffsetX,
+                                                 fc.dstWidthOffsetY,
+                                                 fc.dstWidthOffsetZ,
+                                                 fc.dstWidthOffsetA,
+                                                 fc.xmax,
+                                                 src_line_x,
+                                                 src_line_y,
+                                                 src_line_z,
+                                                 dst_line_x,
+                                                 dst_line_y,
+                                                 dst_line_z,
+                                                 dst_line_a,
+                                                 &xs);
+
                 #pragma omp simd if(fc.paralelize)
-                for (int x = fc.xmin; x < fc.xmax; ++x) {
+                for (int x = xs; x < fc.xmax; ++x) {
                     InputType xi;
                     InputType yi;
                     InputType zi;
@@ -1669,6 +1833,19 @@ class AkVideoConverterPrivate
 
                 int x = fc.xmin;
 
+                if (fc.simdPackedLayout && fc.packedLayout)
+                    fc.convertSIMDFast8bitsPacked3to3A(fc.simdConvertParameters,
+                                                       fc.simdPackedLayout,
+                                                       fc.xmax,
+                                                       src_line_x,
+                                                       src_line_y,
+                                                       src_line_z,
+                                                       dst_line_x,
+                                                       dst_line_y,
+                                                       dst_line_z,
+                                                       dst_line_a,
+                                                       &x);
+
                 if (fc.convertSIMDFast8bits3to3A)
                     fc.convertSIMDFast8bits3to3A(fc.simdConvertParameters,
                                                  fc.srcWidthOffsetX,
@@ -1724,8 +1901,31 @@ class AkVideoConverterPrivate
                 auto dst_line_y = dst.line(fc.planeYo, y) + fc.yoOffset;
                 auto dst_line_z = dst.line(fc.planeZo, y) + fc.zoOffset;
 
+                int xs = fc.xmin;
+
+                if (sizeof(InputType) == 2
+                    && fc.simdConvertParameters16bits
+                    && fc.packedLayout)
+                    fc.convertSIMDFast16bits3Ato3(fc.simdConvertParameters16bits,
+                                                  fc.srcWidthOffsetX,
+                                                  fc.srcWidthOffsetY,
+                                                  fc.srcWidthOffsetZ,
+                                                  fc.srcWidthOffsetA,
+                                                  fc.dstWidthOffsetX,
+                                                  fc.dstWidthOffsetY,
+                                                  fc.dstWidthOffsetZ,
+                                                  fc.xmax,
+                                                  src_line_x,
+                                                  src_line_y,
+                                                  src_line_z,
+                                                  src_line_a,
+                                                  dst_line_x,
+                                                  dst_line_y,
+                                                  dst_line_z,
+                                                  &xs);
+
                 #pragma omp simd if(fc.paralelize)
-                for (int x = fc.xmin; x < fc.xmax; ++x) {
+                for (int x = xs; x < fc.xmax; ++x) {
                     InputType xi;
                     InputType yi;
                     InputType zi;
@@ -2638,8 +2838,27 @@ class AkVideoConverterPrivate
                 auto dst_line_y = dst.line(fc.planeYo, y) + fc.yoOffset;
                 auto dst_line_z = dst.line(fc.planeZo, y) + fc.zoOffset;
 
+                int xs = fc.xmin;
+
+                if (sizeof(InputType) == 2
+                    && fc.simdConvertParameters16bits
+                    && fc.packedLayout)
+                    fc.convertSIMDFast16bits1to3(fc.simdConvertParameters16bits,
+                                                 fc.srcWidthOffsetX,
+                                                 fc.dstWidthOffsetX,
+                                                 fc.dstWidthOffsetY,
+                                                 fc.dstWidthOffsetZ,
+                                                 fc.dstWidthOffsetA,
+                                                 fc.xmax,
+                                                 src_line_x,
+                                                 dst_line_x,
+                                                 dst_line_y,
+                                                 dst_line_z,
+                                                 nullptr,
+                                                 &xs);
+
                 #pragma omp simd if(fc.paralelize)
-                for (int x = fc.xmin; x < fc.xmax; ++x) {
+                for (int x = xs; x < fc.xmax; ++x) {
                     InputType xi;
                     this->read1(fc,
                                 src_line_x,
@@ -2722,8 +2941,27 @@ class AkVideoConverterPrivate
                 auto dst_line_z = dst.line(fc.planeZo, y) + fc.zoOffset;
                 auto dst_line_a = dst.line(fc.planeAo, y) + fc.aoOffset;
 
+                int xs = fc.xmin;
+
+                if (sizeof(InputType) == 2
+                    && fc.simdConvertParameters16bits
+                    && fc.packedLayout)
+                    fc.convertSIMDFast16bits1to3(fc.simdConvertParameters16bits,
+                                                 fc.srcWidthOffsetX,
+                                                 fc.dstWidthOffsetX,
+                                                 fc.dstWidthOffsetY,
+                                                 fc.dstWidthOffsetZ,
+                                                 fc.dstWidthOffsetA,
+                                                 fc.xmax,
+                                                 src_line_x,
+                                                 dst_line_x,
+                                                 dst_line_y,
+                                                 dst_line_z,
+                                                 dst_line_a,
+                                                 &xs);
+
                 #pragma omp simd if(fc.paralelize)
-                for (int x = fc.xmin; x < fc.xmax; ++x) {
+                for (int x = xs; x < fc.xmax; ++x) {
                     InputType xi;
                     this->read1(fc,
                                 src_line_x,
@@ -8336,6 +8574,11 @@ AkVideoPacket AkVideoConverter::convert(const AkVideoPacket &packet)
         && this->d->m_inputRect.isEmpty())
         return packet;
 
+    AkTraceScope traceScope("converter",
+                            "AkVideoConverter::convert",
+                            packet.id(),
+                            packet.pts());
+
     return this->d->convert(packet, this->d->m_outputCaps);
 }
 
@@ -8810,6 +9053,12 @@ FrameConvertParameters::~FrameConvertParameters()
 
     if (this->freeSIMDConvertParameters && this->simdConvertParameters)
         this->freeSIMDConvertParameters(this->simdConvertParameters);
+
+    if (this->freeSIMDConvertParameters16bits && this->simdConvertParameters16bits)
+        this->freeSIMDConvertParameters16bits(this->simdConvertParameters16bits);
+
+    if (this->freeSIMDPackedLayout && this->simdPackedLayout)
+        this->freeSIMDPackedLayout(this->simdPackedLayout);
 }
 
 FrameConvertParameters &FrameConvertParameters::operator =(const FrameConvertParameters &other)
@@ -9438,6 +9687,15 @@ void FrameConvertParameters::configure(const AkVideoCaps &icaps,
     this->convertSIMDFast8bits1Ato3   = reinterpret_cast<ConvertFast8bits1Ato3Type>  (simd.resolve("convertFast8bits1Ato3"));
     this->convertSIMDFast8bits1Ato3A  = reinterpret_cast<ConvertFast8bits1Ato3AType> (simd.resolve("convertFast8bits1Ato3A"));
     this->convertSIMDFast8bits1Ato1   = reinterpret_cast<ConvertFast8bits1Ato1Type>  (simd.resolve("convertFast8bits1Ato1"));
+    this->createSIMDConvertParameters16bits = reinterpret_cast<CreateConvertParameters16bitsType>(simd.resolve("createConvertParameters16bits"));
+    this->freeSIMDConvertParameters16bits   = reinterpret_cast<FreeConvertParametersType>        (simd.resolve("freeConvertParameters16bits"));
+    this->convertSIMDFast16bits3to3         = reinterpret_cast<ConvertFast16bits3to3Type>        (simd.resolve("convertFast16bits3to3"));
+    this->convertSIMDFast16bits3Ato3        = reinterpret_cast<ConvertFast16bits3Ato3Type>       (simd.resolve("convertFast16bits3Ato3"));
+    this->convertSIMDFast16bits1to3         = reinterpret_cast<ConvertFast16bits1to3Type>        (simd.resolve("convertFast16bits1to3"));
+    this->createSIMDPackedLayout          = reinterpret_cast<CreatePackedLayoutType>         (simd.resolve("createPackedLayout"));
+    this->freeSIMDPackedLayout            = reinterpret_cast<FreeConvertParametersType>      (simd.resolve("freePackedLayout"));
+    this->convertSIMDFast8bitsPacked3to3  = reinterpret_cast<ConvertFast8bitsPacked3to3Type> (simd.resolve("convertFast8bitsPacked3to3"));
+    this->convertSIMDFast8bitsPacked3to3A = reinterpret_cast<ConvertFast8bitsPacked3to3AType>(simd.resolve("convertFast8bitsPacked3to3A"));
 
     if (this->freeSIMDConvertParameters && this->simdConvertParameters)
         this->freeSIMDConvertParameters(this->simdConvertParameters);
@@ -9464,6 +9722,122 @@ void FrameConvertParameters::configure(const AkVideoCaps &icaps,
                                                   alphaShift);
     }
 
+    if (this->freeSIMDConvertParameters16bits && this->simdConvertParameters16bits)
+        this->freeSIMDConvertParameters16bits(this->simdConvertParameters16bits);
+
+    this->simdConvertParameters16bits = nullptr;
+
+    /* 16 bits inputs (P010, P016, Y210, RGB48, RGBA64, Y16, ...) are
+     * converted with 16 bits fixed point products, or 32 bits ones for the
+     * 16 bits outputs, the plugin refuses the matrix if it can't make the
+     * products fit. The alpha input is only blended into 8 bits outputs.
+     */
+    bool is16bitsInput =
+            this->convertDataTypes == ConvertDataTypes_16_8
+            || this->convertDataTypes == ConvertDataTypes_16_16;
+    bool hasKernel = false;
+
+    switch (this->alphaMode) {
+    case ConvertAlphaMode_AI_O:
+        hasKernel = this->convertType == ConvertType_3to3
+                    && this->convertSIMDFast16bits3Ato3;
+        break;
+    case ConvertAlphaMode_I_AO:
+    case ConvertAlphaMode_I_O:
+        hasKernel =
+                (this->convertType == ConvertType_3to3 && this->convertSIMDFast16bits3to3)
+                || (this->convertType == ConvertType_1to3 && this->convertSIMDFast16bits1to3);
+        break;
+    default:
+        break;
+    }
+
+    if (this->createSIMDConvertParameters16bits
+        && is16bitsInput
+        && hasKernel
+        && this->fromEndian == Q_BYTE_ORDER) {
+        qint64 colorMatrix[12];
+        qint64 alphaMatrix[9];
+        qint64 minValues[3];
+        qint64 maxValues[3];
+        qint64 colorShift;
+        qint64 alphaShift;
+        this->colorConvert.readMatrix(colorMatrix,
+                                      alphaMatrix,
+                                      minValues,
+                                      maxValues,
+                                      &colorShift,
+                                      &alphaShift);
+        bool alphaIn = this->alphaMode == ConvertAlphaMode_AI_O;
+        const AkColorComponent *components[] {
+            &this->compXi, &this->compYi, &this->compZi, &this->compAi,
+            &this->compXo, &this->compYo, &this->compZo, &this->compAo
+        };
+        qint64 layout[34] {
+            qint64(this->xiShift),
+            qint64(this->yiShift),
+            qint64(this->ziShift),
+            qint64(this->aiShift),
+            qint64(this->maxXi),
+            qint64(this->maxYi),
+            qint64(this->maxZi),
+            alphaIn? qint64(this->maxAi): 0,
+            qint64(this->xoShift),
+            qint64(this->yoShift),
+            qint64(this->zoShift),
+            qint64(this->aoShift),
+            qint64(this->maskXo & 0xffff),
+            qint64(this->maskYo & 0xffff),
+            qint64(this->maskZo & 0xffff),
+            qint64(this->maskAo & 0xffff),
+            qint64(this->alphaMask & 0xffff),
+            this->convertDataTypes == ConvertDataTypes_16_8? 8: 16
+        };
+
+        for (int i = 0; i < 8; ++i) {
+            layout[18 + 2 * i] = qint64(components[i]->step());
+            layout[19 + 2 * i] = qint64(components[i]->widthDiv());
+        }
+
+        this->simdConvertParameters16bits =
+                this->createSIMDConvertParameters16bits(colorMatrix,
+                                                        alphaMatrix,
+                                                        minValues,
+                                                        maxValues,
+                                                        colorShift,
+                                                        alphaShift,
+                                                        layout);
+    }
+
+    if (this->freeSIMDPackedLayout && this->simdPackedLayout)
+        this->freeSIMDPackedLayout(this->simdPackedLayout);
+
+    this->simdPackedLayout = nullptr;
+
+    // The component layouts are passed as {step, widthDiv} pairs for X, Y, Z
+    // and A, the plugin refuses the layouts its kernels can't handle.
+    if (this->createSIMDPackedLayout
+        && this->convertDataTypes == ConvertDataTypes_8_8) {
+        const AkColorComponent *srcComponents[] {
+            &this->compXi, &this->compYi, &this->compZi, &this->compAi
+        };
+        const AkColorComponent *dstComponents[] {
+            &this->compXo, &this->compYo, &this->compZo, &this->compAo
+        };
+        int srcLayout[8];
+        int dstLayout[8];
+
+        for (int i = 0; i < 4; ++i) {
+            srcLayout[2 * i] = int(srcComponents[i]->step());
+            srcLayout[2 * i + 1] = int(srcComponents[i]->widthDiv());
+            dstLayout[2 * i] = int(dstComponents[i]->step());
+            dstLayout[2 * i + 1] = int(dstComponents[i]->widthDiv());
+        }
+
+        this->simdPackedLayout =
+                this->createSIMDPackedLayout(srcLayout, dstLayout);
+    }
+
     // Configure the minimum threshold for paralellizing the frame convertion.
 
     int operationsPerByte = 0;
@@ -9663,6 +10037,20 @@ void FrameConvertParameters::configureScaling(const AkVideoCaps &icaps,
             this->kx[x] = 0;
     }
 
+    // The contiguous kernels read the source columns in order, and write
+    // whole blocks of the destination line, so they can't be used when
+    // scaling horizontally, or when several output lines share a plane
+    // line.
+    this->packedLayout = this->fastConvertion
+                         && this->compXo.heightDiv() == 0
+                         && this->compYo.heightDiv() == 0
+                         && this->compZo.heightDiv() == 0
+                         && this->compAo.heightDiv() == 0;
+
+    for (int x = this->xmin; this->packedLayout && x < this->xmax; ++x)
+        if (this->srcWidth[x] != x)
+            this->packedLayout = false;
+
     auto &yomin = this->ymin;
 
     int hi_1 = qMax(1, irect.height() - 1);
@@ -9751,6 +10139,7 @@ void FrameConvertParameters::reset()
     this->alphaMode = ConvertAlphaMode_AI_AO;
     this->resizeMode = ResizeMode_Keep;
     this->fastConvertion = false;
+    this->packedLayout = false;
 
     this->fromEndian = Q_BYTE_ORDER;
     this->toEndian = Q_BYTE_ORDER;
@@ -0,0 +1,317 @@
+/* Webcamoid, camera capture application.
+ * Copyright (C) 2026  Gonzalo Exequiel Pedone
+ *
+ * Webcamoid is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Webcamoid is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Webcamoid. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Web-Site: http://webcamoid.github.io/
+ */
+
+#ifndef AKVIDEOFORMATTRAITS_H
+#define AKVIDEOFORMATTRAITS_H
+
+#include <type_traits>
+
+#include "akvideocaps.h"
+#include "akvideoformatspec.h"
+
+/* Compile time description of the most common pixel formats.
+ *
+ * The values mirror the entries of the formats table in akvideocaps.cpp,
+ * so a kernel written against these traits gets all the component offsets,
+ * steps and depths as constants, and its inner loops don't need to branch
+ * on the layout. Use akVideoFormatDispatch() to pick the instantiation
+ * matching a runtime format.
+ *
+ * The components are named as in the converter: X, Y, Z are R, G, B for
+ * RGB formats, Y, U, V for YUV formats, and only X exists for gray
+ * formats.
+ */
+
+template <int PlaneIndex,
+          int Step,
+          int Offset,
+          int Shift,
+          int ByteDepth,
+          int Depth,
+          int WidthDiv,
+          int HeightDiv>
+struct AkColorComponentTraits
+{
+    using Type =
+        typename std::conditional<ByteDepth == 1,
+                                  quint8,
+                                  typename std::conditional<ByteDepth == 2,
+                                                            quint16,
+                                                            quint32>::type>::type;
+
+    static constexpr bool exists = true;
+    static constexpr int plane = PlaneIndex;
+    static constexpr int step = Step;
+    static constexpr int offset = Offset;
+    static constexpr int shift = Shift;
+    static constexpr int byteDepth = ByteDepth;
+    static constexpr int depth = Depth;
+    static constexpr int widthDiv = WidthDiv;
+    static constexpr int heightDiv = HeightDiv;
+    static constexpr quint32 max = quint32((quint64(1) << Depth) - 1);
+
+    // True if the component fills its whole word, and can be read and
+    // written without masking.
+    static constexpr bool isPlain = Shift == 0 && Depth == 8 * ByteDepth;
+
+    // Byte offset of the pixel x in the plane line.
+    inline static size_t pixelOffset(int x)
+    {
+        return size_t(x >> WidthDiv) * Step + Offset;
+    }
+
+    inline static quint32 read(const quint8 *line, int x)
+    {
+        auto value = *reinterpret_cast<const Type *>(line + pixelOffset(x));
+
+        return isPlain? quint32(value): (quint32(value) >> Shift) & max;
+    }
+
+    inline static void write(quint8 *line, int x, quint32 value)
+    {
+        auto pixel = reinterpret_cast<Type *>(line + pixelOffset(x));
+
+        if (isPlain)
+            *pixel = Type(value);
+        else
+            *pixel = Type((*pixel & ~(max << Shift)) | ((value & max) << Shift));
+    }
+
+    static bool matches(const AkVideoFormatSpec &specs,
+                        AkColorComponent::ComponentType type)
+    {
+        if (!specs.contains(type))
+            return false;
+
+        auto component = specs.component(type);
+
+        return specs.componentPlane(type) == PlaneIndex
+               && component.step() == Step
+               && component.offset() == Offset
+               && component.shift() == Shift
+               && component.byteDepth() == ByteDepth
+               && component.depth() == Depth
+               && component.widthDiv() == WidthDiv
+               && component.heightDiv() == HeightDiv;
+    }
+};
+
+// Placeholder for the components missing in a format.
+struct AkNoColorComponentTraits
+{
+    using Type = quint8;
+
+    static constexpr bool exists = false;
+    static constexpr int plane = 0;
+    static constexpr int step = 0;
+    static constexpr int offset = 0;
+    static constexpr int shift = 0;
+    static constexpr int byteDepth = 0;
+    static constexpr int depth = 0;
+    static constexpr int widthDiv = 0;
+    static constexpr int heightDiv = 0;
+    static constexpr quint32 max = 0;
+    static constexpr bool isPlain = true;
+
+    inline static size_t pixelOffset(int x)
+    {
+        Q_UNUSED(x)
+
+        return 0;
+    }
+
+    inline static quint32 read(const quint8 *line, int x)
+    {
+        Q_UNUSED(line)
+        Q_UNUSED(x)
+
+        return 0;
+    }
+
+    inline static void write(quint8 *line, int x, quint32 value)
+    {
+        Q_UNUSED(line)
+        Q_UNUSED(x)
+        Q_UNUSED(value)
+    }
+
+    static bool matches(const AkVideoFormatSpec &specs,
+                        AkColorComponent::ComponentType type)
+    {
+        return !specs.contains(type);
+    }
+};
+
+template <AkVideoCaps::PixelFormat Format,
+          AkVideoFormatSpec::VideoFormatType FormatType,
+          int Planes,
+          typename XTraits,
+          typename YTraits,
+          typename ZTraits,
+          typename ATraits>
+struct AkVideoFormatTraitsBase
+{
+    using X = XTraits;
+    using Y = YTraits;
+    using Z = ZTraits;
+    using A = ATraits;
+
+    static constexpr AkVideoCaps::PixelFormat format = Format;
+    static constexpr AkVideoFormatSpec::VideoFormatType type = FormatType;
+    static constexpr int planes = Planes;
+    static constexpr int mainComponents = ZTraits::exists? 3: 1;
+    static constexpr bool hasAlpha = ATraits::exists;
+
+    // True if the traits agree with the runtime formats table. The check
+    // is done only once.
+    static bool isValid()
+    {
+        static const bool valid = matchesSpecs();
+
+        return valid;
+    }
+
+    // Checks the traits against the runtime formats table.
+    static bool matchesSpecs()
+    {
+        auto specs = AkVideoCaps::formatSpecs(Format);
+
+        if (specs.type() != FormatType
+            || int(specs.planes()) != Planes
+            || specs.endianness() != Q_BYTE_ORDER)
+            return false;
+
+        if (FormatType == AkVideoFormatSpec::VFT_RGB)
+            return X::matches(specs, AkColorComponent::CT_R)
+                   && Y::matches(specs, AkColorComponent::CT_G)
+                   && Z::matches(specs, AkColorComponent::CT_B)
+                   && A::matches(specs, AkColorComponent::CT_A);
+
+        if (FormatType == AkVideoFormatSpec::VFT_YUV)
+            return X::matches(specs, AkColorComponent::CT_Y)
+                   && Y::matches(specs, AkColorComponent::CT_U)
+                   && Z::matches(specs, AkColorComponent::CT_V)
+                   && A::matches(specs, AkColorComponent::CT_A);
+
+        return X::matches(specs, AkColorComponent::CT_Y)
+               && A::matches(specs, AkColorComponent::CT_A);
+    }
+};
+
+template <AkVideoCaps::PixelFormat Format>
+struct AkVideoFormatTraits;
+
+#define AK_VIDEO_FORMAT_TRAITS(format, type, planes, x, y, z, a) \
+    template <> \
+    struct AkVideoFormatTraits<AkVideoCaps::format>: \
+        AkVideoFormatTraitsBase<AkVideoCaps::format, \
+                                AkVideoFormatSpec::type, \
+                                planes, \
+                                x, \
+                                y, \
+                                z, \
+                                a> \
+    { \
+    };
+
+#define AK_COMPONENT(plane, step, offset, shift, byteDepth, depth, widthDiv, heightDiv) \
+    AkColorComponentTraits<plane, step, offset, shift, byteDepth, depth, widthDiv, heightDiv>
+#define AK_NO_COMPONENT AkNoColorComponentTraits
+
+AK_VIDEO_FORMAT_TRAITS(Format_argb, VFT_RGB, 1,
+                       AK_COMPONENT(0, 4, 1, 0, 1, 8, 0, 0),
+                       AK_COMPONENT(0, 4, 2, 0, 1, 8, 0, 0),
+                       AK_COMPONENT(0, 4, 3, 0, 1, 8, 0, 0),
+                       AK_COMPONENT(0, 4, 0, 0, 1, 8, 0, 0))
+AK_VIDEO_FORMAT_TRAITS(Format_bgra, VFT_RGB, 1,
+                       AK_COMPONENT(0, 4, 2, 0, 1, 8, 0, 0),
+                       AK_COMPONENT(0, 4, 1, 0, 1, 8, 0, 0),
+                       AK_COMPONENT(0, 4, 0, 0, 1, 8, 0, 0),
+                       AK_COMPONENT(0, 4, 3, 0, 1, 8, 0, 0))
+AK_VIDEO_FORMAT_TRAITS(Format_ayuv, VFT_YUV, 1,
+                       AK_COMPONENT(0, 4, 1, 0, 1, 8, 0, 0),
+                       AK_COMPONENT(0, 4, 2, 0, 1, 8, 0, 0),
+                       AK_COMPONENT(0, 4, 3, 0, 1, 8, 0, 0),
+                       AK_COMPONENT(0, 4, 0, 0, 1, 8, 0, 0))
+AK_VIDEO_FORMAT_TRAITS(Format_vuya, VFT_YUV, 1,
+                       AK_COMPONENT(0, 4, 2, 0, 1, 8, 0, 0),
+                       AK_COMPONENT(0, 4, 1, 0, 1, 8, 0, 0),
+                       AK_COMPONENT(0, 4, 0, 0, 1, 8, 0, 0),
+                       AK_COMPONENT(0, 4, 3, 0, 1, 8, 0, 0))
+AK_VIDEO_FORMAT_TRAITS(Format_y8, VFT_Gray, 1,
+                       AK_COMPONENT(0, 1, 0, 0, 1, 8, 0, 0),
+                       AK_NO_COMPONENT,
+                       AK_NO_COMPONENT,
+                       AK_NO_COMPONENT)
+AK_VIDEO_FORMAT_TRAITS(Format_ya88, VFT_Gray, 1,
+                       AK_COMPONENT(0, 2, 0, 0, 1, 8, 0, 0),
+                       AK_NO_COMPONENT,
+                       AK_NO_COMPONENT,
+                       AK_COMPONENT(0, 2, 1, 0, 1, 8, 0, 0))
+AK_VIDEO_FORMAT_TRAITS(Format_ay88, VFT_Gray, 1,
+                       AK_COMPONENT(0, 2, 1, 0, 1, 8, 0, 0),
+                       AK_NO_COMPONENT,
+                       AK_NO_COMPONENT,
+                       AK_COMPONENT(0, 2, 0, 0, 1, 8, 0, 0))
+AK_VIDEO_FORMAT_TRAITS(Format_yuv420p, VFT_YUV, 3,
+                       AK_COMPONENT(0, 1, 0, 0, 1, 8, 0, 0),
+                       AK_COMPONENT(1, 1, 0, 0, 1, 8, 1, 1),
+                       AK_COMPONENT(2, 1, 0, 0, 1, 8, 1, 1),
+                       AK_NO_COMPONENT)
+
+#undef AK_NO_COMPONENT
+#undef AK_COMPONENT
+#undef AK_VIDEO_FORMAT_TRAITS
+
+#define AK_VIDEO_FORMAT_DISPATCH(format) \
+    case AkVideoCaps::format: \
+        if (!AkVideoFormatTraits<AkVideoCaps::format>::isValid()) \
+            return false; \
+        \
+        func(AkVideoFormatTraits<AkVideoCaps::format>()); \
+        \
+        return true;
+
+/* Calls func with an AkVideoFormatTraits instance matching format, and
+ * returns true, or returns false if there are no traits for the format, or
+ * if they don't agree with the formats table, so the caller can fall back
+ * to a generic implementation.
+ */
+template <typename Func>
+inline bool akVideoFormatDispatch(AkVideoCaps::PixelFormat format, Func &&func)
+{
+    switch (format) {
+    AK_VIDEO_FORMAT_DISPATCH(Format_argb)
+    AK_VIDEO_FORMAT_DISPATCH(Format_bgra)
+    AK_VIDEO_FORMAT_DISPATCH(Format_ayuv)
+    AK_VIDEO_FORMAT_DISPATCH(Format_vuya)
+    AK_VIDEO_FORMAT_DISPATCH(Format_y8)
+    AK_VIDEO_FORMAT_DISPATCH(Format_ya88)
+    AK_VIDEO_FORMAT_DISPATCH(Format_ay88)
+    AK_VIDEO_FORMAT_DISPATCH(Format_yuv420p)
+    default:
+        break;
+    }
+
+    return false;
+}
+
+#undef AK_VIDEO_FORMAT_DISPATCH
+
+#endif // AKVIDEOFORMATTRAITS_H
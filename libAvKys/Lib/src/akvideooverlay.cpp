@@ -0,0 +1,290 @@
+/* Webcamoid, camera capture application.
+ * Copyright (C) 2026  Gonzalo Exequiel Pedone
+ *
+ * Webcamoid is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Webcamoid is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Webcamoid. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Web-Site: http://webcamoid.github.io/
+ */
+
+#include <QVector>
+
+#include "akvideooverlay.h"
+#include "akcolorplane.h"
+#include "akvideocaps.h"
+#include "akvideoconverter.h"
+#include "akvideoformatspec.h"
+#include "akvideopacket.h"
+
+struct AkVideoOverlaySpan
+{
+    int y;
+    int x;
+    int width;
+    bool opaque;
+};
+
+class AkVideoOverlayPrivate
+{
+    public:
+        AkVideoPacket m_overlay;
+        AkVideoConverter m_videoConverter;
+
+        // Prepared overlay, in the format of the frames.
+        AkVideoCaps m_maskCaps;
+        AkVideoPacket m_mask;
+        QVector<quint8> m_invAlpha;
+        QVector<AkVideoOverlaySpan> m_spans;
+        int m_pixelSize {0};
+        int m_alphaOffset {0};
+        bool m_isValid {false};
+
+        bool prepare(const AkVideoCaps &caps);
+        void blendSpan(const quint8 *mask,
+                       const quint8 *invAlpha,
+                       quint8 *dst,
+                       int width) const;
+
+        // Fast rounded division by 255, valid for value <= 255 * 255.
+        inline static quint16 div255(quint16 value)
+        {
+            value += 128;
+
+            return quint16((value + (value >> 8)) >> 8);
+        }
+};
+
+AkVideoOverlay::AkVideoOverlay()
+{
+    this->d = new AkVideoOverlayPrivate();
+}
+
+AkVideoOverlay::AkVideoOverlay(const AkVideoOverlay &other)
+{
+    this->d = new AkVideoOverlayPrivate();
+    this->d->m_overlay = other.d->m_overlay;
+}
+
+AkVideoOverlay::~AkVideoOverlay()
+{
+    delete this->d;
+}
+
+AkVideoOverlay &AkVideoOverlay::operator =(const AkVideoOverlay &other)
+{
+    if (this != &other)
+        this->setOverlay(other.d->m_overlay);
+
+    return *this;
+}
+
+AkVideoPacket AkVideoOverlay::overlay() const
+{
+    return this->d->m_overlay;
+}
+
+void AkVideoOverlay::setOverlay(const AkVideoPacket &overlay)
+{
+    this->d->m_overlay = overlay;
+    this->d->m_maskCaps = AkVideoCaps();
+    this->d->m_mask = AkVideoPacket();
+    this->d->m_invAlpha.clear();
+    this->d->m_spans.clear();
+    this->d->m_isValid = false;
+}
+
+bool AkVideoOverlay::draw(AkVideoPacket &frame)
+{
+    if (!frame || !this->d->m_overlay)
+        return false;
+
+    if (!this->d->m_maskCaps.isSameFormat(frame.caps())) {
+        this->d->m_maskCaps = frame.caps();
+        this->d->m_isValid = this->d->prepare(frame.caps());
+    }
+
+    if (!this->d->m_isValid)
+        return false;
+
+    auto pixelSize = this->d->m_pixelSize;
+    auto alphaOffset = this->d->m_alphaOffset;
+    size_t invAlphaLineSize = size_t(frame.caps().width()) * pixelSize;
+
+    for (auto &span: this->d->m_spans) {
+        size_t offset = size_t(span.x) * pixelSize;
+        size_t size = size_t(span.width) * pixelSize;
+        auto mask = this->d->m_mask.constLine(0, span.y) + offset;
+        auto dst = frame.line(0, span.y) + offset;
+
+        if (span.opaque) {
+            memcpy(dst, mask, size);
+
+            continue;
+        }
+
+        // The frames are usually opaque, blend them with a plain loop over
+        // the bytes that the compiler can vectorize.
+        quint8 dstAlpha = 255;
+
+        for (int x = 0; x < span.width; x++)
+            dstAlpha &= dst[x * pixelSize + alphaOffset];
+
+        auto invAlpha = this->d->m_invAlpha.constData()
+                      + size_t(span.y) * invAlphaLineSize
+                      + offset;
+
+        if (dstAlpha == 255) {
+            for (size_t i = 0; i < size; i++)
+                dst[i] = quint8(mask[i]
+                                + AkVideoOverlayPrivate::div255(quint16(dst[i] * invAlpha[i])));
+        } else {
+            this->d->blendSpan(mask, invAlpha, dst, span.width);
+        }
+    }
+
+    return true;
+}
+
+bool AkVideoOverlayPrivate::prepare(const AkVideoCaps &caps)
+{
+    this->m_mask = AkVideoPacket();
+    this->m_invAlpha.clear();
+    this->m_spans.clear();
+
+    if (caps.width() != this->m_overlay.caps().width()
+        || caps.height() != this->m_overlay.caps().height())
+        return false;
+
+    // Only 8 bits packed formats with alpha are supported.
+    auto specs = AkVideoCaps::formatSpecs(caps.format());
+
+    if (specs.planes() != 1 || !specs.contains(AkColorComponent::CT_A))
+        return false;
+
+    auto &plane = specs.plane(0);
+    auto nComponents = int(plane.components());
+
+    for (int i = 0; i < nComponents; i++) {
+        auto &component = plane.component(size_t(i));
+
+        if (component.byteDepth() != 1
+            || component.depth() != 8
+            || component.shift() != 0
+            || component.step() != size_t(nComponents)
+            || component.widthDiv() != 0
+            || component.heightDiv() != 0)
+            return false;
+    }
+
+    this->m_pixelSize = nComponents;
+    this->m_alphaOffset = int(specs.component(AkColorComponent::CT_A).offset());
+
+    this->m_videoConverter.setOutputCaps(caps);
+    this->m_videoConverter.begin();
+    auto mask = this->m_videoConverter.convert(this->m_overlay);
+    this->m_videoConverter.end();
+
+    if (!mask)
+        return false;
+
+    // Premultiply the colors, and build the inverse alpha, repeated for
+    // each byte of the pixel, and the spans list.
+    int width = caps.width();
+    int height = caps.height();
+    auto pixelSize = this->m_pixelSize;
+    auto alphaOffset = this->m_alphaOffset;
+    size_t invAlphaLineSize = size_t(width) * pixelSize;
+    this->m_invAlpha.resize(int(invAlphaLineSize * height));
+
+    for (int y = 0; y < height; y++) {
+        auto line = mask.line(0, y);
+        auto invAlpha = this->m_invAlpha.data() + size_t(y) * invAlphaLineSize;
+        int spanStart = 0;
+        int spanType = -1;
+
+        for (int x = 0; x <= width; x++) {
+            // 0: transparent, 1: opaque, 2: translucent.
+            int type = 0;
+
+            if (x < width) {
+                auto pixel = line + size_t(x) * pixelSize;
+                auto alpha = pixel[alphaOffset];
+
+                for (int c = 0; c < pixelSize; c++) {
+                    if (c != alphaOffset)
+                        pixel[c] = quint8(div255(quint16(pixel[c] * alpha)));
+
+                    invAlpha[size_t(x) * pixelSize + c] = 255 - alpha;
+                }
+
+                type = alpha == 0? 0: alpha == 255? 1: 2;
+            }
+
+            if (type == spanType)
+                continue;
+
+            if (spanType > 0)
+                this->m_spans << AkVideoOverlaySpan {y,
+                                                     spanStart,
+                                                     x - spanStart,
+                                                     spanType == 1};
+
+            spanStart = x;
+            spanType = type;
+        }
+    }
+
+    this->m_mask = mask;
+
+    return true;
+}
+
+void AkVideoOverlayPrivate::blendSpan(const quint8 *mask,
+                                      const quint8 *invAlpha,
+                                      quint8 *dst,
+                                      int width) const
+{
+    auto pixelSize = this->m_pixelSize;
+    auto alphaOffset = this->m_alphaOffset;
+
+    for (int x = 0; x < width; x++) {
+        auto maskPixel = mask + size_t(x) * pixelSize;
+        auto dstPixel = dst + size_t(x) * pixelSize;
+        int ai = maskPixel[alphaOffset];
+        int ao = dstPixel[alphaOffset];
+        int ia = invAlpha[size_t(x) * pixelSize];
+
+        // Resulting alpha, and the weight of the destination in 255^2
+        // units.
+        int aoWeight = ao * ia;
+        int a = ai + div255(quint16(aoWeight));
+
+        if (a < 1) {
+            memset(dstPixel, 0, size_t(pixelSize));
+
+            continue;
+        }
+
+        for (int c = 0; c < pixelSize; c++) {
+            if (c == alphaOffset)
+                continue;
+
+            qint64 num = 255 * 255 * qint64(maskPixel[c])
+                       + qint64(aoWeight) * dstPixel[c];
+            qint64 den = 255 * qint64(a);
+            dstPixel[c] = quint8(qMin<qint64>((num + den / 2) / den, 255));
+        }
+
+        dstPixel[alphaOffset] = quint8(a);
+    }
+}
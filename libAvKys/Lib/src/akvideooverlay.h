@@ -0,0 +1,63 @@
+/* Webcamoid, camera capture application.
+ * Copyright (C) 2026  Gonzalo Exequiel Pedone
+ *
+ * Webcamoid is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Webcamoid is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Webcamoid. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Web-Site: http://webcamoid.github.io/
+ */
+
+#ifndef AKVIDEOOVERLAY_H
+#define AKVIDEOOVERLAY_H
+
+#include "akcommons.h"
+
+class AkVideoOverlayPrivate;
+class AkVideoPacket;
+
+/* Compositor for constant overlays, like masks, bars or frames, drawn over
+ * every frame of a stream.
+ *
+ * The overlay is converted once to the format of the frames and stored
+ * with premultiplied alpha, together with the list of the spans of each
+ * line that are fully opaque or partially transparent. Fully transparent
+ * pixels are never visited, opaque spans are copied, and only the rest is
+ * blended, so the cost is proportional to the visible area of the overlay.
+ *
+ * The frames must be in an 8 bits packed format with alpha, like
+ * Format_argbpack or Format_ayuvpack, and have the same size as the
+ * overlay.
+ */
+class AKCOMMONS_EXPORT AkVideoOverlay
+{
+    public:
+        AkVideoOverlay();
+        AkVideoOverlay(const AkVideoOverlay &other);
+        ~AkVideoOverlay();
+        AkVideoOverlay &operator =(const AkVideoOverlay &other);
+
+        AkVideoPacket overlay() const;
+
+        // Sets the overlay, with straight (non premultiplied) alpha.
+        void setOverlay(const AkVideoPacket &overlay);
+
+        // Draws the overlay over the frame. Returns false if the frame
+        // format or size are not supported, the frame is not modified in
+        // that case.
+        bool draw(AkVideoPacket &frame);
+
+    private:
+        AkVideoOverlayPrivate *d;
+};
+
+#endif // AKVIDEOOVERLAY_H
@@ -17,6 +17,8 @@
  * Web-Site: http://webcamoid.github.io/
  */
 
+#include <atomic>
+#include <numeric>
 #include <QDebug>
 #include <QVariant>
 #include <QImage>
@@ -111,11 +113,31 @@ class FillParameters
 
 using FillParametersPtr = QSharedPointer<FillParameters>;
 
+/* Holds the memory of the frame, either a buffer allocated by the packet or
+ * a foreign one, so it can be shared by the views and foreign packet copies.
+ */
+class AkVideoPacketBuffer
+{
+    public:
+        AkVideoPacket::ReleaseCallback m_release {nullptr};
+        void *m_opaque {nullptr};
+        std::atomic<int> m_views {0};
+
+        AkVideoPacketBuffer(AkVideoPacket::ReleaseCallback release,
+                                   void *opaque);
+        ~AkVideoPacketBuffer();
+};
+
+using AkVideoPacketBufferPtr = QSharedPointer<AkVideoPacketBuffer>;
+
 class AkVideoPacketPrivate
 {
     public:
         AkVideoCaps m_caps;
+        AkVideoPacketBufferPtr m_buffer;
         quint8 *m_data {nullptr};
+        bool m_ownsData {false};
+        bool m_isView {false};
         size_t m_dataSize {0};
         size_t m_nPlanes {0};
         quint8 *m_planes[MAX_PLANES];
@@ -131,6 +153,11 @@ class AkVideoPacketPrivate
 
         void updateParams(const AkVideoFormatSpec &specs);
         inline void updatePlanes();
+        void copyData(const AkVideoPacketPrivate *other);
+        void releaseData();
+        inline void detach();
+        void allocateData(size_t size, size_t align);
+        static void freeData(void *data);
 
         /* Fill functions */
 
@@ -403,8 +430,7 @@ AkVideoPacket::AkVideoPacket(const AkVideoCaps &caps, bool initialized):
     this->d->updateParams(specs);
 
     if (this->d->m_dataSize > 0) {
-            this->d->m_data =
-                    AkSimd::amallocT<quint8>(this->d->m_dataSize, this->d->m_align);
+            this->d->allocateData(this->d->m_dataSize, this->d->m_align);
 
             if (initialized)
                 memset(this->d->m_data, 0, this->d->m_dataSize);
@@ -413,6 +439,38 @@ AkVideoPacket::AkVideoPacket(const AkVideoCaps &caps, bool initialized):
     this->d->updatePlanes();
 }
 
+AkVideoPacket::AkVideoPacket(const AkVideoCaps &caps,
+                             quint8 *const *planes,
+                             const size_t *lineSizes,
+                             size_t dataSize,
+                             ReleaseCallback release,
+                             void *opaque):
+    AkPacketBase()
+{
+    this->d = new AkVideoPacketPrivate;
+    this->d->m_caps = caps;
+    this->d->m_align = AkSimd::preferredAlign();
+    auto specs = AkVideoCaps::formatSpecs(this->d->m_caps.format());
+    this->d->m_nPlanes = specs.planes();
+    this->d->updateParams(specs);
+    this->d->m_buffer =
+            AkVideoPacketBufferPtr::create(release, opaque);
+
+    /* The memory is not ours, so just point the planes to the external buffer
+     * and respect its strides.
+     */
+    for (size_t i = 0; i < this->d->m_nPlanes; ++i) {
+        this->d->m_planes[i] = planes[i];
+        this->d->m_lineSize[i] = lineSizes[i];
+        this->d->m_planeSize[i] =
+                (lineSizes[i] * this->d->m_caps.height()) >> this->d->m_heightDiv[i];
+        this->d->m_planeOffset[i] = 0;
+    }
+
+    this->d->m_data = this->d->m_nPlanes > 0? planes[0]: nullptr;
+    this->d->m_dataSize = dataSize;
+}
+
 AkVideoPacket::AkVideoPacket(const AkPacket &other):
     AkPacketBase(other)
 {
@@ -421,13 +479,7 @@ AkVideoPacket::AkVideoPacket(const AkPacket &other):
     if (other.type() == AkPacket::PacketVideo) {
         auto data = reinterpret_cast<AkVideoPacket *>(other.privateData());
         this->d->m_caps = data->d->m_caps;
-
-        if (data->d->m_data && data->d->m_dataSize > 0) {
-                this->d->m_data =
-                        AkSimd::amallocT<quint8>(data->d->m_dataSize, data->d->m_align);
-                memcpy(this->d->m_data, data->d->m_data, data->d->m_dataSize);
-        }
-
+        this->d->copyData(data->d);
         this->d->m_dataSize = data->d->m_dataSize;
         this->d->m_nPlanes = data->d->m_nPlanes;
 
@@ -453,13 +505,7 @@ AkVideoPacket::AkVideoPacket(const AkVideoPacket &other):
 {
     this->d = new AkVideoPacketPrivate;
     this->d->m_caps = other.d->m_caps;
-
-    if (other.d->m_data && other.d->m_dataSize > 0) {
-        this->d->m_data =
-                AkSimd::amallocT<quint8>(other.d->m_dataSize, other.d->m_align);
-        memcpy(this->d->m_data, other.d->m_data, other.d->m_dataSize);
-    }
-
+    this->d->copyData(other.d);
     this->d->m_dataSize = other.d->m_dataSize;
     this->d->m_nPlanes = other.d->m_nPlanes;
 
@@ -481,9 +527,7 @@ AkVideoPacket::AkVideoPacket(const AkVideoPacket &other):
 
 AkVideoPacket::~AkVideoPacket()
 {
-    if (this->d->m_data)
-        AkSimd::afree(this->d->m_data);
-
+    this->d->releaseData();
     delete this->d;
 }
 
@@ -492,17 +536,8 @@ AkVideoPacket &AkVideoPacket::operator =(const AkPacket &other)
     if (other.type() == AkPacket::PacketVideo) {
         auto data = reinterpret_cast<AkVideoPacket *>(other.privateData());
         this->d->m_caps = data->d->m_caps;
-
-        if (this->d->m_data) {
-            AkSimd::afree(this->d->m_data);
-            this->d->m_data = nullptr;
-        }
-
-        if (data->d->m_data && data->d->m_dataSize > 0) {
-            this->d->m_data =
-                    AkSimd::amallocT<quint8>(data->d->m_dataSize, data->d->m_align);
-            memcpy(this->d->m_data, data->d->m_data, data->d->m_dataSize);
-        }
+        this->d->releaseData();
+        this->d->copyData(data->d);
 
         this->d->m_dataSize = data->d->m_dataSize;
         this->d->m_nPlanes = data->d->m_nPlanes;
@@ -523,11 +558,7 @@ AkVideoPacket &AkVideoPacket::operator =(const AkPacket &other)
         this->d->updatePlanes();
     } else {
         this->d->m_caps = AkVideoCaps();
-
-        if (this->d->m_data) {
-            AkSimd::afree(this->d->m_data);
-            this->d->m_data = nullptr;
-        }
+        this->d->releaseData();
 
         this->d->m_dataSize = 0;
         this->d->m_nPlanes = 0;
@@ -543,17 +574,8 @@ AkVideoPacket &AkVideoPacket::operator =(const AkVideoPacket &other)
 {
     if (this != &other) {
         this->d->m_caps = other.d->m_caps;
-
-        if (this->d->m_data) {
-            AkSimd::afree(this->d->m_data);
-            this->d->m_data = nullptr;
-        }
-
-        if (other.d->m_data && other.d->m_dataSize > 0) {
-            this->d->m_data =
-                    AkSimd::amallocT<quint8>(other.d->m_dataSize, other.d->m_align);
-            memcpy(this->d->m_data, other.d->m_data, other.d->m_dataSize);
-        }
+        this->d->releaseData();
+        this->d->copyData(other.d);
 
         this->d->m_dataSize = other.d->m_dataSize;
         this->d->m_nPlanes = other.d->m_nPlanes;
@@ -650,6 +672,8 @@ const char *AkVideoPacket::constData() const
 
 char *AkVideoPacket::data()
 {
+    this->d->detach();
+
     return reinterpret_cast<char *>(this->d->m_data);
 }
 
@@ -660,6 +684,8 @@ const quint8 *AkVideoPacket::constPlane(int plane) const
 
 quint8 *AkVideoPacket::plane(int plane)
 {
+    this->d->detach();
+
     return this->d->m_planes[plane];
 }
 
@@ -672,6 +698,8 @@ const quint8 *AkVideoPacket::constLine(int plane, int y) const
 
 quint8 *AkVideoPacket::line(int plane, int y)
 {
+    this->d->detach();
+
     return this->d->m_planes[plane]
             + size_t(y >> this->d->m_heightDiv[plane])
             * this->d->m_lineSize[plane];
@@ -717,8 +745,126 @@ AkVideoPacket AkVideoPacket::copy(int x, int y, int width, int height) const
     return dst;
 }
 
+AkVideoPacket AkVideoPacket::view(int x, int y, int width, int height) const
+{
+    if (!this->d->m_caps || this->d->m_nPlanes < 1)
+        return {};
+
+    auto specs = AkVideoCaps::formatSpecs(this->d->m_caps.format());
+
+    /* The region must start in a pixel that begins a whole pixel block in
+     * every plane (packed pixels like in YUYV, or sub-sampled chroma), else
+     * the plane offsets would fall in the middle of a sample.
+     */
+    size_t alignX = 1;
+    size_t alignY = 1;
+
+    for (size_t i = 0; i < this->d->m_nPlanes; ++i) {
+        auto &plane = specs.plane(i);
+        size_t pixelBits = 8 * plane.pixelSize();
+        size_t blockWidth =
+                pixelBits / std::gcd(plane.bitsSize(), pixelBits);
+        alignX = std::lcm(alignX, blockWidth);
+        alignX = std::lcm(alignX, size_t(1) << plane.widthDiv());
+        alignY = qMax(alignY, size_t(1) << plane.heightDiv());
+    }
+
+    x = int(size_t(qMax(x, 0)) / alignX * alignX);
+    y = int(size_t(qMax(y, 0)) / alignY * alignY);
+    width = qMin(width, this->d->m_caps.width() - x);
+    height = qMin(height, this->d->m_caps.height() - y);
+
+    if (width < 1 || height < 1)
+        return {};
+
+    if (!this->d->m_buffer)
+        return {};
+
+    auto caps = this->d->m_caps;
+    caps.setWidth(width);
+    caps.setHeight(height);
+
+    AkVideoPacket dst;
+    dst.d->m_caps = caps;
+    dst.d->m_align = this->d->m_align;
+    dst.d->m_nPlanes = this->d->m_nPlanes;
+    dst.d->updateParams(specs);
+    dst.d->m_buffer = this->d->m_buffer;
+    dst.d->m_isView = true;
+    dst.d->m_buffer->m_views++;
+
+    for (size_t i = 0; i < this->d->m_nPlanes; ++i) {
+        // x is snapped to a whole pixel block, so this is exact.
+        size_t offset = size_t(x) * specs.plane(i).bitsSize() / 8;
+        size_t heightDiv = dst.d->m_heightDiv[i];
+        size_t lines = (size_t(height) + (size_t(1) << heightDiv) - 1) >> heightDiv;
+        dst.d->m_planes[i] = this->d->m_planes[i]
+                              + size_t(y >> heightDiv)
+                              * this->d->m_lineSize[i]
+                              + offset;
+        dst.d->m_lineSize[i] = this->d->m_lineSize[i];
+
+        // Only count from the first pixel to the last pixel of the region.
+        dst.d->m_planeSize[i] =
+                (lines - 1) * dst.d->m_lineSize[i] + dst.d->m_bytesUsed[i];
+        dst.d->m_planeOffset[i] = 0;
+    }
+
+    /* constData() and size() span from the first byte of the region to its
+     * last byte, lines of the parent included, as long as all planes are in
+     * the same block of the parent. Else they only cover the first plane.
+     */
+    auto parentBegin = this->d->m_data;
+    auto parentEnd = this->d->m_data + this->d->m_dataSize;
+    auto begin = dst.d->m_planes[0];
+    auto end = begin + dst.d->m_planeSize[0];
+    bool contiguous = true;
+
+    for (size_t i = 0; i < dst.d->m_nPlanes; ++i) {
+        auto planeBegin = dst.d->m_planes[i];
+        auto planeEnd = planeBegin + dst.d->m_planeSize[i];
+
+        if (planeBegin < parentBegin || planeEnd > parentEnd) {
+            contiguous = false;
+
+            break;
+        }
+
+        begin = qMin(begin, planeBegin);
+        end = qMax(end, planeEnd);
+    }
+
+    if (!contiguous) {
+        begin = dst.d->m_planes[0];
+        end = begin + dst.d->m_planeSize[0];
+    }
+
+    dst.d->m_data = begin;
+    dst.d->m_dataSize = size_t(end - begin);
+    dst.copyMetadata(*this);
+
+    return dst;
+}
+
+AkVideoPacket AkVideoPacket::view(const QRect &rect) const
+{
+    return this->view(rect.x(), rect.y(), rect.width(), rect.height());
+}
+
+bool AkVideoPacket::isForeign() const
+{
+    return this->d->m_buffer && !this->d->m_ownsData;
+}
+
+void AkVideoPacket::detach()
+{
+    this->d->detach();
+}
+
 void AkVideoPacket::fillRgb(QRgb color)
 {
+    this->d->detach();
+
     return this->d->fill(color);
 }
 
@@ -809,10 +955,115 @@ void AkVideoPacketPrivate::updateParams(const AkVideoFormatSpec &specs)
 
 void AkVideoPacketPrivate::updatePlanes()
 {
+    // Foreign planes are set when the buffer is adopted.
+    if (this->m_buffer && !this->m_ownsData)
+        return;
+
     for (int i = 0; i < this->m_nPlanes; ++i)
         this->m_planes[i] = this->m_data + this->m_planeOffset[i];
 }
 
+void AkVideoPacketPrivate::copyData(const AkVideoPacketPrivate *other)
+{
+    // Foreign buffers and views are read-only, so all copies can share them.
+    if (other->m_buffer && !other->m_ownsData) {
+        this->m_buffer = other->m_buffer;
+        this->m_isView = other->m_isView;
+
+        if (this->m_isView)
+            this->m_buffer->m_views++;
+
+        this->m_data = other->m_data;
+        memcpy(this->m_planes, other->m_planes, MAX_PLANES * sizeof(quint8 *));
+
+        return;
+    }
+
+    if (other->m_data && other->m_dataSize > 0) {
+        this->allocateData(other->m_dataSize, other->m_align);
+        memcpy(this->m_data, other->m_data, other->m_dataSize);
+    }
+}
+
+void AkVideoPacketPrivate::releaseData()
+{
+    if (this->m_isView)
+        this->m_buffer->m_views--;
+
+    this->m_buffer.clear();
+    this->m_data = nullptr;
+    this->m_ownsData = false;
+    this->m_isView = false;
+}
+
+void AkVideoPacketPrivate::detach()
+{
+    if (!this->m_buffer)
+        return;
+
+    // Our own buffer can be written in place while no view is reading it.
+    if (this->m_ownsData && this->m_buffer->m_views < 1)
+        return;
+
+    quint8 *planes[MAX_PLANES];
+    size_t lineSizes[MAX_PLANES];
+    memcpy(planes, this->m_planes, MAX_PLANES * sizeof(quint8 *));
+    memcpy(lineSizes, this->m_lineSize, MAX_PLANES * sizeof(size_t));
+
+    // Keep the old buffer alive until the frame is copied.
+    auto buffer = this->m_buffer;
+    this->releaseData();
+
+    // Recalculate the layout as if the packet was allocated by us.
+    auto specs = AkVideoCaps::formatSpecs(this->m_caps.format());
+    this->updateParams(specs);
+
+    if (this->m_dataSize > 0)
+        this->allocateData(this->m_dataSize, this->m_align);
+
+    for (size_t i = 0; i < this->m_nPlanes; ++i) {
+        auto srcLine = planes[i];
+        auto dstLine = this->m_data + this->m_planeOffset[i];
+        auto copyBytes = this->m_bytesUsed[i];
+        auto height = this->m_caps.height() >> this->m_heightDiv[i];
+
+        for (int y = 0; y < height; ++y) {
+            memcpy(dstLine, srcLine, copyBytes);
+            srcLine += lineSizes[i];
+            dstLine += this->m_lineSize[i];
+        }
+    }
+
+    this->updatePlanes();
+}
+
+void AkVideoPacketPrivate::allocateData(size_t size, size_t align)
+{
+    this->m_data = AkSimd::amallocT<quint8>(size, align);
+    this->m_buffer =
+            AkVideoPacketBufferPtr::create(AkVideoPacketPrivate::freeData,
+                                           this->m_data);
+    this->m_ownsData = true;
+}
+
+void AkVideoPacketPrivate::freeData(void *data)
+{
+    AkSimd::afree(data);
+}
+
+AkVideoPacketBuffer::AkVideoPacketBuffer(AkVideoPacket::ReleaseCallback release,
+                                                       void *opaque):
+    m_release(release),
+    m_opaque(opaque)
+{
+}
+
+AkVideoPacketBuffer::~AkVideoPacketBuffer()
+{
+    if (this->m_release)
+        this->m_release(this->m_opaque);
+}
+
 #define DEFINE_FILL_FUNC(size) \
     case FillDataTypes_##size: \
         this->fill<quint##size>(*this->m_fc, color); \
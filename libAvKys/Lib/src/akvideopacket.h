@@ -21,6 +21,7 @@
 #define AKVIDEOPACKET_H
 
 #include <qrgb.h>
+#include <QRect>
 
 #include "akpacketbase.h"
 #include "akvideocaps.h"
@@ -77,8 +78,26 @@ class AKCOMMONS_EXPORT AkVideoPacket: public AkPacketBase
                CONSTANT)
 
     public:
+        using ReleaseCallback = void (*)(void *opaque);
+
         AkVideoPacket(QObject *parent=nullptr);
         AkVideoPacket(const AkVideoCaps &caps, bool initialized=false);
+
+        /* Wrap an externally owned buffer (GstBuffer, pw_buffer, uvc_frame,
+         * etc.) without copying it. 'release' is called with 'opaque' once the
+         * last packet sharing the buffer is destroyed or detached.
+         *
+         * Copies of the packet share the foreign buffer, which is considered
+         * read-only. Any of the writable accessors (data(), plane(), line(),
+         * fillRgb()) or an explicit call to detach() will copy the frame to
+         * memory owned by the packet first.
+         */
+        AkVideoPacket(const AkVideoCaps &caps,
+                      quint8 *const *planes,
+                      const size_t *lineSizes,
+                      size_t dataSize,
+                      ReleaseCallback release,
+                      void *opaque);
         AkVideoPacket(const AkPacket &other);
         AkVideoPacket(const AkVideoPacket &other);
         ~AkVideoPacket();
@@ -107,6 +126,28 @@ class AKCOMMONS_EXPORT AkVideoPacket: public AkPacketBase
                                        int width,
                                        int height) const;
 
+        /* Returns a packet that shares the frame buffer, reading only the
+         * given region of it, without copying anything. The origin of the
+         * region is moved down to the nearest pixel that starts a whole
+         * chroma block, and the region is clipped to the frame.
+         *
+         * Like foreign packets, views are read-only, writing to them copies
+         * the region to a buffer of its own first. Writing to the packet while
+         * a view is alive also copies the frame, so the views keep reading
+         * the original one.
+         *
+         * The lines of a view keep the strides of the frame, so the pixels
+         * must be read through the planes and lines. constData() and size()
+         * cover the bytes from the first to the last pixel of the region.
+         */
+        Q_INVOKABLE AkVideoPacket view(int x,
+                                       int y,
+                                       int width,
+                                       int height) const;
+        Q_INVOKABLE AkVideoPacket view(const QRect &rect) const;
+        Q_INVOKABLE bool isForeign() const;
+        Q_INVOKABLE void detach();
+
         template <typename T>
         inline T pixel(int plane, int x, int y) const
         {
@@ -0,0 +1,710 @@
+/* Webcamoid, camera capture application.
+ * Copyright (C) 2026  Gonzalo Exequiel Pedone
+ *
+ * Webcamoid is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Webcamoid is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Webcamoid. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Web-Site: http://webcamoid.github.io/
+ */
+
+#include <QSemaphore>
+#include <QThreadPool>
+
+#include "akvideowarp.h"
+#include "akcolorplane.h"
+#include "akvideocaps.h"
+#include "akvideoformatspec.h"
+#include "akvideopacket.h"
+
+// Minimum number of lines per band.
+#define MIN_BAND_LINES 16
+
+// Size of the blocks copied by the transpositions, in pixels.
+#define ORIENT_BLOCK_SIZE 16
+
+/* The effects warp the frames from threads of the global pool, so the bands
+ * can't be queued there, waiting for them would deadlock once all threads of
+ * the global pool are waiting for its own queued jobs.
+ */
+Q_GLOBAL_STATIC(QThreadPool, akVideoWarpThreadPool)
+
+template<int N>
+struct AkVideoWarpPixel
+{
+    quint8 data[N];
+};
+
+struct AkVideoWarpFrame
+{
+    const quint8 *src;
+    size_t srcLineSize;
+    int srcWidth;
+    int srcHeight;
+    quint8 *dst;
+    size_t dstLineSize;
+    int dstWidth;
+    int dstHeight;
+};
+
+class AkVideoWarpPrivate
+{
+    public:
+        qint64 m_matrix[6] {1, 0, 0, 0, 1, 0};
+        int m_shift {0};
+        AkVideoWarp::Filter m_filter {AkVideoWarp::Filter_Nearest};
+        AkVideoWarp::BorderMode m_borderMode {AkVideoWarp::BorderMode_Transparent};
+
+        static bool isSupported(const AkVideoCaps &caps,
+                                int *pixelSize,
+                                bool *is8Bits);
+        static inline qint64 floorDiv(qint64 a, qint64 b);
+        static void solveSpan(qint64 u,
+                              qint64 du,
+                              qint64 maxU,
+                              int &xStart,
+                              int &xEnd);
+        template<int N>
+        void warpLine(const AkVideoWarpFrame &frame,
+                      int y,
+                      bool bilinear) const;
+        template<int N>
+        void warpEdge(const AkVideoWarpFrame &frame,
+                      AkVideoWarpPixel<N> *oLine,
+                      qint64 u0,
+                      qint64 v0,
+                      int xStart,
+                      int xEnd,
+                      bool inside,
+                      bool bilinear) const;
+        template<int N>
+        static void orientBand(const AkVideoWarpFrame &frame,
+                               const quint8 *origin,
+                               ptrdiff_t xStep,
+                               ptrdiff_t yStep,
+                               bool transposed,
+                               int yStart,
+                               int yEnd);
+
+        // Weight of the next sample, in 8 bits, for a coordinate with
+        // 'shift' fractional bits.
+        inline static int fraction(qint64 u, int shift)
+        {
+            return shift >= 8?
+                        int(u >> (shift - 8)) & 0xff:
+                        int(u * (qint64(1) << (8 - shift))) & 0xff;
+        }
+
+        template<int N>
+        inline static void interpolate(const quint8 *p00,
+                                       const quint8 *p01,
+                                       const quint8 *p10,
+                                       const quint8 *p11,
+                                       int fx,
+                                       int fy,
+                                       quint8 *pixel)
+        {
+            for (int c = 0; c < N; c++) {
+                int top = p00[c] * (256 - fx) + p01[c] * fx;
+                int bottom = p10[c] * (256 - fx) + p11[c] * fx;
+                pixel[c] = quint8((top * (256 - fy) + bottom * fy + 32768) >> 16);
+            }
+        }
+
+        // Calls func(yStart, yEnd) for bands of lines, in parallel.
+        template <typename Func>
+        static void forEachBand(int height, Func func)
+        {
+            auto threadPool = akVideoWarpThreadPool();
+            int threads = qMax(1, threadPool->maxThreadCount());
+            int bands = qBound(1, height / MIN_BAND_LINES, threads);
+            QSemaphore done;
+
+            for (int band = 1; band < bands; band++)
+                threadPool->start([&func, &done, band, bands, height] () {
+                    func(band * height / bands, (band + 1) * height / bands);
+                    done.release();
+                });
+
+            func(0, height / bands);
+            done.acquire(bands - 1);
+        }
+};
+
+AkVideoWarp::AkVideoWarp()
+{
+    this->d = new AkVideoWarpPrivate();
+}
+
+AkVideoWarp::AkVideoWarp(const AkVideoWarp &other)
+{
+    this->d = new AkVideoWarpPrivate();
+    *this->d = *other.d;
+}
+
+AkVideoWarp::~AkVideoWarp()
+{
+    delete this->d;
+}
+
+AkVideoWarp &AkVideoWarp::operator =(const AkVideoWarp &other)
+{
+    if (this != &other)
+        *this->d = *other.d;
+
+    return *this;
+}
+
+AkVideoWarp::Filter AkVideoWarp::filter() const
+{
+    return this->d->m_filter;
+}
+
+AkVideoWarp::BorderMode AkVideoWarp::borderMode() const
+{
+    return this->d->m_borderMode;
+}
+
+const qint64 *AkVideoWarp::matrix() const
+{
+    return this->d->m_matrix;
+}
+
+int AkVideoWarp::shift() const
+{
+    return this->d->m_shift;
+}
+
+void AkVideoWarp::setFilter(Filter filter)
+{
+    this->d->m_filter = filter;
+}
+
+void AkVideoWarp::setBorderMode(BorderMode borderMode)
+{
+    this->d->m_borderMode = borderMode;
+}
+
+void AkVideoWarp::setMatrix(const qint64 *matrix, int shift)
+{
+    memcpy(this->d->m_matrix, matrix, 6 * sizeof(qint64));
+    this->d->m_shift = qBound(0, shift, 30);
+}
+
+void AkVideoWarp::resetFilter()
+{
+    this->setFilter(Filter_Nearest);
+}
+
+void AkVideoWarp::resetBorderMode()
+{
+    this->setBorderMode(BorderMode_Transparent);
+}
+
+void AkVideoWarp::resetMatrix()
+{
+    static const qint64 matrix[] {
+        1, 0, 0,
+        0, 1, 0
+    };
+
+    this->setMatrix(matrix, 0);
+}
+
+bool AkVideoWarp::warp(const AkVideoPacket &src, AkVideoPacket &dst) const
+{
+    if (!src || !dst || src.caps().format() != dst.caps().format())
+        return false;
+
+    int pixelSize = 0;
+    bool is8Bits = false;
+
+    if (!AkVideoWarpPrivate::isSupported(src.caps(), &pixelSize, &is8Bits))
+        return false;
+
+    AkVideoWarpFrame frame {
+        src.constPlane(0),
+        src.lineSize(0),
+        src.caps().width(),
+        src.caps().height(),
+        dst.plane(0),
+        dst.lineSize(0),
+        dst.caps().width(),
+        dst.caps().height()
+    };
+    bool bilinear = this->d->m_filter == Filter_Bilinear && is8Bits;
+
+    AkVideoWarpPrivate::forEachBand(frame.dstHeight,
+                                    [this, &frame, pixelSize, bilinear] (int yStart, int yEnd) {
+        for (int y = yStart; y < yEnd; y++)
+            switch (pixelSize) {
+            case 1:
+                this->d->warpLine<1>(frame, y, bilinear);
+                break;
+            case 2:
+                this->d->warpLine<2>(frame, y, bilinear);
+                break;
+            case 3:
+                this->d->warpLine<3>(frame, y, bilinear);
+                break;
+            case 4:
+                this->d->warpLine<4>(frame, y, bilinear);
+                break;
+            case 6:
+                this->d->warpLine<6>(frame, y, bilinear);
+                break;
+            default:
+                this->d->warpLine<8>(frame, y, bilinear);
+                break;
+            }
+    });
+
+    return true;
+}
+
+AkVideoCaps AkVideoWarp::orientedCaps(const AkVideoCaps &caps,
+                                      Orientation orientation)
+{
+    auto oCaps = caps;
+
+    switch (orientation) {
+    case Orientation_Rotate90:
+    case Orientation_Rotate270:
+    case Orientation_Transpose:
+    case Orientation_Transverse:
+        oCaps.setWidth(caps.height());
+        oCaps.setHeight(caps.width());
+        break;
+    default:
+        break;
+    }
+
+    return oCaps;
+}
+
+AkVideoPacket AkVideoWarp::orient(const AkVideoPacket &src,
+                                  Orientation orientation)
+{
+    if (!src)
+        return {};
+
+    if (orientation == Orientation_None)
+        return src;
+
+    int pixelSize = 0;
+
+    if (!AkVideoWarpPrivate::isSupported(src.caps(), &pixelSize, nullptr))
+        return {};
+
+    AkVideoPacket dst(AkVideoWarp::orientedCaps(src.caps(), orientation));
+    dst.copyMetadata(src);
+
+    AkVideoWarpFrame frame {
+        src.constPlane(0),
+        src.lineSize(0),
+        src.caps().width(),
+        src.caps().height(),
+        dst.plane(0),
+        dst.lineSize(0),
+        dst.caps().width(),
+        dst.caps().height()
+    };
+
+    /* Each output pixel (x, y) is read from origin + x * xStep + y * yStep,
+     * in bytes.
+     */
+    auto ps = ptrdiff_t(pixelSize);
+    auto ls = ptrdiff_t(frame.srcLineSize);
+    auto right = ps * (frame.srcWidth - 1);
+    auto bottom = ls * (frame.srcHeight - 1);
+    ptrdiff_t offset = 0;
+    ptrdiff_t xStep = ps;
+    ptrdiff_t yStep = ls;
+    bool transposed = false;
+
+    switch (orientation) {
+    case Orientation_Rotate90:
+        offset = bottom;
+        xStep = -ls;
+        yStep = ps;
+        transposed = true;
+        break;
+    case Orientation_Rotate180:
+        offset = bottom + right;
+        xStep = -ps;
+        yStep = -ls;
+        break;
+    case Orientation_Rotate270:
+        offset = right;
+        xStep = ls;
+        yStep = -ps;
+        transposed = true;
+        break;
+    case Orientation_FlipHorizontal:
+        offset = right;
+        xStep = -ps;
+        yStep = ls;
+        break;
+    case Orientation_FlipVertical:
+        offset = bottom;
+        xStep = ps;
+        yStep = -ls;
+        break;
+    case Orientation_Transpose:
+        xStep = ls;
+        yStep = ps;
+        transposed = true;
+        break;
+    case Orientation_Transverse:
+        offset = bottom + right;
+        xStep = -ls;
+        yStep = -ps;
+        transposed = true;
+        break;
+    default:
+        break;
+    }
+
+    auto origin = frame.src + offset;
+
+    AkVideoWarpPrivate::forEachBand(frame.dstHeight,
+                                    [&frame,
+                                     origin,
+                                     xStep,
+                                     yStep,
+                                     transposed,
+                                     pixelSize] (int yStart, int yEnd) {
+        switch (pixelSize) {
+        case 1:
+            AkVideoWarpPrivate::orientBand<1>(frame, origin, xStep, yStep, transposed, yStart, yEnd);
+            break;
+        case 2:
+            AkVideoWarpPrivate::orientBand<2>(frame, origin, xStep, yStep, transposed, yStart, yEnd);
+            break;
+        case 3:
+            AkVideoWarpPrivate::orientBand<3>(frame, origin, xStep, yStep, transposed, yStart, yEnd);
+            break;
+        case 4:
+            AkVideoWarpPrivate::orientBand<4>(frame, origin, xStep, yStep, transposed, yStart, yEnd);
+            break;
+        case 6:
+            AkVideoWarpPrivate::orientBand<6>(frame, origin, xStep, yStep, transposed, yStart, yEnd);
+            break;
+        default:
+            AkVideoWarpPrivate::orientBand<8>(frame, origin, xStep, yStep, transposed, yStart, yEnd);
+            break;
+        }
+    });
+
+    return dst;
+}
+
+bool AkVideoWarpPrivate::isSupported(const AkVideoCaps &caps,
+                                     int *pixelSize,
+                                     bool *is8Bits)
+{
+    auto specs = AkVideoCaps::formatSpecs(caps.format());
+
+    if (specs.planes() != 1)
+        return false;
+
+    auto &plane = specs.plane(0);
+    auto size = int(plane.pixelSize());
+
+    if (size != 1
+        && size != 2
+        && size != 3
+        && size != 4
+        && size != 6
+        && size != 8)
+        return false;
+
+    bool plain8Bits = true;
+
+    for (size_t i = 0; i < plane.components(); i++) {
+        auto &component = plane.component(i);
+
+        if (component.widthDiv() != 0 || component.heightDiv() != 0)
+            return false;
+
+        if (component.byteDepth() != 1
+            || component.depth() != 8
+            || component.shift() != 0)
+            plain8Bits = false;
+    }
+
+    if (pixelSize)
+        *pixelSize = size;
+
+    if (is8Bits)
+        *is8Bits = plain8Bits;
+
+    return true;
+}
+
+qint64 AkVideoWarpPrivate::floorDiv(qint64 a, qint64 b)
+{
+    auto q = a / b;
+
+    return (a % b != 0) && ((a < 0) != (b < 0))? q - 1: q;
+}
+
+void AkVideoWarpPrivate::solveSpan(qint64 u,
+                                   qint64 du,
+                                   qint64 maxU,
+                                   int &xStart,
+                                   int &xEnd)
+{
+    // Narrows [xStart, xEnd) to the x for which 0 <= u + du * x <= maxU.
+    if (du == 0) {
+        if (u < 0 || u > maxU)
+            xEnd = xStart;
+
+        return;
+    }
+
+    qint64 lo = 0;
+    qint64 hi = 0;
+
+    if (du > 0) {
+        lo = -floorDiv(u, du);
+        hi = floorDiv(maxU - u, du);
+    } else {
+        lo = -floorDiv(u - maxU, du);
+        hi = floorDiv(-u, du);
+    }
+
+    lo = qBound<qint64>(xStart, lo, xEnd);
+    hi = qBound<qint64>(lo, hi + 1, xEnd);
+    xStart = int(lo);
+    xEnd = int(hi);
+}
+
+template<int N>
+void AkVideoWarpPrivate::warpLine(const AkVideoWarpFrame &frame,
+                                  int y,
+                                  bool bilinear) const
+{
+    using Pixel = AkVideoWarpPixel<N>;
+
+    auto m = this->m_matrix;
+    auto shift = this->m_shift;
+    int width = frame.dstWidth;
+    auto oLine = reinterpret_cast<Pixel *>(frame.dst + size_t(y) * frame.dstLineSize);
+
+    // Input coordinates at x = 0.
+    qint64 u0 = m[1] * y + m[2];
+    qint64 v0 = m[4] * y + m[5];
+
+    // Span of the line inside the input frame.
+    int insideStart = 0;
+    int insideEnd = width;
+    solveSpan(u0,
+              m[0],
+              (qint64(frame.srcWidth) << shift) - 1,
+              insideStart,
+              insideEnd);
+    solveSpan(v0,
+              m[3],
+              (qint64(frame.srcHeight) << shift) - 1,
+              insideStart,
+              insideEnd);
+
+    // Span where all the samples are inside the input frame, only differs
+    // from the above for bilinear filtering.
+    int fastStart = insideStart;
+    int fastEnd = insideEnd;
+    qint64 half = bilinear? (qint64(1) << shift) >> 1: 0;
+
+    if (bilinear) {
+        solveSpan(u0 - half,
+                  m[0],
+                  (qint64(frame.srcWidth - 1) << shift) - 1,
+                  fastStart,
+                  fastEnd);
+        solveSpan(v0 - half,
+                  m[3],
+                  (qint64(frame.srcHeight - 1) << shift) - 1,
+                  fastStart,
+                  fastEnd);
+
+        if (fastStart >= fastEnd)
+            fastStart = fastEnd = insideEnd;
+    }
+
+    this->warpEdge<N>(frame, oLine, u0, v0, 0, insideStart, false, bilinear);
+    this->warpEdge<N>(frame, oLine, u0, v0, insideStart, fastStart, true, bilinear);
+
+    auto src = frame.src;
+    auto srcLineSize = frame.srcLineSize;
+    qint64 du = m[0];
+    qint64 dv = m[3];
+    qint64 u = u0 + du * fastStart - half;
+    qint64 v = v0 + dv * fastStart - half;
+
+    if (bilinear) {
+        for (int x = fastStart; x < fastEnd; x++) {
+            auto p00 = src
+                     + size_t(v >> shift) * srcLineSize
+                     + size_t(u >> shift) * N;
+            auto p10 = p00 + srcLineSize;
+            interpolate<N>(p00,
+                           p00 + N,
+                           p10,
+                           p10 + N,
+                           fraction(u, shift),
+                           fraction(v, shift),
+                           oLine[x].data);
+            u += du;
+            v += dv;
+        }
+    } else if (dv == 0) {
+        // The whole span is read from a single line.
+        auto iLine = reinterpret_cast<const Pixel *>(src + size_t(v >> shift) * srcLineSize);
+
+        if (du == qint64(1) << shift) {
+            memcpy(oLine + fastStart,
+                   iLine + (u >> shift),
+                   size_t(fastEnd - fastStart) * N);
+        } else {
+            for (int x = fastStart; x < fastEnd; x++) {
+                oLine[x] = iLine[u >> shift];
+                u += du;
+            }
+        }
+    } else {
+        for (int x = fastStart; x < fastEnd; x++) {
+            oLine[x] =
+                *reinterpret_cast<const Pixel *>(src
+                                                 + size_t(v >> shift) * srcLineSize
+                                                 + size_t(u >> shift) * N);
+            u += du;
+            v += dv;
+        }
+    }
+
+    this->warpEdge<N>(frame, oLine, u0, v0, fastEnd, insideEnd, true, bilinear);
+    this->warpEdge<N>(frame, oLine, u0, v0, insideEnd, width, false, bilinear);
+}
+
+template<int N>
+void AkVideoWarpPrivate::warpEdge(const AkVideoWarpFrame &frame,
+                                  AkVideoWarpPixel<N> *oLine,
+                                  qint64 u0,
+                                  qint64 v0,
+                                  int xStart,
+                                  int xEnd,
+                                  bool inside,
+                                  bool bilinear) const
+{
+    if (xStart >= xEnd)
+        return;
+
+    if (!inside && this->m_borderMode == AkVideoWarp::BorderMode_Transparent) {
+        memset(oLine + xStart, 0, size_t(xEnd - xStart) * N);
+
+        return;
+    }
+
+    // Read the samples clamping the coordinates to the input frame.
+    auto m = this->m_matrix;
+    auto shift = this->m_shift;
+    qint64 half = bilinear? (qint64(1) << shift) >> 1: 0;
+    qint64 maxX = frame.srcWidth - 1;
+    qint64 maxY = frame.srcHeight - 1;
+
+    for (int x = xStart; x < xEnd; x++) {
+        qint64 u = u0 + m[0] * x - half;
+        qint64 v = v0 + m[3] * x - half;
+        auto xp = u >> shift;
+        auto yp = v >> shift;
+
+        if (bilinear) {
+            auto x0 = size_t(qBound<qint64>(0, xp, maxX)) * N;
+            auto x1 = size_t(qBound<qint64>(0, xp + 1, maxX)) * N;
+            auto line0 = frame.src
+                       + size_t(qBound<qint64>(0, yp, maxY)) * frame.srcLineSize;
+            auto line1 = frame.src
+                       + size_t(qBound<qint64>(0, yp + 1, maxY)) * frame.srcLineSize;
+            interpolate<N>(line0 + x0,
+                           line0 + x1,
+                           line1 + x0,
+                           line1 + x1,
+                           fraction(u, shift),
+                           fraction(v, shift),
+                           oLine[x].data);
+        } else {
+            xp = qBound<qint64>(0, xp, maxX);
+            yp = qBound<qint64>(0, yp, maxY);
+            oLine[x] =
+                *reinterpret_cast<const AkVideoWarpPixel<N> *>(frame.src
+                                                               + size_t(yp) * frame.srcLineSize
+                                                               + size_t(xp) * N);
+        }
+    }
+}
+
+template<int N>
+void AkVideoWarpPrivate::orientBand(const AkVideoWarpFrame &frame,
+                                    const quint8 *origin,
+                                    ptrdiff_t xStep,
+                                    ptrdiff_t yStep,
+                                    bool transposed,
+                                    int yStart,
+                                    int yEnd)
+{
+    using Pixel = AkVideoWarpPixel<N>;
+
+    int width = frame.dstWidth;
+
+    if (!transposed) {
+        for (int y = yStart; y < yEnd; y++) {
+            auto iLine = origin + ptrdiff_t(y) * yStep;
+            auto oLine = reinterpret_cast<Pixel *>(frame.dst + size_t(y) * frame.dstLineSize);
+
+            if (xStep == N) {
+                memcpy(oLine, iLine, size_t(width) * N);
+            } else {
+                auto iPixel = reinterpret_cast<const Pixel *>(iLine);
+
+                for (int x = 0; x < width; x++)
+                    oLine[x] = *(iPixel - x);
+            }
+        }
+
+        return;
+    }
+
+    /* The input is read along its columns, copy in blocks so the lines of
+     * the input block are still cached when the next output line reads
+     * them.
+     */
+    for (int by = yStart; by < yEnd; by += ORIENT_BLOCK_SIZE) {
+        int byEnd = qMin(by + ORIENT_BLOCK_SIZE, yEnd);
+
+        for (int bx = 0; bx < width; bx += ORIENT_BLOCK_SIZE) {
+            int bxEnd = qMin(bx + ORIENT_BLOCK_SIZE, width);
+
+            for (int y = by; y < byEnd; y++) {
+                auto iPixel = origin
+                            + ptrdiff_t(y) * yStep
+                            + ptrdiff_t(bx) * xStep;
+                auto oLine = reinterpret_cast<Pixel *>(frame.dst + size_t(y) * frame.dstLineSize);
+
+                for (int x = bx; x < bxEnd; x++) {
+                    oLine[x] = *reinterpret_cast<const Pixel *>(iPixel);
+                    iPixel += xStep;
+                }
+            }
+        }
+    }
+}
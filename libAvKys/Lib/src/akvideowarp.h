@@ -0,0 +1,111 @@
+/* Webcamoid, camera capture application.
+ * Copyright (C) 2026  Gonzalo Exequiel Pedone
+ *
+ * Webcamoid is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Webcamoid is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Webcamoid. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Web-Site: http://webcamoid.github.io/
+ */
+
+#ifndef AKVIDEOWARP_H
+#define AKVIDEOWARP_H
+
+#include "akcommons.h"
+
+class AkVideoWarpPrivate;
+class AkVideoCaps;
+class AkVideoPacket;
+
+/* Affine warp of video frames, shared by the geometric effects.
+ *
+ * The transform is given as the inverse mapping, in fixed point: the output
+ * pixel (x, y) is read from the input pixel
+ *
+ *     xp = (m[0] * x + m[1] * y + m[2]) >> shift
+ *     yp = (m[3] * x + m[4] * y + m[5]) >> shift
+ *
+ * The coordinates are stepped incrementally along each line, and the span
+ * of the line that falls inside the input frame is solved beforehand, so
+ * the inner loops don't check bounds. The lines are split into bands that
+ * run in parallel.
+ *
+ * Quarter turns and flips don't need any arithmetic at all, orient()
+ * copies them in blocks, so both the input and the output stay in cache.
+ *
+ * The frames must have a single plane without subsampling. Bilinear
+ * filtering is only applied to formats with 8 bits components, nearest
+ * neighbour is used for the rest.
+ */
+class AKCOMMONS_EXPORT AkVideoWarp
+{
+    public:
+        enum Filter
+        {
+            Filter_Nearest,
+            Filter_Bilinear
+        };
+
+        enum BorderMode
+        {
+            // Pixels outside the input frame are transparent black.
+            BorderMode_Transparent,
+
+            // Pixels outside the input frame repeat the nearest edge.
+            BorderMode_Clamp
+        };
+
+        enum Orientation
+        {
+            Orientation_None,
+            Orientation_Rotate90,   // Clockwise
+            Orientation_Rotate180,
+            Orientation_Rotate270,  // Clockwise
+            Orientation_FlipHorizontal,
+            Orientation_FlipVertical,
+            Orientation_Transpose,  // Flip over the main diagonal
+            Orientation_Transverse  // Flip over the secondary diagonal
+        };
+
+        AkVideoWarp();
+        AkVideoWarp(const AkVideoWarp &other);
+        ~AkVideoWarp();
+        AkVideoWarp &operator =(const AkVideoWarp &other);
+
+        Filter filter() const;
+        BorderMode borderMode() const;
+        const qint64 *matrix() const;
+        int shift() const;
+
+        void setFilter(Filter filter);
+        void setBorderMode(BorderMode borderMode);
+        void setMatrix(const qint64 *matrix, int shift);
+        void resetFilter();
+        void resetBorderMode();
+        void resetMatrix();
+
+        // Warps src into dst, dst must be already allocated with the output
+        // size and the same format of src.
+        bool warp(const AkVideoPacket &src, AkVideoPacket &dst) const;
+
+        // Caps of the oriented frame, width and height are swapped for
+        // quarter turns and transpositions.
+        static AkVideoCaps orientedCaps(const AkVideoCaps &caps,
+                                        Orientation orientation);
+        static AkVideoPacket orient(const AkVideoPacket &src,
+                                    Orientation orientation);
+
+    private:
+        AkVideoWarpPrivate *d;
+};
+
+#endif // AKVIDEOWARP_H
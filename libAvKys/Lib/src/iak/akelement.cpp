@@ -19,6 +19,7 @@
 
 #include <QDataStream>
 #include <QDebug>
+#include <QMap>
 #include <QMetaMethod>
 #include <QQmlComponent>
 #include <QQmlContext>
@@ -26,7 +27,9 @@
 #include <QRegularExpression>
 
 #include "akelement.h"
+#include "../akelementprofiler.h"
 #include "../akpacket.h"
+#include "../aktracer.h"
 #include "../akaudiopacket.h"
 #include "../akvideopacket.h"
 #include "../akcompressedaudiopacket.h"
@@ -36,8 +39,11 @@ class AkElementPrivate
 {
     public:
         AkElement::ElementState m_state {AkElement::ElementStateNull};
+        AkVideoCaps::PixelFormat m_preferredVideoFormat {AkVideoCaps::Format_none};
+        AkElementProfilerCounters *m_profilerCounters {nullptr};
 
         AkElementPrivate();
+        static AkPacket dispatch(AkElement *element, const AkPacket &packet);
         static QList<QMetaMethod> methodsByName(const QObject *object,
                                                 const QString &methodName);
         static bool methodCompat(const QMetaMethod &method1,
@@ -48,19 +54,41 @@ AkElement::AkElement(QObject *parent):
     QObject(parent)
 {
     this->d = new AkElementPrivate();
+    this->d->m_profilerCounters = AkElementProfiler::registerElement(this);
 }
 
 AkElement::~AkElement()
 {
     this->setState(AkElement::ElementStateNull);
+    AkElementProfiler::unregisterElement(this);
     delete this->d;
 }
 
+AkElementProfilerCounters *AkElement::profilerCounters() const
+{
+    return this->d->m_profilerCounters;
+}
+
 AkElement::ElementState AkElement::state() const
 {
     return this->d->m_state;
 }
 
+AkVideoCaps::PixelFormatList AkElement::videoInputFormats() const
+{
+    return {};
+}
+
+AkVideoCaps::PixelFormatList AkElement::videoOutputFormats() const
+{
+    return {};
+}
+
+AkVideoCaps::PixelFormat AkElement::preferredVideoFormat() const
+{
+    return this->d->m_preferredVideoFormat;
+}
+
 QObject *AkElement::controlInterface(QQmlEngine *engine,
                                      const QString &controlId) const
 {
@@ -193,6 +221,81 @@ bool AkElement::unlink(const QObject *srcElement, const QObject *dstElement)
     return true;
 }
 
+AkVideoCaps::PixelFormat AkElement::negotiateVideoFormats(const QList<AkElementPtr> &elements)
+{
+    if (elements.isEmpty())
+        return AkVideoCaps::Format_none;
+
+    struct Node
+    {
+        int cost;
+        AkVideoCaps::PixelFormat prevFormat;
+        AkVideoCaps::PixelFormat inputFormat;
+    };
+
+    // nodes[i] maps the format leaving the element i to the cheapest way of
+    // reaching it. The chain starts with an unknown format.
+    QVector<QMap<AkVideoCaps::PixelFormat, Node>> nodes;
+    QMap<AkVideoCaps::PixelFormat, Node> prevNodes {
+        {AkVideoCaps::Format_none, {0, AkVideoCaps::Format_none, AkVideoCaps::Format_none}}
+    };
+
+    for (auto &element: elements) {
+        QMap<AkVideoCaps::PixelFormat, Node> curNodes;
+        auto inputs = element? element->videoInputFormats(): AkVideoCaps::PixelFormatList {};
+        auto outputs = element? element->videoOutputFormats(): AkVideoCaps::PixelFormatList {};
+
+        for (auto it = prevNodes.begin(); it != prevNodes.end(); it++) {
+            auto candidates = inputs.isEmpty()?
+                                  AkVideoCaps::PixelFormatList {it.key()}:
+                                  inputs;
+
+            for (auto &input: candidates) {
+                int cost = it.value().cost
+                           + AkVideoCaps::conversionCost(it.key(), input);
+                auto produced = outputs.isEmpty()?
+                                    AkVideoCaps::PixelFormatList {input}:
+                                    outputs;
+
+                for (auto &output: produced) {
+                    auto node = curNodes.find(output);
+
+                    if (node == curNodes.end() || cost < node->cost)
+                        curNodes[output] = {cost, it.key(), input};
+                }
+            }
+        }
+
+        nodes << curNodes;
+        prevNodes = curNodes;
+    }
+
+    // Pick the cheapest end point and walk back the chain.
+    auto best = prevNodes.begin();
+
+    for (auto it = prevNodes.begin(); it != prevNodes.end(); it++)
+        if (it->cost < best->cost)
+            best = it;
+
+    auto format = best.key();
+    auto inputFormat = AkVideoCaps::Format_none;
+
+    for (auto i = elements.size() - 1; i >= 0; i--) {
+        auto node = nodes[i].value(format);
+
+        if (i == elements.size() - 1 && elements[i])
+            elements[i]->resetPreferredVideoFormat();
+
+        if (i > 0 && elements[i - 1])
+            elements[i - 1]->setPreferredVideoFormat(node.inputFormat);
+
+        inputFormat = node.inputFormat;
+        format = node.prevFormat;
+    }
+
+    return inputFormat;
+}
+
 QString AkElement::controlInterfaceProvide(const QString &controlId) const
 {
     Q_UNUSED(controlId)
@@ -237,20 +340,20 @@ AkPacket AkElement::iCompressedVideoStream(const AkCompressedVideoPacket &packet
 
 AkPacket AkElement::iStream(const AkPacket &packet)
 {
-    switch (packet.type()) {
-    case AkPacket::PacketAudio:
-        return this->iAudioStream(packet);
-    case AkPacket::PacketVideo:
-        return this->iVideoStream(packet);
-    case AkPacket::PacketAudioCompressed:
-        return this->iCompressedAudioStream(packet);
-    case AkPacket::PacketVideoCompressed:
-        return this->iCompressedVideoStream(packet);
-    default:
-        break;
+    AkTraceScope traceScope("element",
+                            this->metaObject()->className(),
+                            packet.id(),
+                            packet.pts());
+
+    if (AkElementProfiler::isEnabled()) {
+        AkElementProfilerScope profilerScope(this->d->m_profilerCounters,
+                                             this,
+                                             packet);
+
+        return AkElementPrivate::dispatch(this, packet);
     }
 
-    return {};
+    return AkElementPrivate::dispatch(this, packet);
 }
 
 bool AkElement::setState(AkElement::ElementState state)
@@ -269,6 +372,20 @@ void AkElement::resetState()
     this->setState(ElementStateNull);
 }
 
+void AkElement::setPreferredVideoFormat(AkVideoCaps::PixelFormat format)
+{
+    if (this->d->m_preferredVideoFormat == format)
+        return;
+
+    this->d->m_preferredVideoFormat = format;
+    emit this->preferredVideoFormatChanged(format);
+}
+
+void AkElement::resetPreferredVideoFormat()
+{
+    this->setPreferredVideoFormat(AkVideoCaps::Format_none);
+}
+
 void AkElement::registerTypes()
 {
     qRegisterMetaType<AkElementPtr>("AkElementPtr");
@@ -287,6 +404,24 @@ AkElementPrivate::AkElementPrivate()
 {
 }
 
+AkPacket AkElementPrivate::dispatch(AkElement *element, const AkPacket &packet)
+{
+    switch (packet.type()) {
+    case AkPacket::PacketAudio:
+        return element->iAudioStream(packet);
+    case AkPacket::PacketVideo:
+        return element->iVideoStream(packet);
+    case AkPacket::PacketAudioCompressed:
+        return element->iCompressedAudioStream(packet);
+    case AkPacket::PacketVideoCompressed:
+        return element->iCompressedVideoStream(packet);
+    default:
+        break;
+    }
+
+    return {};
+}
+
 QList<QMetaMethod> AkElementPrivate::methodsByName(const QObject *object,
                                                    const QString &methodName)
 {
@@ -23,9 +23,11 @@
 #include <QObject>
 
 #include "../akcommons.h"
+#include "../akvideocaps.h"
 
 class AkElement;
 class AkElementPrivate;
+class AkElementProfilerCounters;
 class AkPacket;
 class AkAudioPacket;
 class AkVideoPacket;
@@ -45,6 +47,11 @@ class AKCOMMONS_EXPORT AkElement: public QObject
                WRITE setState
                RESET resetState
                NOTIFY stateChanged)
+    Q_PROPERTY(AkVideoCaps::PixelFormat preferredVideoFormat
+               READ preferredVideoFormat
+               WRITE setPreferredVideoFormat
+               RESET resetPreferredVideoFormat
+               NOTIFY preferredVideoFormatChanged)
 
     public:
         enum ElementState
@@ -59,6 +66,18 @@ class AKCOMMONS_EXPORT AkElement: public QObject
         virtual ~AkElement();
 
         Q_INVOKABLE virtual AkElement::ElementState state() const;
+
+        // Pixel formats the element processes without converting, an empty
+        // list means that any format is accepted as is.
+        Q_INVOKABLE virtual AkVideoCaps::PixelFormatList videoInputFormats() const;
+
+        // Pixel formats the element can produce, an empty list means that
+        // the output has the same format as the input.
+        Q_INVOKABLE virtual AkVideoCaps::PixelFormatList videoOutputFormats() const;
+
+        // Output format requested by the downstream element, Format_none if
+        // there is no preference.
+        Q_INVOKABLE AkVideoCaps::PixelFormat preferredVideoFormat() const;
         Q_INVOKABLE virtual QObject *controlInterface(QQmlEngine *engine,
                                                       const QString &controlId) const;
 
@@ -87,6 +106,16 @@ class AKCOMMONS_EXPORT AkElement: public QObject
         Q_INVOKABLE static bool unlink(const QObject *srcElement,
                                        const QObject *dstElement);
 
+        // Choose the formats exchanged between the elements of a linear
+        // chain so that the total conversion cost is minimal, and set the
+        // preferred output format of each element accordingly.
+        // Returns the format that the first element wants to receive, so it
+        // can be requested to the source feeding the chain.
+        Q_INVOKABLE static AkVideoCaps::PixelFormat negotiateVideoFormats(const QList<AkElementPtr> &elements);
+
+        // The profiler counters of this element, valid while it lives.
+        AkElementProfilerCounters *profilerCounters() const;
+
     private:
         AkElementPrivate *d;
 
@@ -101,13 +130,18 @@ class AKCOMMONS_EXPORT AkElement: public QObject
 
     Q_SIGNALS:
         void stateChanged(AkElement::ElementState state);
+        void preferredVideoFormatChanged(AkVideoCaps::PixelFormat format);
         void oStream(const AkPacket &packet);
 
     public Q_SLOTS:
         virtual AkPacket iStream(const AkPacket &packet);
         virtual bool setState(AkElement::ElementState state);
         virtual void resetState();
+        void setPreferredVideoFormat(AkVideoCaps::PixelFormat format);
+        void resetPreferredVideoFormat();
         static void registerTypes();
+
+    friend class AkElementPrivate;
 };
 
 AKCOMMONS_EXPORT QDataStream &operator >>(QDataStream &istream, AkElement::ElementState &state);
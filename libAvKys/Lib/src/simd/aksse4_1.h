@@ -25,6 +25,10 @@
 
 #define AKSIMDSSE4_1I32_DEFAULT_SIZE 4
 #define AKSIMDSSE4_1I32_ALIGN        16
+#define AKSIMDSSE4_1I16_DEFAULT_SIZE 8
+#define AKSIMDSSE4_1I16_ALIGN        16
+#define AKSIMDSSE4_1I8_DEFAULT_SIZE  16
+#define AKSIMDSSE4_1I8_ALIGN         16
 
 class AkSimdSSE4_1I32
 {
@@ -72,12 +76,12 @@ class AkSimdSSE4_1I32
 
         inline VectorType mul(VectorType a, VectorType b) const
         {
-            return _mm_mul_epi32(a, b);
+            return _mm_mullo_epi32(a, b);
         }
 
         inline VectorType mul(VectorType a, NativeType b) const
         {
-            return _mm_mul_epi32(a, _mm_set1_epi32(b));
+            return _mm_mullo_epi32(a, _mm_set1_epi32(b));
         }
 
         inline VectorType div(VectorType a, VectorType b) const
@@ -134,4 +138,224 @@ class AkSimdSSE4_1I32
         }
 };
 
+class AkSimdSSE4_1I16
+{
+    public:
+        using VectorType = __m128i;
+        using NativeType = qint16;
+
+        inline AkSimdSSE4_1I16()
+        {
+        }
+
+        inline size_t size() const
+        {
+            return AKSIMDSSE4_1I16_DEFAULT_SIZE;
+        }
+
+        inline static void end()
+        {
+        }
+
+        inline VectorType load(const NativeType *data) const
+        {
+            return _mm_load_si128(reinterpret_cast<const VectorType *>(data));
+        }
+
+        inline VectorType load(NativeType value) const
+        {
+            return _mm_set1_epi16(value);
+        }
+
+        inline void store(NativeType *data, VectorType vec) const
+        {
+            _mm_store_si128(reinterpret_cast<VectorType *>(data), vec);
+        }
+
+        inline VectorType add(VectorType a, VectorType b) const
+        {
+            return _mm_add_epi16(a, b);
+        }
+
+        inline VectorType sub(VectorType a, VectorType b) const
+        {
+            return _mm_sub_epi16(a, b);
+        }
+
+        inline VectorType mul(VectorType a, VectorType b) const
+        {
+            return _mm_mullo_epi16(a, b);
+        }
+
+        // High 16 bits of the 32 bits product.
+        inline VectorType mulhi(VectorType a, VectorType b) const
+        {
+            return _mm_mulhi_epi16(a, b);
+        }
+
+        // Q15 product, (a * b + 0x4000) >> 15.
+        inline VectorType mulhrs(VectorType a, VectorType b) const
+        {
+            return _mm_mulhrs_epi16(a, b);
+        }
+
+        // Multiply the lanes and add the adjacent pairs, the result is an
+        // AkSimdSSE4_1I32 vector, so no precision is lost.
+        inline VectorType madd(VectorType a, VectorType b) const
+        {
+            return _mm_madd_epi16(a, b);
+        }
+
+        inline VectorType shr(VectorType a, size_t shift) const
+        {
+            return _mm_srai_epi16(a, static_cast<int>(shift));
+        }
+
+        // Logical shifts, the lanes are taken as unsigned.
+        inline VectorType shrl(VectorType a, size_t shift) const
+        {
+            return _mm_srli_epi16(a, static_cast<int>(shift));
+        }
+
+        inline VectorType shl(VectorType a, size_t shift) const
+        {
+            return _mm_slli_epi16(a, static_cast<int>(shift));
+        }
+
+        inline VectorType bitAnd(VectorType a, VectorType b) const
+        {
+            return _mm_and_si128(a, b);
+        }
+
+        inline VectorType bitOr(VectorType a, VectorType b) const
+        {
+            return _mm_or_si128(a, b);
+        }
+
+        inline VectorType bitXor(VectorType a, VectorType b) const
+        {
+            return _mm_xor_si128(a, b);
+        }
+
+        inline VectorType min(VectorType a, VectorType b) const
+        {
+            return _mm_min_epi16(a, b);
+        }
+
+        inline VectorType max(VectorType a, VectorType b) const
+        {
+            return _mm_max_epi16(a, b);
+        }
+
+        inline VectorType bound(VectorType min, VectorType a, VectorType max) const
+        {
+            return this->max(min, this->min(a, max));
+        }
+
+        // Interleave the lanes of a and b.
+        inline VectorType unpackLow(VectorType a, VectorType b) const
+        {
+            return _mm_unpacklo_epi16(a, b);
+        }
+
+        inline VectorType unpackHigh(VectorType a, VectorType b) const
+        {
+            return _mm_unpackhi_epi16(a, b);
+        }
+
+        // Saturate two AkSimdSSE4_1I32 vectors into one 16 bits vector.
+        inline VectorType pack(VectorType low, VectorType high) const
+        {
+            return _mm_packs_epi32(low, high);
+        }
+
+        // Same as pack, but the lanes are saturated to [0, 65535].
+        inline VectorType packu(VectorType low, VectorType high) const
+        {
+            return _mm_packus_epi32(low, high);
+        }
+};
+
+class AkSimdSSE4_1I8
+{
+    public:
+        using VectorType = __m128i;
+        using NativeType = quint8;
+
+        inline AkSimdSSE4_1I8()
+        {
+        }
+
+        inline size_t size() const
+        {
+            return AKSIMDSSE4_1I8_DEFAULT_SIZE;
+        }
+
+        inline static void end()
+        {
+        }
+
+        inline VectorType load(const NativeType *data) const
+        {
+            return _mm_load_si128(reinterpret_cast<const VectorType *>(data));
+        }
+
+        inline VectorType load(NativeType value) const
+        {
+            return _mm_set1_epi8(static_cast<char>(value));
+        }
+
+        // Image lines are not guaranteed to be aligned.
+        inline VectorType loadu(const NativeType *data) const
+        {
+            return _mm_loadu_si128(reinterpret_cast<const VectorType *>(data));
+        }
+
+        inline void store(NativeType *data, VectorType vec) const
+        {
+            _mm_store_si128(reinterpret_cast<VectorType *>(data), vec);
+        }
+
+        inline void storeu(NativeType *data, VectorType vec) const
+        {
+            _mm_storeu_si128(reinterpret_cast<VectorType *>(data), vec);
+        }
+
+        inline VectorType bitOr(VectorType a, VectorType b) const
+        {
+            return _mm_or_si128(a, b);
+        }
+
+        // Reorder the bytes of a, lanes of mask with the high bit set
+        // are zeroed.
+        inline VectorType shuffle(VectorType a, VectorType mask) const
+        {
+            return _mm_shuffle_epi8(a, mask);
+        }
+
+        // Take the bytes of b where the high bit of mask is set, and the
+        // bytes of a otherwise.
+        inline VectorType blend(VectorType a, VectorType b, VectorType mask) const
+        {
+            return _mm_blendv_epi8(a, b, mask);
+        }
+
+        // Zero extend the low and high halves to AkSimdSSE4_1I16 vectors.
+        inline VectorType widenLow(VectorType a) const
+        {
+            return _mm_cvtepu8_epi16(a);
+        }
+
+        inline VectorType widenHigh(VectorType a) const
+        {
+            return _mm_unpackhi_epi8(a, _mm_setzero_si128());
+        }
+
+        // Saturate two AkSimdSSE4_1I16 vectors into one 8 bits vector.
+        inline VectorType pack(VectorType low, VectorType high) const
+        {
+            return _mm_packus_epi16(low, high);
+        }
+};
+
 #endif // AKSIMDSSE4_1_H
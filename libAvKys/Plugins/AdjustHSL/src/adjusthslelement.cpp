@@ -68,6 +68,16 @@ int AdjustHSLElement::luminance() const
     return this->d->m_luminance;
 }
 
+AkVideoCaps::PixelFormatList AdjustHSLElement::videoInputFormats() const
+{
+    return {AkVideoCaps::Format_argbpack};
+}
+
+AkVideoCaps::PixelFormatList AdjustHSLElement::videoOutputFormats() const
+{
+    return {AkVideoCaps::Format_argbpack};
+}
+
 QString AdjustHSLElement::controlInterfaceProvide(const QString &controlId) const
 {
     Q_UNUSED(controlId)
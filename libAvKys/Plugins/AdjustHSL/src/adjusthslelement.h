@@ -47,6 +47,8 @@ class AdjustHSLElement: public AkElement
         AdjustHSLElement();
         ~AdjustHSLElement();
 
+        Q_INVOKABLE AkVideoCaps::PixelFormatList videoInputFormats() const override;
+        Q_INVOKABLE AkVideoCaps::PixelFormatList videoOutputFormats() const override;
         Q_INVOKABLE int hue() const;
         Q_INVOKABLE int saturation() const;
         Q_INVOKABLE int luminance() const;
@@ -17,14 +17,19 @@
  * Web-Site: http://webcamoid.github.io/
  */
 
+#include <QFuture>
 #include <QMutex>
 #include <QQmlContext>
-#include <QRandomGenerator>
+#include <QSize>
+#include <QThreadPool>
 #include <QTime>
 #include <QVector>
+#include <QtConcurrent>
 #include <qrgb.h>
 #include <akfrac.h>
+#include <aknoisetexture.h>
 #include <akpacket.h>
+#include <akrandom.h>
 #include <akvideocaps.h>
 #include <akvideoconverter.h>
 #include <akvideopacket.h>
@@ -32,18 +37,36 @@
 #include "agingelement.h"
 #include "scratch.h"
 
+struct ScratchLine
+{
+    int x;
+    int y1;
+    int y2;
+    int luma;
+};
+
 class AgingElementPrivate
 {
     public:
         AkVideoConverter m_videoConverter {{AkVideoCaps::Format_argbpack, 0, 0, {}}};
+        AkVideoPacket m_dst;
+        QSize m_curSize;
         QVector<Scratch> m_scratches;
+        QVector<ScratchLine> m_scratchLines;
         QMutex m_mutex;
+        QThreadPool m_threadPool;
+        AkNoiseTexture m_noise;
+        int m_pitsInterval {0};
+        int m_dustInterval {0};
         bool m_addDust {true};
 
-        AkVideoPacket colorAging(const AkVideoPacket &src);
-        void scratching(AkVideoPacket &dst);
-        void pits(AkVideoPacket &dest);
-        void dusts(AkVideoPacket &dest);
+        void scratching(int width, int height);
+        void agingBand(const AkVideoPacket &src,
+                       int luma,
+                       int yStart,
+                       int yEnd);
+        void pits(AkVideoPacket &dst);
+        void dusts(AkVideoPacket &dst);
 };
 
 AgingElement::AgingElement():
@@ -68,6 +91,16 @@ bool AgingElement::addDust() const
     return this->d->m_addDust;
 }
 
+AkVideoCaps::PixelFormatList AgingElement::videoInputFormats() const
+{
+    return {AkVideoCaps::Format_argbpack};
+}
+
+AkVideoCaps::PixelFormatList AgingElement::videoOutputFormats() const
+{
+    return {AkVideoCaps::Format_argbpack};
+}
+
 QString AgingElement::controlInterfaceProvide(const QString &controlId) const
 {
     Q_UNUSED(controlId)
@@ -93,17 +126,62 @@ AkPacket AgingElement::iVideoStream(const AkVideoPacket &packet)
     if (!src)
         return {};
 
-    auto dst = this->d->colorAging(src);
-    this->d->scratching(dst);
-    this->d->pits(dst);
+    QSize frameSize(src.caps().width(), src.caps().height());
+    this->d->m_mutex.lock();
+
+    // The output frame and the scratches state are kept between frames,
+    // and reset when the resolution changes.
+    if (frameSize != this->d->m_curSize) {
+        this->d->m_curSize = frameSize;
+        this->d->m_dst = AkVideoPacket(src.caps());
+        this->d->m_scratches.fill(Scratch());
+        this->d->m_pitsInterval = 0;
+        this->d->m_dustInterval = 0;
+    }
+
+    this->d->m_dst.copyMetadata(src);
+    this->d->m_noise.configure(frameSize.width(), frameSize.height(), 0, 24);
+    this->d->m_noise.next();
+    this->d->scratching(frameSize.width(), frameSize.height());
+    int luma = AkRandom::local().bounded(-32, -25);
+
+    // Color aging and scratches are applied in a single pass, in bands of
+    // lines.
+    int height = frameSize.height();
+    int threads = qMax(1, this->d->m_threadPool.maxThreadCount());
+    int bandHeight = qMax(1, (height + threads - 1) / threads);
+    QList<QFuture<void>> bands;
+
+    for (int y = 0; y < height; y += bandHeight) {
+        int yEnd = qMin(y + bandHeight, height);
+
+        if (yEnd >= height) {
+            this->d->agingBand(src, luma, y, yEnd);
+
+            break;
+        }
+
+        bands << QtConcurrent::run(&this->d->m_threadPool,
+                                   [this, &src, luma, y, yEnd] () {
+                                       this->d->agingBand(src, luma, y, yEnd);
+                                   });
+    }
+
+    for (auto &band: bands)
+        band.waitForFinished();
+
+    // Pits and dust only touch a few scattered pixels.
+    this->d->pits(this->d->m_dst);
 
     if (this->d->m_addDust)
-        this->d->dusts(dst);
+        this->d->dusts(this->d->m_dst);
+
+    this->d->m_mutex.unlock();
 
-    if (dst)
-        emit this->oStream(dst);
+    if (this->d->m_dst)
+        emit this->oStream(this->d->m_dst);
 
-    return dst;
+    return this->d->m_dst;
 }
 
 void AgingElement::setNScratches(int nScratches)
@@ -136,78 +214,84 @@ void AgingElement::resetAddDust()
     this->setAddDust(true);
 }
 
-AkVideoPacket AgingElementPrivate::colorAging(const AkVideoPacket &src)
-{
-    AkVideoPacket dst(src.caps());
-    dst.copyMetadata(src);
-    int luma = QRandomGenerator::global()->bounded(-32, -25);
-
-    for (int y = 0; y < src.caps().height(); ++y) {
-        auto srcLine = reinterpret_cast<const QRgb *>(src.constLine(0, y));
-        auto dstLine = reinterpret_cast<QRgb *>(dst.line(0, y));
-
-        for (int x = 0; x < src.caps().width(); ++x) {
-            int c = QRandomGenerator::global()->bounded(24);
-            int r = qRed(srcLine[x]) + luma + c;
-            int g = qGreen(srcLine[x]) + luma + c;
-            int b = qBlue(srcLine[x]) + luma + c;
-
-            r = qBound(0, r, 255);
-            g = qBound(0, g, 255);
-            b = qBound(0, b, 255);
-
-            dstLine[x] = qRgba(r, g, b, qAlpha(srcLine[x]));
-        }
-    }
-
-    return dst;
-}
-
-void AgingElementPrivate::scratching(AkVideoPacket &dst)
+void AgingElementPrivate::scratching(int width, int height)
 {
-    QMutexLocker locker(&this->m_mutex);
+    this->m_scratchLines.clear();
 
     for (auto &scratch: this->m_scratches) {
         if (scratch.life() < 1.0) {
-            if (QRandomGenerator::global()->bounded(RAND_MAX) <= 0.06 * RAND_MAX) {
+            if (AkRandom::local().bounded(RAND_MAX) <= 0.06 * RAND_MAX) {
                 scratch = Scratch(2.0, 33.0,
                                   1.0, 1.0,
-                                  0.0, dst.caps().width() - 1,
+                                  0.0, width - 1,
                                   0.0, 512.0,
-                                  0, dst.caps().height() - 1);
+                                  0, height - 1);
             } else {
                 continue;
             }
         }
 
-        if (scratch.x() < 0.0 || scratch.x() >= dst.caps().width()) {
+        if (scratch.x() < 0.0 || scratch.x() >= width) {
             ++scratch;
 
             continue;
         }
 
-        int luma = QRandomGenerator::global()->bounded(32, 40);
+        int luma = AkRandom::local().bounded(32, 40);
         int x = int(scratch.x());
 
         int y1 = scratch.y();
         int y2 = scratch.isAboutToDie()?
-                     QRandomGenerator::global()->bounded(dst.caps().height()):
-                     dst.caps().height();
+                     AkRandom::local().bounded(height):
+                     height;
 
-        for (int y = y1; y < y2; ++y) {
-            auto line = reinterpret_cast<QRgb *>(dst.line(0, y));
-            int r = qRed(line[x]) + luma;
-            int g = qGreen(line[x]) + luma;
-            int b = qBlue(line[x]) + luma;
+        if (y1 < y2)
+            this->m_scratchLines << ScratchLine {x, y1, y2, luma};
+
+        ++scratch;
+    }
+}
+
+void AgingElementPrivate::agingBand(const AkVideoPacket &src,
+                                    int luma,
+                                    int yStart,
+                                    int yEnd)
+{
+    int width = src.caps().width();
+
+    for (int y = yStart; y < yEnd; ++y) {
+        auto srcLine = reinterpret_cast<const QRgb *>(src.constLine(0, y));
+        auto dstLine = reinterpret_cast<QRgb *>(this->m_dst.line(0, y));
+        auto noiseLine = this->m_noise.line(y);
+
+        for (int x = 0; x < width; ++x) {
+            int c = noiseLine[x];
+            int r = qRed(srcLine[x]) + luma + c;
+            int g = qGreen(srcLine[x]) + luma + c;
+            int b = qBlue(srcLine[x]) + luma + c;
 
             r = qBound(0, r, 255);
             g = qBound(0, g, 255);
             b = qBound(0, b, 255);
 
-            line[x] = qRgba(r, g, b, qAlpha(line[x]));
+            dstLine[x] = qRgba(r, g, b, qAlpha(srcLine[x]));
         }
 
-        ++scratch;
+        for (auto &scratch: this->m_scratchLines) {
+            if (y < scratch.y1 || y >= scratch.y2)
+                continue;
+
+            auto &pixel = dstLine[scratch.x];
+            int r = qRed(pixel) + scratch.luma;
+            int g = qGreen(pixel) + scratch.luma;
+            int b = qBlue(pixel) + scratch.luma;
+
+            r = qBound(0, r, 255);
+            g = qBound(0, g, 255);
+            b = qBound(0, b, 255);
+
+            pixel = qRgba(r, g, b, qAlpha(pixel));
+        }
     }
 }
 
@@ -215,24 +299,23 @@ void AgingElementPrivate::pits(AkVideoPacket &dst)
 {
     int pnumscale = qRound(0.03 * qMax(dst.caps().width(),
                                        dst.caps().height()));
-    static int pitsInterval = 0;
-    int pnum = QRandomGenerator::global()->bounded(pnumscale);
+    int pnum = AkRandom::local().bounded(pnumscale);
 
-    if (pitsInterval) {
+    if (this->m_pitsInterval) {
         pnum += pnumscale;
-        pitsInterval--;
-    } else if (QRandomGenerator::global()->bounded(RAND_MAX) <= 0.03 * RAND_MAX) {
-        pitsInterval = QRandomGenerator::global()->bounded(20, 36);
+        this->m_pitsInterval--;
+    } else if (AkRandom::local().bounded(RAND_MAX) <= 0.03 * RAND_MAX) {
+        this->m_pitsInterval = AkRandom::local().bounded(20, 36);
     }
 
     for (int i = 0; i < pnum; ++i) {
-        int x = QRandomGenerator::global()->bounded(dst.caps().width());
-        int y = QRandomGenerator::global()->bounded(dst.caps().height());
-        int size = QRandomGenerator::global()->bounded(16);
+        int x = AkRandom::local().bounded(dst.caps().width());
+        int y = AkRandom::local().bounded(dst.caps().height());
+        int size = AkRandom::local().bounded(16);
 
         for (int j = 0; j < size; ++j) {
-            x += QRandomGenerator::global()->bounded(-1, 2);
-            y += QRandomGenerator::global()->bounded(-1, 2);
+            x += AkRandom::local().bounded(-1, 2);
+            y += AkRandom::local().bounded(-1, 2);
 
             if (x < 0 || x >= dst.caps().width()
                 || y < 0 || y >= dst.caps().height())
@@ -246,28 +329,26 @@ void AgingElementPrivate::pits(AkVideoPacket &dst)
 
 void AgingElementPrivate::dusts(AkVideoPacket &dst)
 {
-    static int dustInterval = 0;
-
-    if (dustInterval == 0) {
-        if (QRandomGenerator::global()->bounded(RAND_MAX) <= 0.03 * RAND_MAX)
-            dustInterval = QRandomGenerator::global()->bounded(8);
+    if (this->m_dustInterval == 0) {
+        if (AkRandom::local().bounded(RAND_MAX) <= 0.03 * RAND_MAX)
+            this->m_dustInterval = AkRandom::local().bounded(8);
 
         return;
     }
 
-    dustInterval--;
+    this->m_dustInterval--;
     int areaScale = qRound(0.02 * qMax(dst.caps().width(),
                                        dst.caps().height()));
-    int dnum = 4 * areaScale + QRandomGenerator::global()->bounded(32);
+    int dnum = 4 * areaScale + AkRandom::local().bounded(32);
 
     for (int i = 0; i < dnum; ++i) {
-        int x = QRandomGenerator::global()->bounded(dst.caps().width());
-        int y = QRandomGenerator::global()->bounded(dst.caps().height());
-        int size = QRandomGenerator::global()->bounded(areaScale) + 5;
+        int x = AkRandom::local().bounded(dst.caps().width());
+        int y = AkRandom::local().bounded(dst.caps().height());
+        int size = AkRandom::local().bounded(areaScale) + 5;
 
         for (int j = 0; j < size; ++j) {
-            x += QRandomGenerator::global()->bounded(-1, 2);
-            y += QRandomGenerator::global()->bounded(-1, 2);
+            x += AkRandom::local().bounded(-1, 2);
+            y += AkRandom::local().bounded(-1, 2);
 
             if (x < 0 || x >= dst.caps().width()
                 || y < 0 || y >= dst.caps().height())
@@ -42,6 +42,8 @@ class AgingElement: public AkElement
         AgingElement();
         ~AgingElement();
 
+        Q_INVOKABLE AkVideoCaps::PixelFormatList videoInputFormats() const override;
+        Q_INVOKABLE AkVideoCaps::PixelFormatList videoOutputFormats() const override;
         Q_INVOKABLE int nScratches() const;
         Q_INVOKABLE bool addDust() const;
 
@@ -18,8 +18,7 @@
  */
 
 #include <cstdlib>
-#include <random>
-#include <QRandomGenerator>
+#include <akrandom.h>
 
 #include "scratch.h"
 
@@ -60,7 +59,7 @@ Scratch::Scratch(qreal minLife, qreal maxLife,
     if (!qIsNull(this->d->m_dx))
         this->d->m_dx = maxDX - minDX;
 
-    this->d->m_y = QRandomGenerator::global()->bounded(minY, maxY);
+    this->d->m_y = AkRandom::local().bounded(minY, maxY);
 }
 
 Scratch::Scratch(const Scratch &other)
@@ -219,7 +218,5 @@ void Scratch::resetY()
 
 qreal ScratchPrivate::boundedReal(qreal min, qreal max)
 {
-    std::uniform_real_distribution<qreal> distribution(min, max);
-
-    return distribution(*QRandomGenerator::global());
+    return AkRandom::local().bounded(min, max);
 }
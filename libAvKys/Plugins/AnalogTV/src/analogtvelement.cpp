@@ -17,13 +17,17 @@
  * Web-Site: http://webcamoid.github.io/
  */
 
+#include <QFuture>
 #include <QQmlContext>
-#include <QRandomGenerator>
 #include <QSize>
+#include <QThreadPool>
+#include <QVector>
+#include <QtConcurrent>
 #include <QtMath>
 #include <qrgb.h>
 #include <akfrac.h>
 #include <akpacket.h>
+#include <akrandom.h>
 #include <akvideocaps.h>
 #include <akvideoconverter.h>
 #include <akvideopacket.h>
@@ -43,25 +47,54 @@ class AnalogTVElementPrivate
         qreal m_sign {1.0};
         QSize m_curSize;
         AkVideoConverter m_videoConverter {{AkVideoCaps::Format_argbpack, 0, 0, {}}};
+        AkVideoPacket m_dst;
+        QVector<quint64> m_lineLuma;
+        QVector<int> m_lumaOffset;
+        QVector<qint64> m_sumLumaOffset;
+        QThreadPool m_threadPool;
         qint64 *m_aiMultTable {nullptr};
         qint64 *m_aoMultTable {nullptr};
         qint64 *m_alphaDivTable {nullptr};
 
-        void createLumaOffset(const AkVideoPacket &src,
-                              qreal factor,
-                              int *lumaOffset) const;
-        void smoothLumaOffset(int *lumaOffset,
-                              int height,
-                              int smoothness) const;
-        AkVideoPacket applyVSync(const AkVideoPacket &src);
-        AkVideoPacket applyHSync(const AkVideoPacket &src,
-                                 const int *lumaOffset,
-                                 int xOffset);
+        void createLumaOffset(const AkVideoPacket &src, qreal factor);
+        void smoothLumaOffset(int height, int smoothness);
+        void updateVSync(int height);
+        void analogTVBand(const AkVideoPacket &src,
+                          int yOffset,
+                          int xOffset,
+                          qreal hueFactor,
+                          qreal noise,
+                          int yStart,
+                          int yEnd);
         inline void rotateHue(QRgb &pixel, int degrees) const;
-        void applyChromaDephasing(AkVideoPacket &src,
-                                  const int *lumaOffset,
-                                  qreal hueFactor) const;
-        void applyNoise(AkVideoPacket &src, qreal persent) const;
+        inline void applyNoise(QRgb *line, int width, qreal persent) const;
+
+        // Calls func(yStart, yEnd) for bands of lines, one per thread.
+        template <typename Func>
+        void forEachBand(int height, Func func)
+        {
+            int threads = qMax(1, this->m_threadPool.maxThreadCount());
+            int bandHeight = qMax(1, (height + threads - 1) / threads);
+            QList<QFuture<void>> bands;
+
+            for (int y = 0; y < height; y += bandHeight) {
+                int yEnd = qMin(y + bandHeight, height);
+
+                if (yEnd >= height) {
+                    func(y, yEnd);
+
+                    break;
+                }
+
+                bands << QtConcurrent::run(&this->m_threadPool,
+                                           [&func, y, yEnd] () {
+                                               func(y, yEnd);
+                                           });
+            }
+
+            for (auto &band: bands)
+                band.waitForFinished();
+        }
 
         template<typename T>
         inline T mod(T value, T mod) const
@@ -129,6 +162,16 @@ qreal AnalogTVElement::noise() const
     return this->d->m_noise;
 }
 
+AkVideoCaps::PixelFormatList AnalogTVElement::videoInputFormats() const
+{
+    return {AkVideoCaps::Format_argbpack};
+}
+
+AkVideoCaps::PixelFormatList AnalogTVElement::videoOutputFormats() const
+{
+    return {AkVideoCaps::Format_argbpack};
+}
+
 QString AnalogTVElement::controlInterfaceProvide(const QString &controlId) const
 {
     Q_UNUSED(controlId)
@@ -156,26 +199,44 @@ AkPacket AnalogTVElement::iVideoStream(const AkVideoPacket &packet)
 
     QSize frameSize(src.caps().width(), src.caps().height());
 
+    // The line buffers and the output frame are kept between frames, and
+    // only reallocated when the resolution changes.
     if (frameSize != this->d->m_curSize) {
         this->d->m_yOffset = 0.0;
         this->d->m_curSize = frameSize;
+        this->d->m_lineLuma.resize(frameSize.height());
+        this->d->m_lumaOffset.resize(frameSize.height());
+        this->d->m_sumLumaOffset.resize(frameSize.height() + 1);
+        this->d->m_dst = AkVideoPacket(src.caps());
     }
 
-    auto lumaOffset = new int [src.caps().height()];
-    this->d->createLumaOffset(src, this->d->m_hsyncFactor, lumaOffset);
-    this->d->smoothLumaOffset(lumaOffset,
-                              src.caps().height(),
+    this->d->createLumaOffset(src, this->d->m_hsyncFactor);
+    this->d->smoothLumaOffset(frameSize.height(),
                               this->d->m_hsyncSmoothness);
-    auto dst = this->d->applyHSync(src, lumaOffset, this->d->m_xOffset);
-    this->d->applyChromaDephasing(dst, lumaOffset, this->d->m_hueFactor);
-    delete [] lumaOffset;
-    this->d->applyNoise(dst, this->d->m_noise);
-    dst = this->d->applyVSync(dst);
-
-    if (dst)
-        emit this->oStream(dst);
 
-    return dst;
+    // Horizontal sync, chroma dephasing, noise and vertical roll are
+    // applied in a single pass over the output lines.
+    int yOffset = int(this->d->m_yOffset);
+    int xOffset = this->d->m_xOffset;
+    qreal hueFactor = this->d->m_hueFactor;
+    qreal noise = this->d->m_noise;
+    this->d->m_dst.copyMetadata(src);
+    this->d->forEachBand(frameSize.height(),
+                         [this, &src, yOffset, xOffset, hueFactor, noise] (int yStart, int yEnd) {
+        this->d->analogTVBand(src,
+                              yOffset,
+                              xOffset,
+                              hueFactor,
+                              noise,
+                              yStart,
+                              yEnd);
+    });
+    this->d->updateVSync(frameSize.height());
+
+    if (this->d->m_dst)
+        emit this->oStream(this->d->m_dst);
+
+    return this->d->m_dst;
 }
 
 void AnalogTVElement::setVSync(qreal vsync)
@@ -263,38 +324,40 @@ void AnalogTVElement::resetNoise()
 }
 
 void AnalogTVElementPrivate::createLumaOffset(const AkVideoPacket &src,
-                                            qreal factor,
-                                            int *lumaOffset) const
+                                              qreal factor)
 {
-    auto heightLuma = new quint8 [src.caps().height()];
-    quint64 avgLuma = 0;
+    int width = src.caps().width();
+    int height = src.caps().height();
+
+    this->forEachBand(height, [this, &src, width] (int yStart, int yEnd) {
+        for (int y = yStart; y < yEnd; y++) {
+            auto line = reinterpret_cast<const QRgb *>(src.constLine(0, y));
+            quint64 lineLuma = 0;
 
-    for (int y = 0; y < src.caps().height(); y++) {
-        auto line = reinterpret_cast<const QRgb *>(src.constLine(0, y));
-        quint64 avgLineLuma = 0;
+            for (int x = 0; x < width; x++)
+                lineLuma += qGray(line[x]);
 
-        for (int x = 0; x < src.caps().height(); x++) {
-            auto luma = qGray(line[x]);
-            avgLuma += luma;
-            avgLineLuma += luma;
+            this->m_lineLuma[y] = lineLuma;
         }
+    });
 
-        heightLuma[y] = quint8(avgLineLuma / src.caps().height());
-    }
+    quint64 avgLuma = 0;
 
-    avgLuma /= size_t(src.caps().width()) * size_t(src.caps().height());
+    for (int y = 0; y < height; y++)
+        avgLuma += this->m_lineLuma[y];
 
-    for (int y = 0; y < src.caps().height(); y++)
-        lumaOffset[y] = qRound(factor * (int(avgLuma) - int(heightLuma[y])));
+    avgLuma /= size_t(width) * size_t(height);
 
-    delete [] heightLuma;
+    for (int y = 0; y < height; y++) {
+        int lineLuma = int(this->m_lineLuma[y] / quint64(width));
+        this->m_lumaOffset[y] = qRound(factor * (int(avgLuma) - lineLuma));
+    }
 }
 
-void AnalogTVElementPrivate::smoothLumaOffset(int *lumaOffset,
-                                            int height,
-                                            int smoothness) const
+void AnalogTVElementPrivate::smoothLumaOffset(int height, int smoothness)
 {
-    auto sumLumaOffset = new qint64 [height + 1];
+    auto lumaOffset = this->m_lumaOffset.data();
+    auto sumLumaOffset = this->m_sumLumaOffset.data();
     sumLumaOffset[0] = 0;
 
     for (int y = 0; y < height; y++)
@@ -313,75 +376,81 @@ void AnalogTVElementPrivate::smoothLumaOffset(int *lumaOffset,
         if (n != 0)
             lumaOffset[y] = (sumLumaOffset[maxY] - sumLumaOffset[minY]) / n;
     }
-
-    delete [] sumLumaOffset;
 }
 
-AkVideoPacket AnalogTVElementPrivate::applyVSync(const AkVideoPacket &src)
+void AnalogTVElementPrivate::updateVSync(int height)
 {
-    AkVideoPacket dst(src.caps());
-    dst.copyMetadata(src);
-
-    int offset = int(this->m_yOffset);
-
-    memcpy(dst.line(0, 0),
-           src.constLine(0, src.caps().height() - offset - 1),
-           size_t(src.lineSize(0) * offset));
-    memcpy(dst.line(0, offset),
-           src.constLine(0, 0),
-           size_t(src.lineSize(0) * (src.caps().height() - offset)));
-
     auto vsync = this->m_vsync;
 
     if (!qFuzzyCompare(this->m_yOffset, 0.0) && qFuzzyCompare(vsync, 0.0)) {
         auto yOffset = this->m_sign > 0.0?
                            this->m_yOffset:
-                           src.caps().height() - this->m_yOffset;
-        vsync = 0.1 * this->m_sign * yOffset / src.caps().height();
+                           height - this->m_yOffset;
+        vsync = 0.1 * this->m_sign * yOffset / height;
     }
 
-    this->m_yOffset += vsync * dst.caps().height();
+    this->m_yOffset += vsync * height;
     this->m_sign = vsync < 0.0? -1.0: 1.0;
 
     if (int(this->m_yOffset) == 0 && qFuzzyCompare(this->m_vsync, 0.0))
         this->m_yOffset = 0.0;
 
-    if (this->m_yOffset >= qreal(src.caps().height()))
+    if (this->m_yOffset >= qreal(height))
         this->m_yOffset = 0.0;
     else if (this->m_yOffset < 0.0)
-        this->m_yOffset = src.caps().height();
-
-    return dst;
+        this->m_yOffset = height;
 }
 
-AkVideoPacket AnalogTVElementPrivate::applyHSync(const AkVideoPacket &src,
-                                               const int *lumaOffset,
-                                               int xOffset)
+void AnalogTVElementPrivate::analogTVBand(const AkVideoPacket &src,
+                                          int yOffset,
+                                          int xOffset,
+                                          qreal hueFactor,
+                                          qreal noise,
+                                          int yStart,
+                                          int yEnd)
 {
-    AkVideoPacket dst(src.caps());
-    dst.copyMetadata(src);
+    int width = src.caps().width();
+    int height = src.caps().height();
+
+    for (int y = yStart; y < yEnd; y++) {
+        // Vertical roll, the frame is shifted down by yOffset lines.
+        int ys = y - yOffset;
 
-    for (int y = 0; y < src.caps().height(); y++) {
-        int offset = (lumaOffset[y] + xOffset) % src.caps().width();
+        if (ys < 0)
+            ys += height;
+
+        auto srcLine = reinterpret_cast<const QRgb *>(src.constLine(0, ys));
+        auto dstLine = reinterpret_cast<QRgb *>(this->m_dst.line(0, y));
+        auto lumaOffset = this->m_lumaOffset[ys];
+
+        // Horizontal sync.
+        int offset = (lumaOffset + xOffset) % width;
 
         if (offset < 0) {
-            memcpy(dst.line(0, y),
-                   src.constLine(0, y) - offset * sizeof(QRgb),
-                   (src.caps().width() + offset) * sizeof(QRgb));
-            memcpy(dst.line(0, y) + (src.caps().width() + offset) * sizeof(QRgb),
-                   src.constLine(0, y),
+            memcpy(dstLine,
+                   srcLine - offset,
+                   (width + offset) * sizeof(QRgb));
+            memcpy(dstLine + width + offset,
+                   srcLine,
                    -offset * sizeof(QRgb));
         } else {
-            memcpy(dst.line(0, y),
-                   src.constLine(0, y) + (src.caps().width() - offset) * sizeof(QRgb),
+            memcpy(dstLine,
+                   srcLine + width - offset,
                    offset * sizeof(QRgb));
-            memcpy(dst.line(0, y) + offset * sizeof(QRgb),
-                   src.constLine(0, y),
-                   (src.caps().width() - offset) * sizeof(QRgb));
+            memcpy(dstLine + offset,
+                   srcLine,
+                   (width - offset) * sizeof(QRgb));
         }
-    }
 
-    return dst;
+        // Chroma dephasing.
+        auto hueOffset = qRound(hueFactor * lumaOffset);
+
+        if (hueOffset != 0)
+            for (int x = 0; x < width; x++)
+                this->rotateHue(dstLine[x], hueOffset);
+
+        this->applyNoise(dstLine, width, noise);
+    }
 }
 
 void AnalogTVElementPrivate::rotateHue(QRgb &pixel, int degrees) const
@@ -462,29 +531,23 @@ void AnalogTVElementPrivate::rotateHue(QRgb &pixel, int degrees) const
     }
 }
 
-void AnalogTVElementPrivate::applyChromaDephasing(AkVideoPacket &src,
-                                                const int *lumaOffset,
-                                                qreal hueFactor) const
+void AnalogTVElementPrivate::applyNoise(QRgb *line,
+                                        int width,
+                                        qreal persent) const
 {
-    for (int y = 0; y < src.caps().height(); y++) {
-        auto line = reinterpret_cast<QRgb *>(src.line(0, y));
-        auto hueOffset = qRound(hueFactor * lumaOffset[y]);
+    auto &random = AkRandom::local();
 
-        for (int x = 0; x < src.caps().width(); x++)
-            this->rotateHue(line[x], hueOffset);
-    }
-}
+    // Spread the fractional part of the noise pixels between the lines.
+    auto linePeper = persent * width;
+    auto peper = int(linePeper);
 
-void AnalogTVElementPrivate::applyNoise(AkVideoPacket &src, qreal persent) const
-{
-    auto peper = qRound64(persent * src.caps().width() * src.caps().height());
+    if (random.generateDouble() < linePeper - peper)
+        peper++;
 
-    for (size_t i = 0; i < peper; i++) {
-        int gray = QRandomGenerator::global()->bounded(256);
-        int alpha = QRandomGenerator::global()->bounded(256);
-        int x = QRandomGenerator::global()->bounded(src.caps().width());
-        int y = QRandomGenerator::global()->bounded(src.caps().height());
-        auto pixel = src.pixel<QRgb>(0, x, y);
+    for (int i = 0; i < peper; i++) {
+        int gray = random.bounded(256);
+        int alpha = random.bounded(256);
+        auto &pixel = line[random.bounded(width)];
 
         qint64 ro = qRed(pixel);
         qint64 go = qGreen(pixel);
@@ -498,7 +561,7 @@ void AnalogTVElementPrivate::applyNoise(AkVideoPacket &src, qreal persent) const
         qint64 bt = (graym + bo * this->m_aoMultTable[alphaMask]) >> 16;
         qint64 &at = this->m_alphaDivTable[alphaMask];
 
-        src.setPixel(0, x, y, qRgba(int(rt), int(gt), int(bt), int(at)));
+        pixel = qRgba(int(rt), int(gt), int(bt), int(at));
     }
 }
 
@@ -62,6 +62,8 @@ class AnalogTVElement: public AkElement
         AnalogTVElement();
         ~AnalogTVElement();
 
+        Q_INVOKABLE AkVideoCaps::PixelFormatList videoInputFormats() const override;
+        Q_INVOKABLE AkVideoCaps::PixelFormatList videoOutputFormats() const override;
         Q_INVOKABLE qreal vsync() const;
         Q_INVOKABLE int xOffset() const;
         Q_INVOKABLE qreal hsyncFactor() const;
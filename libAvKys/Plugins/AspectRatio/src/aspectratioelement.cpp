@@ -22,7 +22,6 @@
 #include <akfrac.h>
 #include <akpacket.h>
 #include <akvideocaps.h>
-#include <akvideoconverter.h>
 #include <akvideopacket.h>
 
 #include "aspectratioelement.h"
@@ -32,13 +31,11 @@ class AspectRatioElementPrivate
     public:
         int m_width {16};
         int m_height {9};
-        AkVideoConverter m_videoConverter;
 };
 
 AspectRatioElement::AspectRatioElement(): AkElement()
 {
     this->d = new AspectRatioElementPrivate;
-    this->d->m_videoConverter.setAspectRatioMode(AkVideoConverter::AspectRatioMode_Expanding);
 }
 
 AspectRatioElement::~AspectRatioElement()
@@ -86,14 +83,13 @@ AkPacket AspectRatioElement::iVideoStream(const AkVideoPacket &packet)
                          / qMax(this->d->m_width, 1));
     oHeight = qMin(oHeight, packet.caps().height());
 
-    AkVideoCaps oCaps(packet.caps());
-    oCaps.setWidth(oWidth);
-    oCaps.setHeight(oHeight);
-    this->d->m_videoConverter.setOutputCaps(oCaps);
-
-    this->d->m_videoConverter.begin();
-    auto dst = this->d->m_videoConverter.convert(packet);
-    this->d->m_videoConverter.end();
+    /* The output frame is never bigger than the input one, so it's just the
+     * center of the input frame and there is no need to scale nor copy it.
+     */
+    auto dst = packet.view((packet.caps().width() - oWidth) / 2,
+                           (packet.caps().height() - oHeight) / 2,
+                           oWidth,
+                           oHeight);
 
     if (dst)
         emit this->oStream(dst);
@@ -20,7 +20,6 @@
 #include <QFuture>
 #include <QMap>
 #include <QMutex>
-#include <QRandomGenerator>
 #include <QSharedPointer>
 #include <QThreadPool>
 #include <QTime>
@@ -33,6 +32,7 @@
 #include <akcaps.h>
 #include <akfrac.h>
 #include <akpacket.h>
+#include <akrandom.h>
 
 #include "audiogenelement.h"
 
@@ -355,13 +355,13 @@ void AudioGenElementPrivate::readFramesLoop()
         qreal time = QTime::currentTime().msecsSinceStartOfDay() / 1.e3;
         qreal tdiff = 1. / audioCaps.rate();
 
-        if (this->m_waveType != AudioGenElement::WaveTypeSilence) {
+        if (this->m_waveType == AudioGenElement::WaveTypeSilence) {
             memset(iPacket.data(), 0, iPacket.size());
         } else if (this->m_waveType == AudioGenElement::WaveTypeWhiteNoise) {
-            auto data = iPacket.data();
-
-            for (size_t i = 0; i < iPacket.size(); ++i)
-                data[i] = char(QRandomGenerator::global()->bounded(-128, 127));
+            AkRandom::local().fillBounded(reinterpret_cast<quint8 *>(iPacket.data()),
+                                          iPacket.size(),
+                                          0,
+                                          256);
         } else {
             auto ampMax = qint32(this->m_volume * std::numeric_limits<qint32>::max());
             auto ampMin = qint32(this->m_volume * std::numeric_limits<qint32>::min());
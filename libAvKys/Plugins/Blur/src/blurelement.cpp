@@ -52,6 +52,16 @@ int BlurElement::radius() const
     return this->d->m_radius;
 }
 
+AkVideoCaps::PixelFormatList BlurElement::videoInputFormats() const
+{
+    return {AkVideoCaps::Format_argbpack};
+}
+
+AkVideoCaps::PixelFormatList BlurElement::videoOutputFormats() const
+{
+    return {AkVideoCaps::Format_argbpack};
+}
+
 QString BlurElement::controlInterfaceProvide(const QString &controlId) const
 {
     Q_UNUSED(controlId)
@@ -37,6 +37,8 @@ class BlurElement: public AkElement
         BlurElement();
         ~BlurElement();
 
+        Q_INVOKABLE AkVideoCaps::PixelFormatList videoInputFormats() const override;
+        Q_INVOKABLE AkVideoCaps::PixelFormatList videoOutputFormats() const override;
         Q_INVOKABLE int radius() const;
 
     private:
@@ -23,6 +23,7 @@
 #include <QQmlContext>
 #include <QSize>
 #include <akfrac.h>
+#include <akhistogram.h>
 #include <akpacket.h>
 #include <akvideocaps.h>
 #include <akvideoconverter.h>
@@ -48,6 +49,7 @@ class CartoonElementPrivate
         qint64 m_lastTime {0};
         QMutex m_mutex;
         AkVideoConverter m_videoConverter;
+        AkHistogram m_histogram;
         AkVideoMixer m_videoMixer;
 
         void updatePalette(const AkVideoPacket &img,
@@ -317,20 +319,14 @@ void CartoonElementPrivate::updatePalette(const AkVideoPacket &packet,
                                           int ncolors,
                                           int colorDiff)
 {
-    using WeightType = quint64;
+    using WeightType = qreal;
 
-    // Create a histogram of 66k colors.
-    WeightType histogram[PALETTE_SIZE];
-    memset(histogram, 0, sizeof(WeightType) * PALETTE_SIZE);
-
-    for (int y = 0; y < packet.caps().height(); y++) {
-        auto line = reinterpret_cast<const QRgb *>(packet.constLine(0, y));
-
-        for (int x = 0; x < packet.caps().width(); x++)
-            // Pixels must be converted from 24 bits to 16 bits color depth.
-            histogram[this->rgb24Torgb16(line[x])]++;
-    }
+    // Create a histogram of 66k colors, pixels are converted from 24 bits
+    // to 16 bits color depth.
+    if (!this->m_histogram.computeRgb565(packet))
+        return;
 
+    auto histogram = this->m_histogram.data();
     int colorDiff2 = colorDiff * colorDiff;
     quint16 palette[ncolors];
     WeightType ceilWeight = std::numeric_limits<WeightType>::max();
@@ -342,7 +338,7 @@ void CartoonElementPrivate::updatePalette(const AkVideoPacket &packet,
         WeightType maxWeight = 0;
 
         for (int i = 0; i < PALETTE_SIZE; ++i) {
-            int weight = histogram[i];
+            auto weight = histogram[i];
 
             if (weight > maxWeight && weight < ceilWeight) {
                 maxWeight = weight;
@@ -61,6 +61,16 @@ QVariantList ChangeHSLElement::kernel() const
     return kernel;
 }
 
+AkVideoCaps::PixelFormatList ChangeHSLElement::videoInputFormats() const
+{
+    return {AkVideoCaps::Format_argbpack};
+}
+
+AkVideoCaps::PixelFormatList ChangeHSLElement::videoOutputFormats() const
+{
+    return {AkVideoCaps::Format_argbpack};
+}
+
 QString ChangeHSLElement::controlInterfaceProvide(const QString &controlId) const
 {
     Q_UNUSED(controlId)
@@ -37,6 +37,8 @@ class ChangeHSLElement: public AkElement
         ChangeHSLElement();
         ~ChangeHSLElement();
 
+        Q_INVOKABLE AkVideoCaps::PixelFormatList videoInputFormats() const override;
+        Q_INVOKABLE AkVideoCaps::PixelFormatList videoOutputFormats() const override;
         Q_INVOKABLE QVariantList kernel() const;
 
     private:
@@ -18,10 +18,12 @@
  */
 
 #include <QQmlContext>
+#include <QSize>
 #include <akfrac.h>
 #include <akpacket.h>
 #include <akvideocaps.h>
 #include <akvideoconverter.h>
+#include <akvideooverlay.h>
 #include <akvideopacket.h>
 
 #include "cinemaelement.h"
@@ -32,38 +34,23 @@ class CinemaElementPrivate
         qreal m_stripSize {0.5};
         QRgb m_stripColor {qRgb(0, 0, 0)};
         AkVideoConverter m_videoConverter {{AkVideoCaps::Format_argbpack, 0, 0, {}}};
-        qint64 *m_aiMultTable {nullptr};
-        qint64 *m_aoMultTable {nullptr};
-        qint64 *m_alphaDivTable {nullptr};
+        AkVideoOverlay m_strips;
+        QSize m_stripsFrameSize;
+        qreal m_stripsSize {-1.0};
+        QRgb m_stripsColor {0};
+
+        void updateStrips(const QSize &frameSize,
+                          qreal stripSize,
+                          QRgb stripColor);
 };
 
 CinemaElement::CinemaElement(): AkElement()
 {
     this->d = new CinemaElementPrivate;
-
-    constexpr qint64 maxAi = 255;
-    constexpr qint64 maxAi2 = maxAi * maxAi;
-    constexpr qint64 alphaMult = 1 << 16;
-    this->d->m_aiMultTable = new qint64 [alphaMult];
-    this->d->m_aoMultTable = new qint64 [alphaMult];
-    this->d->m_alphaDivTable = new qint64 [alphaMult];
-
-    for (qint64 ai = 0; ai < 256; ai++)
-        for (qint64 ao = 0; ao < 256; ao++) {
-            auto alphaMask = (ai << 8) | ao;
-            auto a = maxAi2 - (maxAi - ai) * (maxAi - ao);
-            this->d->m_aiMultTable[alphaMask] = a? alphaMult * ai * maxAi / a: 0;
-            this->d->m_aoMultTable[alphaMask] = a? alphaMult * ao * (maxAi - ai) / a: 0;
-            this->d->m_alphaDivTable[alphaMask] = a / maxAi;
-        }
 }
 
 CinemaElement::~CinemaElement()
 {
-    delete [] this->d->m_aiMultTable;
-    delete [] this->d->m_aoMultTable;
-    delete [] this->d->m_alphaDivTable;
-
     delete this->d;
 }
 
@@ -77,6 +64,16 @@ QRgb CinemaElement::stripColor() const
     return this->d->m_stripColor;
 }
 
+AkVideoCaps::PixelFormatList CinemaElement::videoInputFormats() const
+{
+    return {AkVideoCaps::Format_argbpack};
+}
+
+AkVideoCaps::PixelFormatList CinemaElement::videoOutputFormats() const
+{
+    return {AkVideoCaps::Format_argbpack};
+}
+
 QString CinemaElement::controlInterfaceProvide(const QString &controlId) const
 {
     Q_UNUSED(controlId)
@@ -102,48 +99,23 @@ AkPacket CinemaElement::iVideoStream(const AkVideoPacket &packet)
     if (!src)
         return {};
 
-    AkVideoPacket dst(src.caps());
-    dst.copyMetadata(src);
-    int cy = src.caps().height() >> 1;
-    auto stripSize = int(cy * this->d->m_stripSize);
-    qint64 ri = qRed(this->d->m_stripColor);
-    qint64 gi = qGreen(this->d->m_stripColor);
-    qint64 bi = qBlue(this->d->m_stripColor);
-    qint64 ai = qAlpha(this->d->m_stripColor);
-    auto iLineSize = src.lineSize(0);
-    auto oLineSize = dst.lineSize(0);
-    auto lineSize = qMin(iLineSize, oLineSize);
-
-    for (int y = 0; y < src.caps().height(); y++) {
-        int k = cy - qAbs(y - cy);
-        auto iLine = reinterpret_cast<const QRgb *>(src.constLine(0, y));
-        auto oLine = reinterpret_cast<QRgb *>(dst.line(0, y));
-
-        if (k > stripSize)
-            memcpy(oLine, iLine, lineSize);
-        else
-            for (int x = 0; x < src.caps().width(); x++) {
-                auto &pixel = iLine[x];
-
-                qint64 ro = qRed(pixel);
-                qint64 go = qGreen(pixel);
-                qint64 bo = qBlue(pixel);
-                qint64 ao = qAlpha(pixel);
-
-                auto alphaMask = (ai << 8) | ao;
-                qint64 rt = (ri * this->d->m_aiMultTable[alphaMask] + ro * this->d->m_aoMultTable[alphaMask]) >> 16;
-                qint64 gt = (gi * this->d->m_aiMultTable[alphaMask] + go * this->d->m_aoMultTable[alphaMask]) >> 16;
-                qint64 bt = (bi * this->d->m_aiMultTable[alphaMask] + bo * this->d->m_aoMultTable[alphaMask]) >> 16;
-                qint64 &at = this->d->m_alphaDivTable[alphaMask];
-
-                oLine[x] = qRgba(int(rt), int(gt), int(bt), int(at));
-            }
-    }
+    // The strips are only redrawn when the frame size or the properties
+    // change.
+    QSize frameSize(src.caps().width(), src.caps().height());
+    auto stripSize = this->d->m_stripSize;
+    auto stripColor = this->d->m_stripColor;
 
-    if (dst)
-        emit this->oStream(dst);
+    if (frameSize != this->d->m_stripsFrameSize
+        || !qFuzzyCompare(stripSize, this->d->m_stripsSize)
+        || stripColor != this->d->m_stripsColor)
+        this->d->updateStrips(frameSize, stripSize, stripColor);
 
-    return dst;
+    this->d->m_strips.draw(src);
+
+    if (src)
+        emit this->oStream(src);
+
+    return src;
 }
 
 void CinemaElement::setStripSize(qreal stripSize)
@@ -174,4 +146,31 @@ void CinemaElement::resetStripColor()
     this->setStripColor(qRgb(0, 0, 0));
 }
 
+void CinemaElementPrivate::updateStrips(const QSize &frameSize,
+                                        qreal stripSize,
+                                        QRgb stripColor)
+{
+    this->m_stripsFrameSize = frameSize;
+    this->m_stripsSize = stripSize;
+    this->m_stripsColor = stripColor;
+
+    AkVideoPacket strips({AkVideoCaps::Format_argbpack,
+                          frameSize.width(),
+                          frameSize.height(),
+                          {}});
+    int cy = frameSize.height() >> 1;
+    auto stripHeight = int(cy * stripSize);
+
+    for (int y = 0; y < frameSize.height(); y++) {
+        int k = cy - qAbs(y - cy);
+        auto line = reinterpret_cast<QRgb *>(strips.line(0, y));
+        auto color = k > stripHeight? qRgba(0, 0, 0, 0): stripColor;
+
+        for (int x = 0; x < frameSize.width(); x++)
+            line[x] = color;
+    }
+
+    this->m_strips.setOverlay(strips);
+}
+
 #include "moc_cinemaelement.cpp"
@@ -28,6 +28,7 @@
 #include <akaudiopacket.h>
 #include <akcompressedaudiopacket.h>
 #include <akpluginmanager.h>
+#include <aktracer.h>
 #include <iak/akelement.h>
 #include <faac.h>
 
@@ -535,6 +536,10 @@ void AudioEncoderFaacElementPrivate::updateOutputCaps(const AkAudioCaps &inputCa
 
 void AudioEncoderFaacElementPrivate::encodeFrame(const AkAudioPacket &src)
 {
+    AkTraceScope traceScope("encoder",
+                            "AudioEncoderFaacElement::encodeFrame",
+                            src.id(),
+                            src.pts());
     if (!src)
         return;
 
@@ -28,6 +28,7 @@
 #include <akaudiopacket.h>
 #include <akcompressedaudiopacket.h>
 #include <akpluginmanager.h>
+#include <aktracer.h>
 #include <iak/akelement.h>
 #include <fdk-aac/aacenc_lib.h>
 
@@ -593,6 +594,10 @@ void AudioEncoderFdkAacElementPrivate::updateOutputCaps(const AkAudioCaps &input
 
 void AudioEncoderFdkAacElementPrivate::encodeFrame(const AkAudioPacket &src)
 {
+    AkTraceScope traceScope("encoder",
+                            "AudioEncoderFdkAacElement::encodeFrame",
+                            src.id(),
+                            src.pts());
     if (!src)
         return;
 
@@ -27,6 +27,7 @@
 #include <akcompressedaudiopacket.h>
 #include <akpacket.h>
 #include <akpluginmanager.h>
+#include <aktracer.h>
 #include <iak/akelement.h>
 
 extern "C" {
@@ -1018,6 +1019,10 @@ void AudioEncoderFFmpegElementPrivate::updateOutputCaps()
 
 void AudioEncoderFFmpegElementPrivate::encodeFrame(const AkAudioPacket &src)
 {
+    AkTraceScope traceScope("encoder",
+                            "AudioEncoderFFmpegElement::encodeFrame",
+                            src.id(),
+                            src.pts());
     this->m_id = src.id();
     this->m_index = src.index();
 
@@ -27,6 +27,7 @@
 #include <akaudiopacket.h>
 #include <akcompressedaudiopacket.h>
 #include <akpluginmanager.h>
+#include <aktracer.h>
 #include <iak/akelement.h>
 #include <lame/lame.h>
 
@@ -316,6 +317,10 @@ void AudioEncoderLameElementPrivate::updateOutputCaps(const AkAudioCaps &inputCa
 
 void AudioEncoderLameElementPrivate::encodeFrame(const AkAudioPacket &src)
 {
+    AkTraceScope traceScope("encoder",
+                            "AudioEncoderLameElement::encodeFrame",
+                            src.id(),
+                            src.pts());
     this->m_id = src.id();
     this->m_index = src.index();
 
@@ -28,6 +28,7 @@
 #include <akcompressedaudiopacket.h>
 #include <akpacket.h>
 #include <akpluginmanager.h>
+#include <aktracer.h>
 #include <iak/akelement.h>
 #include <media/NdkMediaCodec.h>
 
@@ -908,6 +909,10 @@ void AudioEncoderNDKMediaElementPrivate::updateOutputCaps()
 
 void AudioEncoderNDKMediaElementPrivate::encodeFrame(const AkAudioPacket &src)
 {
+    AkTraceScope traceScope("encoder",
+                            "AudioEncoderNDKMediaElement::encodeFrame",
+                            src.id(),
+                            src.pts());
     this->m_id = src.id();
     this->m_index = src.index();
 
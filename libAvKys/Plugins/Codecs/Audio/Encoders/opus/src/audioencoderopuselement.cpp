@@ -29,6 +29,7 @@
 #include <akaudiopacket.h>
 #include <akcompressedaudiopacket.h>
 #include <akpluginmanager.h>
+#include <aktracer.h>
 #include <iak/akelement.h>
 #include <opus.h>
 
@@ -392,6 +393,10 @@ void AudioEncoderOpusElementPrivate::updateOutputCaps(const AkAudioCaps &inputCa
 
 void AudioEncoderOpusElementPrivate::encodeFrame(const AkAudioPacket &src)
 {
+    AkTraceScope traceScope("encoder",
+                            "AudioEncoderOpusElement::encodeFrame",
+                            src.id(),
+                            src.pts());
     this->m_id = src.id();
     this->m_index = src.index();
 
@@ -28,6 +28,7 @@
 #include <akcompressedaudiopacket.h>
 #include <akpacket.h>
 #include <akpluginmanager.h>
+#include <aktracer.h>
 #include <iak/akelement.h>
 #include <vorbis/vorbisenc.h>
 
@@ -432,6 +433,10 @@ void AudioEncoderVorbisElementPrivate::updateOutputCaps(const AkAudioCaps &input
 
 void AudioEncoderVorbisElementPrivate::encodeFrame(const AkAudioPacket &src)
 {
+    AkTraceScope traceScope("encoder",
+                            "AudioEncoderVorbisElement::encodeFrame",
+                            src.id(),
+                            src.pts());
     this->m_id = src.id();
     this->m_index = src.index();
 
@@ -26,6 +26,7 @@
 #include <akcompressedaudiopacket.h>
 #include <akcompressedvideocaps.h>
 #include <akcompressedvideopacket.h>
+#include <aktracer.h>
 #include <akvideocaps.h>
 #include <akfrac.h>
 #include <akpacket.h>
@@ -795,6 +796,10 @@ void VideoMuxerFFmpegElementPrivate::uninit()
 
 void VideoMuxerFFmpegElementPrivate::packetReady(const AkPacket &packet)
 {
+    AkTraceScope traceScope("muxer",
+                            "VideoMuxerFFmpegElement::packetReady",
+                            packet.id(),
+                            packet.pts());
     bool isAudio = packet.type() == AkPacket::PacketAudio
                    || packet.type() == AkPacket::PacketAudioCompressed;
     uint64_t track = isAudio? 1: 0;
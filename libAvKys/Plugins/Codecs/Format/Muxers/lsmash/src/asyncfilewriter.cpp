@@ -0,0 +1,252 @@
+/* Webcamoid, camera capture application.
+ * Copyright (C) 2026  Gonzalo Exequiel Pedone
+ *
+ * Webcamoid is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Webcamoid is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Webcamoid. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Web-Site: http://webcamoid.github.io/
+ */
+
+#include <atomic>
+#include <cstdio>
+#include <QFile>
+#include <QMutex>
+#include <QQueue>
+#include <QThreadPool>
+#include <QWaitCondition>
+#include <QtDebug>
+
+#include "asyncfilewriter.h"
+
+class AsyncFileWriterPrivate
+{
+    public:
+        QFile m_file;
+        QMutex m_mutex;
+        QWaitCondition m_queueChanged;
+        QQueue<QByteArray> m_queue;
+        QByteArray m_chunk;
+        QThreadPool m_threadPool;
+        qint64 m_chunkSize {1 << 20};
+        qint64 m_maxQueued {64 << 20};
+        qint64 m_queuedBytes {0};
+        qint64 m_pos {0};
+        bool m_run {false};
+        bool m_writing {false};
+        std::atomic<bool> m_error {false};
+
+        void writeLoop();
+        void pushChunk();
+        void flush();
+};
+
+AsyncFileWriter::AsyncFileWriter(qint64 chunkSize, qint64 maxQueued)
+{
+    this->d = new AsyncFileWriterPrivate;
+    this->d->m_chunkSize = qMax<qint64>(chunkSize, 1);
+    this->d->m_maxQueued = qMax(maxQueued, this->d->m_chunkSize);
+    this->d->m_threadPool.setMaxThreadCount(1);
+}
+
+AsyncFileWriter::~AsyncFileWriter()
+{
+    this->close();
+    delete this->d;
+}
+
+bool AsyncFileWriter::open(const QString &fileName)
+{
+    this->close();
+    this->d->m_file.setFileName(fileName);
+
+    if (!this->d->m_file.open(QIODevice::ReadWrite | QIODevice::Truncate)) {
+        qCritical() << "Failed to open" << fileName << ":" << this->d->m_file.errorString();
+
+        return false;
+    }
+
+    this->d->m_chunk.reserve(int(this->d->m_chunkSize));
+    this->d->m_queuedBytes = 0;
+    this->d->m_pos = 0;
+    this->d->m_error = false;
+    this->d->m_run = true;
+    this->d->m_threadPool.start([this] () {
+        this->d->writeLoop();
+    });
+
+    return true;
+}
+
+bool AsyncFileWriter::close()
+{
+    if (!this->d->m_file.isOpen())
+        return false;
+
+    this->d->pushChunk();
+    this->d->m_mutex.lock();
+    this->d->m_run = false;
+    this->d->m_queueChanged.wakeAll();
+    this->d->m_mutex.unlock();
+    this->d->m_threadPool.waitForDone();
+    this->d->m_file.close();
+
+    return !this->d->m_error;
+}
+
+bool AsyncFileWriter::isOpen() const
+{
+    return this->d->m_file.isOpen();
+}
+
+bool AsyncFileWriter::error() const
+{
+    return this->d->m_error;
+}
+
+qint64 AsyncFileWriter::write(const char *data, qint64 size)
+{
+    if (!this->d->m_file.isOpen() || this->d->m_error)
+        return -1;
+
+    for (qint64 written = 0; written < size;) {
+        auto copySize = qMin(size - written,
+                             this->d->m_chunkSize - this->d->m_chunk.size());
+        this->d->m_chunk.append(data + written, int(copySize));
+        written += copySize;
+
+        if (this->d->m_chunk.size() >= this->d->m_chunkSize)
+            this->d->pushChunk();
+    }
+
+    this->d->m_pos += size;
+
+    return size;
+}
+
+qint64 AsyncFileWriter::read(char *data, qint64 size)
+{
+    if (!this->d->m_file.isOpen())
+        return -1;
+
+    this->d->flush();
+    auto readSize = this->d->m_file.read(data, size);
+
+    if (readSize > 0)
+        this->d->m_pos += readSize;
+
+    return readSize;
+}
+
+qint64 AsyncFileWriter::seek(qint64 offset, int whence)
+{
+    if (!this->d->m_file.isOpen())
+        return -1;
+
+    // Asking for the position must not stall the caller.
+    if (whence == SEEK_CUR && offset == 0)
+        return this->d->m_pos;
+
+    this->d->flush();
+    qint64 pos = 0;
+
+    switch (whence) {
+    case SEEK_SET:
+        pos = offset;
+
+        break;
+
+    case SEEK_CUR:
+        pos = this->d->m_pos + offset;
+
+        break;
+
+    case SEEK_END:
+        pos = this->d->m_file.size() + offset;
+
+        break;
+
+    default:
+        return -1;
+    }
+
+    if (pos < 0 || !this->d->m_file.seek(pos))
+        return -1;
+
+    this->d->m_pos = pos;
+
+    return pos;
+}
+
+void AsyncFileWriterPrivate::writeLoop()
+{
+    forever {
+        this->m_mutex.lock();
+
+        while (this->m_run && this->m_queue.isEmpty())
+            this->m_queueChanged.wait(&this->m_mutex);
+
+        if (this->m_queue.isEmpty()) {
+            this->m_mutex.unlock();
+
+            break;
+        }
+
+        auto chunk = this->m_queue.dequeue();
+        this->m_writing = true;
+        this->m_mutex.unlock();
+
+        if (this->m_file.write(chunk) != chunk.size()) {
+            qCritical() << "Error writing to"
+                        << this->m_file.fileName()
+                        << ":"
+                        << this->m_file.errorString();
+            this->m_error = true;
+        }
+
+        this->m_mutex.lock();
+        this->m_queuedBytes -= chunk.size();
+        this->m_writing = false;
+        this->m_queueChanged.wakeAll();
+        this->m_mutex.unlock();
+    }
+}
+
+void AsyncFileWriterPrivate::pushChunk()
+{
+    if (this->m_chunk.isEmpty())
+        return;
+
+    this->m_mutex.lock();
+
+    while (this->m_queuedBytes >= this->m_maxQueued && !this->m_error)
+        this->m_queueChanged.wait(&this->m_mutex);
+
+    this->m_queuedBytes += this->m_chunk.size();
+    this->m_queue.enqueue(this->m_chunk);
+    this->m_queueChanged.wakeAll();
+    this->m_mutex.unlock();
+
+    this->m_chunk = {};
+    this->m_chunk.reserve(int(this->m_chunkSize));
+}
+
+void AsyncFileWriterPrivate::flush()
+{
+    this->pushChunk();
+    this->m_mutex.lock();
+
+    while (!this->m_queue.isEmpty() || this->m_writing)
+        this->m_queueChanged.wait(&this->m_mutex);
+
+    this->m_mutex.unlock();
+}
@@ -0,0 +1,54 @@
+/* Webcamoid, camera capture application.
+ * Copyright (C) 2026  Gonzalo Exequiel Pedone
+ *
+ * Webcamoid is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Webcamoid is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Webcamoid. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Web-Site: http://webcamoid.github.io/
+ */
+
+#ifndef ASYNCFILEWRITER_H
+#define ASYNCFILEWRITER_H
+
+#include <QString>
+
+class AsyncFileWriterPrivate;
+
+/* Writes a file from a worker thread.
+ *
+ * The written data is accumulated in chunks of 'chunkSize' bytes that are
+ * queued to the worker, so writing never waits for the disk unless more than
+ * 'maxQueued' bytes are pending. Seeking and reading wait until all the
+ * pending data was written, except for asking the current position.
+ */
+class AsyncFileWriter
+{
+    public:
+        AsyncFileWriter(qint64 chunkSize=1 << 20, qint64 maxQueued=64 << 20);
+        ~AsyncFileWriter();
+
+        bool open(const QString &fileName);
+        bool close();
+        bool isOpen() const;
+        bool error() const;
+        qint64 write(const char *data, qint64 size);
+        qint64 read(char *data, qint64 size);
+
+        // Same as fseek() but returns the new position, or -1 on error.
+        qint64 seek(qint64 offset, int whence);
+
+    private:
+        AsyncFileWriterPrivate *d;
+};
+
+#endif // ASYNCFILEWRITER_H
@@ -31,11 +31,13 @@
 #include <akfrac.h>
 #include <akpacket.h>
 #include <akpluginmanager.h>
+#include <aktracer.h>
 #include <akvideocaps.h>
 #include <iak/akelement.h>
 #include <lsmash.h>
 
 #include "videomuxerlsmashelement.h"
+#include "asyncfilewriter.h"
 
 struct AudioCodecsTable
 {
@@ -125,14 +127,27 @@ struct TrackInfo
     int64_t secondLargestPts {0};
 };
 
+/* In fragmented mode the file is written as an initial 'moov' followed by
+ * 'moof'/'mdat' pairs, every fragment starts with a video key frame and lasts
+ * at least 'fragmentDuration' milliseconds. Nothing has to be rewritten when
+ * the recording ends, and the file stays playable up to the last complete
+ * fragment if the recording is interrupted.
+ */
+
 class VideoMuxerLSmashElementPrivate
 {
     public:
         VideoMuxerLSmashElement *self;
+        AkPropertyOptions m_options;
         lsmash_root_t *m_root {nullptr};
         lsmash_file_parameters_t m_fileParams;
+        AsyncFileWriter m_writer;
         uint32_t m_globalTimeScale {90000};
         QVector<TrackInfo> m_trackInfo;
+        bool m_fragmented {false};
+        qreal m_fragmentDuration {0.0};
+        qreal m_fragmentStart {-1.0};
+        bool m_timelineMapped {false};
         bool m_initialized {false};
         bool m_paused {false};
         AkElementPtr m_packetSync {akPluginManager->create<AkElement>("Utils/PacketSync")};
@@ -140,8 +155,15 @@ class VideoMuxerLSmashElementPrivate
         explicit VideoMuxerLSmashElementPrivate(VideoMuxerLSmashElement *self);
         ~VideoMuxerLSmashElementPrivate();
         static const char *errorToString(int error);
+        static int readFile(void *opaque, uint8_t *buffer, int size);
+        static int writeFile(void *opaque, uint8_t *buffer, int size);
+        static int64_t seekFile(void *opaque, int64_t offset, int whence);
         bool init();
         void uninit();
+        void destroyRoot();
+        bool flushPooledSamples();
+        bool startFragment();
+        bool createTimelineMaps(bool implicitDuration);
         uint32_t addAudioTrack(lsmash_root_t *root,
                                lsmash_codec_type_t codecID,
                                const AkCompressedAudioCaps &audioCaps,
@@ -245,6 +267,11 @@ AkCodecID VideoMuxerLSmashElement::defaultCodec(const QString &muxer,
     return codecs.first();
 }
 
+AkPropertyOptions VideoMuxerLSmashElement::options() const
+{
+    return this->d->m_options;
+}
+
 AkPacket VideoMuxerLSmashElement::iStream(const AkPacket &packet)
 {
     if (this->d->m_paused || !this->d->m_initialized || !this->d->m_packetSync)
@@ -316,6 +343,28 @@ bool VideoMuxerLSmashElement::setState(ElementState state)
 VideoMuxerLSmashElementPrivate::VideoMuxerLSmashElementPrivate(VideoMuxerLSmashElement *self):
     self(self)
 {
+    this->m_options = {
+        {"fragmented" ,
+         QObject::tr("Fragmented"),
+         QObject::tr("Write the movie as a sequence of fragments, so the file "
+                     "is playable even if the recording is interrupted"),
+         AkPropertyOption::OptionType_Boolean,
+         0.0,
+         1.0,
+         1.0,
+         false,
+         {}},
+        {"fragmentDuration" ,
+         QObject::tr("Fragment duration"),
+         QObject::tr("Minimum duration of each fragment in milliseconds"),
+         AkPropertyOption::OptionType_Number,
+         100.0,
+         60000.0,
+         100.0,
+         2000.0,
+         {}},
+    };
+
     if (this->m_packetSync)
         QObject::connect(this->m_packetSync.data(),
                          &AkElement::oStream,
@@ -358,6 +407,33 @@ const char *VideoMuxerLSmashElementPrivate::errorToString(int error)
     return lsmashEncErrorStr;
 }
 
+int VideoMuxerLSmashElementPrivate::readFile(void *opaque,
+                                             uint8_t *buffer,
+                                             int size)
+{
+    auto writer = reinterpret_cast<AsyncFileWriter *>(opaque);
+
+    return int(writer->read(reinterpret_cast<char *>(buffer), size));
+}
+
+int VideoMuxerLSmashElementPrivate::writeFile(void *opaque,
+                                              uint8_t *buffer,
+                                              int size)
+{
+    auto writer = reinterpret_cast<AsyncFileWriter *>(opaque);
+
+    return int(writer->write(reinterpret_cast<const char *>(buffer), size));
+}
+
+int64_t VideoMuxerLSmashElementPrivate::seekFile(void *opaque,
+                                                 int64_t offset,
+                                                 int whence)
+{
+    auto writer = reinterpret_cast<AsyncFileWriter *>(opaque);
+
+    return writer->seek(offset, whence);
+}
+
 bool VideoMuxerLSmashElementPrivate::init()
 {
     this->uninit();
@@ -399,16 +475,38 @@ bool VideoMuxerLSmashElementPrivate::init()
 
     // Create the file
 
-    auto location = self->location();
+    this->m_fragmented = self->optionValue("fragmented").toBool();
+    this->m_fragmentDuration =
+            self->optionValue("fragmentDuration").toReal() / 1000.0;
+    this->m_fragmentStart = -1.0;
+    this->m_timelineMapped = false;
 
-    if (lsmash_open_file(location.toStdString().c_str(),
-                         0,
-                         &this->m_fileParams) < 0) {
+    if (!this->m_writer.open(self->location())) {
         qCritical() << "Failed to open an output file";
 
         return false;
     }
 
+    // Write through our own buffered writer instead of stdio, so the disk
+    // I/O is done in another thread.
+    memset(&this->m_fileParams, 0, sizeof(lsmash_file_parameters_t));
+    this->m_fileParams.mode = LSMASH_FILE_MODE_WRITE
+                              | LSMASH_FILE_MODE_BOX
+                              | LSMASH_FILE_MODE_INITIALIZATION
+                              | LSMASH_FILE_MODE_MEDIA;
+
+    if (this->m_fragmented)
+        this->m_fileParams.mode |= LSMASH_FILE_MODE_FRAGMENTED;
+
+    this->m_fileParams.opaque = &this->m_writer;
+    this->m_fileParams.read = VideoMuxerLSmashElementPrivate::readFile;
+    this->m_fileParams.write = VideoMuxerLSmashElementPrivate::writeFile;
+    this->m_fileParams.seek = VideoMuxerLSmashElementPrivate::seekFile;
+    this->m_fileParams.max_chunk_duration = 0.5;
+    this->m_fileParams.max_async_tolerance = 2.0;
+    this->m_fileParams.max_chunk_size = 4 << 20;
+    this->m_fileParams.max_read_size = 4 << 20;
+
     this->m_root = lsmash_create_root();
 
     QVector<lsmash_brand_type> brands {
@@ -424,8 +522,7 @@ bool VideoMuxerLSmashElementPrivate::init()
 
     if (!lsmash_set_file(this->m_root, &this->m_fileParams)) {
         qCritical() << "Failed to add an output file into a ROOT";
-        lsmash_destroy_root(this->m_root);
-        this->m_root = nullptr;
+        this->destroyRoot();
 
         return false;
     }
@@ -436,8 +533,7 @@ bool VideoMuxerLSmashElementPrivate::init()
 
     if (result) {
         qCritical() << "Failed to set movie parameters:" << errorToString(result);
-        lsmash_destroy_root(this->m_root);
-        this->m_root = nullptr;
+        this->destroyRoot();
 
         return false;
     }
@@ -460,8 +556,7 @@ bool VideoMuxerLSmashElementPrivate::init()
 
     if (videoTrack < 1) {
         qCritical() << "Failed to create the video track";
-        lsmash_destroy_root(this->m_root);
-        this->m_root = nullptr;
+        this->destroyRoot();
 
         return false;
     }
@@ -489,8 +584,7 @@ bool VideoMuxerLSmashElementPrivate::init()
 
         if (audioTrack < 1) {
             qCritical() << "Failed to create the audio track";
-            lsmash_destroy_root(this->m_root);
-            this->m_root = nullptr;
+            this->destroyRoot();
 
             return false;
         }
@@ -518,81 +612,125 @@ void VideoMuxerLSmashElementPrivate::uninit()
     this->m_initialized = false;
     this->m_packetSync->setState(AkElement::ElementStateNull);
 
-    lsmash_movie_parameters_t movieParameters;
-    auto result = lsmash_get_movie_parameters(this->m_root, &movieParameters);
+    // Flush the rest of samples and add the last sample_delta.
 
-    if (result) {
-        qCritical() << "Failed to flush the rest of samples:" << errorToString(result);
+    if (!this->flushPooledSamples()) {
+        this->destroyRoot();
 
         return;
     }
 
-    // Flush the rest of samples and add the last sample_delta.
+    if (!this->m_timelineMapped && !this->createTimelineMaps(false)) {
+        this->destroyRoot();
 
-    for (uint32_t track; track < movieParameters.number_of_tracks; track++) {
-        auto trackId = lsmash_get_track_ID(this->m_root, track);
+        return;
+    }
+
+    // Close
+
+    auto result = lsmash_finish_movie(this->m_root, nullptr);
 
-        if (trackId < 1)
-            continue;
+    if (result)
+        qCritical() << "failed finishing the video:" << errorToString(result);
+
+    this->destroyRoot();
+    this->m_paused = false;
+}
+
+void VideoMuxerLSmashElementPrivate::destroyRoot()
+{
+    if (this->m_root) {
+        lsmash_destroy_root(this->m_root);
+        this->m_root = nullptr;
+    }
+
+    if (this->m_writer.isOpen() && !this->m_writer.close())
+        qCritical() << "Error closing the file";
+}
 
-        auto &trackInfo = this->m_trackInfo[0];
+bool VideoMuxerLSmashElementPrivate::flushPooledSamples()
+{
+    for (auto &trackInfo: this->m_trackInfo) {
         uint32_t lastDelta = trackInfo.largestPts - trackInfo.secondLargestPts;
-        result = lsmash_flush_pooled_samples(this->m_root,
-                                             trackId,
-                                             lastDelta);
+        auto result = lsmash_flush_pooled_samples(this->m_root,
+                                                  trackInfo.track,
+                                                  lastDelta);
 
         if (result) {
             qCritical() << "Failed to flush the rest of samples:" << errorToString(result);
 
-            return;
+            return false;
         }
+    }
+
+    return true;
+}
+
+bool VideoMuxerLSmashElementPrivate::startFragment()
+{
+    // Close the samples of the current fragment before starting a new one.
+    if (!this->flushPooledSamples())
+        return false;
+
+    /* The first fragment writes the initial 'moov', so the edit lists must be
+     * set before it. Their duration is left implicit, since it's not known
+     * until the recording ends.
+     */
+    if (!this->m_timelineMapped && !this->createTimelineMaps(true))
+        return false;
+
+    auto result = lsmash_create_fragment_movie(this->m_root);
 
+    if (result) {
+        qCritical() << "Failed to create a movie fragment:" << errorToString(result);
+
+        return false;
+    }
+
+    return true;
+}
+
+bool VideoMuxerLSmashElementPrivate::createTimelineMaps(bool implicitDuration)
+{
+    // Skip the leading samples shifted by the B-frames delay.
+    for (auto &trackInfo: this->m_trackInfo) {
         lsmash_media_parameters_t params;
-        result = lsmash_get_media_parameters(this->m_root, trackId, &params);
+        auto result = lsmash_get_media_parameters(this->m_root,
+                                                  trackInfo.track,
+                                                  &params);
 
         if (result) {
             qCritical() << "Failed to read the stream parameters:" << errorToString(result);
 
-            return;
+            return false;
         }
 
-        uint64_t actualDuration =
-                (trackInfo.largestPts + lastDelta) / params.timescale;
-
         lsmash_edit_t edit;
         memset(&edit, 0, sizeof(lsmash_edit_t));
-        edit.duration = actualDuration;
+
+        if (implicitDuration) {
+            edit.duration = ISOM_EDIT_DURATION_IMPLICIT;
+        } else {
+            uint32_t lastDelta = trackInfo.largestPts - trackInfo.secondLargestPts;
+            edit.duration = (trackInfo.largestPts + lastDelta) / params.timescale;
+        }
+
         edit.start_time = trackInfo.firstCts;
         edit.rate = ISOM_EDIT_MODE_NORMAL;
-        result = lsmash_create_explicit_timeline_map(this->m_root, trackId, edit);
+        result = lsmash_create_explicit_timeline_map(this->m_root,
+                                                     trackInfo.track,
+                                                     edit);
 
         if (result) {
             qCritical() << "failed to set timeline map for video:" << errorToString(result);
 
-            return;
+            return false;
         }
     }
 
-    // Close
-
-    result = lsmash_finish_movie(this->m_root, nullptr);
-
-    if (result) {
-        qCritical() << "failed finishing the video:" << errorToString(result);
-
-        return;
-    }
+    this->m_timelineMapped = true;
 
-    lsmash_destroy_root(this->m_root);
-    result = lsmash_close_file(&this->m_fileParams);
-
-    if (result) {
-        qCritical() << "Error closing the file:" << errorToString(result);
-
-        return;
-    }
-
-    this->m_paused = false;
+    return true;
 }
 
 uint32_t VideoMuxerLSmashElementPrivate::addAudioTrack(lsmash_root_t *root,
@@ -905,6 +1043,10 @@ bool VideoMuxerLSmashElementPrivate::addH264SpecificData(lsmash_summary_t *summa
 
 void VideoMuxerLSmashElementPrivate::packetReady(const AkPacket &packet)
 {
+    AkTraceScope traceScope("muxer",
+                            "VideoMuxerLSmashElement::packetReady",
+                            packet.id(),
+                            packet.pts());
     bool isAudio = packet.type() == AkPacket::PacketAudio
                    || packet.type() == AkPacket::PacketAudioCompressed;
     uint32_t track = isAudio? 1: 0;
@@ -932,6 +1074,22 @@ void VideoMuxerLSmashElementPrivate::packetReady(const AkPacket &packet)
         trackInfo.firstPacket = false;
     }
 
+    /* The samples before the first fragment go to the initial movie, the
+     * next fragments start in the first key frame after the fragment duration.
+     */
+    if (this->m_fragmented && !isAudio && isSyncSample) {
+        auto pts = packet.pts() * packet.timeBase().value();
+
+        if (this->m_fragmentStart < 0) {
+            this->m_fragmentStart = pts;
+        } else if (pts - this->m_fragmentStart >= this->m_fragmentDuration) {
+            if (this->startFragment())
+                this->m_fragmentStart = pts;
+        }
+    }
+
+    // L-SMASH owns and frees the sample buffers, so the packet data can't be
+    // adopted.
     auto sample = lsmash_create_sample(packet.size());
 
     if (!sample) {
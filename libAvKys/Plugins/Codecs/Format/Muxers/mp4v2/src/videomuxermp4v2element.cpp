@@ -32,6 +32,7 @@
 #include <akfrac.h>
 #include <akpacket.h>
 #include <akpluginmanager.h>
+#include <aktracer.h>
 #include <akvideocaps.h>
 #include <iak/akelement.h>
 #include <mp4v2/mp4v2.h>
@@ -589,6 +590,10 @@ MP4TrackId VideoMuxerMp4V2ElementPrivate::addH264Track(MP4FileHandle file,
 
 void VideoMuxerMp4V2ElementPrivate::packetReady(const AkPacket &packet)
 {
+    AkTraceScope traceScope("muxer",
+                            "VideoMuxerMp4V2Element::packetReady",
+                            packet.id(),
+                            packet.pts());
     bool isAudio = packet.type() == AkPacket::PacketAudio
                    || packet.type() == AkPacket::PacketAudioCompressed;
     MP4TrackId track = isAudio?
@@ -28,6 +28,7 @@
 #include <akcompressedaudiopacket.h>
 #include <akcompressedvideocaps.h>
 #include <akcompressedvideopacket.h>
+#include <aktracer.h>
 #include <akvideocaps.h>
 #include <akfrac.h>
 #include <akpacket.h>
@@ -571,6 +572,10 @@ void VideoMuxerNDKMediaElementPrivate::uninit()
 
 void VideoMuxerNDKMediaElementPrivate::packetReady(const AkPacket &packet)
 {
+    AkTraceScope traceScope("muxer",
+                            "VideoMuxerNDKMediaElement::packetReady",
+                            packet.id(),
+                            packet.pts());
     if (!this->m_muxer)
         return;
 
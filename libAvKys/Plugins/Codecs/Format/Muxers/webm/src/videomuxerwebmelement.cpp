@@ -31,6 +31,7 @@
 #include <akfrac.h>
 #include <akpacket.h>
 #include <akpluginmanager.h>
+#include <aktracer.h>
 #include <akvideopacket.h>
 #include <iak/akelement.h>
 #include <mkvparser/mkvreader.h>
@@ -607,6 +608,10 @@ void VideoMuxerWebmElementPrivate::uninit()
 
 void VideoMuxerWebmElementPrivate::packetReady(const AkPacket &packet)
 {
+    AkTraceScope traceScope("muxer",
+                            "VideoMuxerWebmElement::packetReady",
+                            packet.id(),
+                            packet.pts());
     bool isAudio = packet.type() == AkPacket::PacketAudio
                    || packet.type() == AkPacket::PacketAudioCompressed;
     uint64_t track = isAudio?
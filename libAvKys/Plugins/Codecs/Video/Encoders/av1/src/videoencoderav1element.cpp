@@ -23,6 +23,7 @@
 #include <akfrac.h>
 #include <akpacket.h>
 #include <akpluginmanager.h>
+#include <aktracer.h>
 #include <akvideocaps.h>
 #include <akcompressedvideocaps.h>
 #include <akvideoconverter.h>
@@ -570,6 +571,10 @@ void VideoEncoderAv1ElementPrivate::printError(aom_codec_err_t error,
 
 void VideoEncoderAv1ElementPrivate::encodeFrame(const AkVideoPacket &src)
 {
+    AkTraceScope traceScope("encoder",
+                            "VideoEncoderAv1Element::encodeFrame",
+                            src.id(),
+                            src.pts());
     this->m_id = src.id();
     this->m_index = src.index();
 
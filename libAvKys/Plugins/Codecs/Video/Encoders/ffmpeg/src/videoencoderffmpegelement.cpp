@@ -22,6 +22,7 @@
 #include <QVariant>
 #include <akfrac.h>
 #include <akpacket.h>
+#include <aktracer.h>
 #include <akvideocaps.h>
 #include <akcompressedvideocaps.h>
 #include <akpluginmanager.h>
@@ -1245,6 +1246,10 @@ void VideoEncoderFFmpegElementPrivate::updateOutputCaps()
 
 void VideoEncoderFFmpegElementPrivate::encodeFrame(const AkVideoPacket &src)
 {
+    AkTraceScope traceScope("encoder",
+                            "VideoEncoderFFmpegElement::encodeFrame",
+                            src.id(),
+                            src.pts());
     this->m_id = src.id();
     this->m_index = src.index();
 
@@ -23,6 +23,7 @@
 #include <QVariant>
 #include <akfrac.h>
 #include <akpacket.h>
+#include <aktracer.h>
 #include <akvideocaps.h>
 #include <akcompressedvideocaps.h>
 #include <akpluginmanager.h>
@@ -1171,6 +1172,10 @@ void VideoEncoderNDKMediaElementPrivate::writeFrame(const AkVideoPacket &packet,
 
 void VideoEncoderNDKMediaElementPrivate::encodeFrame(const AkVideoPacket &src)
 {
+    AkTraceScope traceScope("encoder",
+                            "VideoEncoderNDKMediaElement::encodeFrame",
+                            src.id(),
+                            src.pts());
     this->m_id = src.id();
     this->m_index = src.index();
 
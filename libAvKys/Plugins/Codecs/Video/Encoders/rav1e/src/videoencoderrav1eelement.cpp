@@ -26,6 +26,7 @@
 #include <akfrac.h>
 #include <akpacket.h>
 #include <akpluginmanager.h>
+#include <aktracer.h>
 #include <akvideocaps.h>
 #include <akvideoconverter.h>
 #include <akvideopacket.h>
@@ -554,6 +555,10 @@ void VideoEncoderRav1eElementPrivate::updateOutputCaps(const AkVideoCaps &inputC
 
 void VideoEncoderRav1eElementPrivate::encodeFrame(const AkVideoPacket &src)
 {
+    AkTraceScope traceScope("encoder",
+                            "VideoEncoderRav1eElement::encodeFrame",
+                            src.id(),
+                            src.pts());
     this->m_id = src.id();
     this->m_index = src.index();
 
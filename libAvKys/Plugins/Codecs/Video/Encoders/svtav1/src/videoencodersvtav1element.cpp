@@ -22,6 +22,7 @@
 #include <QVariant>
 #include <akfrac.h>
 #include <akpacket.h>
+#include <aktracer.h>
 #include <akvideocaps.h>
 #include <akcompressedvideocaps.h>
 #include <akpluginmanager.h>
@@ -571,6 +572,10 @@ const char *VideoEncoderSvtAv1ElementPrivate::errortToStr(EbErrorType error)
 
 void VideoEncoderSvtAv1ElementPrivate::encodeFrame(const AkVideoPacket &src)
 {
+    AkTraceScope traceScope("encoder",
+                            "VideoEncoderSvtAv1Element::encodeFrame",
+                            src.id(),
+                            src.pts());
     this->m_id = src.id();
     this->m_index = src.index();
 
@@ -22,6 +22,7 @@
 #include <QVariant>
 #include <akfrac.h>
 #include <akpacket.h>
+#include <aktracer.h>
 #include <akvideocaps.h>
 #include <akcompressedvideocaps.h>
 #include <akpluginmanager.h>
@@ -497,6 +498,10 @@ const char *VideoEncoderSvtVp9ElementPrivate::errortToStr(EbErrorType error)
 
 void VideoEncoderSvtVp9ElementPrivate::encodeFrame(const AkVideoPacket &src)
 {
+    AkTraceScope traceScope("encoder",
+                            "VideoEncoderSvtVp9Element::encodeFrame",
+                            src.id(),
+                            src.pts());
     this->m_id = src.id();
     this->m_index = src.index();
 
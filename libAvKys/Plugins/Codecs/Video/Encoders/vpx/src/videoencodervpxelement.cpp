@@ -22,6 +22,7 @@
 #include <QVariant>
 #include <akfrac.h>
 #include <akpacket.h>
+#include <aktracer.h>
 #include <akvideocaps.h>
 #include <akcompressedvideocaps.h>
 #include <akpluginmanager.h>
@@ -651,6 +652,10 @@ void VideoEncoderVpxElementPrivate::printError(vpx_codec_err_t error,
 
 void VideoEncoderVpxElementPrivate::encodeFrame(const AkVideoPacket &src)
 {
+    AkTraceScope traceScope("encoder",
+                            "VideoEncoderVpxElement::encodeFrame",
+                            src.id(),
+                            src.pts());
     this->m_id = src.id();
     this->m_index = src.index();
 
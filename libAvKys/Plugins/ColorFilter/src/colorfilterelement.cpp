@@ -67,6 +67,16 @@ bool ColorFilterElement::disable() const
     return this->d->m_disable;
 }
 
+AkVideoCaps::PixelFormatList ColorFilterElement::videoInputFormats() const
+{
+    return {AkVideoCaps::Format_argbpack};
+}
+
+AkVideoCaps::PixelFormatList ColorFilterElement::videoOutputFormats() const
+{
+    return {AkVideoCaps::Format_argbpack};
+}
+
 QString ColorFilterElement::controlInterfaceProvide(const QString &controlId) const
 {
     Q_UNUSED(controlId)
@@ -53,6 +53,8 @@ class ColorFilterElement: public AkElement
         ColorFilterElement();
         ~ColorFilterElement();
 
+        Q_INVOKABLE AkVideoCaps::PixelFormatList videoInputFormats() const override;
+        Q_INVOKABLE AkVideoCaps::PixelFormatList videoOutputFormats() const override;
         Q_INVOKABLE QRgb color() const;
         Q_INVOKABLE int radius() const;
         Q_INVOKABLE bool soft() const;
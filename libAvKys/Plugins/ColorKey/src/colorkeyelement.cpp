@@ -93,6 +93,16 @@ QString ColorKeyElement::background() const
     return this->d->m_background;
 }
 
+AkVideoCaps::PixelFormatList ColorKeyElement::videoInputFormats() const
+{
+    return {AkVideoCaps::Format_argbpack};
+}
+
+AkVideoCaps::PixelFormatList ColorKeyElement::videoOutputFormats() const
+{
+    return {AkVideoCaps::Format_argbpack};
+}
+
 QString ColorKeyElement::controlInterfaceProvide(const QString &controlId) const
 {
     Q_UNUSED(controlId)
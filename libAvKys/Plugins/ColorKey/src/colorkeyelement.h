@@ -76,6 +76,8 @@ class ColorKeyElement: public AkElement
         ColorKeyElement();
         ~ColorKeyElement();
 
+        Q_INVOKABLE AkVideoCaps::PixelFormatList videoInputFormats() const override;
+        Q_INVOKABLE AkVideoCaps::PixelFormatList videoOutputFormats() const override;
         Q_INVOKABLE QRgb colorKey() const;
         Q_INVOKABLE int colorDiff() const;
         Q_INVOKABLE int smoothness() const;
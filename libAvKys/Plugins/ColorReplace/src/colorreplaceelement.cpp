@@ -73,6 +73,16 @@ bool ColorReplaceElement::disable() const
     return this->d->m_disable;
 }
 
+AkVideoCaps::PixelFormatList ColorReplaceElement::videoInputFormats() const
+{
+    return {AkVideoCaps::Format_argbpack};
+}
+
+AkVideoCaps::PixelFormatList ColorReplaceElement::videoOutputFormats() const
+{
+    return {AkVideoCaps::Format_argbpack};
+}
+
 QString ColorReplaceElement::controlInterfaceProvide(const QString &controlId) const
 {
     Q_UNUSED(controlId)
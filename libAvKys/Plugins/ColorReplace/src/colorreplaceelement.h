@@ -58,6 +58,8 @@ class ColorReplaceElement: public AkElement
         ColorReplaceElement();
         ~ColorReplaceElement();
 
+        Q_INVOKABLE AkVideoCaps::PixelFormatList videoInputFormats() const override;
+        Q_INVOKABLE AkVideoCaps::PixelFormatList videoOutputFormats() const override;
         Q_INVOKABLE QRgb from() const;
         Q_INVOKABLE QRgb to() const;
         Q_INVOKABLE int radius() const;
@@ -55,6 +55,16 @@ QString ColorTapElement::table() const
     return this->d->m_tableName;
 }
 
+AkVideoCaps::PixelFormatList ColorTapElement::videoInputFormats() const
+{
+    return {AkVideoCaps::Format_argbpack};
+}
+
+AkVideoCaps::PixelFormatList ColorTapElement::videoOutputFormats() const
+{
+    return {AkVideoCaps::Format_argbpack};
+}
+
 QString ColorTapElement::controlInterfaceProvide(const QString &controlId) const
 {
     Q_UNUSED(controlId)
@@ -37,6 +37,8 @@ class ColorTapElement: public AkElement
         ColorTapElement();
         ~ColorTapElement();
 
+        Q_INVOKABLE AkVideoCaps::PixelFormatList videoInputFormats() const override;
+        Q_INVOKABLE AkVideoCaps::PixelFormatList videoOutputFormats() const override;
         Q_INVOKABLE QString table() const;
 
     private:
@@ -63,6 +63,16 @@ QVariantList ColorTransformElement::kernel() const
     return kernel;
 }
 
+AkVideoCaps::PixelFormatList ColorTransformElement::videoInputFormats() const
+{
+    return {AkVideoCaps::Format_argbpack};
+}
+
+AkVideoCaps::PixelFormatList ColorTransformElement::videoOutputFormats() const
+{
+    return {AkVideoCaps::Format_argbpack};
+}
+
 QString ColorTransformElement::controlInterfaceProvide(const QString &controlId) const
 {
     Q_UNUSED(controlId)
@@ -53,6 +53,16 @@ int ContrastElement::contrast() const
     return this->d->m_contrast;
 }
 
+AkVideoCaps::PixelFormatList ContrastElement::videoInputFormats() const
+{
+    return {AkVideoCaps::Format_argbpack};
+}
+
+AkVideoCaps::PixelFormatList ContrastElement::videoOutputFormats() const
+{
+    return {AkVideoCaps::Format_argbpack};
+}
+
 QString ContrastElement::controlInterfaceProvide(const QString &controlId) const
 {
     Q_UNUSED(controlId)
@@ -37,6 +37,8 @@ class ContrastElement: public AkElement
         ContrastElement();
         ~ContrastElement();
 
+        Q_INVOKABLE AkVideoCaps::PixelFormatList videoInputFormats() const override;
+        Q_INVOKABLE AkVideoCaps::PixelFormatList videoOutputFormats() const override;
         Q_INVOKABLE int contrast() const;
 
     private:
@@ -17,11 +17,14 @@
  * Web-Site: http://webcamoid.github.io/
  */
 
+#include <QFuture>
 #include <QMutex>
 #include <QQmlContext>
 #include <QSize>
+#include <QThreadPool>
 #include <QVariant>
 #include <QVector>
+#include <QtConcurrent>
 #include <qrgb.h>
 #include <akfrac.h>
 #include <akpacket.h>
@@ -31,6 +34,18 @@
 
 #include "convolveelement.h"
 
+// Largest range of sums for which the output values are read from a table.
+#define MAX_OUTPUT_TABLE_SIZE (1 << 20)
+
+template<typename T>
+using ConvolveLineFunc = void (*)(const quint8 *plane,
+                                  size_t stride,
+                                  const int *kernel,
+                                  int kernelWidth,
+                                  int kernelHeight,
+                                  T *sums,
+                                  int width);
+
 class ConvolveElementPrivate
 {
     public:
@@ -40,6 +55,81 @@ class ConvolveElementPrivate
         QMutex m_mutex;
         int m_bias {0};
         AkVideoConverter m_videoConverter {{AkVideoCaps::Format_argbpack, 0, 0, {}}};
+        QThreadPool m_threadPool;
+
+        // Convolution plan, rebuilt when the parameters change.
+        bool m_planIsValid {false};
+        bool m_isSeparable {false};
+        int m_sumSize {sizeof(qint32)};
+        bool m_sumIsSigned {true};
+        QVector<int> m_rowKernel;
+        QVector<int> m_colKernel;
+        int m_minSum {0};
+        QVector<quint8> m_outputTable;
+
+        // Buffers kept between frames.
+        QSize m_curSize;
+        AkVideoPacket m_dst;
+        QVector<quint8> m_padded;
+        QByteArray m_intermediate;
+        int m_paddedWidth {0};
+        int m_paddedHeight {0};
+
+        void updatePlan();
+        void updateBuffers(const AkVideoCaps &caps);
+        void padFrame(const AkVideoPacket &src, int yStart, int yEnd);
+        template<typename T>
+        void convolveFrame(const AkVideoPacket &src);
+        template<typename T>
+        void convolve(const AkVideoPacket &src, ConvolveLineFunc<T> convolveLine);
+        template<typename T>
+        void convolveSeparable(const AkVideoPacket &src);
+        template<typename T, int KW, int KH>
+        static void convolveLineFixed(const quint8 *plane,
+                                      size_t stride,
+                                      const int *kernel,
+                                      int kernelWidth,
+                                      int kernelHeight,
+                                      T *sums,
+                                      int width);
+        template<typename T>
+        static void convolveLine(const quint8 *plane,
+                                 size_t stride,
+                                 const int *kernel,
+                                 int kernelWidth,
+                                 int kernelHeight,
+                                 T *sums,
+                                 int width);
+        template<typename T>
+        void writeLine(const AkVideoPacket &src, int y, const T *sums, int width);
+        quint8 outputValue(qint64 sum) const;
+
+        // Calls func(yStart, yEnd) for bands of lines, one per thread.
+        template <typename Func>
+        void forEachBand(int height, Func func)
+        {
+            int threads = qMax(1, this->m_threadPool.maxThreadCount());
+            int bandHeight = qMax(1, (height + threads - 1) / threads);
+            QList<QFuture<void>> bands;
+
+            for (int y = 0; y < height; y += bandHeight) {
+                int yEnd = qMin(y + bandHeight, height);
+
+                if (yEnd >= height) {
+                    func(y, yEnd);
+
+                    break;
+                }
+
+                bands << QtConcurrent::run(&this->m_threadPool,
+                                           [&func, y, yEnd] () {
+                                               func(y, yEnd);
+                                           });
+            }
+
+            for (auto &band: bands)
+                band.waitForFinished();
+        }
 };
 
 ConvolveElement::ConvolveElement(): AkElement()
@@ -83,6 +173,16 @@ int ConvolveElement::bias() const
     return this->d->m_bias;
 }
 
+AkVideoCaps::PixelFormatList ConvolveElement::videoInputFormats() const
+{
+    return {AkVideoCaps::Format_argbpack};
+}
+
+AkVideoCaps::PixelFormatList ConvolveElement::videoOutputFormats() const
+{
+    return {AkVideoCaps::Format_argbpack};
+}
+
 QString ConvolveElement::controlInterfaceProvide(const QString &controlId) const
 {
     Q_UNUSED(controlId)
@@ -108,12 +208,15 @@ AkPacket ConvolveElement::iVideoStream(const AkVideoPacket &packet)
     if (!src)
         return {};
 
-    AkVideoPacket dst(src.caps());
-    dst.copyMetadata(src);
-
     this->d->m_mutex.lock();
 
-    if (this->d->m_kernel.size() < 9) {
+    int kernelWidth = this->d->m_kernelSize.width();
+    int kernelHeight = this->d->m_kernelSize.height();
+
+    if (this->d->m_kernel.size() < 9
+        || kernelWidth < 1
+        || kernelHeight < 1
+        || this->d->m_kernel.size() < kernelWidth * kernelHeight) {
         this->d->m_mutex.unlock();
 
         if (packet)
@@ -122,67 +225,34 @@ AkPacket ConvolveElement::iVideoStream(const AkVideoPacket &packet)
         return packet;
     }
 
-    auto kernel = this->d->m_kernel.constData();
-    qint64 factorNum = this->d->m_factor.num();
-    qint64 factorDen = this->d->m_factor.den();
-    int kernelWidth = this->d->m_kernelSize.width();
-    int kernelHeight = this->d->m_kernelSize.height();
+    if (!this->d->m_planIsValid)
+        this->d->updatePlan();
 
-    int minI = -(kernelWidth - 1) / 2;
-    int maxI = (kernelWidth + 1) / 2;
-    int minJ = -(kernelHeight - 1) / 2;
-    int maxJ = (kernelHeight + 1) / 2;
-
-    for (int y = 0; y < src.caps().height(); y++) {
-        auto iLine = reinterpret_cast<const QRgb *>(src.constLine(0, y));
-        auto oLine = reinterpret_cast<QRgb *>(dst.line(0, y));
-
-        for (int x = 0; x < src.caps().width(); x++) {
-            int r = 0;
-            int g = 0;
-            int b = 0;
-
-            for (int j = minJ, k = 0; j < maxJ; j++) {
-                int yp = qBound(0, y + j, src.caps().height() - 1);
-                auto iLine =
-                        reinterpret_cast<const QRgb *>(src.constLine(0, yp));
-
-                for (int i = minI; i < maxI; i++, k++) {
-                    int xp = qBound(0, x + i, src.caps().width() - 1);
-
-                    if (kernel[k]) {
-                        auto pixel = iLine[xp];
-                        r += kernel[k] * qRed(pixel);
-                        g += kernel[k] * qGreen(pixel);
-                        b += kernel[k] * qBlue(pixel);
-                    }
-                }
-            }
+    this->d->updateBuffers(src.caps());
+    this->d->m_dst.copyMetadata(src);
 
-            if (factorNum) {
-                r = int(factorNum * r / factorDen + this->d->m_bias);
-                g = int(factorNum * g / factorDen + this->d->m_bias);
-                b = int(factorNum * b / factorDen + this->d->m_bias);
-
-                r = qBound(0, r, 255);
-                g = qBound(0, g, 255);
-                b = qBound(0, b, 255);
-            } else {
-                r = 255;
-                g = 255;
-                b = 255;
-            }
+    // Copy the frame with edge replicated borders, so the kernel can be
+    // applied to every pixel without bound checks.
+    this->d->forEachBand(this->d->m_paddedHeight,
+                         [this, &src] (int yStart, int yEnd) {
+        this->d->padFrame(src, yStart, yEnd);
+    });
 
-            oLine[x] = qRgba(r, g, b, qAlpha(iLine[x]));
-        }
-    }
+    // Use the smallest accumulator that can hold the sums, the narrower the
+    // type the more pixels are processed by each SIMD instruction.
+    if (this->d->m_sumSize == sizeof(qint32))
+        this->d->convolveFrame<qint32>(src);
+    else if (this->d->m_sumIsSigned)
+        this->d->convolveFrame<qint16>(src);
+    else
+        this->d->convolveFrame<quint16>(src);
 
     this->d->m_mutex.unlock();
 
-    if (dst)
-        emit this->oStream(dst);
+    if (this->d->m_dst)
+        emit this->oStream(this->d->m_dst);
 
-    return dst;
+    return this->d->m_dst;
 }
 
 void ConvolveElement::setKernel(const QVariantList &kernel)
@@ -197,6 +267,7 @@ void ConvolveElement::setKernel(const QVariantList &kernel)
 
     this->d->m_mutex.lock();
     this->d->m_kernel = k;
+    this->d->m_planIsValid = false;
     this->d->m_mutex.unlock();
     emit this->kernelChanged(kernel);
 }
@@ -208,6 +279,7 @@ void ConvolveElement::setKernelSize(const QSize &kernelSize)
 
     this->d->m_mutex.lock();
     this->d->m_kernelSize = kernelSize;
+    this->d->m_planIsValid = false;
     this->d->m_mutex.unlock();
     emit this->kernelSizeChanged(kernelSize);
 }
@@ -219,6 +291,7 @@ void ConvolveElement::setFactor(const AkFrac &factor)
 
     this->d->m_mutex.lock();
     this->d->m_factor = factor;
+    this->d->m_planIsValid = false;
     this->d->m_mutex.unlock();
     emit this->factorChanged(factor);
 }
@@ -230,6 +303,7 @@ void ConvolveElement::setBias(int bias)
 
     this->d->m_mutex.lock();
     this->d->m_bias = bias;
+    this->d->m_planIsValid = false;
     this->d->m_mutex.unlock();
     emit this->biasChanged(bias);
 }
@@ -260,4 +334,387 @@ void ConvolveElement::resetBias()
     this->setBias(0);
 }
 
+void ConvolveElementPrivate::updatePlan()
+{
+    int kernelWidth = this->m_kernelSize.width();
+    int kernelHeight = this->m_kernelSize.height();
+    int kernelSize = kernelWidth * kernelHeight;
+    auto kernel = this->m_kernel.constData();
+
+    // Range of the sums for each component.
+    qint64 minSum = 0;
+    qint64 maxSum = 0;
+
+    for (int k = 0; k < kernelSize; k++)
+        if (kernel[k] < 0)
+            minSum += 255 * qint64(kernel[k]);
+        else
+            maxSum += 255 * qint64(kernel[k]);
+
+    /* The sums are accumulated with wrap around arithmetic, so the result is
+     * exact as long as the final sum fits in the accumulator, no matter the
+     * partial sums.
+     */
+    if (minSum >= 0 && maxSum <= 65535) {
+        this->m_sumSize = sizeof(quint16);
+        this->m_sumIsSigned = false;
+    } else if (minSum >= -32768 && maxSum <= 32767) {
+        this->m_sumSize = sizeof(qint16);
+        this->m_sumIsSigned = true;
+    } else {
+        this->m_sumSize = sizeof(qint32);
+        this->m_sumIsSigned = true;
+    }
+
+    // Check if the kernel is the product of a column and a row, in that case
+    // it can be applied as two 1D passes.
+    this->m_isSeparable = false;
+    this->m_rowKernel.clear();
+    this->m_colKernel.clear();
+    int k0 = 0;
+
+    while (k0 < kernelSize && !kernel[k0])
+        k0++;
+
+    if (kernelWidth > 1 && kernelHeight > 1 && k0 < kernelSize) {
+        int j0 = k0 / kernelWidth;
+        int i0 = k0 % kernelWidth;
+        auto kernelLine = kernel + j0 * kernelWidth;
+        int gcd = 0;
+
+        for (int i = 0; i < kernelWidth; i++) {
+            int a = gcd;
+            int b = qAbs(kernelLine[i]);
+
+            while (b) {
+                int t = a % b;
+                a = b;
+                b = t;
+            }
+
+            gcd = a;
+        }
+
+        // Keep the signs in the column, so the factors of a non-negative
+        // kernel are non-negative too.
+        if (kernelLine[i0] < 0)
+            gcd = -gcd;
+
+        this->m_rowKernel.resize(kernelWidth);
+
+        for (int i = 0; i < kernelWidth; i++)
+            this->m_rowKernel[i] = kernelLine[i] / gcd;
+
+        this->m_colKernel.resize(kernelHeight);
+        bool isSeparable = true;
+
+        for (int j = 0; j < kernelHeight && isSeparable; j++) {
+            int value = kernel[j * kernelWidth + i0];
+
+            if (value % this->m_rowKernel[i0]) {
+                isSeparable = false;
+
+                break;
+            }
+
+            this->m_colKernel[j] = value / this->m_rowKernel[i0];
+
+            for (int i = 0; i < kernelWidth; i++)
+                if (qint64(this->m_colKernel[j]) * this->m_rowKernel[i]
+                    != kernel[j * kernelWidth + i]) {
+                    isSeparable = false;
+
+                    break;
+                }
+        }
+
+        // 3x3 kernels are applied directly, the extra pass costs more than
+        // the taps it saves.
+        this->m_isSeparable = isSeparable && kernelSize > 9;
+    }
+
+    // Map the sums to the output values.
+    this->m_outputTable.clear();
+    this->m_minSum = 0;
+
+    if (maxSum - minSum < MAX_OUTPUT_TABLE_SIZE) {
+        this->m_minSum = int(minSum);
+        this->m_outputTable.resize(int(maxSum - minSum + 1));
+
+        for (qint64 sum = minSum; sum <= maxSum; sum++)
+            this->m_outputTable[int(sum - minSum)] = this->outputValue(sum);
+    }
+
+    this->m_planIsValid = true;
+}
+
+void ConvolveElementPrivate::updateBuffers(const AkVideoCaps &caps)
+{
+    QSize frameSize(caps.width(), caps.height());
+
+    if (frameSize != this->m_curSize) {
+        this->m_curSize = frameSize;
+        this->m_dst = AkVideoPacket(caps);
+    }
+
+    this->m_paddedWidth = caps.width() + this->m_kernelSize.width() - 1;
+    this->m_paddedHeight = caps.height() + this->m_kernelSize.height() - 1;
+    this->m_padded.resize(3 * this->m_paddedWidth * this->m_paddedHeight);
+
+    if (this->m_isSeparable)
+        this->m_intermediate.resize(3
+                                    * caps.width()
+                                    * this->m_paddedHeight
+                                    * this->m_sumSize);
+}
+
+void ConvolveElementPrivate::padFrame(const AkVideoPacket &src,
+                                      int yStart,
+                                      int yEnd)
+{
+    int width = src.caps().width();
+    int height = src.caps().height();
+    int padLeft = (this->m_kernelSize.width() - 1) / 2;
+    int padTop = (this->m_kernelSize.height() - 1) / 2;
+    auto stride = size_t(this->m_paddedWidth);
+    auto planeSize = stride * size_t(this->m_paddedHeight);
+    auto padded = this->m_padded.data();
+
+    for (int y = yStart; y < yEnd; y++) {
+        int yp = qBound(0, y - padTop, height - 1);
+        auto iLine = reinterpret_cast<const QRgb *>(src.constLine(0, yp));
+        auto rLine = padded + size_t(y) * stride;
+        auto gLine = rLine + planeSize;
+        auto bLine = gLine + planeSize;
+
+        for (int x = 0; x < padLeft; x++) {
+            rLine[x] = quint8(qRed(iLine[0]));
+            gLine[x] = quint8(qGreen(iLine[0]));
+            bLine[x] = quint8(qBlue(iLine[0]));
+        }
+
+        for (int x = 0; x < width; x++) {
+            auto pixel = iLine[x];
+            rLine[padLeft + x] = quint8(qRed(pixel));
+            gLine[padLeft + x] = quint8(qGreen(pixel));
+            bLine[padLeft + x] = quint8(qBlue(pixel));
+        }
+
+        for (int x = padLeft + width; x < this->m_paddedWidth; x++) {
+            rLine[x] = quint8(qRed(iLine[width - 1]));
+            gLine[x] = quint8(qGreen(iLine[width - 1]));
+            bLine[x] = quint8(qBlue(iLine[width - 1]));
+        }
+    }
+}
+
+template<typename T>
+void ConvolveElementPrivate::convolveFrame(const AkVideoPacket &src)
+{
+    int kernelWidth = this->m_kernelSize.width();
+    int kernelHeight = this->m_kernelSize.height();
+
+    if (this->m_isSeparable)
+        this->convolveSeparable<T>(src);
+    else if (kernelWidth == 3 && kernelHeight == 3)
+        this->convolve<T>(src, ConvolveElementPrivate::convolveLineFixed<T, 3, 3>);
+    else if (kernelWidth == 5 && kernelHeight == 5)
+        this->convolve<T>(src, ConvolveElementPrivate::convolveLineFixed<T, 5, 5>);
+    else
+        this->convolve<T>(src, ConvolveElementPrivate::convolveLine<T>);
+}
+
+template<typename T>
+void ConvolveElementPrivate::convolve(const AkVideoPacket &src,
+                                      ConvolveLineFunc<T> convolveLine)
+{
+    int width = src.caps().width();
+    int kernelWidth = this->m_kernelSize.width();
+    int kernelHeight = this->m_kernelSize.height();
+    auto kernel = this->m_kernel.constData();
+    auto stride = size_t(this->m_paddedWidth);
+    auto planeSize = stride * size_t(this->m_paddedHeight);
+    auto padded = this->m_padded.constData();
+
+    this->forEachBand(src.caps().height(),
+                      [&] (int yStart, int yEnd) {
+        QVector<T> sums(3 * width);
+
+        for (int y = yStart; y < yEnd; y++) {
+            for (int c = 0; c < 3; c++)
+                convolveLine(padded + c * planeSize + size_t(y) * stride,
+                             stride,
+                             kernel,
+                             kernelWidth,
+                             kernelHeight,
+                             sums.data() + c * width,
+                             width);
+
+            this->writeLine(src, y, sums.constData(), width);
+        }
+    });
+}
+
+template<typename T>
+void ConvolveElementPrivate::convolveSeparable(const AkVideoPacket &src)
+{
+    int width = src.caps().width();
+    int height = src.caps().height();
+    int kernelWidth = this->m_kernelSize.width();
+    int kernelHeight = this->m_kernelSize.height();
+    auto rowKernel = this->m_rowKernel.constData();
+    auto colKernel = this->m_colKernel.constData();
+    auto stride = size_t(this->m_paddedWidth);
+    auto planeSize = stride * size_t(this->m_paddedHeight);
+    auto padded = this->m_padded.constData();
+    auto intermediate = reinterpret_cast<T *>(this->m_intermediate.data());
+    auto intermediatePlaneSize = size_t(width) * size_t(this->m_paddedHeight);
+
+    // Horizontal pass, over all the padded lines.
+    this->forEachBand(this->m_paddedHeight,
+                      [&] (int yStart, int yEnd) {
+        for (int y = yStart; y < yEnd; y++)
+            for (int c = 0; c < 3; c++)
+                ConvolveElementPrivate::convolveLine(padded
+                                                     + c * planeSize
+                                                     + size_t(y) * stride,
+                                                     stride,
+                                                     rowKernel,
+                                                     kernelWidth,
+                                                     1,
+                                                     intermediate
+                                                     + c * intermediatePlaneSize
+                                                     + size_t(y) * width,
+                                                     width);
+    });
+
+    // Vertical pass.
+    this->forEachBand(height,
+                      [&] (int yStart, int yEnd) {
+        QVector<T> sums(3 * width);
+
+        for (int y = yStart; y < yEnd; y++) {
+            for (int c = 0; c < 3; c++) {
+                auto cSums = sums.data() + c * width;
+                memset(cSums, 0, size_t(width) * sizeof(T));
+
+                for (int j = 0; j < kernelHeight; j++) {
+                    if (!colKernel[j])
+                        continue;
+
+                    auto k = T(colKernel[j]);
+                    auto line = intermediate
+                              + c * intermediatePlaneSize
+                              + size_t(y + j) * width;
+
+                    for (int x = 0; x < width; x++)
+                        cSums[x] = T(cSums[x] + k * line[x]);
+                }
+            }
+
+            this->writeLine(src, y, sums.constData(), width);
+        }
+    });
+}
+
+template<typename T, int KW, int KH>
+void ConvolveElementPrivate::convolveLineFixed(const quint8 *plane,
+                                               size_t stride,
+                                               const int *kernel,
+                                               int kernelWidth,
+                                               int kernelHeight,
+                                               T *sums,
+                                               int width)
+{
+    Q_UNUSED(kernelWidth)
+    Q_UNUSED(kernelHeight)
+
+    // All the taps are applied to each pixel at once, the compiler unrolls
+    // them and vectorizes the loop over the pixels.
+    T k[KW * KH];
+    const quint8 *lines[KH];
+
+    for (int i = 0; i < KW * KH; i++)
+        k[i] = T(kernel[i]);
+
+    for (int j = 0; j < KH; j++)
+        lines[j] = plane + j * stride;
+
+    for (int x = 0; x < width; x++) {
+        T sum = 0;
+
+        for (int j = 0; j < KH; j++)
+            for (int i = 0; i < KW; i++)
+                sum = T(sum + k[j * KW + i] * T(lines[j][x + i]));
+
+        sums[x] = sum;
+    }
+}
+
+template<typename T>
+void ConvolveElementPrivate::convolveLine(const quint8 *plane,
+                                          size_t stride,
+                                          const int *kernel,
+                                          int kernelWidth,
+                                          int kernelHeight,
+                                          T *sums,
+                                          int width)
+{
+    memset(sums, 0, size_t(width) * sizeof(T));
+
+    for (int j = 0; j < kernelHeight; j++)
+        for (int i = 0; i < kernelWidth; i++) {
+            auto k = T(kernel[j * kernelWidth + i]);
+
+            if (!k)
+                continue;
+
+            auto line = plane + j * stride + i;
+
+            for (int x = 0; x < width; x++)
+                sums[x] = T(sums[x] + k * T(line[x]));
+        }
+}
+
+template<typename T>
+void ConvolveElementPrivate::writeLine(const AkVideoPacket &src,
+                                       int y,
+                                       const T *sums,
+                                       int width)
+{
+    auto iLine = reinterpret_cast<const QRgb *>(src.constLine(0, y));
+    auto oLine = reinterpret_cast<QRgb *>(this->m_dst.line(0, y));
+    auto rSums = sums;
+    auto gSums = rSums + width;
+    auto bSums = gSums + width;
+
+    if (this->m_outputTable.isEmpty()) {
+        for (int x = 0; x < width; x++)
+            oLine[x] = qRgba(this->outputValue(rSums[x]),
+                             this->outputValue(gSums[x]),
+                             this->outputValue(bSums[x]),
+                             qAlpha(iLine[x]));
+    } else {
+        auto outputTable = this->m_outputTable.constData();
+        int minSum = this->m_minSum;
+
+        for (int x = 0; x < width; x++)
+            oLine[x] = qRgba(outputTable[rSums[x] - minSum],
+                             outputTable[gSums[x] - minSum],
+                             outputTable[bSums[x] - minSum],
+                             qAlpha(iLine[x]));
+    }
+}
+
+quint8 ConvolveElementPrivate::outputValue(qint64 sum) const
+{
+    qint64 factorNum = this->m_factor.num();
+    qint64 factorDen = this->m_factor.den();
+
+    if (!factorNum)
+        return 255;
+
+    return quint8(qBound(0, int(factorNum * sum / factorDen + this->m_bias), 255));
+}
+
 #include "moc_convolveelement.cpp"
@@ -53,6 +53,8 @@ class ConvolveElement: public AkElement
         ConvolveElement();
         ~ConvolveElement();
 
+        Q_INVOKABLE AkVideoCaps::PixelFormatList videoInputFormats() const override;
+        Q_INVOKABLE AkVideoCaps::PixelFormatList videoOutputFormats() const override;
         Q_INVOKABLE QVariantList kernel() const;
         Q_INVOKABLE QSize kernelSize() const;
         Q_INVOKABLE AkFrac factor() const;
@@ -223,24 +223,32 @@ AkPacket CropElement::iVideoStream(const AkVideoPacket &packet)
         return dst;
     }
 
+    /* Without scaling the cropped frame is just a region of the input frame,
+     * so send a view of it instead of converting it.
+     */
+    if (!this->d->m_keepResolution) {
+        auto cropped = packet.view(srcRect);
+
+        if (cropped)
+            emit this->oStream(cropped);
+
+        return cropped;
+    }
+
     QRect dstRect;
 
-    if (this->d->m_keepResolution) {
-        if (packet.caps().width() * srcRect.height() <= packet.caps().height() * srcRect.width()) {
-            int dstHeight = packet.caps().width() * srcRect.height() / srcRect.width();
-            dstRect = {0,
-                       (packet.caps().height() - dstHeight) / 2,
-                       packet.caps().width(),
-                       dstHeight};
-        } else {
-            int dstWidth = packet.caps().height() * srcRect.width() / srcRect.height();
-            dstRect = {(packet.caps().width() - dstWidth) / 2,
-                       0,
-                       dstWidth,
-                       packet.caps().height()};
-        }
+    if (packet.caps().width() * srcRect.height() <= packet.caps().height() * srcRect.width()) {
+        int dstHeight = packet.caps().width() * srcRect.height() / srcRect.width();
+        dstRect = {0,
+                   (packet.caps().height() - dstHeight) / 2,
+                   packet.caps().width(),
+                   dstHeight};
     } else {
-        dstRect = {0, 0, srcRect.width(), srcRect.height()};
+        int dstWidth = packet.caps().height() * srcRect.width() / srcRect.height();
+        dstRect = {(packet.caps().width() - dstWidth) / 2,
+                   0,
+                   dstWidth,
+                   packet.caps().height()};
     }
 
     this->d->m_videoConverter.setInputRect(srcRect);
@@ -252,21 +260,9 @@ AkPacket CropElement::iVideoStream(const AkVideoPacket &packet)
     auto cropped = this->d->m_videoConverter.convert(packet);
     this->d->m_videoConverter.end();
 
-    if (!this->d->m_keepResolution) {
-        if (cropped)
-            emit this->oStream(cropped);
-
-        return cropped;
-    }
-
     auto caps = packet.caps();
     caps.setFormat(this->d->m_videoConverter.outputCaps().format());
 
-    if (!this->d->m_keepResolution) {
-        caps.setWidth(srcRect.width());
-        caps.setHeight(srcRect.height());
-    }
-
     AkVideoPacket dst(caps);
     dst.copyMetadata(packet);
     dst.fill(this->d->m_fillColor);
@@ -21,13 +21,13 @@
 #include <QMap>
 #include <QMutex>
 #include <QQmlContext>
-#include <QRandomGenerator>
 #include <QSize>
 #include <QVector>
 #include <QtMath>
 #include <qrgb.h>
 #include <akfrac.h>
 #include <akpacket.h>
+#include <akrandom.h>
 #include <akvideocaps.h>
 #include <akvideoconverter.h>
 #include <akvideopacket.h>
@@ -74,6 +74,16 @@ int DelayGrabElement::nFrames() const
     return this->d->m_nFrames;
 }
 
+AkVideoCaps::PixelFormatList DelayGrabElement::videoInputFormats() const
+{
+    return {AkVideoCaps::Format_argbpack};
+}
+
+AkVideoCaps::PixelFormatList DelayGrabElement::videoOutputFormats() const
+{
+    return {AkVideoCaps::Format_argbpack};
+}
+
 QString DelayGrabElement::controlInterfaceProvide(const QString &controlId) const
 {
     Q_UNUSED(controlId)
@@ -273,7 +283,7 @@ void DelayGrabElementPrivate::updateDelaymap()
             switch (this->m_mode) {
             case DelayGrabElement::DelayGrabModeRandomSquare: {
                 // Random delay with square distribution
-                auto d = QRandomGenerator::global()->bounded(1.0);
+                auto d = AkRandom::local().bounded(1.0);
                 value = qRound(16.0 * d * d);
 
                 break;
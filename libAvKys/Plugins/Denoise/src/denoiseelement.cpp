@@ -195,6 +195,16 @@ void DenoiseElementPrivate::makeTable(int factor)
     }
 }
 
+AkVideoCaps::PixelFormatList DenoiseElement::videoInputFormats() const
+{
+    return {AkVideoCaps::Format_argbpack};
+}
+
+AkVideoCaps::PixelFormatList DenoiseElement::videoOutputFormats() const
+{
+    return {AkVideoCaps::Format_argbpack};
+}
+
 QString DenoiseElement::controlInterfaceProvide(const QString &controlId) const
 {
     Q_UNUSED(controlId)
@@ -52,6 +52,8 @@ class DenoiseElement: public AkElement
         DenoiseElement();
         ~DenoiseElement();
 
+        Q_INVOKABLE AkVideoCaps::PixelFormatList videoInputFormats() const override;
+        Q_INVOKABLE AkVideoCaps::PixelFormatList videoOutputFormats() const override;
         Q_INVOKABLE int radius() const;
         Q_INVOKABLE int factor() const;
         Q_INVOKABLE int mu() const;
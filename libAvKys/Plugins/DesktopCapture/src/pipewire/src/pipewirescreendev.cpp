@@ -24,9 +24,11 @@
 #include <QFuture>
 #include <QMutex>
 #include <QScreen>
+#include <QSet>
 #include <QThreadPool>
 #include <QTime>
 #include <QTimer>
+#include <QWaitCondition>
 #include <QWindow>
 #include <QtConcurrent>
 #include <ak.h>
@@ -110,6 +112,47 @@ using PwThreadLoopUnlockType = void (*)(pw_thread_loop *loop);
 using PwThreadLoopWaitType = void (*)(pw_thread_loop *loop);
 #endif
 
+/* The frames are copied instead of adopting the buffers when the stream would
+ * be left with less than this number of free buffers.
+ */
+#define MIN_FREE_BUFFERS 2
+
+// Maximum time to wait for the packets using a buffer that is being removed.
+#define REMOVE_BUFFER_TIMEOUT 1000
+
+class PipewireScreenDevPrivate;
+
+class StreamBuffersOwner
+{
+    public:
+        QMutex m_mutex;
+        QWaitCondition m_bufferReleased;
+        PipewireScreenDevPrivate *m_device {nullptr};
+        pw_stream *m_stream {nullptr};
+        QSet<pw_buffer *> m_adoptedBuffers;
+        QSet<pw_buffer *> m_returningBuffers;
+        QSet<pw_buffer *> m_removedBuffers;
+        int m_nBuffers {0};
+        int m_queueing {0};
+
+        bool adopt(pw_buffer *buffer);
+        void addBuffer();
+        void removeBuffer(pw_buffer *buffer);
+        void invalidate();
+};
+
+using StreamBuffersOwnerPtr = QSharedPointer<StreamBuffersOwner>;
+
+class AdoptedBuffer
+{
+    public:
+        StreamBuffersOwnerPtr owner;
+        pw_stream *stream {nullptr};
+        pw_buffer *buffer {nullptr};
+
+        static void release(void *opaque);
+};
+
 class PipewireScreenDevPrivate
 {
     public:
@@ -123,6 +166,7 @@ class PipewireScreenDevPrivate
         pw_core *m_pwStreamCore {nullptr};
         pw_stream *m_pwStream {nullptr};
         spa_hook m_streamHook;
+        StreamBuffersOwnerPtr m_streamBuffersOwner;
         AkFrac m_fps {30000, 1001};
         bool m_showCursor {false};
         qint64 m_id {-1};
@@ -176,6 +220,9 @@ class PipewireScreenDevPrivate
         static void streamParamChangedEvent(void *userData,
                                             uint32_t id,
                                             const struct spa_pod *param);
+        static void streamAddBufferEvent(void *userData, pw_buffer *buffer);
+        static void streamRemoveBufferEvent(void *userData,
+                                            pw_buffer *buffer);
         static void streamProcessEvent(void *userData);
 
         // PipeWire functions wrappers
@@ -456,8 +503,8 @@ static const struct pw_stream_events pipewireDesktopStreamEvents = {
     .control_info  = nullptr                                          ,
     .io_changed    = nullptr                                          ,
     .param_changed = PipewireScreenDevPrivate::streamParamChangedEvent,
-    .add_buffer    = nullptr                                          ,
-    .remove_buffer = nullptr                                          ,
+    .add_buffer    = PipewireScreenDevPrivate::streamAddBufferEvent   ,
+    .remove_buffer = PipewireScreenDevPrivate::streamRemoveBufferEvent,
     .process       = PipewireScreenDevPrivate::streamProcessEvent     ,
 };
 
@@ -996,6 +1043,9 @@ void PipewireScreenDevPrivate::initPipewire(int pipewireFd)
             this->pwStreamNew(this->m_pwStreamCore,
                               "Webcamoid Screen Capture",
                               this->pwPropertiesNewDict(&dict));
+    this->m_streamBuffersOwner = StreamBuffersOwnerPtr::create();
+    this->m_streamBuffersOwner->m_device = this;
+    this->m_streamBuffersOwner->m_stream = this->m_pwStream;
     this->pwStreamAddListener(this->m_pwStream,
                               &this->m_streamHook,
                               &pipewireDesktopStreamEvents,
@@ -1058,6 +1108,9 @@ void PipewireScreenDevPrivate::uninitPipewire()
 {
     this->m_run = false;
 
+    if (this->m_streamBuffersOwner)
+        this->m_streamBuffersOwner->invalidate();
+
     if (this->m_pwStreamLoop) {
         this->pwThreadLoopWait(this->m_pwStreamLoop);
         this->pwThreadLoopStop(this->m_pwStreamLoop);
@@ -1069,6 +1122,8 @@ void PipewireScreenDevPrivate::uninitPipewire()
         this->m_pwStream = nullptr;
     }
 
+    this->m_streamBuffersOwner.clear();
+
     if (this->m_pwStreamContext) {
         this->pwContextDestroy(this->m_pwStreamContext);
         this->m_pwStreamContext = nullptr;
@@ -1142,6 +1197,29 @@ void PipewireScreenDevPrivate::streamParamChangedEvent(void *userData,
     qInfo() << "Stream format:" << self->m_curCaps;
 }
 
+void PipewireScreenDevPrivate::streamAddBufferEvent(void *userData,
+                                                    pw_buffer *buffer)
+{
+    Q_UNUSED(buffer)
+    auto self = reinterpret_cast<PipewireScreenDevPrivate *>(userData);
+
+    if (self->m_streamBuffersOwner)
+        self->m_streamBuffersOwner->addBuffer();
+}
+
+void PipewireScreenDevPrivate::streamRemoveBufferEvent(void *userData,
+                                                       pw_buffer *buffer)
+{
+    auto self = reinterpret_cast<PipewireScreenDevPrivate *>(userData);
+
+    if (!self->m_streamBuffersOwner)
+        return;
+
+    // Don't keep the removed buffer alive in the last sent frame.
+    self->m_curPacket = {};
+    self->m_streamBuffersOwner->removeBuffer(buffer);
+}
+
 void PipewireScreenDevPrivate::streamProcessEvent(void *userData)
 {
     auto self = reinterpret_cast<PipewireScreenDevPrivate *>(userData);
@@ -1150,18 +1228,44 @@ void PipewireScreenDevPrivate::streamProcessEvent(void *userData)
     if (!buffer)
         return;
 
-    if (!buffer->buffer->datas[0].data)
+    auto &data = buffer->buffer->datas[0];
+
+    if (!data.data || !data.chunk)
         return;
 
-    AkVideoPacket packet(self->m_curCaps);
-    auto iLineSize = buffer->buffer->datas[0].chunk->stride;
-    auto oLineSize = packet.lineSize(0);
-    auto lineSize = qMin<size_t>(iLineSize, oLineSize);
+    AkVideoPacket packet;
+
+    /* Wrap the buffer instead of copying it, it will be queued back to the
+     * stream when the last copy of the packet is released. If the stream is
+     * running short of buffers, copy the frame and give it back right away.
+     */
+    if (self->m_streamBuffersOwner
+        && self->m_streamBuffersOwner->adopt(buffer)) {
+        auto adoptedBuffer = new AdoptedBuffer;
+        adoptedBuffer->owner = self->m_streamBuffersOwner;
+        adoptedBuffer->stream = self->m_pwStream;
+        adoptedBuffer->buffer = buffer;
+        quint8 *planes[] {reinterpret_cast<quint8 *>(data.data) + data.chunk->offset};
+        size_t lineSizes[] {size_t(data.chunk->stride)};
+        packet = AkVideoPacket(self->m_curCaps,
+                               planes,
+                               lineSizes,
+                               data.chunk->size,
+                               AdoptedBuffer::release,
+                               adoptedBuffer);
+    } else {
+        packet = AkVideoPacket(self->m_curCaps);
+        auto iLineSize = data.chunk->stride;
+        auto oLineSize = packet.lineSize(0);
+        auto lineSize = qMin<size_t>(iLineSize, oLineSize);
 
-    for (int y = 0; y < packet.caps().height(); y++)
-        memcpy(packet.line(0, y),
-               reinterpret_cast<quint8 *>(buffer->buffer->datas[0].data) + y * iLineSize,
-               lineSize);
+        for (int y = 0; y < packet.caps().height(); y++)
+            memcpy(packet.line(0, y),
+                   reinterpret_cast<quint8 *>(data.data) + y * iLineSize,
+                   lineSize);
+
+        self->pwStreamQueueBuffer(self->m_pwStream, buffer);
+    }
 
     auto fps = self->m_curCaps.fps();
     auto pts = qRound64(QTime::currentTime().msecsSinceStartOfDay()
@@ -1187,8 +1291,113 @@ void PipewireScreenDevPrivate::streamProcessEvent(void *userData)
                                   self,
                                   self->m_curPacket);
     }
+}
 
-    self->pwStreamQueueBuffer(self->m_pwStream, buffer);
+void AdoptedBuffer::release(void *opaque)
+{
+    /* This can be called from any thread. The buffer is queued back right
+     * away, so the stream doesn't run out of buffers while the packets wait
+     * in the queues of the pipeline. The loop lock is recursive, so this also
+     * works from the stream thread.
+     */
+    auto self = reinterpret_cast<AdoptedBuffer *>(opaque);
+    auto owner = self->owner;
+    auto device = owner->m_device;
+    owner->m_mutex.lock();
+    owner->m_adoptedBuffers.remove(self->buffer);
+    bool queue = !owner->m_removedBuffers.remove(self->buffer)
+                 && owner->m_stream == self->stream;
+
+    if (queue) {
+        owner->m_returningBuffers << self->buffer;
+        owner->m_queueing++;
+    }
+
+    owner->m_bufferReleased.wakeAll();
+    owner->m_mutex.unlock();
+
+    if (queue) {
+        device->pwThreadLoopLock(device->m_pwStreamLoop);
+
+        /* Check again with the loop locked, the buffer could have been
+         * removed in the meantime.
+         */
+        owner->m_mutex.lock();
+        queue = owner->m_returningBuffers.remove(self->buffer)
+                && owner->m_stream == self->stream;
+        owner->m_mutex.unlock();
+
+        if (queue)
+            device->pwStreamQueueBuffer(self->stream, self->buffer);
+
+        device->pwThreadLoopUnlock(device->m_pwStreamLoop);
+
+        owner->m_mutex.lock();
+        owner->m_queueing--;
+        owner->m_bufferReleased.wakeAll();
+        owner->m_mutex.unlock();
+    }
+
+    delete self;
+}
+
+bool StreamBuffersOwner::adopt(pw_buffer *buffer)
+{
+    this->m_mutex.lock();
+    bool adopt =
+            this->m_nBuffers - this->m_adoptedBuffers.size() - 1 >= MIN_FREE_BUFFERS;
+
+    if (adopt)
+        this->m_adoptedBuffers << buffer;
+
+    this->m_mutex.unlock();
+
+    return adopt;
+}
+
+void StreamBuffersOwner::addBuffer()
+{
+    this->m_mutex.lock();
+    this->m_nBuffers++;
+    this->m_mutex.unlock();
+}
+
+void StreamBuffersOwner::removeBuffer(pw_buffer *buffer)
+{
+    this->m_mutex.lock();
+    this->m_nBuffers--;
+    this->m_returningBuffers.remove(buffer);
+
+    /* The memory of the buffer goes away with it, so wait until the last
+     * packet using it is released.
+     */
+    if (this->m_adoptedBuffers.contains(buffer)) {
+        this->m_removedBuffers << buffer;
+        QDeadlineTimer deadline(REMOVE_BUFFER_TIMEOUT);
+
+        while (this->m_adoptedBuffers.contains(buffer))
+            if (!this->m_bufferReleased.wait(&this->m_mutex, deadline)) {
+                qWarning() << "Timeout waiting for the packets using a removed buffer";
+
+                break;
+            }
+    }
+
+    this->m_mutex.unlock();
+}
+
+void StreamBuffersOwner::invalidate()
+{
+    /* Packets still holding adopted buffers must not give them back to a
+     * stream that is going to be destroyed.
+     */
+    this->m_mutex.lock();
+    this->m_stream = nullptr;
+
+    while (this->m_queueing > 0)
+        this->m_bufferReleased.wait(&this->m_mutex);
+
+    this->m_mutex.unlock();
 }
 
 #include "moc_pipewirescreendev.cpp"
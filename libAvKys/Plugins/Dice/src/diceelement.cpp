@@ -19,12 +19,12 @@
 
 #include <QMutex>
 #include <QQmlContext>
-#include <QRandomGenerator>
 #include <QSize>
 #include <QtMath>
 #include <akfrac.h>
 #include <akpacket.h>
 #include <akpluginmanager.h>
+#include <akrandom.h>
 #include <akvideocaps.h>
 #include <akvideoconverter.h>
 #include <akvideomixer.h>
@@ -68,6 +68,16 @@ int DiceElement::diceSize() const
     return this->d->m_diceSize;
 }
 
+AkVideoCaps::PixelFormatList DiceElement::videoInputFormats() const
+{
+    return {AkVideoCaps::Format_argbpack};
+}
+
+AkVideoCaps::PixelFormatList DiceElement::videoOutputFormats() const
+{
+    return {AkVideoCaps::Format_argbpack};
+}
+
 QString DiceElement::controlInterfaceProvide(const QString &controlId) const
 {
     Q_UNUSED(controlId)
@@ -169,12 +179,11 @@ void DiceElementPrivate::updateDiceMap(const QSize &frameSize, int diceSize)
 
     AkVideoPacket diceMap({AkVideoCaps::Format_y8, width, height, {}});
 
-    for (int y = 0; y < diceMap.caps().height(); y++) {
-        auto oLine = diceMap.line(0, y);
-
-        for (int x = 0; x < diceMap.caps().width(); x++)
-            oLine[x] = quint8(QRandomGenerator::global()->bounded(4));
-    }
+    for (int y = 0; y < diceMap.caps().height(); y++)
+        AkRandom::local().fillBounded(diceMap.line(0, y),
+                                      size_t(diceMap.caps().width()),
+                                      0,
+                                      4);
 
     this->m_diceMap = diceMap;
 }
@@ -37,6 +37,8 @@ class DiceElement: public AkElement
         DiceElement();
         ~DiceElement();
 
+        Q_INVOKABLE AkVideoCaps::PixelFormatList videoInputFormats() const override;
+        Q_INVOKABLE AkVideoCaps::PixelFormatList videoOutputFormats() const override;
         Q_INVOKABLE int diceSize() const;
 
     private:
@@ -110,6 +110,16 @@ QVector<QPoint> DistortElementPrivate::createGrid(int width,
     return grid;
 }
 
+AkVideoCaps::PixelFormatList DistortElement::videoInputFormats() const
+{
+    return {AkVideoCaps::Format_argbpack};
+}
+
+AkVideoCaps::PixelFormatList DistortElement::videoOutputFormats() const
+{
+    return {AkVideoCaps::Format_argbpack};
+}
+
 QString DistortElement::controlInterfaceProvide(const QString &controlId) const
 {
     Q_UNUSED(controlId)
@@ -47,6 +47,8 @@ class DistortElement: public AkElement
         DistortElement();
         ~DistortElement();
 
+        Q_INVOKABLE AkVideoCaps::PixelFormatList videoInputFormats() const override;
+        Q_INVOKABLE AkVideoCaps::PixelFormatList videoOutputFormats() const override;
         Q_INVOKABLE qreal amplitude() const;
         Q_INVOKABLE qreal frequency() const;
         Q_INVOKABLE int gridSizeLog() const;
@@ -27,9 +27,12 @@
 #include <akvideoconverter.h>
 #include <akvideomixer.h>
 #include <akvideopacket.h>
+#include <akvideowarp.h>
 
 #include "dizzyelement.h"
 
+#define VALUE_SHIFT 8
+
 class DizzyElementPrivate
 {
     public:
@@ -37,10 +40,10 @@ class DizzyElementPrivate
         qreal m_zoomRate {0.02};
         qreal m_strength {0.75};
         AkVideoPacket m_prevFrame;
-        AkElementPtr m_transform {akPluginManager->create<AkElement>("VideoFilter/MatrixTransform")};
         AkElementPtr m_opacity {akPluginManager->create<AkElement>("VideoFilter/Opacity")};
         AkVideoConverter m_videoConverter {{AkVideoCaps::Format_argbpack, 0, 0, {}}};
         AkVideoMixer m_videoMixer;
+        AkVideoWarp m_warp;
 };
 
 DizzyElement::DizzyElement():
@@ -69,6 +72,16 @@ qreal DizzyElement::strength() const
     return this->d->m_strength;
 }
 
+AkVideoCaps::PixelFormatList DizzyElement::videoInputFormats() const
+{
+    return {AkVideoCaps::Format_argbpack};
+}
+
+AkVideoCaps::PixelFormatList DizzyElement::videoOutputFormats() const
+{
+    return {AkVideoCaps::Format_argbpack};
+}
+
 QString DizzyElement::controlInterfaceProvide(const QString &controlId) const
 {
     Q_UNUSED(controlId)
@@ -104,13 +117,32 @@ AkPacket DizzyElement::iVideoStream(const AkVideoPacket &packet)
                 / this->d->m_speed;
     qreal angle = (2.0 * qSin(pts) + qSin(pts + 2.5)) * M_PI / 180.0;
     qreal scale = 1.0 + this->d->m_zoomRate;
-    QVariantList kernel {
-        scale * qCos(angle), -scale * qSin(angle), 0,
-        scale * qSin(angle),  scale * qCos(angle), 0,
+    qreal kernel[] {
+        scale * qCos(angle), -scale * qSin(angle),
+        scale * qSin(angle),  scale * qCos(angle),
+    };
+
+    // Rotate and zoom the previous frame around its center, reading each
+    // pixel from the inverse transform.
+    auto det = kernel[0] * kernel[3] - kernel[1] * kernel[2];
+
+    if (qFuzzyCompare(det, 0.0))
+        det = 0.01;
+
+    auto mult = (1 << VALUE_SHIFT) / det;
+    qint64 ik[] {
+         qRound(mult * kernel[3]), -qRound(mult * kernel[2]),
+        -qRound(mult * kernel[1]),  qRound(mult * kernel[0]),
+    };
+    qint64 cx = this->d->m_prevFrame.caps().width() >> 1;
+    qint64 cy = this->d->m_prevFrame.caps().height() >> 1;
+    qint64 matrix[] {
+        ik[0], ik[1], (cx << VALUE_SHIFT) - cx * ik[0] - cy * ik[1],
+        ik[2], ik[3], (cy << VALUE_SHIFT) - cx * ik[2] - cy * ik[3],
     };
-    this->d->m_transform->setProperty("kernel", kernel);
-    AkVideoPacket transformedFrame =
-            this->d->m_transform->iStream(this->d->m_prevFrame);
+    this->d->m_warp.setMatrix(matrix, VALUE_SHIFT);
+    AkVideoPacket transformedFrame(this->d->m_prevFrame.caps());
+    this->d->m_warp.warp(this->d->m_prevFrame, transformedFrame);
 
     auto opacity = qBound(0.0, 1.0 - this->d->m_strength, 1.0);;
     this->d->m_opacity->setProperty("opacity", opacity);
@@ -47,6 +47,8 @@ class DizzyElement: public AkElement
         DizzyElement();
         ~DizzyElement();
 
+        Q_INVOKABLE AkVideoCaps::PixelFormatList videoInputFormats() const override;
+        Q_INVOKABLE AkVideoCaps::PixelFormatList videoOutputFormats() const override;
         Q_INVOKABLE qreal speed() const;
         Q_INVOKABLE qreal zoomRate() const;
         Q_INVOKABLE qreal strength() const;
@@ -21,9 +21,12 @@
 #include <QVector>
 #include <QtMath>
 #include <akfrac.h>
+#include <akhistogram.h>
 #include <akpacket.h>
 #include <akvideocaps.h>
 #include <akvideoconverter.h>
+#include <akvideoformatspec.h>
+#include <akvideoformattraits.h>
 #include <akvideopacket.h>
 
 #include "edgeelement.h"
@@ -37,8 +40,13 @@ class EdgeElementPrivate
         bool m_equalize {false};
         bool m_invert {false};
         AkVideoConverter m_videoConverter {{AkVideoCaps::Format_ya88pack, 0, 0, {}}};
+        AkHistogram m_histogram;
 
+        template <typename Traits>
+        AkVideoPacket edges(const AkVideoPacket &src);
+        template <typename Traits>
         AkVideoPacket equalize(const AkVideoPacket &src);
+        template <typename Traits>
         void sobel(const AkVideoPacket &gray,
                    AkVideoPacket &gradient,
                    AkVideoPacket &direction) const;
@@ -88,6 +96,13 @@ bool EdgeElement::invert() const
     return this->d->m_invert;
 }
 
+AkVideoCaps::PixelFormatList EdgeElement::videoInputFormats() const
+{
+    return {AkVideoCaps::Format_y8,
+            AkVideoCaps::Format_ya88,
+            AkVideoCaps::Format_ay88};
+}
+
 QString EdgeElement::controlInterfaceProvide(const QString &controlId) const
 {
     Q_UNUSED(controlId)
@@ -106,59 +121,29 @@ void EdgeElement::controlInterfaceConfigure(QQmlContext *context,
 
 AkPacket EdgeElement::iVideoStream(const AkVideoPacket &packet)
 {
-    this->d->m_videoConverter.begin();
-    auto src = this->d->m_videoConverter.convert(packet);
-    this->d->m_videoConverter.end();
-
-    if (!src)
-        return {};
-
-    AkVideoPacket dst(src.caps());
-    dst.copyMetadata(src);
-    AkVideoPacket src_;
-
-    if (this->d->m_equalize)
-        src_ = this->d->equalize(src);
-    else
-        src_ = src;
-
-    AkVideoPacket gradient;
-    AkVideoPacket direction;
-    this->d->sobel(src_, gradient, direction);
-    auto invert = this->d->m_invert;
-
-    if (this->d->m_canny) {
-        auto thinned = this->d->thinning(gradient, direction);
-        QVector<int> thresholds {this->d->m_thLow, this->d->m_thHi};
-        QVector<int> colors {0, 127, 255};
-        auto thresholded = this->d->threshold(thinned, thresholds, colors);
-        auto canny = this->d->hysteresisThresholding(thresholded);
-
-        for (int y = 0; y < src.caps().height(); y++) {
-            auto cannyLine = canny.constLine(0, y);
-            auto srcLine = reinterpret_cast<const quint16 *>(src_.constLine(0, y));
-            auto dstLine = reinterpret_cast<quint16 *>(dst.line(0, y));
-
-            for (int x = 0; x < src.caps().width(); x++) {
-                auto &pixel = cannyLine[x];
-                quint16 y = invert? 255 - pixel: pixel;
-                quint16 a = srcLine[x] & 0xff;
-                dstLine[x] = y << 8 | a;
-            }
-        }
-    } else {
-        for (int y = 0; y < src.caps().height(); y++) {
-            auto gradientLine = reinterpret_cast<const quint16 *>(gradient.constLine(0, y));
-            auto srcLine = reinterpret_cast<const quint16 *>(src_.constLine(0, y));
-            auto dstLine = reinterpret_cast<quint16 *>(dst.line(0, y));
-
-            for (int x = 0; x < src.caps().width(); x++) {
-                auto pixel = quint8(qBound<int>(0, gradientLine[x], 255));
-                quint16 y = invert? 255 - pixel: pixel;
-                quint16 a = srcLine[x] & 0xff;
-                dstLine[x] = y << 8 | a;
-            }
-        }
+    AkVideoPacket dst;
+
+    // Gray frames with a known layout are processed as they come, the rest
+    // are converted to ya88pack first.
+    auto specs = AkVideoCaps::formatSpecs(packet.caps().format());
+    bool isProcessed =
+        specs.type() == AkVideoFormatSpec::VFT_Gray
+        && akVideoFormatDispatch(packet.caps().format(),
+                                 [this, &dst, &packet] (auto traits) {
+            dst = this->d->edges<decltype(traits)>(packet);
+        });
+
+    if (!isProcessed) {
+        this->d->m_videoConverter.begin();
+        auto src = this->d->m_videoConverter.convert(packet);
+        this->d->m_videoConverter.end();
+
+        if (!src)
+            return {};
+
+        // The layout of ya88pack is the one the filter always assumed, so
+        // there is no need to check it against the formats table here.
+        dst = this->d->edges<AkVideoFormatTraits<AkVideoCaps::Format_ya88pack>>(src);
     }
 
     if (dst)
@@ -237,34 +222,88 @@ void EdgeElement::resetInvert()
     this->setInvert(false);
 }
 
-AkVideoPacket EdgeElementPrivate::equalize(const AkVideoPacket &src)
+template <typename Traits>
+AkVideoPacket EdgeElementPrivate::edges(const AkVideoPacket &src)
 {
+    using Gray = typename Traits::X;
+    using Alpha = typename Traits::A;
+
     AkVideoPacket dst(src.caps());
     dst.copyMetadata(src);
-    int minGray = 255;
-    int maxGray = 0;
+    AkVideoPacket src_;
+
+    if (this->m_equalize)
+        src_ = this->equalize<Traits>(src);
+    else
+        src_ = src;
+
+    AkVideoPacket gradient;
+    AkVideoPacket direction;
+    this->sobel<Traits>(src_, gradient, direction);
+    auto invert = this->m_invert;
+
+    if (this->m_canny) {
+        auto thinned = this->thinning(gradient, direction);
+        QVector<int> thresholds {this->m_thLow, this->m_thHi};
+        QVector<int> colors {0, 127, 255};
+        auto thresholded = this->threshold(thinned, thresholds, colors);
+        auto canny = this->hysteresisThresholding(thresholded);
+
+        for (int y = 0; y < src.caps().height(); y++) {
+            auto cannyLine = canny.constLine(0, y);
+            auto srcLine = src_.constLine(0, y);
+            auto dstLine = dst.line(0, y);
 
-    for (int y = 0; y < src.caps().height(); y++) {
-        auto line = reinterpret_cast<const quint16 *>(src.constLine(0, y));
+            for (int x = 0; x < src.caps().width(); x++) {
+                auto &pixel = cannyLine[x];
+                Gray::write(dstLine, x, invert? 255 - pixel: pixel);
 
-        for (int x = 0; x < src.caps().width(); x++) {
-            auto gray = line[x] >> 8;
+                if (Traits::hasAlpha)
+                    Alpha::write(dstLine, x, Alpha::read(srcLine, x));
+            }
+        }
+    } else {
+        for (int y = 0; y < src.caps().height(); y++) {
+            auto gradientLine = reinterpret_cast<const quint16 *>(gradient.constLine(0, y));
+            auto srcLine = src_.constLine(0, y);
+            auto dstLine = dst.line(0, y);
 
-            if (gray < minGray)
-                minGray = gray;
+            for (int x = 0; x < src.caps().width(); x++) {
+                auto pixel = quint8(qBound<int>(0, gradientLine[x], 255));
+                Gray::write(dstLine, x, invert? 255 - pixel: pixel);
 
-            if (gray > maxGray)
-                maxGray = gray;
+                if (Traits::hasAlpha)
+                    Alpha::write(dstLine, x, Alpha::read(srcLine, x));
+            }
         }
     }
 
+    return dst;
+}
+
+template <typename Traits>
+AkVideoPacket EdgeElementPrivate::equalize(const AkVideoPacket &src)
+{
+    using Gray = typename Traits::X;
+
+    AkVideoPacket dst(src.caps());
+    dst.copyMetadata(src);
+    this->m_histogram.compute(src, AkColorComponent::CT_Y);
+    int minGray = qMax(this->m_histogram.minimum(), 0);
+    int maxGray = qMax(this->m_histogram.maximum(), 0);
+
+    // Copy the alpha channel along with the gray levels.
+    auto lineSize = qMin(src.lineSize(0), dst.lineSize(0));
+
     if (maxGray == minGray) {
         for (int y = 0; y < src.caps().height(); y++) {
-            auto srcLine = reinterpret_cast<const quint16 *>(src.constLine(0, y));
-            auto dstLine = reinterpret_cast<quint16 *>(dst.line(0, y));
+            auto dstLine = dst.line(0, y);
+
+            if (Traits::hasAlpha)
+                memcpy(dstLine, src.constLine(0, y), lineSize);
 
             for (int x = 0; x < src.caps().width(); x++)
-                dstLine[x] = minGray << 8 | srcLine[x] & 0xff;
+                Gray::write(dstLine, x, minGray);
         }
     } else {
         int diffGray = maxGray - minGray;
@@ -274,25 +313,27 @@ AkVideoPacket EdgeElementPrivate::equalize(const AkVideoPacket &src)
             colorTable[i] = quint8(255 * (i - minGray) / diffGray);
 
         for (int y = 0; y < src.caps().height(); y++) {
-            auto srcLine = reinterpret_cast<const quint16 *>(src.constLine(0, y));
-            auto dstLine = reinterpret_cast<quint16 *>(dst.line(0, y));
+            auto srcLine = src.constLine(0, y);
+            auto dstLine = dst.line(0, y);
 
-            for (int x = 0; x < src.caps().width(); x++) {
-                auto &pixel = srcLine[x];
-                auto y = pixel >> 8;
-                auto a = pixel & 0xff;
-                dstLine[x] = colorTable[y] << 8 | a;
-            }
+            if (Traits::hasAlpha)
+                memcpy(dstLine, srcLine, lineSize);
+
+            for (int x = 0; x < src.caps().width(); x++)
+                Gray::write(dstLine, x, colorTable[Gray::read(srcLine, x)]);
         }
     }
 
     return dst;
 }
 
+template <typename Traits>
 void EdgeElementPrivate::sobel(const AkVideoPacket &gray,
                                AkVideoPacket &gradient,
                                AkVideoPacket &direction) const
 {
+    using Gray = typename Traits::X;
+
     auto caps = gray.caps();
     caps.setFormat(AkVideoCaps::Format_y16);
     gradient = {caps};
@@ -305,9 +346,9 @@ void EdgeElementPrivate::sobel(const AkVideoPacket &gray,
     auto height_1 = gray.caps().height() - 1;
 
     for (int y = 0; y < gray.caps().height(); y++) {
-        auto grayLine = reinterpret_cast<const quint16 *>(gray.constLine(0, y));
-        auto grayLine_m1 = reinterpret_cast<const quint16 *>(gray.constLine(0, qMax(y - 1, 0)));
-        auto grayLine_p1 = reinterpret_cast<const quint16 *>(gray.constLine(0, qMin(y + 1, height_1)));
+        auto grayLine = gray.constLine(0, y);
+        auto grayLine_m1 = gray.constLine(0, qMax(y - 1, 0));
+        auto grayLine_p1 = gray.constLine(0, qMin(y + 1, height_1));
 
         auto gradientLine  = reinterpret_cast<quint16 *>(gradient.line(0, y));
         auto directionLine = direction.line(0, y);
@@ -316,23 +357,23 @@ void EdgeElementPrivate::sobel(const AkVideoPacket &gray,
             int x_m1 = qMax(x - 1, 0);
             int x_p1 = qMin(x + 1,  width_1);
 
-            int pixel_m1_p1 = grayLine_m1[x_p1] >> 8;
-            int pixel_p1_p1 = grayLine_p1[x_p1] >> 8;
-            int pixel_m1_m1 = grayLine_m1[x_m1] >> 8;
-            int pixel_p1_m1 = grayLine_p1[x_m1] >> 8;
+            int pixel_m1_p1 = Gray::read(grayLine_m1, x_p1);
+            int pixel_p1_p1 = Gray::read(grayLine_p1, x_p1);
+            int pixel_m1_m1 = Gray::read(grayLine_m1, x_m1);
+            int pixel_p1_m1 = Gray::read(grayLine_p1, x_m1);
 
             int gradX = pixel_m1_p1
-                      + 2 * int(grayLine[x_p1] >> 8)
+                      + 2 * int(Gray::read(grayLine, x_p1))
                       + pixel_p1_p1
                       - pixel_m1_m1
-                      - 2 * int(grayLine[x_m1] >> 8)
+                      - 2 * int(Gray::read(grayLine, x_m1))
                       - pixel_p1_m1;
 
             int gradY = pixel_m1_m1
-                      + 2 * int(grayLine_m1[x] >> 8)
+                      + 2 * int(Gray::read(grayLine_m1, x))
                       + pixel_m1_p1
                       - pixel_p1_m1
-                      - 2 * int(grayLine_p1[x] >> 8)
+                      - 2 * int(Gray::read(grayLine_p1, x))
                       - pixel_p1_p1;
 
             gradientLine[x] = quint16(qAbs(gradX) + qAbs(gradY));
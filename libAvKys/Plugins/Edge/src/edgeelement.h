@@ -62,6 +62,7 @@ class EdgeElement: public AkElement
         Q_INVOKABLE int thHi() const;
         Q_INVOKABLE bool equalize() const;
         Q_INVOKABLE bool invert() const;
+        Q_INVOKABLE AkVideoCaps::PixelFormatList videoInputFormats() const override;
 
     private:
         EdgeElementPrivate *d;
@@ -55,6 +55,16 @@ qreal EmbossElement::bias() const
     return this->d->m_bias;
 }
 
+AkVideoCaps::PixelFormatList EmbossElement::videoInputFormats() const
+{
+    return {AkVideoCaps::Format_ya88pack};
+}
+
+AkVideoCaps::PixelFormatList EmbossElement::videoOutputFormats() const
+{
+    return {AkVideoCaps::Format_ya88pack};
+}
+
 QString EmbossElement::controlInterfaceProvide(const QString &controlId) const
 {
     Q_UNUSED(controlId)
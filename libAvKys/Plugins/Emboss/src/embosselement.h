@@ -42,6 +42,8 @@ class EmbossElement: public AkElement
         EmbossElement();
         ~EmbossElement();
 
+        Q_INVOKABLE AkVideoCaps::PixelFormatList videoInputFormats() const override;
+        Q_INVOKABLE AkVideoCaps::PixelFormatList videoOutputFormats() const override;
         Q_INVOKABLE qreal factor() const;
         Q_INVOKABLE qreal bias() const;
 
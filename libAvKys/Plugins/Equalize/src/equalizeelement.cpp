@@ -18,9 +18,12 @@
  */
 
 #include <akfrac.h>
+#include <akhistogram.h>
 #include <akpacket.h>
 #include <akvideocaps.h>
 #include <akvideoconverter.h>
+#include <akvideoformatspec.h>
+#include <akvideoformattraits.h>
 #include <akvideopacket.h>
 
 #include "equalizeelement.h"
@@ -37,24 +40,62 @@
     #define MAX_Y 235
 #endif
 
-using HistogramType = quint64;
-using HistogramSumType = qreal;
+// Frames bigger than this are equalized with a subsampled histogram.
+#define HISTOGRAM_MAX_SAMPLES (1 << 21)
 
 class EqualizeElementPrivate
 {
     public:
         AkVideoConverter m_videoConverter {{AkVideoCaps::Format_ayuvpack, 0, 0, {}}};
-
-        static void histogram(const AkVideoPacket &src, HistogramType *table);
-        static void cumulativeHistogram(const HistogramType *histogram,
-                                        HistogramSumType *cumHistogram);
-        static void equalizationTable(const AkVideoPacket &src, quint8 *table);
+        AkHistogram m_histogram;
+
+        void equalizationTable(const AkVideoPacket &src, quint8 *table);
+        void equalizeGeneric(const AkVideoPacket &src,
+                             AkVideoPacket &dst,
+                             const quint8 *table) const;
+
+        // Equalizes the luma of a YUV frame whose layout is known at compile
+        // time, the rest of the components are copied as they are.
+        template <typename Traits>
+        void equalize(const AkVideoPacket &src,
+                      AkVideoPacket &dst,
+                      const quint8 *table) const
+        {
+            using Luma = typename Traits::X;
+            constexpr bool lumaOnly = Luma::step == Luma::byteDepth;
+            int width = src.caps().width();
+            int height = src.caps().height();
+
+            for (int plane = 0; plane < Traits::planes; plane++) {
+                int yStep = 1 << src.heightDiv(plane);
+                auto lineSize = qMin(src.lineSize(plane), dst.lineSize(plane));
+
+                for (int y = 0; y < height; y += yStep) {
+                    auto srcLine = src.constLine(plane, y);
+                    auto dstLine = dst.line(plane, y);
+
+                    if (plane != Luma::plane || !lumaOnly)
+                        memcpy(dstLine, srcLine, lineSize);
+
+                    if (plane != Luma::plane)
+                        continue;
+
+                    for (int x = 0; x < width; x++) {
+                        auto luma = qBound<quint32>(MIN_Y,
+                                                    Luma::read(srcLine, x),
+                                                    MAX_Y);
+                        Luma::write(dstLine, x, table[luma]);
+                    }
+                }
+            }
+        }
 };
 
 EqualizeElement::EqualizeElement():
     AkElement()
 {
     this->d = new EqualizeElementPrivate;
+    this->d->m_histogram.setMaxSamples(HISTOGRAM_MAX_SAMPLES);
 
 #ifdef USE_FULLSWING
     this->d->m_videoConverter.setYuvColorSpaceType(AkVideoConverter::YuvColorSpaceType_FullSwing);
@@ -66,32 +107,61 @@ EqualizeElement::~EqualizeElement()
     delete this->d;
 }
 
-AkPacket EqualizeElement::iVideoStream(const AkVideoPacket &packet)
+AkVideoCaps::PixelFormatList EqualizeElement::videoInputFormats() const
 {
-    this->d->m_videoConverter.begin();
-    auto src = this->d->m_videoConverter.convert(packet);
-    this->d->m_videoConverter.end();
-
-    if (!src)
-        return {};
+    return {AkVideoCaps::Format_ayuv,
+            AkVideoCaps::Format_vuya,
+            AkVideoCaps::Format_yuv420p};
+}
 
-    AkVideoPacket dst(src.caps());
-    dst.copyMetadata(src);
+AkVideoCaps::PixelFormatList EqualizeElement::videoOutputFormats() const
+{
+    // The output has the same format as the input.
+    return {};
+}
 
+AkPacket EqualizeElement::iVideoStream(const AkVideoPacket &packet)
+{
+    AkVideoPacket dst;
     quint8 equTable[256];
-    EqualizeElementPrivate::equalizationTable(src, equTable);
-
-    for (int y = 0; y < src.caps().height(); y++) {
-        auto srcLine = reinterpret_cast<const AkYuv *>(src.constLine(0, y));
-        auto dstLine = reinterpret_cast<AkYuv *>(dst.line(0, y));
 
-        for (int x = 0; x < src.caps().width(); x++) {
-            auto &pixel = srcLine[x];
-            auto y = qBound<int>(MIN_Y, akCompY(pixel), MAX_Y);
-            dstLine[x] = akYuv(equTable[y],
-                               akCompU(pixel),
-                               akCompV(pixel),
-                               akCompA(pixel));
+    auto equalize = [this, &dst, &equTable] (const AkVideoPacket &src,
+                                             auto traits) {
+        dst = {src.caps()};
+        dst.copyMetadata(src);
+        this->d->equalizationTable(src, equTable);
+        this->d->equalize<decltype(traits)>(src, dst, equTable);
+    };
+
+    // YUV frames with a known layout are equalized as they come, the rest
+    // are converted first.
+    auto specs = AkVideoCaps::formatSpecs(packet.caps().format());
+    bool isEqualized =
+        specs.type() == AkVideoFormatSpec::VFT_YUV
+        && akVideoFormatDispatch(packet.caps().format(),
+                                 [&equalize, &packet] (auto traits) {
+            equalize(packet, traits);
+        });
+
+    if (!isEqualized) {
+        this->d->m_videoConverter.begin();
+        auto src = this->d->m_videoConverter.convert(packet);
+        this->d->m_videoConverter.end();
+
+        if (!src)
+            return {};
+
+        isEqualized =
+            akVideoFormatDispatch(src.caps().format(),
+                                  [&equalize, &src] (auto traits) {
+                equalize(src, traits);
+            });
+
+        if (!isEqualized) {
+            dst = {src.caps()};
+            dst.copyMetadata(src);
+            this->d->equalizationTable(src, equTable);
+            this->d->equalizeGeneric(src, dst, equTable);
         }
     }
 
@@ -101,40 +171,27 @@ AkPacket EqualizeElement::iVideoStream(const AkVideoPacket &packet)
     return dst;
 }
 
-void EqualizeElementPrivate::histogram(const AkVideoPacket &src,
-                                       HistogramType *table)
+void EqualizeElementPrivate::equalizationTable(const AkVideoPacket &src,
+                                               quint8 *table)
 {
-    memset(table, 0, 256 * sizeof(HistogramType));
+    this->m_histogram.compute(src, AkColorComponent::CT_Y);
+    auto cumHistogram = this->m_histogram.cumulative();
 
-    for (int y = 0; y < src.caps().height(); y++) {
-        auto srcLine = reinterpret_cast<const AkYuv *>(src.constLine(0, y));
+    if (cumHistogram.size() != 256) {
+        for (int i = 0; i < 256; i++)
+            table[i] = i;
 
-        for (int x = 0; x < src.caps().width(); x++) {
-            auto &pixel = srcLine[x];
-            auto y = qBound<int>(MIN_Y, akCompY(pixel), MAX_Y);
-            table[y]++;
-        }
+        return;
     }
-}
 
-void EqualizeElementPrivate::cumulativeHistogram(const HistogramType *histogram,
-                                                 HistogramSumType *cumHistogram)
-{
-    HistogramSumType sum = 0;
+    // The levels out of [MIN_Y, MAX_Y] are counted as the nearest limit.
+    auto total = cumHistogram[255];
 
-    for (int i = 0; i < 256; i++) {
-        sum += histogram[i];
-        cumHistogram[i] = sum;
-    }
-}
+    for (int i = 0; i < MIN_Y; i++)
+        cumHistogram[i] = 0;
 
-void EqualizeElementPrivate::equalizationTable(const AkVideoPacket &src,
-                                               quint8 *table)
-{
-    HistogramType histogram[256];
-    EqualizeElementPrivate::histogram(src, histogram);
-    HistogramSumType cumHistogram[256];
-    EqualizeElementPrivate::cumulativeHistogram(histogram, cumHistogram);
+    for (int i = MAX_Y; i < 256; i++)
+        cumHistogram[i] = total;
 
     auto &hMinY = cumHistogram[MIN_Y];
     auto &hMaxY = cumHistogram[MAX_Y];
@@ -153,4 +210,23 @@ void EqualizeElementPrivate::equalizationTable(const AkVideoPacket &src,
     }
 }
 
+void EqualizeElementPrivate::equalizeGeneric(const AkVideoPacket &src,
+                                             AkVideoPacket &dst,
+                                             const quint8 *table) const
+{
+    for (int y = 0; y < src.caps().height(); y++) {
+        auto srcLine = reinterpret_cast<const AkYuv *>(src.constLine(0, y));
+        auto dstLine = reinterpret_cast<AkYuv *>(dst.line(0, y));
+
+        for (int x = 0; x < src.caps().width(); x++) {
+            auto &pixel = srcLine[x];
+            auto y = qBound<int>(MIN_Y, akCompY(pixel), MAX_Y);
+            dstLine[x] = akYuv(table[y],
+                               akCompU(pixel),
+                               akCompV(pixel),
+                               akCompA(pixel));
+        }
+    }
+}
+
 #include "moc_equalizeelement.cpp"
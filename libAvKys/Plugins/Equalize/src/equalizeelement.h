@@ -32,6 +32,9 @@ class EqualizeElement: public AkElement
         EqualizeElement();
         ~EqualizeElement();
 
+        Q_INVOKABLE AkVideoCaps::PixelFormatList videoInputFormats() const override;
+        Q_INVOKABLE AkVideoCaps::PixelFormatList videoOutputFormats() const override;
+
     private:
         EqualizeElementPrivate *d;
 
@@ -221,20 +221,27 @@ QVector<QRect> FaceDetectElement::detectFaces(const AkVideoPacket &packet)
     if (!src)
         return {};
 
-    QImage iFrame(src.caps().width(), src.caps().height(), QImage::Format_ARGB32);
-    auto lineSize = qMin<size_t>(src.lineSize(0), iFrame.bytesPerLine());
-
-    for (int y = 0; y < src.caps().height(); y++) {
-        auto srcLine = src.constLine(0, y);
-        auto dstLine = iFrame.scanLine(y);
-        memcpy(dstLine, srcLine, lineSize);
-    }
-
+    // Read the frame in place, the image is only scaled down.
+    QImage iFrame(src.constPlane(0),
+                  src.caps().width(),
+                  src.caps().height(),
+                  qsizetype(src.lineSize(0)),
+                  QImage::Format_ARGB32);
     auto scanFrame = iFrame.scaled(scanSize, Qt::KeepAspectRatio);
 
     return this->d->m_cascadeClassifier.detect(scanFrame);
 }
 
+AkVideoCaps::PixelFormatList FaceDetectElement::videoInputFormats() const
+{
+    return {AkVideoCaps::Format_argbpack};
+}
+
+AkVideoCaps::PixelFormatList FaceDetectElement::videoOutputFormats() const
+{
+    return {AkVideoCaps::Format_argbpack};
+}
+
 QString FaceDetectElement::controlInterfaceProvide(const QString &controlId) const
 {
     Q_UNUSED(controlId)
@@ -273,17 +280,14 @@ AkPacket FaceDetectElement::iVideoStream(const AkVideoPacket &packet)
     if (!src)
         return {};
 
-    QImage iFrame(src.caps().width(),
+    /* The input frame is only read, so wrap it without copying, the only copy
+     * is the output frame.
+     */
+    QImage iFrame(src.constPlane(0),
+                  src.caps().width(),
                   src.caps().height(),
+                  qsizetype(src.lineSize(0)),
                   QImage::Format_ARGB32);
-    auto lineSize = qMin<size_t>(src.lineSize(0), iFrame.bytesPerLine());
-
-    for (int y = 0; y < src.caps().height(); y++) {
-        auto srcLine = src.constLine(0, y);
-        auto dstLine = iFrame.scanLine(y);
-        memcpy(dstLine, srcLine, lineSize);
-    }
-
     auto oFrame = iFrame.copy();
     auto scanFrame = iFrame.scaled(scanSize, Qt::KeepAspectRatio);
     qreal scale = 1;
@@ -364,33 +368,16 @@ AkPacket FaceDetectElement::iVideoStream(const AkVideoPacket &packet)
 
             painter.drawImage(rect, imagePixelate);
         } else if (this->d->m_markerType == MarkerTypeBlur) {
-            auto subFrame = iFrame.copy(rect);
-            auto caps = src.caps();
-            caps.setWidth(subFrame.width());
-            caps.setHeight(subFrame.height());
-            AkVideoPacket rectPacket(caps);
-            rectPacket.copyMetadata(src);
-            auto lineSize = qMin<size_t>(subFrame.bytesPerLine(), rectPacket.lineSize(0));
-
-            for (int y = 0; y < subFrame.height(); y++) {
-                auto srcLine = subFrame.constScanLine(y);
-                auto dstLine = rectPacket.line(0, y);
-                memcpy(dstLine, srcLine, lineSize);
-            }
-
-            AkVideoPacket blurPacket = this->d->m_blurFilter->iStream(rectPacket);
-            QImage blurImage(blurPacket.caps().width(),
+            // Blur the face region in place, as a view of the frame.
+            auto faceRect = rect.intersected(iFrame.rect());
+            AkVideoPacket blurPacket =
+                    this->d->m_blurFilter->iStream(src.view(faceRect));
+            QImage blurImage(blurPacket.constPlane(0),
+                             blurPacket.caps().width(),
                              blurPacket.caps().height(),
+                             qsizetype(blurPacket.lineSize(0)),
                              QImage::Format_ARGB32);
-            lineSize = qMin<size_t>(blurPacket.lineSize(0), blurImage.bytesPerLine());
-
-            for (int y = 0; y < blurPacket.caps().height(); y++) {
-                auto srcLine = blurPacket.constLine(0, y);
-                auto dstLine = blurImage.scanLine(y);
-                memcpy(dstLine, srcLine, lineSize);
-            }
-
-            painter.drawImage(rect, blurImage);
+            painter.drawImage(faceRect, blurImage);
         } else if (this->d->m_markerType == MarkerTypeBlurOuter
                    || this->d->m_markerType == MarkerTypeImageOuter) {
             if (this->d->m_smootheEdges) {
@@ -410,7 +397,7 @@ AkPacket FaceDetectElement::iVideoStream(const AkVideoPacket &packet)
                 painter.setClipPath(path);
             }
 
-            painter.drawImage(rect, iFrame.copy(rect));
+            painter.drawImage(rect, iFrame, rect);
         }
     }
 
@@ -418,7 +405,7 @@ AkPacket FaceDetectElement::iVideoStream(const AkVideoPacket &packet)
 
     AkVideoPacket dst(src.caps());
     dst.copyMetadata(src);
-    lineSize = qMin<size_t>(oFrame.bytesPerLine(), dst.lineSize(0));
+    auto lineSize = qMin<size_t>(oFrame.bytesPerLine(), dst.lineSize(0));
 
     for (int y = 0; y < dst.caps().height(); y++) {
         auto srcLine = oFrame.constScanLine(y);
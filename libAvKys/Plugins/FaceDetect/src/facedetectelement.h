@@ -150,6 +150,8 @@ class FaceDetectElement: public AkElement
         FaceDetectElement();
         ~FaceDetectElement();
 
+        Q_INVOKABLE AkVideoCaps::PixelFormatList videoInputFormats() const override;
+        Q_INVOKABLE AkVideoCaps::PixelFormatList videoOutputFormats() const override;
         Q_INVOKABLE QString haarFile() const;
         Q_INVOKABLE MarkerType markerType() const;
         Q_INVOKABLE QRgb markerColor() const;
@@ -143,6 +143,16 @@ bool FaceTrackElement::debugModeEnabled() const
     return this->d->m_debugModeEnabled;
 }
 
+AkVideoCaps::PixelFormatList FaceTrackElement::videoInputFormats() const
+{
+    return {AkVideoCaps::Format_argbpack};
+}
+
+AkVideoCaps::PixelFormatList FaceTrackElement::videoOutputFormats() const
+{
+    return {AkVideoCaps::Format_argbpack};
+}
+
 QString FaceTrackElement::controlInterfaceProvide(const QString &controlId) const
 {
     Q_UNUSED(controlId)
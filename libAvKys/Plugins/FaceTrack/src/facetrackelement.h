@@ -93,6 +93,8 @@ class FaceTrackElement: public AkElement
         FaceTrackElement();
         ~FaceTrackElement();
 
+        Q_INVOKABLE AkVideoCaps::PixelFormatList videoInputFormats() const override;
+        Q_INVOKABLE AkVideoCaps::PixelFormatList videoOutputFormats() const override;
         Q_INVOKABLE QString haarFile() const;
         Q_INVOKABLE QSize scanSize() const;
         Q_INVOKABLE int faceBucketSize() const;
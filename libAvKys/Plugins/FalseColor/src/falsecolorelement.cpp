@@ -78,6 +78,16 @@ QRgb FalseColorElement::colorAt(int index)
     return color;
 }
 
+AkVideoCaps::PixelFormatList FalseColorElement::videoInputFormats() const
+{
+    return {AkVideoCaps::Format_ya88pack};
+}
+
+AkVideoCaps::PixelFormatList FalseColorElement::videoOutputFormats() const
+{
+    return {AkVideoCaps::Format_argbpack};
+}
+
 QString FalseColorElement::controlInterfaceProvide(const QString &controlId) const
 {
     Q_UNUSED(controlId)
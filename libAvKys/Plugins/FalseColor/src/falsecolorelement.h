@@ -43,6 +43,8 @@ class FalseColorElement: public AkElement
         FalseColorElement();
         ~FalseColorElement();
 
+        Q_INVOKABLE AkVideoCaps::PixelFormatList videoInputFormats() const override;
+        Q_INVOKABLE AkVideoCaps::PixelFormatList videoOutputFormats() const override;
         Q_INVOKABLE QVariantList table() const;
         Q_INVOKABLE bool soft() const;
         Q_INVOKABLE QRgb colorAt(int index);
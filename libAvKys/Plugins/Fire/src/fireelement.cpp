@@ -20,14 +20,15 @@
 #include <QDataStream>
 #include <QMap>
 #include <QQmlContext>
-#include <QRandomGenerator>
 #include <QSize>
 #include <QVariant>
+#include <QVector>
 #include <QtMath>
 #include <qrgb.h>
 #include <akfrac.h>
 #include <akpacket.h>
 #include <akpluginmanager.h>
+#include <akrandom.h>
 #include <akvideocaps.h>
 #include <akvideoconverter.h>
 #include <akvideomixer.h>
@@ -387,12 +388,23 @@ AkVideoPacket FireElementPrivate::imageDiff(const AkVideoPacket &img1,
     ocaps.setHeight(height);
     AkVideoPacket diff(ocaps);
     diff.copyMetadata(img2);
+    auto &random = AkRandom::local();
+    QVector<quint8> alphas(width);
+    QVector<quint8> blues(width);
 
     for (int y = 0; y < height; y++) {
         auto iLine1 = reinterpret_cast<const QRgb *>(img1.constLine(0, y));
         auto iLine2 = reinterpret_cast<const QRgb *>(img2.constLine(0, y));
         auto oLine = reinterpret_cast<QRgb *>(diff.line(0, y));
 
+        if (mode != FireElement::FireModeSoft)
+            random.fillBounded(alphas.data(),
+                               size_t(width),
+                               255 - alphaVariation,
+                               256);
+
+        random.fillBounded(blues.data(), size_t(width), 255 - colors, 256);
+
         for (int x = 0; x < width; x++) {
             int r1 = qRed(iLine1[x]);
             int g1 = qGreen(iLine1[x]);
@@ -412,12 +424,11 @@ AkVideoPacket FireElementPrivate::imageDiff(const AkVideoPacket &img1,
             if (mode == FireElement::FireModeSoft)
                 alpha = alpha < threshold? 0: alpha;
             else
-                alpha = alpha < threshold?
-                          0: QRandomGenerator::global()->bounded(255 - alphaVariation, 256);
+                alpha = alpha < threshold? 0: alphas[x];
 
             int gray = qGray(iLine2[x]);
             alpha = gray < lumaThreshold? 0: alpha;
-            int b = QRandomGenerator::global()->bounded(255 - colors, 256);
+            int b = blues[x];
             oLine[x] = qRgba(0, 0, b, alpha);
         }
     }
@@ -482,11 +493,11 @@ void FireElementPrivate::dissolveImage(AkVideoPacket &src, qreal amount)
     auto n = qRound64(amount * videoArea);
 
     for (qint64 i = 0; i < n; i++) {
-        int x = QRandomGenerator::global()->bounded(src.caps().width());
-        int y = QRandomGenerator::global()->bounded(src.caps().height());
+        int x = AkRandom::local().bounded(src.caps().width());
+        int y = AkRandom::local().bounded(src.caps().height());
         auto pixel = src.pixel<QRgb>(0, x, y);
         int b = qBlue(pixel);
-        int a = QRandomGenerator::global()->bounded(qAlpha(pixel) + 1);
+        int a = AkRandom::local().bounded(qAlpha(pixel) + 1);
         src.setPixel(0, x, y, qRgba(0, 0, b, a));
     }
 }
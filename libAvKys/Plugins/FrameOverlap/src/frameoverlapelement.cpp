@@ -66,6 +66,16 @@ int FrameOverlapElement::stride() const
     return this->d->m_stride;
 }
 
+AkVideoCaps::PixelFormatList FrameOverlapElement::videoInputFormats() const
+{
+    return {AkVideoCaps::Format_argbpack};
+}
+
+AkVideoCaps::PixelFormatList FrameOverlapElement::videoOutputFormats() const
+{
+    return {AkVideoCaps::Format_argbpack};
+}
+
 QString FrameOverlapElement::controlInterfaceProvide(const QString &controlId) const
 {
     Q_UNUSED(controlId)
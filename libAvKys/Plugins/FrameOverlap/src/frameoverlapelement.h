@@ -42,6 +42,8 @@ class FrameOverlapElement: public AkElement
         FrameOverlapElement();
         ~FrameOverlapElement();
 
+        Q_INVOKABLE AkVideoCaps::PixelFormatList videoInputFormats() const override;
+        Q_INVOKABLE AkVideoCaps::PixelFormatList videoOutputFormats() const override;
         Q_INVOKABLE int nFrames() const;
         Q_INVOKABLE int stride() const;
 
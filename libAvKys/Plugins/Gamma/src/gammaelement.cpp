@@ -58,6 +58,16 @@ int GammaElement::gamma() const
     return this->d->m_gamma;
 }
 
+AkVideoCaps::PixelFormatList GammaElement::videoInputFormats() const
+{
+    return {AkVideoCaps::Format_argbpack};
+}
+
+AkVideoCaps::PixelFormatList GammaElement::videoOutputFormats() const
+{
+    return {AkVideoCaps::Format_argbpack};
+}
+
 QString GammaElement::controlInterfaceProvide(const QString &controlId) const
 {
     Q_UNUSED(controlId)
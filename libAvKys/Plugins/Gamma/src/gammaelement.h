@@ -37,6 +37,8 @@ class GammaElement: public AkElement
         GammaElement();
         ~GammaElement();
 
+        Q_INVOKABLE AkVideoCaps::PixelFormatList videoInputFormats() const override;
+        Q_INVOKABLE AkVideoCaps::PixelFormatList videoOutputFormats() const override;
         Q_INVOKABLE int gamma() const;
 
     private:
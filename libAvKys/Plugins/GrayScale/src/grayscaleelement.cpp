@@ -42,6 +42,16 @@ GrayScaleElement::~GrayScaleElement()
     delete this->d;
 }
 
+AkVideoCaps::PixelFormatList GrayScaleElement::videoInputFormats() const
+{
+    return {AkVideoCaps::Format_ya88pack};
+}
+
+AkVideoCaps::PixelFormatList GrayScaleElement::videoOutputFormats() const
+{
+    return {AkVideoCaps::Format_ya88pack};
+}
+
 AkPacket GrayScaleElement::iVideoStream(const AkVideoPacket &packet)
 {
     this->d->m_videoConverter.begin();
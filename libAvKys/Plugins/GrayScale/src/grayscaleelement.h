@@ -32,6 +32,9 @@ class GrayScaleElement: public AkElement
         GrayScaleElement();
         ~GrayScaleElement();
 
+        Q_INVOKABLE AkVideoCaps::PixelFormatList videoInputFormats() const override;
+        Q_INVOKABLE AkVideoCaps::PixelFormatList videoOutputFormats() const override;
+
     private:
         GrayScaleElementPrivate *d;
 
@@ -17,10 +17,13 @@
  * Web-Site: http://webcamoid.github.io/
  */
 
+#include <QFuture>
 #include <QImage>
 #include <QQmlContext>
 #include <QMutex>
 #include <QStandardPaths>
+#include <QThreadPool>
+#include <QtConcurrent>
 #include <akfrac.h>
 #include <akpacket.h>
 #include <akvideocaps.h>
@@ -29,6 +32,10 @@
 
 #include "halftoneelement.h"
 
+// Minimum width of the threshold tile, so the inner loop always runs over
+// enough contiguous pixels to be vectorized.
+#define TILE_MIN_WIDTH 64
+
 class HalftoneElementPrivate
 {
     public:
@@ -38,11 +45,19 @@ class HalftoneElementPrivate
         qreal m_slope {1.0};
         qreal m_interception {0.0};
         QMutex m_mutex;
-        QSize m_frameSize;
         QImage m_patternImage;
+        QVector<quint8> m_thresholds;
+        int m_tileWidth {0};
+        int m_tileHeight {0};
+        QThreadPool m_threadPool;
         AkVideoConverter m_videoConverter {{AkVideoCaps::Format_argbpack, 0, 0, {}}};
 
         void updatePattern();
+        void updateThresholds();
+        void halftoneBand(const AkVideoPacket &src,
+                          AkVideoPacket &dst,
+                          int yStart,
+                          int yEnd) const;
 };
 
 HalftoneElement::HalftoneElement(): AkElement()
@@ -60,6 +75,20 @@ HalftoneElement::HalftoneElement(): AkElement()
                      [this] () {
                          this->d->updatePattern();
                      });
+    QObject::connect(this,
+                     &HalftoneElement::slopeChanged,
+                     [this] () {
+                         this->d->m_mutex.lock();
+                         this->d->updateThresholds();
+                         this->d->m_mutex.unlock();
+                     });
+    QObject::connect(this,
+                     &HalftoneElement::interceptionChanged,
+                     [this] () {
+                         this->d->m_mutex.lock();
+                         this->d->updateThresholds();
+                         this->d->m_mutex.unlock();
+                     });
 }
 
 HalftoneElement::~HalftoneElement()
@@ -92,6 +121,16 @@ qreal HalftoneElement::interception() const
     return this->d->m_interception;
 }
 
+AkVideoCaps::PixelFormatList HalftoneElement::videoInputFormats() const
+{
+    return {AkVideoCaps::Format_argbpack};
+}
+
+AkVideoCaps::PixelFormatList HalftoneElement::videoOutputFormats() const
+{
+    return {AkVideoCaps::Format_argbpack};
+}
+
 QString HalftoneElement::controlInterfaceProvide(const QString &controlId) const
 {
     Q_UNUSED(controlId)
@@ -122,7 +161,7 @@ AkPacket HalftoneElement::iVideoStream(const AkVideoPacket &packet)
 
     this->d->m_mutex.lock();
 
-    if (this->d->m_patternImage.isNull()) {
+    if (this->d->m_thresholds.isEmpty()) {
         this->d->m_mutex.unlock();
 
         if (packet)
@@ -134,37 +173,31 @@ AkPacket HalftoneElement::iVideoStream(const AkVideoPacket &packet)
     AkVideoPacket dst(src.caps());
     dst.copyMetadata(src);
 
-    auto lightning = this->d->m_lightning;
-    auto slope = this->d->m_slope;
-    auto interception = this->d->m_interception;
+    // Split the frame in bands of whole tiles, one per thread.
+    int height = src.caps().height();
+    int threads = qMax(1, this->d->m_threadPool.maxThreadCount());
+    int tiles = (height + this->d->m_tileHeight - 1) / this->d->m_tileHeight;
+    int bandHeight = this->d->m_tileHeight * ((tiles + threads - 1) / threads);
+    QList<QFuture<void>> bands;
 
-    // filter image
-    for (int y = 0; y < src.caps().height(); y++) {
-        auto iLine = reinterpret_cast<const QRgb *>(src.constLine(0, y));
-        auto oLine = reinterpret_cast<QRgb *>(dst.line(0, y));
-        int row = y % this->d->m_patternImage.height();
-        auto pattern = reinterpret_cast<const quint8 *>(this->d->m_patternImage.constScanLine(row));
-
-        for (int x = 0; x < src.caps().width(); x++) {
-            int col = x % this->d->m_patternImage.width();
-            auto &pixel = iLine[x];
-
-            int gray = qGray(pixel);
-            int threshold = pattern[col];
-            threshold = int(slope * threshold + interception);
-            threshold = qBound(0, threshold, 255);
-
-            if (gray > threshold) {
-                oLine[x] = pixel;
-            } else {
-                int r = qBound(0, qRed(pixel) + lightning, 255);
-                int g = qBound(0, qGreen(pixel) + lightning, 255);
-                int b = qBound(0, qBlue(pixel) + lightning, 255);
-                oLine[x] = qRgba(r, g, b, qAlpha(pixel));
-            }
+    for (int y = 0; y < height; y += bandHeight) {
+        int yEnd = qMin(y + bandHeight, height);
+
+        if (yEnd >= height) {
+            this->d->halftoneBand(src, dst, y, yEnd);
+
+            break;
         }
+
+        bands << QtConcurrent::run(&this->d->m_threadPool,
+                                   [this, &src, &dst, y, yEnd] () {
+                                       this->d->halftoneBand(src, dst, y, yEnd);
+                                   });
     }
 
+    for (auto &band: bands)
+        band.waitForFinished();
+
     this->d->m_mutex.unlock();
 
     if (dst)
@@ -248,6 +281,7 @@ void HalftoneElementPrivate::updatePattern()
     if (this->m_pattern.isEmpty()) {
         this->m_mutex.lock();
         this->m_patternImage = QImage();
+        this->updateThresholds();
         this->m_mutex.unlock();
 
         return;
@@ -258,6 +292,7 @@ void HalftoneElementPrivate::updatePattern()
     if (image.isNull()) {
         this->m_mutex.lock();
         this->m_patternImage = QImage();
+        this->updateThresholds();
         this->m_mutex.unlock();
 
         return;
@@ -266,11 +301,88 @@ void HalftoneElementPrivate::updatePattern()
     auto pattern = image.convertToFormat(QImage::Format_Grayscale8);
 
     if (!this->m_patternSize.isEmpty() && this->m_patternSize != image.size())
-        pattern = image.scaled(this->m_patternSize);
+        pattern = pattern.scaled(this->m_patternSize);
 
     this->m_mutex.lock();
     this->m_patternImage = pattern;
+    this->updateThresholds();
     this->m_mutex.unlock();
 }
 
+// Maps the pattern through the slope and interception, and repeats it
+// horizontally until it's at least TILE_MIN_WIDTH pixels wide. Must be
+// called with m_mutex locked.
+void HalftoneElementPrivate::updateThresholds()
+{
+    if (this->m_patternImage.isNull()) {
+        this->m_thresholds.clear();
+        this->m_tileWidth = 0;
+        this->m_tileHeight = 0;
+
+        return;
+    }
+
+    int patternWidth = this->m_patternImage.width();
+    int repeat = (TILE_MIN_WIDTH + patternWidth - 1) / patternWidth;
+    this->m_tileWidth = repeat * patternWidth;
+    this->m_tileHeight = this->m_patternImage.height();
+
+    quint8 thresholdTable[256];
+
+    for (int i = 0; i < 256; i++) {
+        int threshold = int(this->m_slope * i + this->m_interception);
+        thresholdTable[i] = quint8(qBound(0, threshold, 255));
+    }
+
+    this->m_thresholds.resize(this->m_tileWidth * this->m_tileHeight);
+
+    for (int y = 0; y < this->m_tileHeight; y++) {
+        auto pattern = this->m_patternImage.constScanLine(y);
+        auto tileLine = this->m_thresholds.data() + y * this->m_tileWidth;
+
+        for (int x = 0; x < this->m_tileWidth; x++)
+            tileLine[x] = thresholdTable[pattern[x % patternWidth]];
+    }
+}
+
+void HalftoneElementPrivate::halftoneBand(const AkVideoPacket &src,
+                                          AkVideoPacket &dst,
+                                          int yStart,
+                                          int yEnd) const
+{
+    int width = src.caps().width();
+    int lightning = this->m_lightning;
+
+    for (int y = yStart; y < yEnd; y++) {
+        auto iLine = reinterpret_cast<const QRgb *>(src.constLine(0, y));
+        auto oLine = reinterpret_cast<QRgb *>(dst.line(0, y));
+        auto thresholds = this->m_thresholds.constData()
+                        + (y % this->m_tileHeight) * this->m_tileWidth;
+
+        for (int x = 0; x < width; x += this->m_tileWidth) {
+            int n = qMin(this->m_tileWidth, width - x);
+            auto iPixels = iLine + x;
+            auto oPixels = oLine + x;
+
+            // Keep this loop free of branches and lookups, so the compiler
+            // can turn it into a vector compare and select.
+            for (int i = 0; i < n; i++) {
+                auto pixel = iPixels[i];
+                int r = qRed(pixel);
+                int g = qGreen(pixel);
+                int b = qBlue(pixel);
+                int gray = (11 * r + 16 * g + 5 * b) >> 5;
+                int rl = qBound(0, r + lightning, 255);
+                int gl = qBound(0, g + lightning, 255);
+                int bl = qBound(0, b + lightning, 255);
+                QRgb lit = (pixel & 0xff000000)
+                         | QRgb(rl << 16)
+                         | QRgb(gl << 8)
+                         | QRgb(bl);
+                oPixels[i] = gray > thresholds[i]? pixel: lit;
+            }
+        }
+    }
+}
+
 #include "moc_halftoneelement.cpp"
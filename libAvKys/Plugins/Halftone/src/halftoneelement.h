@@ -57,6 +57,8 @@ class HalftoneElement: public AkElement
         HalftoneElement();
         ~HalftoneElement();
 
+        Q_INVOKABLE AkVideoCaps::PixelFormatList videoInputFormats() const override;
+        Q_INVOKABLE AkVideoCaps::PixelFormatList videoOutputFormats() const override;
         Q_INVOKABLE QString pattern() const;
         Q_INVOKABLE QSize patternSize() const;
         Q_INVOKABLE int lightning() const;
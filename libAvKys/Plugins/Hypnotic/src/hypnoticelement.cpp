@@ -77,6 +77,16 @@ int HypnoticElement::threshold() const
     return this->d->m_threshold;
 }
 
+AkVideoCaps::PixelFormatList HypnoticElement::videoInputFormats() const
+{
+    return {AkVideoCaps::Format_argbpack};
+}
+
+AkVideoCaps::PixelFormatList HypnoticElement::videoOutputFormats() const
+{
+    return {AkVideoCaps::Format_argbpack};
+}
+
 QString HypnoticElement::controlInterfaceProvide(const QString &controlId) const
 {
     Q_UNUSED(controlId)
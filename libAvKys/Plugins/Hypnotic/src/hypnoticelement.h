@@ -56,6 +56,8 @@ class HypnoticElement: public AkElement
         HypnoticElement();
         ~HypnoticElement();
 
+        Q_INVOKABLE AkVideoCaps::PixelFormatList videoInputFormats() const override;
+        Q_INVOKABLE AkVideoCaps::PixelFormatList videoOutputFormats() const override;
         Q_INVOKABLE OpticMode mode() const;
         Q_INVOKABLE int speedInc() const;
         Q_INVOKABLE int threshold() const;
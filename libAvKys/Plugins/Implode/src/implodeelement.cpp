@@ -50,6 +50,16 @@ qreal ImplodeElement::amount() const
     return this->d->m_amount;
 }
 
+AkVideoCaps::PixelFormatList ImplodeElement::videoInputFormats() const
+{
+    return {AkVideoCaps::Format_argbpack};
+}
+
+AkVideoCaps::PixelFormatList ImplodeElement::videoOutputFormats() const
+{
+    return {AkVideoCaps::Format_argbpack};
+}
+
 QString ImplodeElement::controlInterfaceProvide(const QString &controlId) const
 {
     Q_UNUSED(controlId)
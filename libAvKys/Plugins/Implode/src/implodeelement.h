@@ -37,6 +37,8 @@ class ImplodeElement: public AkElement
         ImplodeElement();
         ~ImplodeElement();
 
+        Q_INVOKABLE AkVideoCaps::PixelFormatList videoInputFormats() const override;
+        Q_INVOKABLE AkVideoCaps::PixelFormatList videoOutputFormats() const override;
         Q_INVOKABLE qreal amount() const;
 
     protected:
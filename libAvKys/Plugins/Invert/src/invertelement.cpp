@@ -42,6 +42,16 @@ InvertElement::~InvertElement()
     delete this->d;
 }
 
+AkVideoCaps::PixelFormatList InvertElement::videoInputFormats() const
+{
+    return {AkVideoCaps::Format_argbpack};
+}
+
+AkVideoCaps::PixelFormatList InvertElement::videoOutputFormats() const
+{
+    return {AkVideoCaps::Format_argbpack};
+}
+
 AkPacket InvertElement::iVideoStream(const AkVideoPacket &packet)
 {
     this->d->m_videoConverter.begin();
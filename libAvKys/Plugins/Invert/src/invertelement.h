@@ -32,6 +32,9 @@ class InvertElement: public AkElement
         InvertElement();
         ~InvertElement();
 
+        Q_INVOKABLE AkVideoCaps::PixelFormatList videoInputFormats() const override;
+        Q_INVOKABLE AkVideoCaps::PixelFormatList videoOutputFormats() const override;
+
     private:
         InvertElementPrivate *d;
 
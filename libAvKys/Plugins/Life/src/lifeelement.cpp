@@ -72,6 +72,16 @@ int LifeElement::lumaThreshold() const
     return this->d->m_lumaThreshold;
 }
 
+AkVideoCaps::PixelFormatList LifeElement::videoInputFormats() const
+{
+    return {AkVideoCaps::Format_argbpack};
+}
+
+AkVideoCaps::PixelFormatList LifeElement::videoOutputFormats() const
+{
+    return {AkVideoCaps::Format_argbpack};
+}
+
 QString LifeElement::controlInterfaceProvide(const QString &controlId) const
 {
     Q_UNUSED(controlId)
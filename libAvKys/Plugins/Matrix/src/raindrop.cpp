@@ -17,8 +17,8 @@
  * Web-Site: http://webcamoid.github.io/
  */
 
-#include <QRandomGenerator>
 #include <cstring>
+#include <akrandom.h>
 
 #include "raindrop.h"
 
@@ -50,13 +50,13 @@ RainDrop::RainDrop(int width,
     this->d->m_nCharacters = nCharacters;
 
     this->d->m_height = height;
-    this->d->m_x = QRandomGenerator::global()->bounded(width);
+    this->d->m_x = AkRandom::local().bounded(width);
     this->d->m_y = randomStart?
-                       QRandomGenerator::global()->bounded(height):
+                       AkRandom::local().bounded(height):
                        0;
     this->d->m_prevY = this->d->m_y;
     this->d->m_length =
-            QRandomGenerator::global()->bounded(minLength, maxLength);
+            AkRandom::local().bounded(minLength, maxLength);
 
     if (this->d->m_length < 1)
         this->d->m_length = 1;
@@ -71,7 +71,7 @@ RainDrop::RainDrop(int width,
 
         if (nCharacters > 0)
             for (int i = 0; i < this->d->m_length; i++)
-                this->d->m_line[i] = QRandomGenerator::global()->bounded(nCharacters);
+                this->d->m_line[i] = AkRandom::local().bounded(nCharacters);
         else
             memset(this->d->m_line, 0, this->d->m_length * sizeof(int));
     }
@@ -136,7 +136,7 @@ RainDrop RainDrop::operator ++(int)
 
     this->d->m_line[0] =
             this->d->m_nCharacters > 0?
-                QRandomGenerator::global()->bounded(this->d->m_nCharacters):
+                AkRandom::local().bounded(this->d->m_nCharacters):
                 0;
 
     return rainDrop;
@@ -153,7 +153,7 @@ RainDrop &RainDrop::operator ++()
 
     this->d->m_line[0] =
             this->d->m_nCharacters > 0?
-                QRandomGenerator::global()->bounded(this->d->m_nCharacters):
+                AkRandom::local().bounded(this->d->m_nCharacters):
                 0;
 
     return *this;
@@ -186,7 +186,5 @@ int RainDrop::y() const
 
 qreal RainDropPrivate::boundedReal(qreal min, qreal max)
 {
-    std::uniform_real_distribution<qreal> distribution(min, max);
-
-    return distribution(*QRandomGenerator::global());
+    return AkRandom::local().bounded(min, max);
 }
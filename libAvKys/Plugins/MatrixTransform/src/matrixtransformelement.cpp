@@ -27,6 +27,7 @@
 #include <akvideocaps.h>
 #include <akvideoconverter.h>
 #include <akvideopacket.h>
+#include <akvideowarp.h>
 
 #include "matrixtransformelement.h"
 
@@ -37,6 +38,7 @@ class MatrixTransformElementPrivate
     public:
         QVector<qreal> m_kernel;
         int m_ikernel[6];
+        AkVideoWarp m_warp;
         QMutex m_mutex;
         AkVideoConverter m_videoConverter {{AkVideoCaps::Format_argbpack, 0, 0, {}}};
 };
@@ -73,6 +75,16 @@ QVariantList MatrixTransformElement::kernel() const
     return kernel;
 }
 
+AkVideoCaps::PixelFormatList MatrixTransformElement::videoInputFormats() const
+{
+    return {AkVideoCaps::Format_argbpack};
+}
+
+AkVideoCaps::PixelFormatList MatrixTransformElement::videoOutputFormats() const
+{
+    return {AkVideoCaps::Format_argbpack};
+}
+
 QString MatrixTransformElement::controlInterfaceProvide(const QString &controlId) const
 {
     Q_UNUSED(controlId)
@@ -103,35 +115,18 @@ AkPacket MatrixTransformElement::iVideoStream(const AkVideoPacket &packet)
 
     this->d->m_mutex.lock();
 
-    int cx = src.caps().width() >> 1;
-    int cy = src.caps().height() >> 1;
-    int dxi = -(cx + this->d->m_ikernel[2]);
-    int dy  = -(cy + this->d->m_ikernel[5]);
-    auto mult = 1 << VALUE_SHIFT;
+    qint64 cx = src.caps().width() >> 1;
+    qint64 cy = src.caps().height() >> 1;
+    qint64 dx = -(cx + this->d->m_ikernel[2]);
+    qint64 dy = -(cy + this->d->m_ikernel[5]);
+    auto ik = this->d->m_ikernel;
 
-    for (int y = 0; y < src.caps().height(); y++) {
-        auto oLine = reinterpret_cast<QRgb *>(dst.line(0, y));
-        int dx = dxi;
-
-        for (int x = 0; x < src.caps().width(); x++) {
-            int xp = (dx * this->d->m_ikernel[0] + dy * this->d->m_ikernel[1] + cx * mult) >> VALUE_SHIFT;
-            int yp = (dy * this->d->m_ikernel[3] + dx * this->d->m_ikernel[4] + cy * mult) >> VALUE_SHIFT;
-
-            if (xp >= 0
-                && xp < src.caps().width()
-                && yp >= 0
-                && yp < src.caps().height()) {
-                auto iLine = reinterpret_cast<const QRgb *>(src.constLine(0, yp));
-                oLine[x] = iLine[xp];
-            } else {
-                oLine[x] = qRgba(0, 0, 0, 0);
-            }
-
-            dx++;
-        }
-
-        dy++;
-    }
+    qint64 matrix[] {
+        ik[0], ik[1], dx * ik[0] + dy * ik[1] + (cx << VALUE_SHIFT),
+        ik[4], ik[3], dx * ik[4] + dy * ik[3] + (cy << VALUE_SHIFT),
+    };
+    this->d->m_warp.setMatrix(matrix, VALUE_SHIFT);
+    this->d->m_warp.warp(src, dst);
 
     this->d->m_mutex.unlock();
 
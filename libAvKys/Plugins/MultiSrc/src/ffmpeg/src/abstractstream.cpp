@@ -19,6 +19,7 @@
 
 #include <QQueue>
 #include <QAbstractEventDispatcher>
+#include <QElapsedTimer>
 #include <QEventLoop>
 #include <QtConcurrent>
 #include <QFuture>
@@ -31,6 +32,10 @@
 #include "abstractstream.h"
 #include "clock.h"
 
+// Maximum number of threads used by the decoders, above this the decoders
+// don't scale anymore and just add latency.
+#define MAX_DECODING_THREADS 16
+
 template <typename T>
 inline void waitLoop(const QFuture<T> &loop)
 {
@@ -65,11 +70,14 @@ class AbstractStreamPrivate
         QQueue<FramePtr> m_frames;
         QQueue<SubtitlePtr> m_subtitles;
         qint64 m_packetQueueSize {0};
+        std::atomic<qint64> m_decodingTime {0};
+        std::atomic<int> m_activeDecodingThreads {0};
         Clock *m_globalClock {nullptr};
         QFuture<void> m_packetLoopResult;
         QFuture<void> m_dataLoopResult;
         qint64 m_id {-1};
         uint m_index {0};
+        int m_decodingThreads {0};
         AVMediaType m_mediaType {AVMEDIA_TYPE_UNKNOWN};
         AkElement::ElementState m_state {AkElement::ElementStateNull};
         bool m_sync {true};
@@ -85,6 +93,7 @@ class AbstractStreamPrivate
         static void deletePacket(AVPacket *packet);
         static void deleteFrame(AVFrame *frame);
         static void deleteSubtitle(AVSubtitle *subtitle);
+        void setupThreads();
 };
 
 AbstractStream::AbstractStream(const AVFormatContext *formatContext,
@@ -228,6 +237,37 @@ qint64 AbstractStream::queueSize() const
     return this->d->m_packetQueueSize;
 }
 
+int AbstractStream::frameQueueSize() const
+{
+    this->d->m_dataMutex.lock();
+    auto size = this->d->m_frames.size() + this->d->m_subtitles.size();
+    this->d->m_dataMutex.unlock();
+
+    return size;
+}
+
+int AbstractStream::decodingThreads() const
+{
+    return this->d->m_decodingThreads;
+}
+
+qreal AbstractStream::decodingTime() const
+{
+    return qreal(this->d->m_decodingTime) / 1e6;
+}
+
+QVariantMap AbstractStream::stats() const
+{
+    // This is called from the GUI thread while the codec context can be
+    // freed, so use the number of threads cached when the codec was opened.
+    return QVariantMap {
+        {"decodingThreads", int(this->d->m_activeDecodingThreads)},
+        {"decodingTime"   , this->decodingTime()                 },
+        {"packetQueueSize", this->queueSize()                    },
+        {"frameQueueSize" , this->frameQueueSize()               },
+    };
+}
+
 Clock *AbstractStream::globalClock()
 {
     return this->d->m_globalClock;
@@ -329,6 +369,10 @@ void AbstractStream::processData(AVSubtitle *subtitle)
     Q_UNUSED(subtitle)
 }
 
+void AbstractStream::interrupt()
+{
+}
+
 void AbstractStream::flush()
 {
     this->d->m_dataMutex.lock();
@@ -339,6 +383,8 @@ void AbstractStream::flush()
     this->d->m_frames.clear();
     this->d->m_subtitles.clear();
     this->d->m_dataMutex.unlock();
+
+    this->interrupt();
 }
 
 bool AbstractStream::setState(AkElement::ElementState state)
@@ -350,12 +396,17 @@ bool AbstractStream::setState(AkElement::ElementState state)
             if (!this->d->m_codecContext || !this->d->m_codec)
                 return false;
 
+            this->d->setupThreads();
+
             if (avcodec_open2(this->d->m_codecContext,
                               this->d->m_codec,
                               &this->d->m_codecOptions) < 0)
                 return false;
 
             this->m_clockDiff = 0.0;
+            this->d->m_decodingTime = 0;
+            this->d->m_activeDecodingThreads =
+                    this->d->m_codecContext->thread_count;
             this->d->m_run = true;
             this->d->m_runPacketLoop = true;
             this->d->m_paused = state == AkElement::ElementStatePaused;
@@ -378,10 +429,12 @@ bool AbstractStream::setState(AkElement::ElementState state)
     case AkElement::ElementStatePaused: {
         switch (state) {
         case AkElement::ElementStateNull: {
+            this->d->m_activeDecodingThreads = 0;
             this->d->m_runPacketLoop = false;
             waitLoop(this->d->m_packetLoopResult);
 
             this->d->m_run = false;
+            this->interrupt();
             waitLoop(this->d->m_dataLoopResult);
 
             if (this->d->m_codecOptions)
@@ -420,10 +473,12 @@ bool AbstractStream::setState(AkElement::ElementState state)
     case AkElement::ElementStatePlaying: {
         switch (state) {
         case AkElement::ElementStateNull: {
+            this->d->m_activeDecodingThreads = 0;
             this->d->m_runPacketLoop = false;
             waitLoop(this->d->m_packetLoopResult);
 
             this->d->m_run = false;
+            this->interrupt();
             waitLoop(this->d->m_dataLoopResult);
 
             if (this->d->m_codecOptions)
@@ -469,6 +524,11 @@ void AbstractStream::setSync(bool sync)
     this->d->m_sync = sync;
 }
 
+void AbstractStream::setDecodingThreads(int decodingThreads)
+{
+    this->d->m_decodingThreads = decodingThreads;
+}
+
 AbstractStreamPrivate::AbstractStreamPrivate(AbstractStream *self):
     self(self)
 {
@@ -507,6 +567,9 @@ void AbstractStreamPrivate::readPacket()
 
     this->m_packetMutex.unlock();
 
+    QElapsedTimer timer;
+    timer.start();
+
     if (gotPacket) {
         self->processPacket(packet.data());
         emit self->notify();
@@ -514,6 +577,13 @@ void AbstractStreamPrivate::readPacket()
 
     self->decodeData();
 
+    // Keep a moving average of the time spent decoding each packet.
+    if (gotPacket && packet) {
+        qint64 decodingTime = this->m_decodingTime;
+        this->m_decodingTime = decodingTime
+                             + (timer.nsecsElapsed() - decodingTime) / 16;
+    }
+
     if (!packet)
         this->m_runPacketLoop = false;
 }
@@ -600,6 +670,23 @@ void AbstractStreamPrivate::readData()
     }
 }
 
+void AbstractStreamPrivate::setupThreads()
+{
+    // Let the decoder split the work in frames and slices, by default use
+    // as many threads as cores.
+    auto threads = this->m_decodingThreads;
+
+    if (threads < 1)
+        threads = qBound(1, QThread::idealThreadCount(), MAX_DECODING_THREADS);
+
+    if (!(this->m_codec->capabilities
+          & (AV_CODEC_CAP_FRAME_THREADS | AV_CODEC_CAP_SLICE_THREADS)))
+        threads = 1;
+
+    this->m_codecContext->thread_count = threads;
+    this->m_codecContext->thread_type = FF_THREAD_FRAME | FF_THREAD_SLICE;
+}
+
 void AbstractStreamPrivate::deletePacket(AVPacket *packet)
 {
     if (!packet)
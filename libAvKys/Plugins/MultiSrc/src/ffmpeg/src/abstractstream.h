@@ -64,6 +64,10 @@ class AbstractStream: public QObject
         Q_INVOKABLE virtual AkCaps caps() const;
         Q_INVOKABLE bool sync() const;
         Q_INVOKABLE qint64 queueSize() const;
+        Q_INVOKABLE int frameQueueSize() const;
+        Q_INVOKABLE int decodingThreads() const;
+        Q_INVOKABLE qreal decodingTime() const;
+        Q_INVOKABLE virtual QVariantMap stats() const;
         Q_INVOKABLE Clock *globalClock();
         Q_INVOKABLE qreal clockDiff() const;
         Q_INVOKABLE qreal &clockDiff();
@@ -84,6 +88,10 @@ class AbstractStream: public QObject
         virtual void processData(AVFrame *frame);
         virtual void processData(AVSubtitle *subtitle);
 
+        // Wakes up the data thread if it's waiting for a frame to be
+        // presented.
+        virtual void interrupt();
+
     private:
         AbstractStreamPrivate *d;
 
@@ -97,6 +105,7 @@ class AbstractStream: public QObject
         void flush();
         bool setState(AkElement::ElementState state);
         void setSync(bool sync);
+        void setDecodingThreads(int decodingThreads);
 
         friend class AbstractStreamPrivate;
 };
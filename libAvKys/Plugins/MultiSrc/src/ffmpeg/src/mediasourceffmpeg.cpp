@@ -28,10 +28,13 @@
 #include <QtConcurrent>
 #include <ak.h>
 #include <akcaps.h>
+#include <akvideocaps.h>
+#include <akvideopacket.h>
 
 extern "C"
 {
     #include <libavcodec/avcodec.h>
+    #include <libswscale/swscale.h>
 
 #ifdef HAVE_LIBAVDEVICE
     #include <libavdevice/avdevice.h>
@@ -44,6 +47,9 @@ extern "C"
 #include "subtitlestream.h"
 #include "videostream.h"
 
+// Maximum number of packets read looking for a thumbnail frame.
+#define MAX_THUMBNAIL_PACKETS 1024
+
 using FormatContextPtr = QSharedPointer<AVFormatContext>;
 using AbstractStreamPtr = QSharedPointer<AbstractStream>;
 using AvMediaTypeAkMap = QMap<AVMediaType, AkCaps::CapsType>;
@@ -114,6 +120,7 @@ class MediaSourceFFmpegPrivate
         QMap<int, AbstractStreamPtr> m_streamsMap;
         Clock m_globalClock;
         qreal m_curClockTime {0.0};
+        int m_decodingThreads {0};
         AkElement::ElementState m_state {AkElement::ElementStateNull};
         bool m_loop {false};
         bool m_sync {true};
@@ -125,6 +132,9 @@ class MediaSourceFFmpegPrivate
         explicit MediaSourceFFmpegPrivate(MediaSourceFFmpeg *self);
         qint64 packetQueueSize() const;
         static void deleteFormatContext(AVFormatContext *context);
+        static AVFrame *readKeyFrame(AVFormatContext *context,
+                                     int index,
+                                     const QSize &size);
         AbstractStreamPtr createStream(int index, bool noModify=false);
         void readPackets();
         void readPacket();
@@ -342,6 +352,110 @@ qint64 MediaSourceFFmpeg::maxPacketQueueSize() const
     return this->d->m_maxPacketQueueSize;
 }
 
+int MediaSourceFFmpeg::decodingThreads() const
+{
+    return this->d->m_decodingThreads;
+}
+
+QVariantMap MediaSourceFFmpeg::streamStats(int stream)
+{
+    this->d->m_dataMutex.lock();
+    auto abstractStream = this->d->m_streamsMap.value(stream);
+    this->d->m_dataMutex.unlock();
+
+    if (!abstractStream)
+        return {};
+
+    return abstractStream->stats();
+}
+
+AkPacket MediaSourceFFmpeg::thumbnail(const QString &media,
+                                     const QSize &size,
+                                     qreal position)
+{
+    if (media.isEmpty() || size.isEmpty())
+        return {};
+
+    AVFormatContext *inputContext = nullptr;
+
+    if (avformat_open_input(&inputContext,
+                            media.toStdString().c_str(),
+                            nullptr,
+                            nullptr) < 0)
+        return {};
+
+    FormatContextPtr context(inputContext,
+                             MediaSourceFFmpegPrivate::deleteFormatContext);
+
+    if (avformat_find_stream_info(inputContext, nullptr) < 0)
+        return {};
+
+    int index = av_find_best_stream(inputContext,
+                                    AVMEDIA_TYPE_VIDEO,
+                                    -1,
+                                    -1,
+                                    nullptr,
+                                    0);
+
+    if (index < 0)
+        return {};
+
+    // Jump to the key frame before the position, only key frames are
+    // decoded.
+    if (inputContext->duration > 0 && position > 0.0)
+        av_seek_frame(inputContext,
+                      -1,
+                      int64_t(qBound(0.0, position, 1.0) * inputContext->duration),
+                      AVSEEK_FLAG_BACKWARD);
+
+    auto frame = MediaSourceFFmpegPrivate::readKeyFrame(inputContext,
+                                                        index,
+                                                        size);
+
+    if (!frame)
+        return {};
+
+    // Scale the frame straight to the thumbnail size, keeping the aspect
+    // ratio.
+    auto thumbnailSize =
+            QSize(frame->width, frame->height).scaled(size, Qt::KeepAspectRatio);
+    thumbnailSize = thumbnailSize.expandedTo({1, 1});
+    auto scaleContext = sws_getContext(frame->width,
+                                       frame->height,
+                                       AVPixelFormat(frame->format),
+                                       thumbnailSize.width(),
+                                       thumbnailSize.height(),
+                                       AV_PIX_FMT_RGB24,
+                                       SWS_BILINEAR,
+                                       nullptr,
+                                       nullptr,
+                                       nullptr);
+
+    if (!scaleContext) {
+        av_frame_free(&frame);
+
+        return {};
+    }
+
+    AkVideoPacket thumbnail({AkVideoCaps::Format_rgb24,
+                             thumbnailSize.width(),
+                             thumbnailSize.height(),
+                             {}});
+    uint8_t *dstData[] {thumbnail.line(0, 0)};
+    int dstLineSize[] {int(thumbnail.lineSize(0))};
+    sws_scale(scaleContext,
+              frame->data,
+              frame->linesize,
+              0,
+              frame->height,
+              dstData,
+              dstLineSize);
+    sws_freeContext(scaleContext);
+    av_frame_free(&frame);
+
+    return thumbnail;
+}
+
 bool MediaSourceFFmpeg::showLog() const
 {
     return this->d->m_showLog;
@@ -424,6 +538,15 @@ void MediaSourceFFmpeg::setMaxPacketQueueSize(qint64 maxPacketQueueSize)
     emit this->maxPacketQueueSizeChanged(maxPacketQueueSize);
 }
 
+void MediaSourceFFmpeg::setDecodingThreads(int decodingThreads)
+{
+    if (this->d->m_decodingThreads == decodingThreads)
+        return;
+
+    this->d->m_decodingThreads = decodingThreads;
+    emit this->decodingThreadsChanged(decodingThreads);
+}
+
 void MediaSourceFFmpeg::setShowLog(bool showLog)
 {
     if (this->d->m_showLog == showLog)
@@ -473,6 +596,11 @@ void MediaSourceFFmpeg::resetMaxPacketQueueSize()
     this->setMaxPacketQueueSize(15 * 1024 * 1024);
 }
 
+void MediaSourceFFmpeg::resetDecodingThreads()
+{
+    this->setDecodingThreads(0);
+}
+
 void MediaSourceFFmpeg::resetShowLog()
 {
     this->setShowLog(false);
@@ -524,7 +652,9 @@ bool MediaSourceFFmpeg::setState(AkElement::ElementState state)
                 if (!stream)
                     continue;
 
+                this->d->m_dataMutex.lock();
                 this->d->m_streamsMap[i] = stream;
+                this->d->m_dataMutex.unlock();
 
                 QObject::connect(stream.data(),
                                  SIGNAL(oStream(AkPacket)),
@@ -544,6 +674,7 @@ bool MediaSourceFFmpeg::setState(AkElement::ElementState state)
                                  this,
                                  SLOT(doLoop()));
 
+                stream->setDecodingThreads(this->d->m_decodingThreads);
                 stream->setState(state);
             }
 
@@ -578,7 +709,9 @@ bool MediaSourceFFmpeg::setState(AkElement::ElementState state)
             for (auto &stream: this->d->m_streamsMap)
                 stream->setState(state);
 
+            this->d->m_dataMutex.lock();
             this->d->m_streamsMap.clear();
+            this->d->m_dataMutex.unlock();
             this->d->m_inputContext.clear();
             this->d->m_state = state;
             emit this->stateChanged(state);
@@ -617,7 +750,9 @@ bool MediaSourceFFmpeg::setState(AkElement::ElementState state)
             for (auto &stream: this->d->m_streamsMap)
                 stream->setState(state);
 
+            this->d->m_dataMutex.lock();
             this->d->m_streamsMap.clear();
+            this->d->m_dataMutex.unlock();
             this->d->m_inputContext.clear();
             this->d->m_state = state;
             emit this->stateChanged(state);
@@ -688,6 +823,8 @@ void MediaSourceFFmpeg::log()
     qreal diff;
     qint64 audioQueueSize = 0;
     qint64 videoQueueSize = 0;
+    int videoFrames = 0;
+    qreal videoDecodingTime = 0.0;
 
     if (audioStream && videoStream) {
         diffType = "A-V";
@@ -705,12 +842,19 @@ void MediaSourceFFmpeg::log()
     } else
         return;
 
-    QString logFmt("%1 %2: %3 aq=%4KB vq=%5KB");
+    if (videoStream) {
+        videoFrames = videoStream->frameQueueSize();
+        videoDecodingTime = videoStream->decodingTime();
+    }
+
+    QString logFmt("%1 %2: %3 aq=%4KB vq=%5KB vf=%6 vdt=%7ms");
     QString log = logFmt.arg(this->d->m_globalClock.clock(), 7, 'f', 2)
                         .arg(diffType)
                         .arg(diff, 7, 'f', 3)
                         .arg(audioQueueSize / 1024, 5)
-                        .arg(videoQueueSize / 1024, 5);
+                        .arg(videoQueueSize / 1024, 5)
+                        .arg(videoFrames, 2)
+                        .arg(videoDecodingTime, 6, 'f', 2);
     qDebug() << log.toStdString().c_str();
 }
 
@@ -840,6 +984,79 @@ void MediaSourceFFmpegPrivate::deleteFormatContext(AVFormatContext *context)
     avformat_close_input(&context);
 }
 
+AVFrame *MediaSourceFFmpegPrivate::readKeyFrame(AVFormatContext *context,
+                                                int index,
+                                                const QSize &size)
+{
+    auto stream = context->streams[index];
+    auto codec = avcodec_find_decoder(stream->codecpar->codec_id);
+
+    if (!codec)
+        return nullptr;
+
+    auto codecContext = avcodec_alloc_context3(codec);
+
+    if (!codecContext)
+        return nullptr;
+
+    if (avcodec_parameters_to_context(codecContext, stream->codecpar) < 0) {
+        avcodec_free_context(&codecContext);
+
+        return nullptr;
+    }
+
+    // Skip everything that is not needed for a still picture, and decode at
+    // the lowest resolution that is still bigger than the thumbnail. Several
+    // thumbnails are read at the same time, so use just one thread.
+    codecContext->skip_frame = AVDISCARD_NONKEY;
+    codecContext->skip_loop_filter = AVDISCARD_ALL;
+    codecContext->thread_count = 1;
+    int lowres = 0;
+
+    while (lowres < codec->max_lowres
+           && (codecContext->width >> (lowres + 1)) >= size.width()
+           && (codecContext->height >> (lowres + 1)) >= size.height())
+        lowres++;
+
+    codecContext->lowres = lowres;
+
+    if (avcodec_open2(codecContext, codec, nullptr) < 0) {
+        avcodec_free_context(&codecContext);
+
+        return nullptr;
+    }
+
+    auto packet = av_packet_alloc();
+    auto frame = av_frame_alloc();
+    bool gotFrame = false;
+    bool eof = false;
+
+    for (int i = 0; i < MAX_THUMBNAIL_PACKETS && !gotFrame && !eof; i++) {
+        if (av_read_frame(context, packet) < 0) {
+            // Flush the decoder.
+            eof = true;
+            avcodec_send_packet(codecContext, nullptr);
+        } else if (packet->stream_index != index) {
+            av_packet_unref(packet);
+
+            continue;
+        } else {
+            avcodec_send_packet(codecContext, packet);
+            av_packet_unref(packet);
+        }
+
+        gotFrame = avcodec_receive_frame(codecContext, frame) >= 0;
+    }
+
+    av_packet_free(&packet);
+    avcodec_free_context(&codecContext);
+
+    if (!gotFrame)
+        av_frame_free(&frame);
+
+    return frame;
+}
+
 AbstractStreamPtr MediaSourceFFmpegPrivate::createStream(int index,
                                                          bool noModify)
 {
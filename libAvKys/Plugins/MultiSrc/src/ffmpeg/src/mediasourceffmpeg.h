@@ -45,6 +45,11 @@ class MediaSourceFFmpeg: public MediaSource
         Q_INVOKABLE qint64 durationMSecs() override;
         Q_INVOKABLE qint64 currentTimeMSecs() override;
         Q_INVOKABLE qint64 maxPacketQueueSize() const override;
+        Q_INVOKABLE int decodingThreads() const override;
+        Q_INVOKABLE QVariantMap streamStats(int stream) override;
+        Q_INVOKABLE AkPacket thumbnail(const QString &media,
+                                       const QSize &size,
+                                       qreal position) override;
         Q_INVOKABLE bool showLog() const override;
         Q_INVOKABLE AkElement::ElementState state() const override;
 
@@ -56,12 +61,14 @@ class MediaSourceFFmpeg: public MediaSource
         void setMedia(const QString &media) override;
         void setStreams(const QList<int> &streams) override;
         void setMaxPacketQueueSize(qint64 maxPacketQueueSize) override;
+        void setDecodingThreads(int decodingThreads) override;
         void setShowLog(bool showLog) override;
         void setLoop(bool loop) override;
         void setSync(bool sync) override;
         void resetMedia() override;
         void resetStreams() override;
         void resetMaxPacketQueueSize() override;
+        void resetDecodingThreads() override;
         void resetShowLog() override;
         void resetLoop() override;
         void resetSync() override;
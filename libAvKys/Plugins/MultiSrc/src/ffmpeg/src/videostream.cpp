@@ -17,7 +17,10 @@
  * Web-Site: http://webcamoid.github.io/
  */
 
+#include <QDeadlineTimer>
+#include <QMutex>
 #include <QThread>
+#include <QWaitCondition>
 #include <akfrac.h>
 #include <akcaps.h>
 #include <akpacket.h>
@@ -46,6 +49,23 @@ extern "C"
 // no AV correction is done if too big error
 #define AV_NOSYNC_THRESHOLD 10.0
 
+// If the video is late by more than this, the decoder skips the frames that
+// are not used as reference.
+#define LAG_SKIP_NONREF_THRESHOLD 0.1
+
+// If the video is late by more than this, only key frames are decoded.
+#define LAG_SKIP_NONKEY_THRESHOLD 0.5
+
+// Number of frames on time before decoding all frames again.
+#define LAG_RECOVERY_FRAMES 8
+
+enum SkipLevel
+{
+    SkipLevel_None,
+    SkipLevel_NonRef,
+    SkipLevel_NonKey
+};
+
 class VideoStreamPrivate
 {
     public:
@@ -54,10 +74,26 @@ class VideoStreamPrivate
         qreal m_lastPts {0.0};
         bool m_firstPacket {true};
 
+        // Feedback from the presentation to the decoder.
+        std::atomic<int> m_skipLevel {SkipLevel_None};
+        int m_decoderSkipLevel {SkipLevel_None};
+        int m_onTimeFrames {0};
+        std::atomic<qint64> m_lag {0};
+        std::atomic<quint64> m_decodedFrames {0};
+        std::atomic<quint64> m_droppedFrames {0};
+        std::atomic<quint64> m_skipLevelChanges {0};
+
+        QMutex m_waitMutex;
+        QWaitCondition m_waitCondition;
+        quint64 m_interruptions {0};
+
         explicit VideoStreamPrivate(VideoStream *self);
         AkFrac fps() const;
         AkPacket convert(AVFrame *iFrame);
         AVFrame *copyFrame(AVFrame *frame) const;
+        void updateSkipLevel(qreal lag);
+        void applySkipLevel();
+        bool waitFor(qreal seconds);
 
         template<typename R, typename S>
         inline static R align(R value, S align)
@@ -114,6 +150,7 @@ bool VideoStream::decodeData()
 
         if (r >= 0) {
             this->dataEnqueue(this->d->copyFrame(iFrame));
+            this->d->m_decodedFrames++;
             result = true;
         }
 
@@ -137,6 +174,7 @@ void VideoStream::processPacket(AVPacket *packet)
         return;
     }
 
+    this->d->applySkipLevel();
     avcodec_send_packet(this->codecContext(), packet);
 }
 
@@ -165,17 +203,22 @@ void VideoStream::processData(AVFrame *frame)
             && !qIsNaN(diff)
             && qAbs(diff) < AV_NOSYNC_THRESHOLD
             && delay < AV_SYNC_FRAMEDUP_THRESHOLD) {
+            this->d->updateSkipLevel(-diff);
+
             // Video is backward the external clock.
             if (diff <= -syncThreshold) {
                 // Drop frame.
                 this->d->m_lastPts = pts;
+                this->d->m_droppedFrames++;
 
                 break;
             }
 
             if (diff > syncThreshold) {
-                // Video is ahead the external clock.
-                QThread::usleep(ulong(1e6 * (diff - syncThreshold)));
+                // Video is ahead the external clock, wait until the frame
+                // is due, and check again in case the clock was changed.
+                if (!this->d->waitFor(diff - syncThreshold))
+                    break;
 
                 continue;
             }
@@ -193,6 +236,26 @@ void VideoStream::processData(AVFrame *frame)
     }
 }
 
+QVariantMap VideoStream::stats() const
+{
+    auto stats = AbstractStream::stats();
+    stats["lag"] = qreal(this->d->m_lag) / 1e6;
+    stats["skipLevel"] = int(this->d->m_skipLevel);
+    stats["skipLevelChanges"] = quint64(this->d->m_skipLevelChanges);
+    stats["decodedFrames"] = quint64(this->d->m_decodedFrames);
+    stats["droppedFrames"] = quint64(this->d->m_droppedFrames);
+
+    return stats;
+}
+
+void VideoStream::interrupt()
+{
+    this->d->m_waitMutex.lock();
+    this->d->m_interruptions++;
+    this->d->m_waitCondition.wakeAll();
+    this->d->m_waitMutex.unlock();
+}
+
 VideoStreamPrivate::VideoStreamPrivate(VideoStream *self):
     self(self)
 {
@@ -292,6 +355,85 @@ AkPacket VideoStreamPrivate::convert(AVFrame *iFrame)
     return oPacket;
 }
 
+void VideoStreamPrivate::updateSkipLevel(qreal lag)
+{
+    this->m_lag = qMax<qint64>(0, qRound64(1e6 * lag));
+    int skipLevel = this->m_skipLevel;
+
+    if (lag >= LAG_SKIP_NONKEY_THRESHOLD) {
+        skipLevel = SkipLevel_NonKey;
+        this->m_onTimeFrames = 0;
+    } else if (lag >= LAG_SKIP_NONREF_THRESHOLD) {
+        skipLevel = qMax<int>(skipLevel, SkipLevel_NonRef);
+        this->m_onTimeFrames = 0;
+    } else if (lag < AV_SYNC_THRESHOLD_MIN && skipLevel != SkipLevel_None) {
+        /* Only key frames arrive in the highest level, so go back to normal
+         * decoding as soon as one of them is on time. Otherwise wait for a
+         * few frames to avoid switching back and forth.
+         */
+        if (skipLevel == SkipLevel_NonKey
+            || ++this->m_onTimeFrames >= LAG_RECOVERY_FRAMES) {
+            skipLevel = SkipLevel_None;
+            this->m_onTimeFrames = 0;
+        }
+    }
+
+    if (skipLevel != this->m_skipLevel) {
+        this->m_skipLevel = skipLevel;
+        this->m_skipLevelChanges++;
+    }
+}
+
+void VideoStreamPrivate::applySkipLevel()
+{
+    int skipLevel = this->m_skipLevel;
+
+    if (skipLevel == this->m_decoderSkipLevel)
+        return;
+
+    auto codecContext = self->codecContext();
+
+    switch (skipLevel) {
+    case SkipLevel_NonRef:
+        codecContext->skip_frame = AVDISCARD_NONREF;
+        codecContext->skip_loop_filter = AVDISCARD_ALL;
+
+        break;
+
+    case SkipLevel_NonKey:
+        codecContext->skip_frame = AVDISCARD_NONKEY;
+        codecContext->skip_loop_filter = AVDISCARD_ALL;
+
+        break;
+
+    default:
+        codecContext->skip_frame = AVDISCARD_DEFAULT;
+        codecContext->skip_loop_filter = AVDISCARD_DEFAULT;
+
+        break;
+    }
+
+    this->m_decoderSkipLevel = skipLevel;
+}
+
+bool VideoStreamPrivate::waitFor(qreal seconds)
+{
+    QDeadlineTimer deadline(Qt::PreciseTimer);
+    deadline.setPreciseRemainingTime(0,
+                                     qRound64(1e9 * seconds),
+                                     Qt::PreciseTimer);
+    this->m_waitMutex.lock();
+    auto interruptions = this->m_interruptions;
+
+    while (this->m_interruptions == interruptions && !deadline.hasExpired())
+        this->m_waitCondition.wait(&this->m_waitMutex, deadline);
+
+    bool interrupted = this->m_interruptions != interruptions;
+    this->m_waitMutex.unlock();
+
+    return !interrupted;
+}
+
 AVFrame *VideoStreamPrivate::copyFrame(AVFrame *frame) const
 {
     auto oFrame = av_frame_alloc();
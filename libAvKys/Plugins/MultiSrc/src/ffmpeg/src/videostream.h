@@ -40,10 +40,12 @@ class VideoStream: public AbstractStream
 
         Q_INVOKABLE AkCaps caps() const override;
         Q_INVOKABLE bool decodeData() override;
+        Q_INVOKABLE QVariantMap stats() const override;
 
     protected:
         void processPacket(AVPacket *packet) override;
         void processData(AVFrame *frame) override;
+        void interrupt() override;
 
     private:
         VideoStreamPrivate *d;
@@ -56,6 +56,16 @@ class Stream
         }
 };
 
+class MappedSample
+{
+    public:
+        GstSample *sample {nullptr};
+        GstBuffer *buffer {nullptr};
+        GstMapInfo map;
+
+        static void release(void *opaque);
+};
+
 class MediaSourceGStreamerPrivate
 {
     public:
@@ -1029,26 +1039,30 @@ GstFlowReturn MediaSourceGStreamerPrivate::audioBufferCallback(GstElement *audio
     gst_audio_info_from_caps(audioInfo, caps);
 
     auto buf = gst_sample_get_buffer(sample);
-    GstMapInfo map;
-    gst_buffer_map(buf, &map, GST_MAP_READ);
-    gint samples = gint(map.size) / audioInfo->bpf;
+    auto mappedSample = new MappedSample;
+    mappedSample->sample = sample;
+    mappedSample->buffer = buf;
+    gst_buffer_map(buf, &mappedSample->map, GST_MAP_READ);
+    gint samples = gint(mappedSample->map.size) / audioInfo->bpf;
 
     AkAudioCaps audioCaps(AkAudioCaps::SampleFormat_s32,
                           AkAudioCaps::Layout_stereo,
                           false,
                           audioInfo->rate);
-    AkAudioPacket packet(audioCaps, samples);
-    memcpy(packet.data(),
-           map.data,
-           qMin<size_t>(packet.size(), map.size));
+
+    // Adopt the mapped buffer instead of copying it.
+    quint8 *planes[] = {mappedSample->map.data};
+    AkAudioPacket packet(audioCaps,
+                         samples,
+                         planes,
+                         MappedSample::release,
+                         mappedSample);
     packet.setPts(qint64(GST_BUFFER_PTS(buf)));
     packet.setDuration(qint64(GST_BUFFER_DURATION(buf)));
     packet.setTimeBase({1, GST_SECOND});
     packet.setIndex(int(self->d->m_audioIndex));
     packet.setId(self->d->m_audioId);
 
-    gst_buffer_unmap(buf, &map);
-    gst_sample_unref(sample);
     gst_audio_info_free(audioInfo);
 
     emit self->oStream(packet);
@@ -1079,33 +1093,34 @@ GstFlowReturn MediaSourceGStreamerPrivate::videoBufferCallback(GstElement *video
                           videoInfo->width,
                           videoInfo->height,
                           AkFrac(videoInfo->fps_n, videoInfo->fps_d));
-    AkVideoPacket packet(videoCaps);
     auto buf = gst_sample_get_buffer(sample);
-    GstMapInfo map;
-    gst_buffer_map(buf, &map, GST_MAP_READ);
+    auto mappedSample = new MappedSample;
+    mappedSample->sample = sample;
+    mappedSample->buffer = buf;
+    gst_buffer_map(buf, &mappedSample->map, GST_MAP_READ);
+
+    // Adopt the mapped buffer instead of copying it line by line.
+    quint8 *planes[GST_VIDEO_MAX_PLANES];
+    size_t lineSizes[GST_VIDEO_MAX_PLANES];
 
     for (int plane = 0; plane < GST_VIDEO_INFO_N_PLANES(videoInfo); ++plane) {
-        auto planeData = map.data + GST_VIDEO_INFO_PLANE_OFFSET(videoInfo, plane);
-        auto oLineSize = GST_VIDEO_INFO_PLANE_STRIDE(videoInfo, plane);
-        auto lineSize = qMin<size_t>(packet.lineSize(plane), oLineSize);
-        auto heightDiv = packet.heightDiv(plane);
-
-        for (int y = 0; y < videoInfo->height; ++y) {
-            auto ys = y >> heightDiv;
-            memcpy(packet.line(plane, y),
-                   planeData + ys * oLineSize,
-                   lineSize);
-        }
+        planes[plane] = mappedSample->map.data
+                        + GST_VIDEO_INFO_PLANE_OFFSET(videoInfo, plane);
+        lineSizes[plane] = GST_VIDEO_INFO_PLANE_STRIDE(videoInfo, plane);
     }
 
+    AkVideoPacket packet(videoCaps,
+                         planes,
+                         lineSizes,
+                         mappedSample->map.size,
+                         MappedSample::release,
+                         mappedSample);
     packet.setPts(qint64(GST_BUFFER_PTS(buf)));
     packet.setDuration(qint64(GST_BUFFER_DURATION(buf)));
     packet.setTimeBase({1, GST_SECOND});
     packet.setIndex(int(self->d->m_videoIndex));
     packet.setId(self->d->m_videoId);
 
-    gst_buffer_unmap(buf, &map);
-    gst_sample_unref(sample);
     gst_video_info_free(videoInfo);
 
     emit self->oStream(packet);
@@ -1218,4 +1233,12 @@ QStringList MediaSourceGStreamerPrivate::languageCodes()
     return languages;
 }
 
+void MappedSample::release(void *opaque)
+{
+    auto self = reinterpret_cast<MappedSample *>(opaque);
+    gst_buffer_unmap(self->buffer, &self->map);
+    gst_sample_unref(self->sample);
+    delete self;
+}
+
 #include "moc_mediasourcegstreamer.cpp"
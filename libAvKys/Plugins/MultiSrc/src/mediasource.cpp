@@ -99,6 +99,29 @@ qint64 MediaSource::maxPacketQueueSize() const
     return 0;
 }
 
+int MediaSource::decodingThreads() const
+{
+    return 0;
+}
+
+QVariantMap MediaSource::streamStats(int stream)
+{
+    Q_UNUSED(stream)
+
+    return {};
+}
+
+AkPacket MediaSource::thumbnail(const QString &media,
+                               const QSize &size,
+                               qreal position)
+{
+    Q_UNUSED(media)
+    Q_UNUSED(size)
+    Q_UNUSED(position)
+
+    return {};
+}
+
 bool MediaSource::showLog() const
 {
     return false;
@@ -130,6 +153,11 @@ void MediaSource::setMaxPacketQueueSize(qint64 maxPacketQueueSize)
     Q_UNUSED(maxPacketQueueSize)
 }
 
+void MediaSource::setDecodingThreads(int decodingThreads)
+{
+    Q_UNUSED(decodingThreads)
+}
+
 void MediaSource::setShowLog(bool showLog)
 {
     Q_UNUSED(showLog)
@@ -167,6 +195,11 @@ void MediaSource::resetMaxPacketQueueSize()
     this->setMaxPacketQueueSize(0);
 }
 
+void MediaSource::resetDecodingThreads()
+{
+    this->setDecodingThreads(0);
+}
+
 void MediaSource::resetShowLog()
 {
     this->setShowLog(false);
@@ -20,8 +20,10 @@
 #ifndef MEDIASOURCE_H
 #define MEDIASOURCE_H
 
+#include <QSize>
 #include <iak/akelement.h>
 #include <akcaps.h>
+#include <akpacket.h>
 
 class MediaSource: public QObject
 {
@@ -60,6 +62,11 @@ class MediaSource: public QObject
                WRITE setMaxPacketQueueSize
                RESET resetMaxPacketQueueSize
                NOTIFY maxPacketQueueSizeChanged)
+    Q_PROPERTY(int decodingThreads
+               READ decodingThreads
+               WRITE setDecodingThreads
+               RESET resetDecodingThreads
+               NOTIFY decodingThreadsChanged)
     Q_PROPERTY(bool showLog
                READ showLog
                WRITE setShowLog
@@ -94,6 +101,11 @@ class MediaSource: public QObject
         Q_INVOKABLE virtual qint64 durationMSecs();
         Q_INVOKABLE virtual qint64 currentTimeMSecs();
         Q_INVOKABLE virtual qint64 maxPacketQueueSize() const;
+        Q_INVOKABLE virtual int decodingThreads() const;
+        Q_INVOKABLE virtual QVariantMap streamStats(int stream);
+        Q_INVOKABLE virtual AkPacket thumbnail(const QString &media,
+                                               const QSize &size,
+                                               qreal position);
         Q_INVOKABLE virtual bool showLog() const;
         Q_INVOKABLE virtual AkElement::ElementState state() const;
 
@@ -104,6 +116,7 @@ class MediaSource: public QObject
         void durationMSecsChanged(qint64 durationMSecs);
         void currentTimeMSecsChanged(qint64 currentTimeMSecs);
         void maxPacketQueueSizeChanged(qint64 maxPacketQueue);
+        void decodingThreadsChanged(int decodingThreads);
         void showLogChanged(bool showLog);
         void loopChanged(bool loop);
         void syncChanged(bool sync);
@@ -117,6 +130,7 @@ class MediaSource: public QObject
         virtual void setMedia(const QString &media);
         virtual void setStreams(const QList<int> &streams);
         virtual void setMaxPacketQueueSize(qint64 maxPacketQueueSize);
+        virtual void setDecodingThreads(int decodingThreads);
         virtual void setShowLog(bool showLog);
         virtual void setLoop(bool loop);
         virtual void setSync(bool sync);
@@ -124,6 +138,7 @@ class MediaSource: public QObject
         virtual void resetMedia();
         virtual void resetStreams();
         virtual void resetMaxPacketQueueSize();
+        virtual void resetDecodingThreads();
         virtual void resetShowLog();
         virtual void resetLoop();
         virtual void resetSync();
@@ -78,6 +78,10 @@ MultiSrcElement::MultiSrcElement():
                          &MediaSource::maxPacketQueueSizeChanged,
                          this,
                          &MultiSrcElement::maxPacketQueueSizeChanged);
+        QObject::connect(this->d->m_mediaSource.data(),
+                         &MediaSource::decodingThreadsChanged,
+                         this,
+                         &MultiSrcElement::decodingThreadsChanged);
         QObject::connect(this->d->m_mediaSource.data(),
                          &MediaSource::showLogChanged,
                          this,
@@ -284,6 +288,47 @@ qint64 MultiSrcElement::maxPacketQueueSize() const
     return queueSize;
 }
 
+int MultiSrcElement::decodingThreads() const
+{
+    this->d->m_mutex.lockForRead();
+    int decodingThreads = 0;
+
+    if (this->d->m_mediaSource)
+        decodingThreads = this->d->m_mediaSource->decodingThreads();
+
+    this->d->m_mutex.unlock();
+
+    return decodingThreads;
+}
+
+QVariantMap MultiSrcElement::streamStats(int stream)
+{
+    this->d->m_mutex.lockForRead();
+    QVariantMap stats;
+
+    if (this->d->m_mediaSource)
+        stats = this->d->m_mediaSource->streamStats(stream);
+
+    this->d->m_mutex.unlock();
+
+    return stats;
+}
+
+AkPacket MultiSrcElement::thumbnail(const QString &media,
+                                   const QSize &size,
+                                   qreal position)
+{
+    this->d->m_mutex.lockForRead();
+    AkPacket thumbnail;
+
+    if (this->d->m_mediaSource)
+        thumbnail = this->d->m_mediaSource->thumbnail(media, size, position);
+
+    this->d->m_mutex.unlock();
+
+    return thumbnail;
+}
+
 bool MultiSrcElement::showLog() const
 {
     this->d->m_mutex.lockForRead();
@@ -386,6 +431,16 @@ void MultiSrcElement::setMaxPacketQueueSize(qint64 maxPacketQueueSize)
     this->d->m_mutex.unlock();
 }
 
+void MultiSrcElement::setDecodingThreads(int decodingThreads)
+{
+    this->d->m_mutex.lockForRead();
+
+    if (this->d->m_mediaSource)
+        this->d->m_mediaSource->setDecodingThreads(decodingThreads);
+
+    this->d->m_mutex.unlock();
+}
+
 void MultiSrcElement::setShowLog(bool showLog)
 {
     this->d->m_mutex.lockForRead();
@@ -446,6 +501,16 @@ void MultiSrcElement::resetMaxPacketQueueSize()
     this->d->m_mutex.unlock();
 }
 
+void MultiSrcElement::resetDecodingThreads()
+{
+    this->d->m_mutex.lockForRead();
+
+    if (this->d->m_mediaSource)
+        this->d->m_mediaSource->resetDecodingThreads();
+
+    this->d->m_mutex.unlock();
+}
+
 void MultiSrcElement::resetShowLog()
 {
     this->d->m_mutex.lockForRead();
@@ -491,11 +556,13 @@ void MultiSrcElementPrivate::linksChanged(const AkPluginLinks &links)
 
     QString media;
     bool loop = false;
+    int decodingThreads = 0;
     bool showLog = false;
 
     if (this->m_mediaSource) {
         media = this->m_mediaSource->media();
         loop = this->m_mediaSource->loop();
+        decodingThreads = this->m_mediaSource->decodingThreads();
         showLog = this->m_mediaSource->showLog();
     }
 
@@ -532,6 +599,10 @@ void MultiSrcElementPrivate::linksChanged(const AkPluginLinks &links)
                      &MediaSource::maxPacketQueueSizeChanged,
                      self,
                      &MultiSrcElement::maxPacketQueueSizeChanged);
+    QObject::connect(this->m_mediaSource.data(),
+                     &MediaSource::decodingThreadsChanged,
+                     self,
+                     &MultiSrcElement::decodingThreadsChanged);
     QObject::connect(this->m_mediaSource.data(),
                      &MediaSource::showLogChanged,
                      self,
@@ -563,6 +634,7 @@ void MultiSrcElementPrivate::linksChanged(const AkPluginLinks &links)
 
     this->m_mediaSource->setMedia(media);
     this->m_mediaSource->setLoop(loop);
+    this->m_mediaSource->setDecodingThreads(decodingThreads);
     this->m_mediaSource->setShowLog(showLog);
 
     emit self->streamsChanged(self->streams());
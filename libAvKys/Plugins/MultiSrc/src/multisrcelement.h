@@ -20,7 +20,9 @@
 #ifndef MULTISRCELEMENT_H
 #define MULTISRCELEMENT_H
 
+#include <QSize>
 #include <akcaps.h>
+#include <akpacket.h>
 #include <iak/akmultimediasourceelement.h>
 
 class MultiSrcElementPrivate;
@@ -62,6 +64,11 @@ class MultiSrcElement: public AkMultimediaSourceElement
                WRITE setMaxPacketQueueSize
                RESET resetMaxPacketQueueSize
                NOTIFY maxPacketQueueSizeChanged)
+    Q_PROPERTY(int decodingThreads
+               READ decodingThreads
+               WRITE setDecodingThreads
+               RESET resetDecodingThreads
+               NOTIFY decodingThreadsChanged)
     Q_PROPERTY(bool showLog
                READ showLog
                WRITE setShowLog
@@ -92,6 +99,15 @@ class MultiSrcElement: public AkMultimediaSourceElement
         Q_INVOKABLE qint64 durationMSecs();
         Q_INVOKABLE qint64 currentTimeMSecs();
         Q_INVOKABLE qint64 maxPacketQueueSize() const;
+        Q_INVOKABLE int decodingThreads() const;
+        Q_INVOKABLE QVariantMap streamStats(int stream);
+
+        // Reads a frame of the media close to position (a fraction of the
+        // duration), scaled to fit in size. Independent of the current
+        // media, so it can be called from several threads at once.
+        Q_INVOKABLE AkPacket thumbnail(const QString &media,
+                                       const QSize &size,
+                                       qreal position=0.1);
         Q_INVOKABLE bool showLog() const;
         Q_INVOKABLE AkElement::ElementState state() const override;
 
@@ -114,6 +130,7 @@ class MultiSrcElement: public AkMultimediaSourceElement
         void durationMSecsChanged(qint64 durationMSecs);
         void currentTimeMSecsChanged(qint64 currentTimeMSecs);
         void maxPacketQueueSizeChanged(qint64 maxPacketQueue);
+        void decodingThreadsChanged(int decodingThreads);
         void showLogChanged(bool showLog);
 
     public slots:
@@ -123,12 +140,14 @@ class MultiSrcElement: public AkMultimediaSourceElement
         void setLoop(bool loop) override;
         void setSync(bool sync);
         void setMaxPacketQueueSize(qint64 maxPacketQueueSize);
+        void setDecodingThreads(int decodingThreads);
         void setShowLog(bool showLog);
         void resetMedia() override;
         void resetStreams() override;
         void resetLoop() override;
         void resetSync();
         void resetMaxPacketQueueSize();
+        void resetDecodingThreads();
         void resetShowLog();
         bool setState(AkElement::ElementState state) override;
 };
@@ -18,10 +18,10 @@
  */
 
 #include <QQmlContext>
-#include <QRandomGenerator>
 #include <QSize>
 #include <QVector>
 #include <akpacket.h>
+#include <akrandom.h>
 #include <akvideopacket.h>
 
 #include "nervouselement.h"
@@ -107,16 +107,16 @@ AkPacket NervousElement::iVideoStream(const AkVideoPacket &packet)
             nFrame = qBound(0, nFrame, this->d->m_frames.size() - 1);
             timer--;
         } else {
-            nFrame = QRandomGenerator::global()->bounded(this->d->m_frames.size());
-            this->d->m_stride = QRandomGenerator::global()->bounded(2, 6);
+            nFrame = AkRandom::local().bounded(this->d->m_frames.size());
+            this->d->m_stride = AkRandom::local().bounded(2, 6);
 
             if (this->d->m_stride >= 0)
                 this->d->m_stride++;
 
-            timer = QRandomGenerator::global()->bounded(2, 8);
+            timer = AkRandom::local().bounded(2, 8);
         }
     } else if(!this->d->m_frames.isEmpty()) {
-        nFrame = QRandomGenerator::global()->bounded(this->d->m_frames.size());
+        nFrame = AkRandom::local().bounded(this->d->m_frames.size());
     }
 
     auto dst = this->d->m_frames[nFrame];
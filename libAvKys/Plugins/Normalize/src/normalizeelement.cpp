@@ -18,6 +18,7 @@
  */
 
 #include <akfrac.h>
+#include <akhistogram.h>
 #include <akpacket.h>
 #include <akvideocaps.h>
 #include <akvideoconverter.h>
@@ -37,23 +38,25 @@
     #define MAX_Y 235
 #endif
 
-using HistogramType = quint64;
+// Frames bigger than this are normalized with a subsampled histogram.
+#define HISTOGRAM_MAX_SAMPLES (1 << 21)
 
 class NormalizeElementPrivate
 {
     public:
         AkVideoConverter m_videoConverter {{AkVideoCaps::Format_ayuvpack, 0, 0, {}}};
+        AkHistogram m_histogram;
 
-        static void histogram(const AkVideoPacket &src, HistogramType *table);
-        static void limits(const AkVideoPacket &src,
-                           const HistogramType *histogram,
+        static void limits(const qreal *histogram,
+                           qreal total,
                            int &low, int &high);
-        static void normalizationTable(const AkVideoPacket &src, quint8 *table);
+        void normalizationTable(const AkVideoPacket &src, quint8 *table);
 };
 
 NormalizeElement::NormalizeElement(): AkElement()
 {
     this->d = new NormalizeElementPrivate;
+    this->d->m_histogram.setMaxSamples(HISTOGRAM_MAX_SAMPLES);
 
 #ifdef USE_FULLSWING
     this->d->m_videoConverter.setYuvColorSpaceType(AkVideoConverter::YuvColorSpaceType_FullSwing);
@@ -65,6 +68,16 @@ NormalizeElement::~NormalizeElement()
     delete this->d;
 }
 
+AkVideoCaps::PixelFormatList NormalizeElement::videoInputFormats() const
+{
+    return {AkVideoCaps::Format_ayuvpack};
+}
+
+AkVideoCaps::PixelFormatList NormalizeElement::videoOutputFormats() const
+{
+    return {AkVideoCaps::Format_ayuvpack};
+}
+
 AkPacket NormalizeElement::iVideoStream(const AkVideoPacket &packet)
 {
     this->d->m_videoConverter.begin();
@@ -78,7 +91,7 @@ AkPacket NormalizeElement::iVideoStream(const AkVideoPacket &packet)
     dst.copyMetadata(src);
 
     quint8 normTable[256];
-    NormalizeElementPrivate::normalizationTable(src, normTable);
+    this->d->normalizationTable(src, normTable);
 
     for (int y = 0; y < src.caps().height(); y++) {
         auto srcLine = reinterpret_cast<const AkYuv *>(src.constLine(0, y));
@@ -100,30 +113,13 @@ AkPacket NormalizeElement::iVideoStream(const AkVideoPacket &packet)
     return dst;
 }
 
-void NormalizeElementPrivate::histogram(const AkVideoPacket &src,
-                                        HistogramType *table)
-{
-    memset(table, 0, 256 * sizeof(HistogramType));
-
-    for (int y = 0; y < src.caps().height(); y++) {
-        auto srcLine = reinterpret_cast<const AkYuv *>(src.constLine(0, y));
-
-        for (int x = 0; x < src.caps().width(); x++) {
-            auto &pixel = srcLine[x];
-            auto y = qBound<int>(MIN_Y, akCompY(pixel), MAX_Y);
-            table[y]++;
-        }
-    }
-}
-
-void NormalizeElementPrivate::limits(const AkVideoPacket &src,
-                                     const HistogramType *histogram,
+void NormalizeElementPrivate::limits(const qreal *histogram,
+                                     qreal total,
                                      int &low, int &high)
 {
     // The lowest and highest levels must occupy at least 0.1 % of the image.
-    auto thresholdIntensity =
-            size_t(src.caps().width()) * size_t(src.caps().height()) / 1000;
-    int intensity = 0;
+    auto thresholdIntensity = total / 1000;
+    qreal intensity = 0;
 
     for (low = 0; low < 256; low++) {
         intensity += histogram[low];
@@ -145,11 +141,24 @@ void NormalizeElementPrivate::limits(const AkVideoPacket &src,
 void NormalizeElementPrivate::normalizationTable(const AkVideoPacket &src,
                                                  quint8 *table)
 {
-    HistogramType histogram[256];
-    NormalizeElementPrivate::histogram(src, histogram);
+    qreal histogram[256];
+    memset(histogram, 0, 256 * sizeof(qreal));
+
+    if (this->m_histogram.compute(src, AkColorComponent::CT_Y)) {
+        auto data = this->m_histogram.data();
+
+        // The levels out of [MIN_Y, MAX_Y] are counted as the nearest
+        // limit.
+        for (int i = 0; i < 256; i++)
+            histogram[qBound(MIN_Y, i, MAX_Y)] += data[i];
+    }
+
     int low = 0;
     int high = 0;
-    NormalizeElementPrivate::limits(src, histogram, low, high);
+    NormalizeElementPrivate::limits(histogram,
+                                    this->m_histogram.total(),
+                                    low,
+                                    high);
 
     if (low == high) {
         for (int i = 0; i < 256; i++)
@@ -32,6 +32,9 @@ class NormalizeElement: public AkElement
         NormalizeElement();
         ~NormalizeElement();
 
+        Q_INVOKABLE AkVideoCaps::PixelFormatList videoInputFormats() const override;
+        Q_INVOKABLE AkVideoCaps::PixelFormatList videoOutputFormats() const override;
+
     private:
         NormalizeElementPrivate *d;
 
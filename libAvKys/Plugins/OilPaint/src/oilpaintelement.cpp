@@ -49,6 +49,16 @@ int OilPaintElement::radius() const
     return this->d->m_radius;
 }
 
+AkVideoCaps::PixelFormatList OilPaintElement::videoInputFormats() const
+{
+    return {AkVideoCaps::Format_argbpack};
+}
+
+AkVideoCaps::PixelFormatList OilPaintElement::videoOutputFormats() const
+{
+    return {AkVideoCaps::Format_argbpack};
+}
+
 QString OilPaintElement::controlInterfaceProvide(const QString &controlId) const
 {
     Q_UNUSED(controlId)
@@ -49,6 +49,16 @@ qreal OpacityElement::opacity() const
     return this->d->m_opacity;
 }
 
+AkVideoCaps::PixelFormatList OpacityElement::videoInputFormats() const
+{
+    return {AkVideoCaps::Format_argbpack};
+}
+
+AkVideoCaps::PixelFormatList OpacityElement::videoOutputFormats() const
+{
+    return {AkVideoCaps::Format_argbpack};
+}
+
 QString OpacityElement::controlInterfaceProvide(const QString &controlId) const
 {
     Q_UNUSED(controlId)
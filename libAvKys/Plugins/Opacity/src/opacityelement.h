@@ -37,6 +37,8 @@ class OpacityElement: public AkElement
         OpacityElement();
         ~OpacityElement();
 
+        Q_INVOKABLE AkVideoCaps::PixelFormatList videoInputFormats() const override;
+        Q_INVOKABLE AkVideoCaps::PixelFormatList videoOutputFormats() const override;
         Q_INVOKABLE qreal opacity() const;
 
     private:
@@ -19,6 +19,7 @@
 
 #include <QQmlContext>
 #include <akfrac.h>
+#include <akhistogram.h>
 #include <akpacket.h>
 #include <akvideocaps.h>
 #include <akvideoconverter.h>
@@ -33,8 +34,9 @@ class OtsuElementPrivate
     public:
         int m_levels {2};
         AkVideoConverter m_videoConverter {{AkVideoCaps::Format_ya88pack, 0, 0, {}}};
+        AkHistogram m_histogram;
 
-        QVector<HistogramType> histogram(const AkVideoPacket &src) const;
+        QVector<HistogramType> histogram(const AkVideoPacket &src);
         QVector<qreal> buildTables(const QVector<HistogramType> &histogram) const;
         void forLoop(qreal *maxSum,
                      QVector<int> *thresholds,
@@ -67,6 +69,16 @@ int OtsuElement::levels() const
     return this->d->m_levels;
 }
 
+AkVideoCaps::PixelFormatList OtsuElement::videoInputFormats() const
+{
+    return {AkVideoCaps::Format_ya88pack};
+}
+
+AkVideoCaps::PixelFormatList OtsuElement::videoOutputFormats() const
+{
+    return {AkVideoCaps::Format_ya88pack};
+}
+
 QString OtsuElement::controlInterfaceProvide(const QString &controlId) const
 {
     Q_UNUSED(controlId)
@@ -117,16 +129,17 @@ void OtsuElement::resetLevels()
     this->setLevels(5);
 }
 
-QVector<HistogramType> OtsuElementPrivate::histogram(const AkVideoPacket &src) const
+QVector<HistogramType> OtsuElementPrivate::histogram(const AkVideoPacket &src)
 {
     QVector<HistogramType> histogram(256, 0);
 
-    for (int y = 0; y < src.caps().height(); y++) {
-        auto srcLine = reinterpret_cast<const quint16 *>(src.constLine(0, y));
+    if (!this->m_histogram.compute(src, AkColorComponent::CT_Y))
+        return histogram;
 
-        for (int x = 0; x < src.caps().width(); x++)
-            histogram[srcLine[x] >> 8]++;
-    }
+    auto data = this->m_histogram.data();
+
+    for (int i = 0; i < 256; i++)
+        histogram[i] = HistogramType(qRound64(data[i]));
 
     return histogram;
 }
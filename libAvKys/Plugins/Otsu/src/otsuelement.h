@@ -37,6 +37,8 @@ class OtsuElement: public AkElement
         OtsuElement();
         ~OtsuElement();
 
+        Q_INVOKABLE AkVideoCaps::PixelFormatList videoInputFormats() const override;
+        Q_INVOKABLE AkVideoCaps::PixelFormatList videoOutputFormats() const override;
         Q_INVOKABLE int levels() const;
 
     private:
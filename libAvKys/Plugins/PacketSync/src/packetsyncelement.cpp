@@ -17,6 +17,8 @@
  * Web-Site: http://webcamoid.github.io/
  */
 
+#include <atomic>
+#include <QElapsedTimer>
 #include <QFuture>
 #include <QMutex>
 #include <QQmlContext>
@@ -24,11 +26,17 @@
 #include <QThreadPool>
 #include <QWaitCondition>
 #include <QtConcurrent>
+#include <akelementprofiler.h>
 #include <akfrac.h>
 #include <akpacket.h>
 
 #include "packetsyncelement.h"
 
+// Packets that can be queued per stream, must be a power of 2.
+#define QUEUE_CAPACITY 4096
+
+#define DEFAULT_MAX_BUFFER_SIZE (64 << 20)
+
 template <typename T>
 inline void waitLoop(const QFuture<T> &loop)
 {
@@ -40,28 +48,142 @@ inline void waitLoop(const QFuture<T> &loop)
     }
 }
 
+struct PacketSlot
+{
+    AkPacket packet;
+    qreal pts;
+    qint64 arrivalTime;
+};
+
+// Single producer, single consumer ring buffer. The sender thread of the
+// stream pushes at the tail, and the packet loop pops from the head, no lock
+// is needed as long as there is only one thread at each end.
+class PacketQueue
+{
+    public:
+        PacketQueue():
+            m_slots(QUEUE_CAPACITY)
+        {
+        }
+
+        inline size_t size() const
+        {
+            return this->m_tail.load() - this->m_head.load();
+        }
+
+        inline bool isEmpty() const
+        {
+            return this->size() < 1;
+        }
+
+        inline bool isFull() const
+        {
+            return this->size() >= QUEUE_CAPACITY;
+        }
+
+        // Producer side.
+        inline bool push(const PacketSlot &slot)
+        {
+            auto tail = this->m_tail.load(std::memory_order_relaxed);
+
+            if (tail - this->m_head.load() >= QUEUE_CAPACITY)
+                return false;
+
+            this->m_slots[tail & (QUEUE_CAPACITY - 1)] = slot;
+            this->m_tail.store(tail + 1);
+
+            return true;
+        }
+
+        // Consumer side.
+        inline const PacketSlot &front() const
+        {
+            auto head = this->m_head.load(std::memory_order_relaxed);
+
+            return this->m_slots[head & (QUEUE_CAPACITY - 1)];
+        }
+
+        inline PacketSlot pop()
+        {
+            auto head = this->m_head.load(std::memory_order_relaxed);
+            auto &slot = this->m_slots[head & (QUEUE_CAPACITY - 1)];
+            auto front = slot;
+            slot = {};
+            this->m_head.store(head + 1);
+
+            return front;
+        }
+
+        // Only valid when neither end is running.
+        inline void clear()
+        {
+            while (!this->isEmpty())
+                this->pop();
+        }
+
+    private:
+        QVector<PacketSlot> m_slots;
+        std::atomic<size_t> m_head {0};
+        std::atomic<size_t> m_tail {0};
+};
+
 class PacketSyncElementPrivate
 {
     public:
         PacketSyncElement *self;
         bool m_audioEnabled {true};
         bool m_discardLast {false};
+        std::atomic<qint64> m_maxBufferSize {DEFAULT_MAX_BUFFER_SIZE};
+        std::atomic<int> m_overflowPolicy {PacketSyncElement::OverflowPolicyBlock};
+        QThreadPool m_threadPool;
+        QElapsedTimer m_timer;
+        QFuture<void> m_packetLoopResult;
+        std::atomic<bool> m_initialized {false};
+        std::atomic<bool> m_run {false};
+
+        // Audio sender state
+        QMutex m_audioMutex;
+        PacketQueue m_audioQueue;
         qint64 m_audioClock {0};
+
+        // Video sender state
+        QMutex m_videoMutex;
+        PacketQueue m_videoQueue;
         qint64 m_videoClock {0};
         qint64 m_lastVideoPts {0};
         qint64 m_videoId {-1};
-        QThreadPool m_threadPool;
-        QMutex m_mutex;
+
+        // The duration of a video packet is not known until the next one
+        // arrives, so the last one is held back here.
+        PacketSlot m_pendingVideo {};
+        bool m_hasPendingVideo {false};
+
+        // Sleeping and waking up, the mutex is only taken when one of the
+        // ends is waiting for the other.
+        QMutex m_waitMutex;
         QWaitCondition m_packetAvailable;
-        QVector<AkPacket> m_audioPackets;
-        QVector<AkPacket> m_videoPackets;
-        QFuture<void> m_packetLoopResult;
-        bool m_initialized {false};
-        bool m_run {false};
+        QWaitCondition m_spaceAvailable;
+        std::atomic<bool> m_loopWaiting {false};
+        std::atomic<int> m_blockedSenders {0};
+
+        // Stats
+        std::atomic<qint64> m_bufferSize {0};
+        std::atomic<quint64> m_emittedPackets {0};
+        std::atomic<quint64> m_droppedPackets {0};
+        std::atomic<quint64> m_forcedPackets {0};
+        std::atomic<qint64> m_delaySum {0};
+        std::atomic<qint64> m_maxDelay {0};
+        AkElementProfilerCounters *m_profilerCounters {nullptr};
 
         explicit PacketSyncElementPrivate(PacketSyncElement *self);
         bool init();
         void uninit();
+        void resetStats();
+        bool isOverflowed() const;
+        bool enqueue(PacketQueue &queue, const PacketSlot &slot);
+        void packetAvailable();
+        PacketQueue *nextQueue(bool draining, bool *forced=nullptr);
+        void emitPacket(PacketQueue *queue, bool forced);
         void packetLoop();
 };
 
@@ -73,6 +195,7 @@ PacketSyncElement::PacketSyncElement():
 
 PacketSyncElement::~PacketSyncElement()
 {
+    this->d->uninit();
     delete this->d;
 }
 
@@ -86,6 +209,35 @@ bool PacketSyncElement::discardLast() const
     return this->d->m_discardLast;
 }
 
+qint64 PacketSyncElement::maxBufferSize() const
+{
+    return this->d->m_maxBufferSize;
+}
+
+PacketSyncElement::OverflowPolicy PacketSyncElement::overflowPolicy() const
+{
+    return OverflowPolicy(int(this->d->m_overflowPolicy));
+}
+
+QVariantMap PacketSyncElement::stats() const
+{
+    quint64 emittedPackets = this->d->m_emittedPackets;
+    qreal delay = emittedPackets > 0?
+                      qreal(this->d->m_delaySum) / emittedPackets / 1e9:
+                      0.0;
+
+    return {
+        {"audioPackets"      , quint64(this->d->m_audioQueue.size())},
+        {"videoPackets"      , quint64(this->d->m_videoQueue.size())},
+        {"bufferSize"        , qint64(this->d->m_bufferSize)         },
+        {"emittedPackets"    , emittedPackets                        },
+        {"droppedPackets"    , quint64(this->d->m_droppedPackets)    },
+        {"forcedPackets"     , quint64(this->d->m_forcedPackets)     },
+        {"interleaveDelay"   , delay                                 },
+        {"maxInterleaveDelay", qreal(this->d->m_maxDelay) / 1e9      },
+    };
+}
+
 void PacketSyncElement::setAudioEnabled(bool audioEnabled)
 {
     if (this->d->m_audioEnabled == audioEnabled)
@@ -104,6 +256,29 @@ void PacketSyncElement::setDiscardLast(bool discardLast)
     this->discardLastChanged(discardLast);
 }
 
+void PacketSyncElement::setMaxBufferSize(qint64 maxBufferSize)
+{
+    // An empty buffer would be always full, and the senders would block or
+    // drop everything.
+    if (maxBufferSize < 1)
+        maxBufferSize = DEFAULT_MAX_BUFFER_SIZE;
+
+    if (this->d->m_maxBufferSize == maxBufferSize)
+        return;
+
+    this->d->m_maxBufferSize = maxBufferSize;
+    this->maxBufferSizeChanged(maxBufferSize);
+}
+
+void PacketSyncElement::setOverflowPolicy(OverflowPolicy overflowPolicy)
+{
+    if (this->d->m_overflowPolicy == overflowPolicy)
+        return;
+
+    this->d->m_overflowPolicy = overflowPolicy;
+    this->overflowPolicyChanged(overflowPolicy);
+}
+
 void PacketSyncElement::resetAudioEnabled()
 {
     this->setAudioEnabled(true);
@@ -114,10 +289,18 @@ void PacketSyncElement::resetDiscardLast()
     this->setDiscardLast(false);
 }
 
-AkPacket PacketSyncElement::iStream(const AkPacket &packet)
+void PacketSyncElement::resetMaxBufferSize()
+{
+    this->setMaxBufferSize(DEFAULT_MAX_BUFFER_SIZE);
+}
+
+void PacketSyncElement::resetOverflowPolicy()
 {
-    QMutexLocker mutexLocker(&this->d->m_mutex);
+    this->setOverflowPolicy(OverflowPolicyBlock);
+}
 
+AkPacket PacketSyncElement::iStream(const AkPacket &packet)
+{
     if (!this->d->m_initialized)
         return {};
 
@@ -127,38 +310,50 @@ AkPacket PacketSyncElement::iStream(const AkPacket &packet)
         if (!this->d->m_audioEnabled)
             break;
 
-        auto pkt = packet;
-        pkt.setPts(this->d->m_audioClock);
-        this->d->m_audioPackets << pkt;
+        QMutexLocker mutexLocker(&this->d->m_audioMutex);
+
+        if (!this->d->m_initialized)
+            break;
+
+        PacketSlot slot {packet, 0.0, this->d->m_timer.nsecsElapsed()};
+        slot.packet.setPts(this->d->m_audioClock);
+        slot.pts = this->d->m_audioClock * packet.timeBase().value();
         this->d->m_audioClock += packet.duration();
-        this->d->m_packetAvailable.wakeAll();
+        this->d->enqueue(this->d->m_audioQueue, slot);
 
         break;
     }
 
     case AkPacket::PacketVideo:
     case AkPacket::PacketVideoCompressed: {
-        auto pkt = packet;
+        QMutexLocker mutexLocker(&this->d->m_videoMutex);
+
+        if (!this->d->m_initialized)
+            break;
+
+        PacketSlot slot {packet, 0.0, this->d->m_timer.nsecsElapsed()};
+        auto &pending = this->d->m_pendingVideo;
 
-        if (this->d->m_videoPackets.isEmpty()) {
-            pkt.setPts(0);
+        if (!this->d->m_hasPendingVideo) {
             this->d->m_videoClock = 0;
         } else {
             if (this->d->m_videoId == packet.id()) {
                 auto duration = packet.pts() - this->d->m_lastVideoPts;
-                this->d->m_videoPackets.last().setDuration(duration);
+                pending.packet.setDuration(duration);
                 this->d->m_videoClock += duration;
-                pkt.setPts(this->d->m_videoClock);
             } else {
-                this->d->m_videoClock += this->d->m_videoPackets.last().duration();
-                pkt.setPts(this->d->m_videoClock);
+                this->d->m_videoClock += pending.packet.duration();
             }
+
+            this->d->enqueue(this->d->m_videoQueue, pending);
         }
 
-        this->d->m_videoPackets << pkt;
+        slot.packet.setPts(this->d->m_videoClock);
+        slot.pts = this->d->m_videoClock * packet.timeBase().value();
+        pending = slot;
+        this->d->m_hasPendingVideo = true;
         this->d->m_lastVideoPts = packet.pts();
         this->d->m_videoId = packet.id();
-        this->d->m_packetAvailable.wakeAll();
 
         break;
     }
@@ -224,26 +419,30 @@ bool PacketSyncElement::setState(AkElement::ElementState state)
 }
 
 PacketSyncElementPrivate::PacketSyncElementPrivate(PacketSyncElement *self):
-    self(self)
+    self(self),
+    m_profilerCounters(self->profilerCounters())
 {
 
 }
 
 bool PacketSyncElementPrivate::init()
 {
+    this->m_audioClock = 0;
+    this->m_videoClock = 0;
+    this->m_lastVideoPts = 0;
+    this->m_videoId = -1;
+    this->m_pendingVideo = {};
+    this->m_hasPendingVideo = false;
+    this->m_audioQueue.clear();
+    this->m_videoQueue.clear();
+    this->resetStats();
+    this->m_timer.start();
+
     this->m_run = true;
     this->m_packetLoopResult =
             QtConcurrent::run(&this->m_threadPool,
                               &PacketSyncElementPrivate::packetLoop,
                               this);
-
-    this->m_audioClock = 0;
-    this->m_videoClock = 0;
-    this->m_lastVideoPts = 0;
-    this->m_videoId = 1;
-    this->m_audioPackets.clear();
-    this->m_videoPackets.clear();
-
     this->m_initialized = true;
 
     return true;
@@ -256,76 +455,203 @@ void PacketSyncElementPrivate::uninit()
 
     this->m_initialized = false;
 
+    // Release the blocked senders and wait until they leave.
+
+    this->m_waitMutex.lock();
+    this->m_spaceAvailable.wakeAll();
+    this->m_waitMutex.unlock();
+
+    this->m_audioMutex.lock();
+    this->m_videoMutex.lock();
+
+    this->m_waitMutex.lock();
     this->m_run = false;
+    this->m_packetAvailable.wakeAll();
+    this->m_waitMutex.unlock();
+
+    this->m_videoMutex.unlock();
+    this->m_audioMutex.unlock();
+
     waitLoop(this->m_packetLoopResult);
 
-    this->m_audioPackets.clear();
-    this->m_videoPackets.clear();
+    this->m_audioQueue.clear();
+    this->m_videoQueue.clear();
+    this->m_pendingVideo = {};
+    this->m_hasPendingVideo = false;
+    this->m_bufferSize = 0;
 }
 
-void PacketSyncElementPrivate::packetLoop()
+void PacketSyncElementPrivate::resetStats()
 {
-    while (this->m_run) {
-        QMutexLocker mutexLocker(&this->m_mutex);
+    this->m_bufferSize = 0;
+    this->m_emittedPackets = 0;
+    this->m_droppedPackets = 0;
+    this->m_forcedPackets = 0;
+    this->m_delaySum = 0;
+    this->m_maxDelay = 0;
+}
 
-        if ((this->m_audioEnabled && this->m_audioPackets.isEmpty())
-            || this->m_videoPackets.size() < 2) {
-            this->m_packetAvailable.wait(&this->m_mutex, 3000);
+bool PacketSyncElementPrivate::isOverflowed() const
+{
+    return this->m_bufferSize >= this->m_maxBufferSize
+           || this->m_audioQueue.isFull()
+           || this->m_videoQueue.isFull();
+}
 
-            if (this->m_audioPackets.isEmpty()
-                || this->m_videoPackets.size() < 2) {
-                continue;
-            }
-        }
+bool PacketSyncElementPrivate::enqueue(PacketQueue &queue,
+                                       const PacketSlot &slot)
+{
+    if (this->isOverflowed()) {
+        if (this->m_overflowPolicy == PacketSyncElement::OverflowPolicyDrop) {
+            this->m_droppedPackets++;
 
-        if (this->m_audioEnabled) {
-            auto &audioPacket = this->m_audioPackets.first();
-            auto &videoPacket = this->m_videoPackets.first();
-            auto audioPts = audioPacket.pts() * audioPacket.timeBase().value();
-            auto videoPts = videoPacket.pts() * videoPacket.timeBase().value();
-            AkPacket packet =
-                    videoPts <= audioPts?
-                        this->m_videoPackets.takeFirst():
-                        this->m_audioPackets.takeFirst();
-
-            emit self->oStream(packet);
-        } else {
-            emit self->oStream(this->m_videoPackets.takeFirst());
+            return false;
         }
+
+        // Wait until the packet loop makes some room. The loop doesn't wait
+        // for the other stream while the buffer is full, so this can't
+        // dead lock even if the other stream stalled.
+        this->m_waitMutex.lock();
+        this->m_blockedSenders++;
+
+        while (this->m_initialized && this->isOverflowed())
+            this->m_spaceAvailable.wait(&this->m_waitMutex);
+
+        this->m_blockedSenders--;
+        this->m_waitMutex.unlock();
+
+        if (!this->m_initialized)
+            return false;
     }
 
-    while (!this->m_audioPackets.isEmpty()
-           || !this->m_videoPackets.isEmpty()) {
-        qreal audioPts = 0.0;
+    if (!queue.push(slot)) {
+        this->m_droppedPackets++;
+
+        return false;
+    }
 
-        if (this->m_audioEnabled && !this->m_audioPackets.isEmpty()) {
-            auto &audioPacket = this->m_audioPackets.first();
-            audioPts = audioPacket.pts() * audioPacket.timeBase().value();
+    this->m_bufferSize += qint64(slot.packet.size());
+    this->packetAvailable();
+
+    return true;
+}
+
+void PacketSyncElementPrivate::packetAvailable()
+{
+    if (!this->m_loopWaiting)
+        return;
+
+    this->m_waitMutex.lock();
+    this->m_packetAvailable.wakeAll();
+    this->m_waitMutex.unlock();
+}
+
+PacketQueue *PacketSyncElementPrivate::nextQueue(bool draining, bool *forced)
+{
+    // Merge the streams by pts, the video goes first on ties.
+    PacketQueue *queues[] = {&this->m_videoQueue, &this->m_audioQueue};
+    int nQueues = this->m_audioEnabled? 2: 1;
+    PacketQueue *next = nullptr;
+    bool missing = false;
+
+    for (int i = 0; i < nQueues; i++) {
+        auto queue = queues[i];
+
+        if (queue->isEmpty()) {
+            missing = true;
+
+            continue;
         }
 
-        qreal videoPts = 0.0;
+        if (!next || queue->front().pts < next->front().pts)
+            next = queue;
+    }
+
+    // The next packet of an empty stream could go before any of the queued
+    // ones, so wait for it, unless the buffer is full.
+    if (missing && !draining) {
+        if (!next || !this->isOverflowed())
+            return nullptr;
+
+        if (forced)
+            *forced = true;
+    }
+
+    return next;
+}
+
+void PacketSyncElementPrivate::emitPacket(PacketQueue *queue, bool forced)
+{
+    auto slot = queue->pop();
+    this->m_bufferSize -= qint64(slot.packet.size());
+
+    if (this->m_blockedSenders > 0) {
+        this->m_waitMutex.lock();
+        this->m_spaceAvailable.wakeAll();
+        this->m_waitMutex.unlock();
+    }
+
+    auto delay = this->m_timer.nsecsElapsed() - slot.arrivalTime;
+    this->m_delaySum += delay;
+    AkElementProfiler::addQueueWait(this->m_profilerCounters, delay);
 
-        if (!this->m_videoPackets.isEmpty()) {
-            auto &videoPacket = this->m_videoPackets.first();
-            videoPts = videoPacket.pts() * videoPacket.timeBase().value();
+    if (delay > this->m_maxDelay)
+        this->m_maxDelay = delay;
+
+    this->m_emittedPackets++;
+
+    if (forced)
+        this->m_forcedPackets++;
+
+    // No lock is held here, the senders keep queueing packets while the
+    // muxer writes.
+    emit self->oStream(slot.packet);
+}
+
+void PacketSyncElementPrivate::packetLoop()
+{
+    while (this->m_run) {
+        bool forced = false;
+        auto queue = this->nextQueue(false, &forced);
+
+        if (queue) {
+            this->emitPacket(queue, forced);
+
+            continue;
         }
 
-        AkPacket packet;
+        this->m_waitMutex.lock();
+        this->m_loopWaiting = true;
 
-        if ((this->m_audioEnabled
-             && !this->m_audioPackets.isEmpty()
-             && audioPts <= videoPts)
-            || this->m_videoPackets.isEmpty()) {
-            packet = this->m_audioPackets.takeFirst();
-        } else {
-            packet = this->m_videoPackets.takeFirst();
+        // Check again with the flag raised, so a packet queued in between
+        // can't be missed.
+        if (this->m_run && !this->nextQueue(false))
+            this->m_packetAvailable.wait(&this->m_waitMutex);
+
+        this->m_loopWaiting = false;
+        this->m_waitMutex.unlock();
+    }
+
+    // The senders are stopped now, send the remaining packets in order.
+    forever {
+        if (this->m_hasPendingVideo && !this->m_videoQueue.isFull()) {
+            this->m_videoQueue.push(this->m_pendingVideo);
+            this->m_bufferSize += qint64(this->m_pendingVideo.packet.size());
+            this->m_pendingVideo = {};
+            this->m_hasPendingVideo = false;
         }
 
-        emit self->oStream(packet);
+        auto queue = this->nextQueue(true);
+
+        if (!queue)
+            break;
+
+        this->emitPacket(queue, false);
 
         if (this->m_discardLast
-            && (this->m_audioPackets.isEmpty()
-                || this->m_videoPackets.isEmpty())) {
+            && ((this->m_audioEnabled && this->m_audioQueue.isEmpty())
+                || (this->m_videoQueue.isEmpty()
+                    && !this->m_hasPendingVideo))) {
             break;
         }
     }
@@ -20,6 +20,7 @@
 #ifndef PACKETSYNCELEMENT_H
 #define PACKETSYNCELEMENT_H
 
+#include <QVariantMap>
 #include <iak/akelement.h>
 
 class PacketSyncElementPrivate;
@@ -37,13 +38,35 @@ class PacketSyncElement: public AkElement
                WRITE setDiscardLast
                RESET resetDiscardLast
                NOTIFY discardLastChanged)
+    Q_PROPERTY(qint64 maxBufferSize
+               READ maxBufferSize
+               WRITE setMaxBufferSize
+               RESET resetMaxBufferSize
+               NOTIFY maxBufferSizeChanged)
+    Q_PROPERTY(OverflowPolicy overflowPolicy
+               READ overflowPolicy
+               WRITE setOverflowPolicy
+               RESET resetOverflowPolicy
+               NOTIFY overflowPolicyChanged)
 
     public:
+        enum OverflowPolicy
+        {
+            // Block the sender until the muxer consumes some packets
+            OverflowPolicyBlock,
+            // Discard the incoming packets
+            OverflowPolicyDrop
+        };
+        Q_ENUM(OverflowPolicy)
+
         PacketSyncElement();
         ~PacketSyncElement();
 
         Q_INVOKABLE bool audioEnabled() const;
         Q_INVOKABLE bool discardLast() const;
+        Q_INVOKABLE qint64 maxBufferSize() const;
+        Q_INVOKABLE OverflowPolicy overflowPolicy() const;
+        Q_INVOKABLE QVariantMap stats() const;
 
     private:
         PacketSyncElementPrivate *d;
@@ -51,14 +74,22 @@ class PacketSyncElement: public AkElement
     signals:
         void audioEnabledChanged(bool audioEnabled);
         void discardLastChanged(bool discardLast);
+        void maxBufferSizeChanged(qint64 maxBufferSize);
+        void overflowPolicyChanged(OverflowPolicy overflowPolicy);
 
     public slots:
         void setAudioEnabled(bool audioEnabled);
         void setDiscardLast(bool discardLast);
+        void setMaxBufferSize(qint64 maxBufferSize);
+        void setOverflowPolicy(OverflowPolicy overflowPolicy);
         void resetAudioEnabled();
         void resetDiscardLast();
+        void resetMaxBufferSize();
+        void resetOverflowPolicy();
         AkPacket iStream(const AkPacket &packet) override;
         bool setState(AkElement::ElementState state) override;
 };
 
+Q_DECLARE_METATYPE(PacketSyncElement::OverflowPolicy)
+
 #endif // PACKETSYNCELEMENT_H
@@ -63,6 +63,16 @@ int PhotocopyElement::contrast() const
     return this->d->m_contrast;
 }
 
+AkVideoCaps::PixelFormatList PhotocopyElement::videoInputFormats() const
+{
+    return {AkVideoCaps::Format_argbpack};
+}
+
+AkVideoCaps::PixelFormatList PhotocopyElement::videoOutputFormats() const
+{
+    return {AkVideoCaps::Format_ya88pack};
+}
+
 QString PhotocopyElement::controlInterfaceProvide(const QString &controlId) const
 {
     Q_UNUSED(controlId)
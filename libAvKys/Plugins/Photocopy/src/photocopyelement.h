@@ -42,6 +42,8 @@ class PhotocopyElement: public AkElement
         PhotocopyElement();
         ~PhotocopyElement();
 
+        Q_INVOKABLE AkVideoCaps::PixelFormatList videoInputFormats() const override;
+        Q_INVOKABLE AkVideoCaps::PixelFormatList videoOutputFormats() const override;
         Q_INVOKABLE int brightness() const;
         Q_INVOKABLE int contrast() const;
 
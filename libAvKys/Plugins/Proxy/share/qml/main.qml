@@ -0,0 +1,198 @@
+/* Webcamoid, camera capture application.
+ * Copyright (C) 2026  Gonzalo Exequiel Pedone
+ *
+ * Webcamoid is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Webcamoid is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Webcamoid. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Web-Site: http://webcamoid.github.io/
+ */
+import QtQuick
+import QtQuick.Controls
+import QtQuick.Layouts
+import Ak
+
+GridLayout {
+    columns: 3
+
+    function effectIndex(effect)
+    {
+        for (let i = 0; i < cbxEffect.model.count; i++)
+            if (cbxEffect.model.get(i).plugin == effect)
+                return i
+
+        return 0
+    }
+
+    function loadEffectControls()
+    {
+        for (let i = clyEffectControls.children.length - 1; i >= 0; i--)
+            clyEffectControls.children[i].destroy()
+
+        let controls = Proxy.effectControls()
+
+        if (controls)
+            controls.parent = clyEffectControls
+    }
+
+    Component.onCompleted: {
+        let plugins =
+            AkPluginManager.listPlugins("",
+                                        ["VideoFilter"],
+                                        AkPluginManager.FilterEnabled)
+        plugins.sort(function(a, b) {
+            a = AkPluginInfo.create(AkPluginManager.pluginInfo(a)).description
+            b = AkPluginInfo.create(AkPluginManager.pluginInfo(b)).description
+
+            return a.localeCompare(b)
+        })
+
+        for (let i in plugins) {
+            let plugin = plugins[i]
+
+            if (plugin == "VideoFilter/Proxy")
+                continue
+
+            let info = AkPluginInfo.create(AkPluginManager.pluginInfo(plugin))
+            cbxEffect.model.append({
+                plugin: plugin,
+                description: info.description
+            })
+        }
+
+        cbxEffect.currentIndex = effectIndex(Proxy.effect)
+        loadEffectControls()
+    }
+
+    Connections {
+        target: Proxy
+
+        function onEffectChanged(effect)
+        {
+            cbxEffect.currentIndex = effectIndex(effect)
+            loadEffectControls()
+        }
+        function onScaleChanged(scale)
+        {
+            sldScale.value = scale
+            spbScale.value = scale * spbScale.multiplier
+        }
+        function onGuidanceChanged(guidance)
+        {
+            sldGuidance.value = guidance
+            spbGuidance.value = guidance * spbGuidance.multiplier
+        }
+    }
+
+    Label {
+        id: lblEffect
+        text: qsTr("Effect")
+    }
+    ComboBox {
+        id: cbxEffect
+        textRole: "description"
+        Layout.fillWidth: true
+        Layout.columnSpan: 2
+        Accessible.description: lblEffect.text
+        model: ListModel {
+            ListElement {
+                plugin: ""
+                description: qsTr("None")
+            }
+        }
+
+        onActivated: Proxy.effect = cbxEffect.model.get(currentIndex).plugin
+    }
+
+    Label {
+        id: lblScale
+        text: qsTr("Scale")
+    }
+    Slider {
+        id: sldScale
+        value: Proxy.scale
+        stepSize: 0.05
+        from: 0.0625
+        to: 1
+        Layout.fillWidth: true
+        Accessible.name: lblScale.text
+
+        onValueChanged: Proxy.scale = value
+    }
+    SpinBox {
+        id: spbScale
+        value: multiplier * Proxy.scale
+        from: multiplier * sldScale.from
+        to: multiplier * sldScale.to
+        stepSize: multiplier * sldScale.stepSize
+        editable: true
+        Accessible.name: lblScale.text
+
+        readonly property int decimals: 2
+        readonly property int multiplier: Math.pow(10, decimals)
+
+        validator: DoubleValidator {
+            bottom: Math.min(spbScale.from, spbScale.to)
+            top:  Math.max(spbScale.from, spbScale.to)
+        }
+        textFromValue: function(value, locale) {
+            return Number(value / multiplier).toLocaleString(locale, 'f', decimals)
+        }
+        valueFromText: function(text, locale) {
+            return Number.fromLocaleString(locale, text) * multiplier
+        }
+        onValueModified: Proxy.scale = value / multiplier
+    }
+
+    Label {
+        id: lblGuidance
+        text: qsTr("Edge guidance")
+    }
+    Slider {
+        id: sldGuidance
+        value: Proxy.guidance
+        stepSize: 0.01
+        to: 1
+        Layout.fillWidth: true
+        Accessible.name: lblGuidance.text
+
+        onValueChanged: Proxy.guidance = value
+    }
+    SpinBox {
+        id: spbGuidance
+        value: multiplier * Proxy.guidance
+        to: multiplier * sldGuidance.to
+        stepSize: multiplier * sldGuidance.stepSize
+        editable: true
+        Accessible.name: lblGuidance.text
+
+        readonly property int decimals: 2
+        readonly property int multiplier: Math.pow(10, decimals)
+
+        validator: DoubleValidator {
+            bottom: Math.min(spbGuidance.from, spbGuidance.to)
+            top:  Math.max(spbGuidance.from, spbGuidance.to)
+        }
+        textFromValue: function(value, locale) {
+            return Number(value / multiplier).toLocaleString(locale, 'f', decimals)
+        }
+        valueFromText: function(text, locale) {
+            return Number.fromLocaleString(locale, text) * multiplier
+        }
+        onValueModified: Proxy.guidance = value / multiplier
+    }
+    ColumnLayout {
+        id: clyEffectControls
+        Layout.fillWidth: true
+        Layout.columnSpan: 3
+    }
+}
@@ -0,0 +1,316 @@
+/* Webcamoid, camera capture application.
+ * Copyright (C) 2026  Gonzalo Exequiel Pedone
+ *
+ * Webcamoid is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Webcamoid is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Webcamoid. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Web-Site: http://webcamoid.github.io/
+ */
+
+#include <QMutex>
+#include <QPointer>
+#include <QQmlContext>
+#include <QQmlEngine>
+#include <qrgb.h>
+#include <akfrac.h>
+#include <akpacket.h>
+#include <akpluginmanager.h>
+#include <akvideocaps.h>
+#include <akvideoconverter.h>
+#include <akvideopacket.h>
+
+#include "proxyelement.h"
+
+#define MIN_SCALE (1.0 / 16.0)
+
+/* The controls of the wrapped effect reference it from their context, so
+ * they keep a reference to the effect as a child, which is released only
+ * when the controls are destroyed.
+ */
+class ProxyEffectHolder: public QObject
+{
+    public:
+        AkElementPtr m_effect;
+
+        ProxyEffectHolder(const AkElementPtr &effect, QObject *parent):
+            QObject(parent),
+            m_effect(effect)
+        {
+        }
+};
+
+class ProxyElementPrivate
+{
+    public:
+        QString m_effectId;
+        AkElementPtr m_effect;
+        qreal m_scale {0.5};
+        qreal m_guidance {0.0};
+        QMutex m_mutex;
+        QPointer<QQmlEngine> m_engine;
+        AkVideoConverter m_inputConverter {{AkVideoCaps::Format_argbpack, 0, 0, {}}};
+        AkVideoConverter m_downConverter;
+        AkVideoConverter m_upConverter;
+        AkVideoConverter m_guideConverter;
+
+        ProxyElementPrivate();
+        AkVideoPacket addDetail(const AkVideoPacket &effect,
+                                const AkVideoPacket &input,
+                                const AkVideoPacket &lowPass,
+                                qreal guidance) const;
+};
+
+ProxyElement::ProxyElement(): AkElement()
+{
+    this->d = new ProxyElementPrivate;
+}
+
+ProxyElement::~ProxyElement()
+{
+    delete this->d;
+}
+
+QString ProxyElement::effect() const
+{
+    return this->d->m_effectId;
+}
+
+qreal ProxyElement::scale() const
+{
+    return this->d->m_scale;
+}
+
+qreal ProxyElement::guidance() const
+{
+    return this->d->m_guidance;
+}
+
+QObject *ProxyElement::effectControls() const
+{
+    this->d->m_mutex.lock();
+    auto effect = this->d->m_effect;
+    auto effectId = this->d->m_effectId;
+    this->d->m_mutex.unlock();
+
+    if (!effect || !this->d->m_engine)
+        return nullptr;
+
+    auto controls = effect->controlInterface(this->d->m_engine, effectId);
+
+    if (controls)
+        new ProxyEffectHolder(effect, controls);
+
+    return controls;
+}
+
+QString ProxyElement::controlInterfaceProvide(const QString &controlId) const
+{
+    Q_UNUSED(controlId)
+
+    return QString("qrc:/Proxy/share/qml/main.qml");
+}
+
+void ProxyElement::controlInterfaceConfigure(QQmlContext *context,
+                                             const QString &controlId) const
+{
+    Q_UNUSED(controlId)
+
+    this->d->m_engine = context->engine();
+    context->setContextProperty("Proxy", const_cast<QObject *>(qobject_cast<const QObject *>(this)));
+    context->setContextProperty("controlId", this->objectName());
+}
+
+AkPacket ProxyElement::iVideoStream(const AkVideoPacket &packet)
+{
+    this->d->m_mutex.lock();
+    auto effect = this->d->m_effect;
+    auto scale = this->d->m_scale;
+    auto guidance = this->d->m_guidance;
+    this->d->m_mutex.unlock();
+
+    if (!effect) {
+        if (packet)
+            emit this->oStream(packet);
+
+        return packet;
+    }
+
+    // Nothing to save, run the effect at full resolution.
+    if (scale >= 1.0) {
+        AkVideoPacket dst = effect->iStream(packet);
+
+        if (dst)
+            emit this->oStream(dst);
+
+        return dst;
+    }
+
+    this->d->m_inputConverter.begin();
+    auto src = this->d->m_inputConverter.convert(packet);
+    this->d->m_inputConverter.end();
+
+    if (!src)
+        return {};
+
+    auto caps = src.caps();
+    auto proxyCaps = caps;
+    proxyCaps.setWidth(qMax(qRound(scale * caps.width()), 1));
+    proxyCaps.setHeight(qMax(qRound(scale * caps.height()), 1));
+
+    this->d->m_downConverter.begin();
+    this->d->m_downConverter.setOutputCaps(proxyCaps);
+    auto proxy = this->d->m_downConverter.convert(src);
+    this->d->m_downConverter.end();
+
+    if (!proxy)
+        return {};
+
+    AkVideoPacket result = effect->iStream(proxy);
+
+    if (!result)
+        return {};
+
+    // The effect may change the format, so bring it back to ARGB too.
+    this->d->m_upConverter.begin();
+    this->d->m_upConverter.setOutputCaps(caps);
+    auto dst = this->d->m_upConverter.convert(result);
+    this->d->m_upConverter.end();
+
+    if (!dst)
+        return {};
+
+    if (guidance > 0.0) {
+        this->d->m_guideConverter.begin();
+        this->d->m_guideConverter.setOutputCaps(caps);
+        auto lowPass = this->d->m_guideConverter.convert(proxy);
+        this->d->m_guideConverter.end();
+
+        if (lowPass)
+            dst = this->d->addDetail(dst, src, lowPass, guidance);
+    }
+
+    dst.copyMetadata(packet);
+
+    if (dst)
+        emit this->oStream(dst);
+
+    return dst;
+}
+
+void ProxyElement::setEffect(const QString &effect)
+{
+    if (this->d->m_effectId == effect)
+        return;
+
+    AkElementPtr element;
+
+    // Wrapping the proxy in itself makes no sense.
+    if (!effect.isEmpty() && effect != "VideoFilter/Proxy")
+        element = akPluginManager->create<AkElement>(effect);
+
+    this->d->m_mutex.lock();
+    this->d->m_effectId = element? effect: QString();
+    this->d->m_effect = element;
+    this->d->m_mutex.unlock();
+    emit this->effectChanged(this->d->m_effectId);
+}
+
+void ProxyElement::setScale(qreal scale)
+{
+    scale = qBound(MIN_SCALE, scale, 1.0);
+
+    if (qFuzzyCompare(this->d->m_scale, scale))
+        return;
+
+    this->d->m_mutex.lock();
+    this->d->m_scale = scale;
+    this->d->m_mutex.unlock();
+    emit this->scaleChanged(scale);
+}
+
+void ProxyElement::setGuidance(qreal guidance)
+{
+    guidance = qBound(0.0, guidance, 1.0);
+
+    if (qFuzzyCompare(this->d->m_guidance, guidance))
+        return;
+
+    this->d->m_mutex.lock();
+    this->d->m_guidance = guidance;
+    this->d->m_mutex.unlock();
+    emit this->guidanceChanged(guidance);
+}
+
+void ProxyElement::resetEffect()
+{
+    this->setEffect({});
+}
+
+void ProxyElement::resetScale()
+{
+    this->setScale(0.5);
+}
+
+void ProxyElement::resetGuidance()
+{
+    this->setGuidance(0.0);
+}
+
+ProxyElementPrivate::ProxyElementPrivate()
+{
+    this->m_downConverter.setScalingMode(AkVideoConverter::ScalingMode_Linear);
+    this->m_upConverter.setScalingMode(AkVideoConverter::ScalingMode_Linear);
+    this->m_guideConverter.setScalingMode(AkVideoConverter::ScalingMode_Linear);
+}
+
+/* The difference between the input frame and the upscaled proxy is the
+ * detail lost when downscaling, adding it back to the upscaled effect output
+ * restores the edges of the full resolution frame.
+ */
+AkVideoPacket ProxyElementPrivate::addDetail(const AkVideoPacket &effect,
+                                             const AkVideoPacket &input,
+                                             const AkVideoPacket &lowPass,
+                                             qreal guidance) const
+{
+    AkVideoPacket dst(effect.caps());
+    auto k = qRound(256 * guidance);
+
+    for (int y = 0; y < effect.caps().height(); y++) {
+        auto eLine = reinterpret_cast<const QRgb *>(effect.constLine(0, y));
+        auto iLine = reinterpret_cast<const QRgb *>(input.constLine(0, y));
+        auto lLine = reinterpret_cast<const QRgb *>(lowPass.constLine(0, y));
+        auto oLine = reinterpret_cast<QRgb *>(dst.line(0, y));
+
+        for (int x = 0; x < effect.caps().width(); x++) {
+            auto &ePixel = eLine[x];
+            auto &iPixel = iLine[x];
+            auto &lPixel = lLine[x];
+
+            int r = qRed(ePixel)
+                    + ((k * (qRed(iPixel) - qRed(lPixel))) >> 8);
+            int g = qGreen(ePixel)
+                    + ((k * (qGreen(iPixel) - qGreen(lPixel))) >> 8);
+            int b = qBlue(ePixel)
+                    + ((k * (qBlue(iPixel) - qBlue(lPixel))) >> 8);
+
+            oLine[x] = qRgba(qBound(0, r, 255),
+                             qBound(0, g, 255),
+                             qBound(0, b, 255),
+                             qAlpha(ePixel));
+        }
+    }
+
+    return dst;
+}
+
+#include "moc_proxyelement.cpp"
@@ -0,0 +1,80 @@
+/* Webcamoid, camera capture application.
+ * Copyright (C) 2026  Gonzalo Exequiel Pedone
+ *
+ * Webcamoid is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Webcamoid is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Webcamoid. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Web-Site: http://webcamoid.github.io/
+ */
+
+#ifndef PROXYELEMENT_H
+#define PROXYELEMENT_H
+
+#include <iak/akelement.h>
+
+class ProxyElementPrivate;
+
+class ProxyElement: public AkElement
+{
+    Q_OBJECT
+    Q_PROPERTY(QString effect
+               READ effect
+               WRITE setEffect
+               RESET resetEffect
+               NOTIFY effectChanged)
+    Q_PROPERTY(qreal scale
+               READ scale
+               WRITE setScale
+               RESET resetScale
+               NOTIFY scaleChanged)
+    Q_PROPERTY(qreal guidance
+               READ guidance
+               WRITE setGuidance
+               RESET resetGuidance
+               NOTIFY guidanceChanged)
+
+    public:
+        ProxyElement();
+        ~ProxyElement();
+
+        Q_INVOKABLE QString effect() const;
+        Q_INVOKABLE qreal scale() const;
+        Q_INVOKABLE qreal guidance() const;
+
+        // Creates the controls of the wrapped effect, or nullptr if none.
+        Q_INVOKABLE QObject *effectControls() const;
+
+    private:
+        ProxyElementPrivate *d;
+
+    protected:
+        QString controlInterfaceProvide(const QString &controlId) const override;
+        void controlInterfaceConfigure(QQmlContext *context,
+                                       const QString &controlId) const override;
+        AkPacket iVideoStream(const AkVideoPacket &packet) override;
+
+    signals:
+        void effectChanged(const QString &effect);
+        void scaleChanged(qreal scale);
+        void guidanceChanged(qreal guidance);
+
+    public slots:
+        void setEffect(const QString &effect);
+        void setScale(qreal scale);
+        void setGuidance(qreal guidance);
+        void resetEffect();
+        void resetScale();
+        void resetGuidance();
+};
+
+#endif // PROXYELEMENT_H
@@ -18,11 +18,11 @@
  */
 
 #include <QQmlContext>
-#include <QRandomGenerator>
 #include <QSize>
 #include <qrgb.h>
 #include <akfrac.h>
 #include <akpacket.h>
+#include <akrandom.h>
 #include <akvideocaps.h>
 #include <akvideoconverter.h>
 #include <akvideopacket.h>
@@ -53,6 +53,16 @@ int QuarkElement::nFrames() const
     return this->d->m_nFrames;
 }
 
+AkVideoCaps::PixelFormatList QuarkElement::videoInputFormats() const
+{
+    return {AkVideoCaps::Format_argbpack};
+}
+
+AkVideoCaps::PixelFormatList QuarkElement::videoOutputFormats() const
+{
+    return {AkVideoCaps::Format_argbpack};
+}
+
 QString QuarkElement::controlInterfaceProvide(const QString &controlId) const
 {
     Q_UNUSED(controlId)
@@ -92,12 +102,18 @@ AkPacket QuarkElement::iVideoStream(const AkVideoPacket &packet)
 
     AkVideoPacket dst(src.caps());
     dst.copyMetadata(src);
+    auto &random = AkRandom::local();
+    QVector<int> frames(src.caps().width());
 
     for (int y = 0; y < src.caps().height(); y++) {
         auto dstLine = reinterpret_cast<QRgb *>(dst.line(0, y));
+        random.fillBounded(frames.data(),
+                           size_t(frames.size()),
+                           0,
+                           int(this->d->m_frames.size()));
 
         for (int x = 0; x < src.caps().width(); x++) {
-            int frame = QRandomGenerator::global()->bounded(this->d->m_frames.size());
+            auto &frame = frames[x];
             dstLine[x] = this->d->m_frames[frame].pixel<QRgb>(0, x, y);
         }
     }
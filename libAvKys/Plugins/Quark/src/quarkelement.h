@@ -37,6 +37,8 @@ class QuarkElement: public AkElement
         QuarkElement();
         ~QuarkElement();
 
+        Q_INVOKABLE AkVideoCaps::PixelFormatList videoInputFormats() const override;
+        Q_INVOKABLE AkVideoCaps::PixelFormatList videoOutputFormats() const override;
         Q_INVOKABLE int nFrames() const;
 
     private:
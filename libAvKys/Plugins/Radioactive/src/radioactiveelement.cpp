@@ -113,6 +113,16 @@ QRgb RadioactiveElement::radColor() const
     return this->d->m_radColor;
 }
 
+AkVideoCaps::PixelFormatList RadioactiveElement::videoInputFormats() const
+{
+    return {AkVideoCaps::Format_argbpack};
+}
+
+AkVideoCaps::PixelFormatList RadioactiveElement::videoOutputFormats() const
+{
+    return {AkVideoCaps::Format_argbpack};
+}
+
 QString RadioactiveElement::controlInterfaceProvide(const QString &controlId) const
 {
     Q_UNUSED(controlId)
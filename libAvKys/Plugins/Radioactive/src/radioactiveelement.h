@@ -77,6 +77,8 @@ class RadioactiveElement: public AkElement
         RadioactiveElement();
         ~RadioactiveElement();
 
+        Q_INVOKABLE AkVideoCaps::PixelFormatList videoInputFormats() const override;
+        Q_INVOKABLE AkVideoCaps::PixelFormatList videoOutputFormats() const override;
         Q_INVOKABLE RadiationMode mode() const;
         Q_INVOKABLE int blur() const;
         Q_INVOKABLE qreal zoom() const;
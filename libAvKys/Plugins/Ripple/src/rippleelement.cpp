@@ -19,12 +19,12 @@
 
 #include <QDataStream>
 #include <QQmlContext>
-#include <QRandomGenerator>
 #include <QtMath>
 #include <qrgb.h>
 #include <akcaps.h>
 #include <akfrac.h>
 #include <akpacket.h>
+#include <akrandom.h>
 #include <akvideocaps.h>
 #include <akvideoconverter.h>
 #include <akvideopacket.h>
@@ -122,6 +122,16 @@ qreal RippleElement::dropProbability() const
     return this->d->m_dropProbability;
 }
 
+AkVideoCaps::PixelFormatList RippleElement::videoInputFormats() const
+{
+    return {AkVideoCaps::Format_argbpack};
+}
+
+AkVideoCaps::PixelFormatList RippleElement::videoOutputFormats() const
+{
+    return {AkVideoCaps::Format_argbpack};
+}
+
 QString RippleElement::controlInterfaceProvide(const QString &controlId) const
 {
     Q_UNUSED(controlId)
@@ -183,11 +193,11 @@ AkPacket RippleElement::iVideoStream(const AkVideoPacket &packet)
                     std::swap(minDropSize, maxDropSize);
 
                 auto dropSize =
-                        QRandomGenerator::global()->bounded(minDropSize,
-                                                            maxDropSize);
+                        AkRandom::local().bounded(minDropSize,
+                                                  maxDropSize);
                 auto amplitude =
-                        QRandomGenerator::global()->bounded(-this->d->m_amplitude,
-                                                            this->d->m_amplitude);
+                        AkRandom::local().bounded(-this->d->m_amplitude,
+                                                  this->d->m_amplitude);
                 drop = this->d->drop(src.caps().width(),
                                      src.caps().height(),
                                      dropSize,
@@ -567,8 +577,8 @@ AkVideoPacket RippleElementPrivate::drop(int bufferWidth,
     if (qFuzzyCompare(sigma, 0.0))
         return drop;
 
-    int x = QRandomGenerator::global()->bounded(0, bufferWidth);
-    int y = QRandomGenerator::global()->bounded(0, bufferHeight);
+    int x = AkRandom::local().bounded(0, bufferWidth);
+    int y = AkRandom::local().bounded(0, bufferHeight);
 
     int minX = -dropWidth / 2;
     int maxX = 1 + dropWidth / 2;
@@ -84,6 +84,8 @@ class RippleElement: public AkElement
         RippleElement();
         ~RippleElement();
 
+        Q_INVOKABLE AkVideoCaps::PixelFormatList videoInputFormats() const override;
+        Q_INVOKABLE AkVideoCaps::PixelFormatList videoOutputFormats() const override;
         Q_INVOKABLE RippleMode mode() const;
         Q_INVOKABLE int amplitude() const;
         Q_INVOKABLE int decay() const;
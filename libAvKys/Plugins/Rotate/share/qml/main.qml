@@ -78,4 +78,23 @@ GridLayout {
             onCheckedChanged: Rotate.keep = checked
         }
     }
+
+    Label {
+        id: txtSmooth
+        text: qsTr("Smooth")
+    }
+    RowLayout {
+        Layout.columnSpan: 2
+        Layout.fillWidth: true
+
+        Label {
+            Layout.fillWidth: true
+        }
+        Switch {
+            checked: Rotate.smooth
+            Accessible.name: txtSmooth.text
+
+            onCheckedChanged: Rotate.smooth = checked
+        }
+    }
 }
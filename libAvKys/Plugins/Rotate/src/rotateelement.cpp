@@ -27,6 +27,7 @@
 #include <akvideocaps.h>
 #include <akvideoconverter.h>
 #include <akvideopacket.h>
+#include <akvideowarp.h>
 
 #include "rotateelement.h"
 
@@ -37,9 +38,13 @@ class RotateElementPrivate
     public:
         qreal m_angle {0.0};
         bool m_keep {false};
+        bool m_smooth {false};
         qint64 m_kernel[4];
         qint64 m_frameKernel[4];
         bool m_clampBounds {false};
+        bool m_quarterTurn {true};
+        AkVideoWarp::Orientation m_orientation {AkVideoWarp::Orientation_None};
+        AkVideoWarp m_warp;
         QMutex m_mutex;
         AkVideoConverter m_videoConverter {{AkVideoCaps::Format_argbpack, 0, 0, {}}};
 
@@ -67,6 +72,21 @@ bool RotateElement::keep() const
     return this->d->m_keep;
 }
 
+bool RotateElement::smooth() const
+{
+    return this->d->m_smooth;
+}
+
+AkVideoCaps::PixelFormatList RotateElement::videoInputFormats() const
+{
+    return {AkVideoCaps::Format_argbpack};
+}
+
+AkVideoCaps::PixelFormatList RotateElement::videoOutputFormats() const
+{
+    return {AkVideoCaps::Format_argbpack};
+}
+
 QString RotateElement::controlInterfaceProvide(const QString &controlId) const
 {
     Q_UNUSED(controlId)
@@ -94,6 +114,24 @@ AkPacket RotateElement::iVideoStream(const AkVideoPacket &packet)
 
     this->d->m_mutex.lock();
 
+    // Quarter turns only reorder the pixels.
+    if (this->d->m_quarterTurn) {
+        auto orientation = this->d->m_orientation;
+        auto caps = AkVideoWarp::orientedCaps(src.caps(), orientation);
+
+        if (!this->d->m_keep
+            || (caps.width() == src.caps().width()
+                && caps.height() == src.caps().height())) {
+            this->d->m_mutex.unlock();
+            auto dst = AkVideoWarp::orient(src, orientation);
+
+            if (dst)
+                emit this->oStream(dst);
+
+            return dst;
+        }
+    }
+
     int oWidth = 0;
     int oHeight = 0;
 
@@ -111,34 +149,25 @@ AkPacket RotateElement::iVideoStream(const AkVideoPacket &packet)
     AkVideoPacket dst(caps);
     dst.copyMetadata(src);
 
-    int scx = src.caps().width() >> 1;
-    int scy = src.caps().height() >> 1;
-    int dcx = dst.caps().width() >> 1;
-    int dcy = dst.caps().height() >> 1;
-
-    for (int y = 0; y < dst.caps().height(); y++) {
-        int dy = y - dcy;
-        auto oLine = reinterpret_cast<QRgb *>(dst.line(0, y));
-
-        for (int x = 0; x < dst.caps().width(); x++) {
-            int dx = x - dcx;
-            int xp = int(((dx * this->d->m_kernel[0] + dy * this->d->m_kernel[1]) >> VALUE_SHIFT) + scx);
-            int yp = int(((dx * this->d->m_kernel[2] + dy * this->d->m_kernel[3]) >> VALUE_SHIFT) + scy);
-
-            if (this->d->m_clampBounds) {
-                xp = qBound(0, xp, src.caps().width() - 1);
-                yp = qBound(0, yp, src.caps().height() - 1);
-            }
-
-            if (xp >= 0 && xp < src.caps().width()
-                && yp >= 0 && yp < src.caps().height()) {
-                auto iLine = reinterpret_cast<const QRgb *>(src.constLine(0, yp));
-                oLine[x] = iLine[xp];
-            } else {
-                oLine[x] = qRgba(0, 0, 0, 0);
-            }
-        }
-    }
+    qint64 scx = src.caps().width() >> 1;
+    qint64 scy = src.caps().height() >> 1;
+    qint64 dcx = dst.caps().width() >> 1;
+    qint64 dcy = dst.caps().height() >> 1;
+    auto kernel = this->d->m_kernel;
+
+    // Rotate around the center of the frames.
+    qint64 matrix[] {
+        kernel[0], kernel[1], (scx << VALUE_SHIFT) - dcx * kernel[0] - dcy * kernel[1],
+        kernel[2], kernel[3], (scy << VALUE_SHIFT) - dcx * kernel[2] - dcy * kernel[3],
+    };
+    this->d->m_warp.setMatrix(matrix, VALUE_SHIFT);
+    this->d->m_warp.setBorderMode(this->d->m_clampBounds?
+                                      AkVideoWarp::BorderMode_Clamp:
+                                      AkVideoWarp::BorderMode_Transparent);
+    this->d->m_warp.setFilter(this->d->m_smooth?
+                                  AkVideoWarp::Filter_Bilinear:
+                                  AkVideoWarp::Filter_Nearest);
+    this->d->m_warp.warp(src, dst);
 
     this->d->m_mutex.unlock();
 
@@ -167,6 +196,17 @@ void RotateElement::setKeep(bool keep)
     emit this->keepChanged(keep);
 }
 
+void RotateElement::setSmooth(bool smooth)
+{
+    if (this->d->m_smooth == smooth)
+        return;
+
+    this->d->m_mutex.lock();
+    this->d->m_smooth = smooth;
+    this->d->m_mutex.unlock();
+    emit this->smoothChanged(smooth);
+}
+
 void RotateElement::resetAngle()
 {
     this->setAngle(0.0);
@@ -177,6 +217,11 @@ void RotateElement::resetKeep()
     this->setKeep(false);
 }
 
+void RotateElement::resetSmooth()
+{
+    this->setSmooth(false);
+}
+
 void RotateElementPrivate::updateMatrix(qreal angle)
 {
     int mult = 1 << VALUE_SHIFT;
@@ -198,10 +243,37 @@ void RotateElementPrivate::updateMatrix(qreal angle)
     this->m_frameKernel[2] = sa;
     this->m_frameKernel[3] = ca;
 
-    this->m_mutex.unlock();
-
     this->m_clampBounds =
             this->m_frameKernel[0] == 0 || this->m_frameKernel[0] == mult;
+
+    /* The rounded kernel already looks like a quarter turn for angles a few
+     * degrees away from it, so check the angle itself.
+     */
+    this->m_quarterTurn = std::fmod(angle, 90.0) == 0.0;
+
+    switch (((qRound64(angle / 90.0) % 4) + 4) % 4) {
+    case 1:
+        this->m_orientation = AkVideoWarp::Orientation_Rotate270;
+
+        break;
+
+    case 2:
+        this->m_orientation = AkVideoWarp::Orientation_Rotate180;
+
+        break;
+
+    case 3:
+        this->m_orientation = AkVideoWarp::Orientation_Rotate90;
+
+        break;
+
+    default:
+        this->m_orientation = AkVideoWarp::Orientation_None;
+
+        break;
+    }
+
+    this->m_mutex.unlock();
 }
 
 #include "moc_rotateelement.cpp"
@@ -37,13 +37,21 @@ class RotateElement: public AkElement
                WRITE setKeep
                RESET resetKeep
                NOTIFY keepChanged)
+    Q_PROPERTY(bool smooth
+               READ smooth
+               WRITE setSmooth
+               RESET resetSmooth
+               NOTIFY smoothChanged)
 
     public:
         RotateElement();
         ~RotateElement();
 
+        Q_INVOKABLE AkVideoCaps::PixelFormatList videoInputFormats() const override;
+        Q_INVOKABLE AkVideoCaps::PixelFormatList videoOutputFormats() const override;
         Q_INVOKABLE qreal angle() const;
         Q_INVOKABLE bool keep() const;
+        Q_INVOKABLE bool smooth() const;
 
     private:
         RotateElementPrivate *d;
@@ -57,12 +65,15 @@ class RotateElement: public AkElement
     signals:
         void angleChanged(qreal angle);
         void keepChanged(bool keep);
+        void smoothChanged(bool smooth);
 
     public slots:
         void setAngle(qreal angle);
         void setKeep(bool keep);
+        void setSmooth(bool smooth);
         void resetAngle();
         void resetKeep();
+        void resetSmooth();
 };
 
 #endif // ROTATEELEMENT_H
@@ -56,6 +56,16 @@ int SaturatedElement::factor() const
     return this->d->m_factor;
 }
 
+AkVideoCaps::PixelFormatList SaturatedElement::videoInputFormats() const
+{
+    return {AkVideoCaps::Format_argbpack};
+}
+
+AkVideoCaps::PixelFormatList SaturatedElement::videoOutputFormats() const
+{
+    return {AkVideoCaps::Format_argbpack};
+}
+
 QString SaturatedElement::controlInterfaceProvide(const QString &controlId) const
 {
     Q_UNUSED(controlId)
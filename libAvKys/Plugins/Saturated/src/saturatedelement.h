@@ -37,6 +37,8 @@ class SaturatedElement: public AkElement
         SaturatedElement();
         ~SaturatedElement();
 
+        Q_INVOKABLE AkVideoCaps::PixelFormatList videoInputFormats() const override;
+        Q_INVOKABLE AkVideoCaps::PixelFormatList videoOutputFormats() const override;
         Q_INVOKABLE int factor() const;
 
     private:
@@ -17,6 +17,7 @@
  * Web-Site: http://webcamoid.github.io/
  */
 
+#include <QMutex>
 #include <QQmlContext>
 #include <akfrac.h>
 #include <akpacket.h>
@@ -33,37 +34,27 @@ class ScanLinesElementPrivate
         int m_hideSize {4};
         QRgb m_hideColor {qRgb(0, 0, 0)};
         AkVideoConverter m_videoConverter {{AkVideoCaps::Format_argbpack, 0, 0, {}}};
-        qint64 *m_aiMultTable {nullptr};
-        qint64 *m_aoMultTable {nullptr};
-        qint64 *m_alphaDivTable {nullptr};
+        QMutex m_mutex;
+
+        // Blending of the hide color over a pixel, indexed by the pixel
+        // alpha. Only depends on the hide color.
+        qint64 m_redTable[256];
+        qint64 m_greenTable[256];
+        qint64 m_blueTable[256];
+        qint64 m_aoMultTable[256];
+        quint8 m_alphaTable[256];
+
+        void updateBlendTables();
 };
 
 ScanLinesElement::ScanLinesElement(): AkElement()
 {
     this->d = new ScanLinesElementPrivate;
-
-    constexpr qint64 maxAi = 255;
-    qint64 maxAi2 = maxAi * maxAi;
-    constexpr qint64 alphaMult = 1 << 16;
-    this->d->m_aiMultTable = new qint64 [alphaMult];
-    this->d->m_aoMultTable = new qint64 [alphaMult];
-    this->d->m_alphaDivTable = new qint64 [alphaMult];
-
-    for (qint64 ai = 0; ai < 256; ai++)
-        for (qint64 ao = 0; ao < 256; ao++) {
-            auto alphaMask = (ai << 8) | ao;
-            auto a = maxAi2 - (maxAi - ai) * (maxAi - ao);
-            this->d->m_aiMultTable[alphaMask] = a? alphaMult * ai * maxAi / a: 0;
-            this->d->m_aoMultTable[alphaMask] = a? alphaMult * ao * (maxAi - ai) / a: 0;
-            this->d->m_alphaDivTable[alphaMask] = a / maxAi;
-        }
+    this->d->updateBlendTables();
 }
 
 ScanLinesElement::~ScanLinesElement()
 {
-    delete [] this->d->m_aiMultTable;
-    delete [] this->d->m_aoMultTable;
-    delete [] this->d->m_alphaDivTable;
     delete this->d;
 }
 
@@ -82,6 +73,16 @@ QRgb ScanLinesElement::hideColor() const
     return this->d->m_hideColor;
 }
 
+AkVideoCaps::PixelFormatList ScanLinesElement::videoInputFormats() const
+{
+    return {AkVideoCaps::Format_argbpack};
+}
+
+AkVideoCaps::PixelFormatList ScanLinesElement::videoOutputFormats() const
+{
+    return {AkVideoCaps::Format_argbpack};
+}
+
 QString ScanLinesElement::controlInterfaceProvide(const QString &controlId) const
 {
     Q_UNUSED(controlId)
@@ -116,13 +117,10 @@ AkPacket ScanLinesElement::iVideoStream(const AkVideoPacket &packet)
         stripeSize = 2;
     }
 
-    auto hideColor = this->d->m_hideColor;
-    auto ri = qRed(hideColor);
-    auto gi = qGreen(hideColor);
-    auto bi = qBlue(hideColor);
-    auto ai = qAlpha(hideColor);
     int i = 0;
 
+    this->d->m_mutex.lock();
+
     for (int y = 0; y < dst.caps().height(); y++) {
         if (i >= showSize) {
             auto line = reinterpret_cast<QRgb *>(dst.line(0, y));
@@ -133,21 +131,22 @@ AkPacket ScanLinesElement::iVideoStream(const AkVideoPacket &packet)
                 qint64 ro = qRed(pixel);
                 qint64 go = qGreen(pixel);
                 qint64 bo = qBlue(pixel);
-                qint64 ao = qAlpha(pixel);
+                int ao = qAlpha(pixel);
 
-                auto alphaMask = (ai << 8) | ao;
-                qint64 rt = (ri * this->d->m_aiMultTable[alphaMask] + ro * this->d->m_aoMultTable[alphaMask]) >> 16;
-                qint64 gt = (gi * this->d->m_aiMultTable[alphaMask] + go * this->d->m_aoMultTable[alphaMask]) >> 16;
-                qint64 bt = (bi * this->d->m_aiMultTable[alphaMask] + bo * this->d->m_aoMultTable[alphaMask]) >> 16;
-                qint64 &at = this->d->m_alphaDivTable[alphaMask];
+                auto &aoMult = this->d->m_aoMultTable[ao];
+                qint64 rt = (this->d->m_redTable[ao] + ro * aoMult) >> 16;
+                qint64 gt = (this->d->m_greenTable[ao] + go * aoMult) >> 16;
+                qint64 bt = (this->d->m_blueTable[ao] + bo * aoMult) >> 16;
 
-                pixel = qRgba(int(rt), int(gt), int(bt), int(at));
+                pixel = qRgba(int(rt), int(gt), int(bt), this->d->m_alphaTable[ao]);
             }
         }
 
         i = (i + 1) % stripeSize;
     }
 
+    this->d->m_mutex.unlock();
+
     if (dst)
         emit this->oStream(dst);
 
@@ -177,7 +176,10 @@ void ScanLinesElement::setHideColor(QRgb hideColor)
     if (this->d->m_hideColor == hideColor)
         return;
 
+    this->d->m_mutex.lock();
     this->d->m_hideColor = hideColor;
+    this->d->updateBlendTables();
+    this->d->m_mutex.unlock();
     emit this->hideColorChanged(hideColor);
 }
 
@@ -196,4 +198,26 @@ void ScanLinesElement::resetHideColor()
     this->setHideColor(qRgb(0, 0, 0));
 }
 
+void ScanLinesElementPrivate::updateBlendTables()
+{
+    constexpr qint64 maxAi = 255;
+    qint64 maxAi2 = maxAi * maxAi;
+    constexpr qint64 alphaMult = 1 << 16;
+
+    qint64 ri = qRed(this->m_hideColor);
+    qint64 gi = qGreen(this->m_hideColor);
+    qint64 bi = qBlue(this->m_hideColor);
+    qint64 ai = qAlpha(this->m_hideColor);
+
+    for (qint64 ao = 0; ao < 256; ao++) {
+        auto a = maxAi2 - (maxAi - ai) * (maxAi - ao);
+        qint64 aiMult = a? alphaMult * ai * maxAi / a: 0;
+        this->m_redTable[ao] = ri * aiMult;
+        this->m_greenTable[ao] = gi * aiMult;
+        this->m_blueTable[ao] = bi * aiMult;
+        this->m_aoMultTable[ao] = a? alphaMult * ao * (maxAi - ai) / a: 0;
+        this->m_alphaTable[ao] = quint8(a / maxAi);
+    }
+}
+
 #include "moc_scanlineselement.cpp"
@@ -48,6 +48,8 @@ class ScanLinesElement: public AkElement
         ScanLinesElement();
         ~ScanLinesElement();
 
+        Q_INVOKABLE AkVideoCaps::PixelFormatList videoInputFormats() const override;
+        Q_INVOKABLE AkVideoCaps::PixelFormatList videoOutputFormats() const override;
         Q_INVOKABLE int showSize() const;
         Q_INVOKABLE int hideSize() const;
         Q_INVOKABLE QRgb hideColor() const;
@@ -18,12 +18,12 @@
  */
 
 #include <QQmlContext>
-#include <QRandomGenerator>
 #include <QSize>
 #include <QtMath>
 #include <qrgb.h>
 #include <akfrac.h>
 #include <akpacket.h>
+#include <akrandom.h>
 #include <akvideocaps.h>
 #include <akvideoconverter.h>
 #include <akvideopacket.h>
@@ -68,6 +68,16 @@ quint32 ShagadelicElement::mask() const
     return this->d->m_mask;
 }
 
+AkVideoCaps::PixelFormatList ShagadelicElement::videoInputFormats() const
+{
+    return {AkVideoCaps::Format_argbpack};
+}
+
+AkVideoCaps::PixelFormatList ShagadelicElement::videoOutputFormats() const
+{
+    return {AkVideoCaps::Format_argbpack};
+}
+
 QString ShagadelicElement::controlInterfaceProvide(const QString &controlId) const
 {
     Q_UNUSED(controlId)
@@ -218,10 +228,10 @@ void ShagadelicElementPrivate::init(const QSize &size)
     this->m_ripple = this->makeRipple(size);
     this->m_spiral = this->makeSpiral(size);
 
-    this->m_rx = QRandomGenerator::global()->bounded(size.width());
-    this->m_ry = QRandomGenerator::global()->bounded(size.height());
-    this->m_bx = QRandomGenerator::global()->bounded(size.width());
-    this->m_by = QRandomGenerator::global()->bounded(size.height());
+    this->m_rx = AkRandom::local().bounded(size.width());
+    this->m_ry = AkRandom::local().bounded(size.height());
+    this->m_bx = AkRandom::local().bounded(size.width());
+    this->m_by = AkRandom::local().bounded(size.height());
 
     this->m_rvx = -2;
     this->m_rvy = -2;
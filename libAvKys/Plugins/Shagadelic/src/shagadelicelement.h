@@ -37,6 +37,8 @@ class ShagadelicElement: public AkElement
         ShagadelicElement();
         ~ShagadelicElement();
 
+        Q_INVOKABLE AkVideoCaps::PixelFormatList videoInputFormats() const override;
+        Q_INVOKABLE AkVideoCaps::PixelFormatList videoOutputFormats() const override;
         Q_INVOKABLE quint32 mask() const;
 
     private:
@@ -0,0 +1,167 @@
+/* Webcamoid, camera capture application.
+ * Copyright (C) 2026  Gonzalo Exequiel Pedone
+ *
+ * Webcamoid is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Webcamoid is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Webcamoid. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Web-Site: http://webcamoid.github.io/
+ */
+
+#include <QMutex>
+#include <akpacket.h>
+#include <akvideocaps.h>
+#include <akvideopacket.h>
+
+#include "shmsinkelement.h"
+#include "shmframering.h"
+
+class ShmSinkElementPrivate
+{
+    public:
+        ShmSinkElement *self;
+        QString m_name {"webcamoid"};
+        int m_slotCount {4};
+        ShmFrameRing m_ring;
+        AkVideoCaps m_caps;
+        size_t m_frameSize {0};
+        QMutex m_mutex;
+
+        explicit ShmSinkElementPrivate(ShmSinkElement *self);
+        bool writeFrame(const AkVideoPacket &packet);
+};
+
+ShmSinkElement::ShmSinkElement():
+    AkElement()
+{
+    this->d = new ShmSinkElementPrivate(this);
+}
+
+ShmSinkElement::~ShmSinkElement()
+{
+    this->setState(AkElement::ElementStateNull);
+    delete this->d;
+}
+
+QString ShmSinkElement::name() const
+{
+    return this->d->m_name;
+}
+
+int ShmSinkElement::slotCount() const
+{
+    return this->d->m_slotCount;
+}
+
+AkPacket ShmSinkElement::iVideoStream(const AkVideoPacket &packet)
+{
+    if (packet && this->state() == AkElement::ElementStatePlaying) {
+        this->d->m_mutex.lock();
+        this->d->writeFrame(packet);
+        this->d->m_mutex.unlock();
+    }
+
+    if (packet)
+        emit this->oStream(packet);
+
+    return packet;
+}
+
+void ShmSinkElement::setName(const QString &name)
+{
+    this->d->m_mutex.lock();
+
+    if (this->d->m_name == name) {
+        this->d->m_mutex.unlock();
+
+        return;
+    }
+
+    this->d->m_name = name;
+
+    // The ring will be created again with the next frame.
+    this->d->m_ring.close();
+    this->d->m_mutex.unlock();
+
+    emit this->nameChanged(name);
+}
+
+void ShmSinkElement::setSlotCount(int slotCount)
+{
+    slotCount = qBound(2, slotCount, 64);
+    this->d->m_mutex.lock();
+
+    if (this->d->m_slotCount == slotCount) {
+        this->d->m_mutex.unlock();
+
+        return;
+    }
+
+    this->d->m_slotCount = slotCount;
+    this->d->m_ring.close();
+    this->d->m_mutex.unlock();
+
+    emit this->slotCountChanged(slotCount);
+}
+
+void ShmSinkElement::resetName()
+{
+    this->setName("webcamoid");
+}
+
+void ShmSinkElement::resetSlotCount()
+{
+    this->setSlotCount(4);
+}
+
+bool ShmSinkElement::setState(AkElement::ElementState state)
+{
+    if (state == AkElement::ElementStateNull) {
+        this->d->m_mutex.lock();
+        this->d->m_ring.close();
+        this->d->m_mutex.unlock();
+    }
+
+    return AkElement::setState(state);
+}
+
+ShmSinkElementPrivate::ShmSinkElementPrivate(ShmSinkElement *self):
+    self(self)
+{
+
+}
+
+bool ShmSinkElementPrivate::writeFrame(const AkVideoPacket &packet)
+{
+    if (this->m_name.isEmpty())
+        return false;
+
+    if (this->m_ring.isOpen() && this->m_ring.write(packet))
+        return true;
+
+    if (packet.caps() != this->m_caps) {
+        this->m_caps = packet.caps();
+        this->m_frameSize = ShmFrameRing::frameSize(this->m_caps);
+    }
+
+    if (this->m_frameSize < 1
+        || (this->m_ring.isOpen() && this->m_frameSize <= this->m_ring.slotSize()))
+        return false;
+
+    // The ring doesn't exist yet, or the frame is bigger than the slots.
+    if (!this->m_ring.create(this->m_name, this->m_slotCount, this->m_frameSize))
+        return false;
+
+    return this->m_ring.write(packet);
+}
+
+#include "moc_shmsinkelement.cpp"
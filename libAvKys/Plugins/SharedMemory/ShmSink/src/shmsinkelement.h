@@ -0,0 +1,66 @@
+/* Webcamoid, camera capture application.
+ * Copyright (C) 2026  Gonzalo Exequiel Pedone
+ *
+ * Webcamoid is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Webcamoid is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Webcamoid. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Web-Site: http://webcamoid.github.io/
+ */
+
+#ifndef SHMSINKELEMENT_H
+#define SHMSINKELEMENT_H
+
+#include <iak/akelement.h>
+
+class ShmSinkElementPrivate;
+
+class ShmSinkElement: public AkElement
+{
+    Q_OBJECT
+    Q_PROPERTY(QString name
+               READ name
+               WRITE setName
+               RESET resetName
+               NOTIFY nameChanged)
+    Q_PROPERTY(int slotCount
+               READ slotCount
+               WRITE setSlotCount
+               RESET resetSlotCount
+               NOTIFY slotCountChanged)
+
+    public:
+        ShmSinkElement();
+        ~ShmSinkElement();
+
+        Q_INVOKABLE QString name() const;
+        Q_INVOKABLE int slotCount() const;
+
+    private:
+        ShmSinkElementPrivate *d;
+
+    protected:
+        AkPacket iVideoStream(const AkVideoPacket &packet) override;
+
+    signals:
+        void nameChanged(const QString &name);
+        void slotCountChanged(int slotCount);
+
+    public slots:
+        void setName(const QString &name);
+        void setSlotCount(int slotCount);
+        void resetName();
+        void resetSlotCount();
+        bool setState(AkElement::ElementState state) override;
+};
+
+#endif // SHMSINKELEMENT_H
@@ -0,0 +1,263 @@
+/* Webcamoid, camera capture application.
+ * Copyright (C) 2026  Gonzalo Exequiel Pedone
+ *
+ * Webcamoid is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Webcamoid is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Webcamoid. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Web-Site: http://webcamoid.github.io/
+ */
+
+#include <atomic>
+#include <QElapsedTimer>
+#include <QReadWriteLock>
+#include <QThread>
+#include <QThreadPool>
+#include <QtConcurrent>
+#include <ak.h>
+#include <akcaps.h>
+#include <akfrac.h>
+#include <akpacket.h>
+#include <akvideocaps.h>
+#include <akvideopacket.h>
+
+#include "shmsrcelement.h"
+#include "shmframering.h"
+
+// Time to wait for a new frame, and time without frames before checking if
+// the ring was replaced.
+#define FRAME_TIMEOUT  100
+#define REOPEN_TIMEOUT 2000
+
+class ShmSrcElementPrivate
+{
+    public:
+        ShmSrcElement *self;
+        QString m_media;
+        qint64 m_id {-1};
+        QThreadPool m_threadPool;
+        QFuture<void> m_framesThreadStatus;
+        QReadWriteLock m_mutex;
+        std::atomic<bool> m_run {false};
+
+        explicit ShmSrcElementPrivate(ShmSrcElement *self);
+        void readFrames();
+};
+
+ShmSrcElement::ShmSrcElement():
+    AkMultimediaSourceElement()
+{
+    this->d = new ShmSrcElementPrivate(this);
+}
+
+ShmSrcElement::~ShmSrcElement()
+{
+    this->setState(AkElement::ElementStateNull);
+    delete this->d;
+}
+
+QStringList ShmSrcElement::medias()
+{
+    auto media = this->media();
+
+    if (media.isEmpty())
+        return {};
+
+    return {media};
+}
+
+QString ShmSrcElement::media() const
+{
+    this->d->m_mutex.lockForRead();
+    auto media = this->d->m_media;
+    this->d->m_mutex.unlock();
+
+    return media;
+}
+
+QList<int> ShmSrcElement::streams()
+{
+    if (this->media().isEmpty())
+        return {};
+
+    return {0};
+}
+
+int ShmSrcElement::defaultStream(AkCaps::CapsType type)
+{
+    if (type == AkCaps::CapsVideo)
+        return 0;
+
+    return -1;
+}
+
+QString ShmSrcElement::description(const QString &media)
+{
+    if (media.isEmpty() || media != this->media())
+        return {};
+
+    return ShmFrameRing::objectName(media);
+}
+
+AkCaps ShmSrcElement::caps(int stream)
+{
+    auto media = this->media();
+
+    if (stream != 0 || media.isEmpty())
+        return {};
+
+    // Read the caps of the last frame, the reading thread has its own ring.
+    ShmFrameRing ring;
+
+    if (!ring.open(media))
+        return {};
+
+    return ring.caps();
+}
+
+void ShmSrcElement::setMedia(const QString &media)
+{
+    if (this->media() == media)
+        return;
+
+    auto state = this->state();
+    this->setState(AkElement::ElementStateNull);
+
+    this->d->m_mutex.lockForWrite();
+    this->d->m_media = media;
+    this->d->m_mutex.unlock();
+
+    if (!media.isEmpty())
+        this->setState(state);
+
+    emit this->mediaChanged(media);
+    emit this->mediasChanged(this->medias());
+}
+
+void ShmSrcElement::resetMedia()
+{
+    this->setMedia({});
+}
+
+bool ShmSrcElement::setState(AkElement::ElementState state)
+{
+    if (this->media().isEmpty())
+        return false;
+
+    auto curState = this->state();
+
+    switch (curState) {
+    case AkElement::ElementStateNull: {
+        switch (state) {
+        case AkElement::ElementStatePaused:
+            this->d->m_id = Ak::id();
+
+            return AkElement::setState(state);
+        case AkElement::ElementStatePlaying:
+            this->d->m_id = Ak::id();
+            this->d->m_run = true;
+            this->d->m_framesThreadStatus =
+                    QtConcurrent::run(&this->d->m_threadPool,
+                                      &ShmSrcElementPrivate::readFrames,
+                                      this->d);
+
+            return AkElement::setState(state);
+        case AkElement::ElementStateNull:
+            break;
+        }
+
+        break;
+    }
+    case AkElement::ElementStatePaused: {
+        switch (state) {
+        case AkElement::ElementStateNull:
+            return AkElement::setState(state);
+        case AkElement::ElementStatePlaying:
+            this->d->m_run = true;
+            this->d->m_framesThreadStatus =
+                    QtConcurrent::run(&this->d->m_threadPool,
+                                      &ShmSrcElementPrivate::readFrames,
+                                      this->d);
+
+            return AkElement::setState(state);
+        case AkElement::ElementStatePaused:
+            break;
+        }
+
+        break;
+    }
+    case AkElement::ElementStatePlaying: {
+        switch (state) {
+        case AkElement::ElementStateNull:
+        case AkElement::ElementStatePaused:
+            this->d->m_run = false;
+            this->d->m_framesThreadStatus.waitForFinished();
+
+            return AkElement::setState(state);
+        case AkElement::ElementStatePlaying:
+            break;
+        }
+
+        break;
+    }
+    }
+
+    return false;
+}
+
+ShmSrcElementPrivate::ShmSrcElementPrivate(ShmSrcElement *self):
+    self(self)
+{
+    this->m_threadPool.setMaxThreadCount(1);
+}
+
+void ShmSrcElementPrivate::readFrames()
+{
+    this->m_mutex.lockForRead();
+    auto media = this->m_media;
+    this->m_mutex.unlock();
+
+    ShmFrameRing ring;
+    QElapsedTimer lastFrame;
+    lastFrame.start();
+
+    while (this->m_run) {
+        /* Open the ring again if the writer closed it, or if it was replaced
+         * by a writer that didn't close it cleanly.
+         */
+        if (!ring.isOpen()
+            || ring.isStale()
+            || (lastFrame.elapsed() > REOPEN_TIMEOUT && ring.isReplaced())) {
+            lastFrame.restart();
+
+            if (!ring.open(media)) {
+                QThread::msleep(FRAME_TIMEOUT);
+
+                continue;
+            }
+        }
+
+        if (!ring.waitFrame(FRAME_TIMEOUT))
+            continue;
+
+        AkVideoPacket packet = ring.read();
+
+        if (!packet)
+            continue;
+
+        lastFrame.restart();
+        packet.setId(this->m_id);
+        emit self->oStream(packet);
+    }
+}
+
+#include "moc_shmsrcelement.cpp"
@@ -0,0 +1,664 @@
+/* Webcamoid, camera capture application.
+ * Copyright (C) 2026  Gonzalo Exequiel Pedone
+ *
+ * Webcamoid is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Webcamoid is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Webcamoid. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Web-Site: http://webcamoid.github.io/
+ */
+
+#include <atomic>
+#include <cstring>
+#include <QElapsedTimer>
+#include <QThread>
+#include <QtDebug>
+#include <akfrac.h>
+#include <akvideocaps.h>
+#include <akvideopacket.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#ifdef Q_OS_LINUX
+#include <climits>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#endif
+
+#include "shmframering.h"
+
+#define SHM_FRAME_RING_MAGIC      0x48534b41 // "AKSH"
+#define SHM_FRAME_RING_VERSION    1
+#define SHM_FRAME_RING_MAX_PLANES 4
+#define SHM_FRAME_RING_ALIGN      64
+
+static_assert(std::atomic<quint32>::is_always_lock_free,
+              "The shared memory ring requires lock free 32 bits atomics");
+static_assert(std::atomic<quint64>::is_always_lock_free,
+              "The shared memory ring requires lock free 64 bits atomics");
+
+struct ShmFrameRingHeader
+{
+    // Published last, with release semantics, so a reader that sees it
+    // also sees the rest of the header.
+    std::atomic<quint32> magic;
+    quint32 version;
+    quint32 slotCount;
+    quint32 reserved;
+    quint64 slotSize;
+    quint64 dataOffset;
+
+    // Number of frames written since the ring was created.
+    std::atomic<quint64> frames;
+
+    // Incremented on every write and when the ring is closed, the readers
+    // wait for it to change.
+    std::atomic<quint32> frameCounter;
+
+    // Number of readers waiting for a frame, so the writer can skip waking
+    // them up when there is none.
+    std::atomic<quint32> waiters;
+
+    // Set when the writer closes the ring.
+    std::atomic<quint32> stale;
+};
+
+// Everything the readers need to know to interpret the frame of a slot.
+struct ShmFrameInfo
+{
+    quint32 format;
+    qint32 width;
+    qint32 height;
+    quint32 planes;
+    qint64 fpsNum;
+    qint64 fpsDen;
+    qint64 pts;
+    qint64 timeBaseNum;
+    qint64 timeBaseDen;
+    quint64 duration;
+    quint64 planeOffset[SHM_FRAME_RING_MAX_PLANES];
+    quint64 lineSize[SHM_FRAME_RING_MAX_PLANES];
+    quint64 dataSize;
+};
+
+struct ShmFrameSlotHeader
+{
+    // Odd while the writer is filling the slot.
+    std::atomic<quint32> sequence;
+    quint32 reserved;
+    ShmFrameInfo info;
+};
+
+class ShmFrameRingPrivate
+{
+    public:
+        QString m_name;
+        int m_fd {-1};
+        quint8 *m_data {nullptr};
+        size_t m_size {0};
+        bool m_isWriter {false};
+        quint64 m_lastFrame {0};
+        ino_t m_inode {0};
+
+        // Planes layout of the last written frame.
+        AkVideoCaps m_layoutCaps;
+        int m_planes {0};
+        size_t m_lineSize[SHM_FRAME_RING_MAX_PLANES];
+        size_t m_planeOffset[SHM_FRAME_RING_MAX_PLANES];
+        size_t m_frameSize {0};
+
+        inline ShmFrameRingHeader *header() const;
+        inline ShmFrameSlotHeader *slotHeader(quint64 frame) const;
+        inline quint8 *slotData(quint64 frame) const;
+        void updateLayout(const AkVideoCaps &caps);
+        bool map(size_t size);
+        void unmap();
+        void wake();
+        static size_t headerSize(int slotCount);
+        static bool isValid(const ShmFrameInfo &info, size_t slotSize);
+};
+
+ShmFrameRing::ShmFrameRing()
+{
+    this->d = new ShmFrameRingPrivate;
+}
+
+ShmFrameRing::~ShmFrameRing()
+{
+    this->close();
+    delete this->d;
+}
+
+bool ShmFrameRing::create(const QString &name, int slotCount, size_t slotSize)
+{
+    this->close();
+
+    if (name.isEmpty() || slotCount < 2 || slotSize < 1)
+        return false;
+
+    auto objectName = ShmFrameRing::objectName(name).toLocal8Bit();
+
+    // Replace the ring of a writer that didn't exit cleanly.
+    shm_unlink(objectName.constData());
+    this->d->m_fd = shm_open(objectName.constData(),
+                             O_CREAT | O_EXCL | O_RDWR,
+                             S_IRUSR | S_IWUSR);
+
+    if (this->d->m_fd < 0) {
+        qCritical() << "Failed to create" << objectName << ":" << strerror(errno);
+
+        return false;
+    }
+
+    slotSize = (slotSize + SHM_FRAME_RING_ALIGN - 1) & ~size_t(SHM_FRAME_RING_ALIGN - 1);
+    auto dataOffset = ShmFrameRingPrivate::headerSize(slotCount);
+    auto size = dataOffset + size_t(slotCount) * slotSize;
+
+    if (ftruncate(this->d->m_fd, off_t(size)) < 0
+        || !this->d->map(size)) {
+        qCritical() << "Failed to allocate" << objectName << ":" << strerror(errno);
+        ::close(this->d->m_fd);
+        this->d->m_fd = -1;
+        shm_unlink(objectName.constData());
+
+        return false;
+    }
+
+    // ftruncate() fills the object with zeros, so the atomics and the slot
+    // sequences are already initialized.
+    auto header = this->d->header();
+    header->version = SHM_FRAME_RING_VERSION;
+    header->slotCount = quint32(slotCount);
+    header->slotSize = slotSize;
+    header->dataOffset = dataOffset;
+    header->magic.store(SHM_FRAME_RING_MAGIC, std::memory_order_release);
+
+    this->d->m_name = name;
+    this->d->m_isWriter = true;
+    this->d->m_layoutCaps = {};
+
+    return true;
+}
+
+bool ShmFrameRing::open(const QString &name)
+{
+    this->close();
+
+    if (name.isEmpty())
+        return false;
+
+    auto objectName = ShmFrameRing::objectName(name).toLocal8Bit();
+    this->d->m_fd = shm_open(objectName.constData(), O_RDWR, 0);
+
+    if (this->d->m_fd < 0)
+        return false;
+
+    struct stat fileInfo;
+
+    if (fstat(this->d->m_fd, &fileInfo) < 0
+        || size_t(fileInfo.st_size) < sizeof(ShmFrameRingHeader)
+        || !this->d->map(size_t(fileInfo.st_size))) {
+        this->close();
+
+        return false;
+    }
+
+    auto header = this->d->header();
+
+    if (header->magic.load(std::memory_order_acquire) != SHM_FRAME_RING_MAGIC
+        || header->version != SHM_FRAME_RING_VERSION
+        || header->slotCount < 2
+        || header->dataOffset < ShmFrameRingPrivate::headerSize(int(header->slotCount))
+        || header->dataOffset + header->slotCount * header->slotSize > this->d->m_size) {
+        qWarning() << "Invalid shared memory frame ring:" << objectName;
+        this->close();
+
+        return false;
+    }
+
+    this->d->m_name = name;
+    this->d->m_isWriter = false;
+    this->d->m_inode = fileInfo.st_ino;
+    this->d->m_lastFrame = header->frames.load(std::memory_order_acquire);
+
+    // Start with the last written frame.
+    if (this->d->m_lastFrame > 0)
+        this->d->m_lastFrame--;
+
+    return true;
+}
+
+void ShmFrameRing::close()
+{
+    if (this->d->m_data && this->d->m_isWriter) {
+        auto header = this->d->header();
+        header->stale.store(1, std::memory_order_release);
+        this->d->wake();
+        shm_unlink(ShmFrameRing::objectName(this->d->m_name).toLocal8Bit().constData());
+    }
+
+    this->d->unmap();
+
+    if (this->d->m_fd >= 0) {
+        ::close(this->d->m_fd);
+        this->d->m_fd = -1;
+    }
+
+    this->d->m_name.clear();
+    this->d->m_isWriter = false;
+    this->d->m_lastFrame = 0;
+    this->d->m_inode = 0;
+}
+
+bool ShmFrameRing::isOpen() const
+{
+    return this->d->m_data != nullptr;
+}
+
+bool ShmFrameRing::isWriter() const
+{
+    return this->d->m_isWriter;
+}
+
+bool ShmFrameRing::isStale() const
+{
+    if (!this->d->m_data)
+        return true;
+
+    return this->d->header()->stale.load(std::memory_order_acquire) != 0;
+}
+
+bool ShmFrameRing::isReplaced() const
+{
+    if (!this->d->m_data || this->d->m_isWriter)
+        return false;
+
+    auto objectName = ShmFrameRing::objectName(this->d->m_name).toLocal8Bit();
+    auto fd = shm_open(objectName.constData(), O_RDONLY, 0);
+
+    if (fd < 0)
+        return false;
+
+    struct stat fileInfo;
+    bool replaced = fstat(fd, &fileInfo) == 0
+                    && fileInfo.st_ino != this->d->m_inode;
+    ::close(fd);
+
+    return replaced;
+}
+
+QString ShmFrameRing::name() const
+{
+    return this->d->m_name;
+}
+
+int ShmFrameRing::slotCount() const
+{
+    if (!this->d->m_data)
+        return 0;
+
+    return int(this->d->header()->slotCount);
+}
+
+size_t ShmFrameRing::slotSize() const
+{
+    if (!this->d->m_data)
+        return 0;
+
+    return this->d->header()->slotSize;
+}
+
+bool ShmFrameRing::write(const AkVideoPacket &packet)
+{
+    if (!this->d->m_data || !this->d->m_isWriter || !packet)
+        return false;
+
+    if (packet.caps() != this->d->m_layoutCaps)
+        this->d->updateLayout(packet.caps());
+
+    auto header = this->d->header();
+
+    if (this->d->m_planes < 1
+        || this->d->m_planes > SHM_FRAME_RING_MAX_PLANES
+        || this->d->m_frameSize > header->slotSize)
+        return false;
+
+    auto frame = header->frames.load(std::memory_order_relaxed);
+    auto slot = this->d->slotHeader(frame);
+    auto data = this->d->slotData(frame);
+    auto sequence = slot->sequence.load(std::memory_order_relaxed);
+    slot->sequence.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    auto &caps = packet.caps();
+    auto &info = slot->info;
+    info.format = quint32(caps.format());
+    info.width = caps.width();
+    info.height = caps.height();
+    info.planes = quint32(this->d->m_planes);
+    info.fpsNum = caps.fps().num();
+    info.fpsDen = caps.fps().den();
+    info.pts = packet.pts();
+    info.timeBaseNum = packet.timeBase().num();
+    info.timeBaseDen = packet.timeBase().den();
+    info.duration = packet.duration();
+    info.dataSize = this->d->m_frameSize;
+
+    for (int plane = 0; plane < this->d->m_planes; ++plane) {
+        auto lineSize = this->d->m_lineSize[plane];
+        auto dst = data + this->d->m_planeOffset[plane];
+        auto height = caps.height() >> packet.heightDiv(plane);
+        info.planeOffset[plane] = this->d->m_planeOffset[plane];
+        info.lineSize[plane] = lineSize;
+
+        // Views share the lines of a bigger frame, copy only the bytes used.
+        if (!packet.isForeign() && packet.lineSize(plane) == lineSize) {
+            memcpy(dst, packet.constPlane(plane), lineSize * height);
+        } else {
+            auto bytesUsed = qMin(packet.bytesUsed(plane), lineSize);
+
+            for (int y = 0; y < height; ++y)
+                memcpy(dst + y * lineSize,
+                       packet.constPlane(plane) + y * packet.lineSize(plane),
+                       bytesUsed);
+        }
+    }
+
+    slot->sequence.store(sequence + 2, std::memory_order_release);
+    header->frames.store(frame + 1, std::memory_order_release);
+    this->d->wake();
+
+    return true;
+}
+
+AkVideoPacket ShmFrameRing::read()
+{
+    if (!this->d->m_data || this->d->m_isWriter)
+        return {};
+
+    auto header = this->d->header();
+
+    // The writer may be overwriting the slot, retry with the next frame.
+    for (int i = 0; i < 4; ++i) {
+        auto frames = header->frames.load(std::memory_order_acquire);
+
+        if (frames == this->d->m_lastFrame)
+            return {};
+
+        auto frame = frames - 1;
+        auto slot = this->d->slotHeader(frame);
+        auto data = this->d->slotData(frame);
+        auto sequence = slot->sequence.load(std::memory_order_acquire);
+
+        if (sequence & 1)
+            continue;
+
+        ShmFrameInfo info;
+        memcpy(&info, &slot->info, sizeof(ShmFrameInfo));
+
+        if (!ShmFrameRingPrivate::isValid(info, header->slotSize)) {
+            // A torn header is not an error, only the final check tells.
+            if (slot->sequence.load(std::memory_order_acquire) != sequence)
+                continue;
+
+            this->d->m_lastFrame = frames;
+
+            return {};
+        }
+
+        AkVideoCaps caps(AkVideoCaps::PixelFormat(info.format),
+                         info.width,
+                         info.height,
+                         {info.fpsNum, info.fpsDen});
+        AkVideoPacket packet(caps);
+
+        if (packet.planes() != info.planes) {
+            this->d->m_lastFrame = frames;
+
+            return {};
+        }
+
+        for (size_t plane = 0; plane < info.planes; ++plane) {
+            auto src = data + info.planeOffset[plane];
+            auto lineSize = info.lineSize[plane];
+            auto height = info.height >> packet.heightDiv(plane);
+
+            if (packet.lineSize(plane) == lineSize) {
+                memcpy(packet.plane(plane), src, lineSize * height);
+            } else {
+                auto copySize = qMin(packet.bytesUsed(plane), lineSize);
+
+                for (int y = 0; y < height; ++y)
+                    memcpy(packet.line(plane, y), src + y * lineSize, copySize);
+            }
+        }
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+
+        if (slot->sequence.load(std::memory_order_relaxed) != sequence)
+            continue;
+
+        packet.setPts(info.pts);
+        packet.setTimeBase({info.timeBaseNum, info.timeBaseDen});
+        packet.setDuration(info.duration);
+        packet.setIndex(0);
+        this->d->m_lastFrame = frames;
+
+        return packet;
+    }
+
+    return {};
+}
+
+AkVideoCaps ShmFrameRing::caps() const
+{
+    if (!this->d->m_data)
+        return {};
+
+    auto header = this->d->header();
+    auto frames = header->frames.load(std::memory_order_acquire);
+
+    if (frames < 1)
+        return {};
+
+    auto slot = this->d->slotHeader(frames - 1);
+    auto sequence = slot->sequence.load(std::memory_order_acquire);
+    ShmFrameInfo info;
+    memcpy(&info, &slot->info, sizeof(ShmFrameInfo));
+    std::atomic_thread_fence(std::memory_order_acquire);
+
+    if ((sequence & 1)
+        || slot->sequence.load(std::memory_order_relaxed) != sequence
+        || !ShmFrameRingPrivate::isValid(info, header->slotSize))
+        return {};
+
+    return AkVideoCaps(AkVideoCaps::PixelFormat(info.format),
+                       info.width,
+                       info.height,
+                       {info.fpsNum, info.fpsDen});
+}
+
+bool ShmFrameRing::waitFrame(int timeout)
+{
+    if (!this->d->m_data || this->d->m_isWriter)
+        return false;
+
+    auto header = this->d->header();
+
+#ifdef Q_OS_LINUX
+    auto counter = header->frameCounter.load(std::memory_order_acquire);
+
+    if (header->frames.load(std::memory_order_acquire) != this->d->m_lastFrame)
+        return true;
+
+    if (header->stale.load(std::memory_order_acquire))
+        return false;
+
+    header->waiters.fetch_add(1);
+    struct timespec ts {timeout / 1000, 1000000L * (timeout % 1000)};
+
+    // The futex word is in a shared mapping, so it can't be private.
+    syscall(SYS_futex,
+            reinterpret_cast<quint32 *>(&header->frameCounter),
+            FUTEX_WAIT,
+            counter,
+            &ts,
+            nullptr,
+            0);
+    header->waiters.fetch_sub(1);
+#else
+    QElapsedTimer timer;
+    timer.start();
+
+    while (header->frames.load(std::memory_order_acquire) == this->d->m_lastFrame
+           && !header->stale.load(std::memory_order_acquire)
+           && timer.elapsed() < timeout)
+        QThread::msleep(1);
+#endif
+
+    return header->frames.load(std::memory_order_acquire) != this->d->m_lastFrame;
+}
+
+QString ShmFrameRing::objectName(const QString &name)
+{
+    return QString("/webcamoid-%1").arg(name);
+}
+
+size_t ShmFrameRing::frameSize(const AkVideoCaps &caps)
+{
+    AkVideoPacket layout(caps);
+    size_t size = 0;
+
+    for (size_t plane = 0; plane < layout.planes(); ++plane)
+        size += layout.planeSize(plane);
+
+    return size;
+}
+
+ShmFrameRingHeader *ShmFrameRingPrivate::header() const
+{
+    return reinterpret_cast<ShmFrameRingHeader *>(this->m_data);
+}
+
+ShmFrameSlotHeader *ShmFrameRingPrivate::slotHeader(quint64 frame) const
+{
+    auto header = this->header();
+    auto slotHeaders =
+            reinterpret_cast<ShmFrameSlotHeader *>(this->m_data
+                                                   + sizeof(ShmFrameRingHeader));
+
+    return slotHeaders + frame % header->slotCount;
+}
+
+quint8 *ShmFrameRingPrivate::slotData(quint64 frame) const
+{
+    auto header = this->header();
+
+    return this->m_data
+           + header->dataOffset
+           + (frame % header->slotCount) * header->slotSize;
+}
+
+void ShmFrameRingPrivate::updateLayout(const AkVideoCaps &caps)
+{
+    this->m_layoutCaps = caps;
+    AkVideoPacket layout(caps);
+    this->m_planes = int(layout.planes());
+    this->m_frameSize = 0;
+
+    for (int plane = 0;
+         plane < qMin(this->m_planes, SHM_FRAME_RING_MAX_PLANES);
+         ++plane) {
+        this->m_lineSize[plane] = layout.lineSize(plane);
+        this->m_planeOffset[plane] = this->m_frameSize;
+        this->m_frameSize += layout.planeSize(plane);
+    }
+}
+
+bool ShmFrameRingPrivate::map(size_t size)
+{
+    // The readers also write to the ring header to register as waiters.
+    auto data = mmap(nullptr,
+                     size,
+                     PROT_READ | PROT_WRITE,
+                     MAP_SHARED,
+                     this->m_fd,
+                     0);
+
+    if (data == MAP_FAILED)
+        return false;
+
+    this->m_data = reinterpret_cast<quint8 *>(data);
+    this->m_size = size;
+
+    return true;
+}
+
+void ShmFrameRingPrivate::unmap()
+{
+    if (this->m_data)
+        munmap(this->m_data, this->m_size);
+
+    this->m_data = nullptr;
+    this->m_size = 0;
+}
+
+void ShmFrameRingPrivate::wake()
+{
+    auto header = this->header();
+    header->frameCounter.fetch_add(1);
+
+#ifdef Q_OS_LINUX
+    if (header->waiters.load() > 0)
+        syscall(SYS_futex,
+                reinterpret_cast<quint32 *>(&header->frameCounter),
+                FUTEX_WAKE,
+                INT_MAX,
+                nullptr,
+                nullptr,
+                0);
+#endif
+}
+
+size_t ShmFrameRingPrivate::headerSize(int slotCount)
+{
+    size_t size = sizeof(ShmFrameRingHeader)
+                  + size_t(slotCount) * sizeof(ShmFrameSlotHeader);
+
+    return (size + SHM_FRAME_RING_ALIGN - 1) & ~size_t(SHM_FRAME_RING_ALIGN - 1);
+}
+
+bool ShmFrameRingPrivate::isValid(const ShmFrameInfo &info, size_t slotSize)
+{
+    if (info.width < 1
+        || info.height < 1
+        || info.planes < 1
+        || info.planes > SHM_FRAME_RING_MAX_PLANES
+        || info.dataSize > slotSize)
+        return false;
+
+    auto specs = AkVideoCaps::formatSpecs(AkVideoCaps::PixelFormat(info.format));
+
+    if (specs.planes() != info.planes)
+        return false;
+
+    for (size_t plane = 0; plane < info.planes; ++plane) {
+        auto height = quint64(info.height) >> specs.plane(plane).heightDiv();
+
+        if (info.planeOffset[plane] + info.lineSize[plane] * height > slotSize)
+            return false;
+    }
+
+    return true;
+}
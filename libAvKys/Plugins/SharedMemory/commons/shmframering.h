@@ -0,0 +1,102 @@
+/* Webcamoid, camera capture application.
+ * Copyright (C) 2026  Gonzalo Exequiel Pedone
+ *
+ * Webcamoid is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Webcamoid is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Webcamoid. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Web-Site: http://webcamoid.github.io/
+ */
+
+#ifndef SHMFRAMERING_H
+#define SHMFRAMERING_H
+
+#include <QString>
+
+class ShmFrameRingPrivate;
+class AkVideoCaps;
+class AkVideoPacket;
+
+/* Ring of video frames in a POSIX shared memory object, to pass frames
+ * between processes of the same host.
+ *
+ * The object is named '/webcamoid-<name>' and contains:
+ *
+ *   ShmFrameRingHeader
+ *   ShmFrameSlotHeader[slotCount]
+ *   The frames data, 'slotSize' bytes per slot.
+ *
+ * There is a single writer, and any number of readers. Every slot is
+ * protected by a sequence lock, the sequence is odd while the writer is
+ * filling the slot, so the readers only have to check that the sequence
+ * didn't change while they were reading to know the frame is consistent.
+ * Readers never block the writer, if a reader is too slow it just loses
+ * frames.
+ *
+ * The frames are stored in their native pixel format, with the planes
+ * layout of an AkVideoPacket of the same caps. The header of the slot
+ * contains the caps, the plane offsets and the line sizes, so readers not
+ * using this class can read the frames in place.
+ */
+class ShmFrameRing
+{
+    public:
+        ShmFrameRing();
+        ~ShmFrameRing();
+
+        // Create the ring as the writer, replacing any existing ring with the
+        // same name.
+        bool create(const QString &name, int slotCount, size_t slotSize);
+
+        // Open an existing ring as a reader.
+        bool open(const QString &name);
+
+        void close();
+        bool isOpen() const;
+        bool isWriter() const;
+
+        // True if the writer closed or replaced the ring, the readers must
+        // open it again.
+        bool isStale() const;
+
+        // True if the name now points to another ring, this happens when a
+        // writer didn't close the ring cleanly.
+        bool isReplaced() const;
+
+        QString name() const;
+        int slotCount() const;
+        size_t slotSize() const;
+
+        // Returns false if the frame doesn't fit in a slot.
+        bool write(const AkVideoPacket &packet);
+
+        // Returns the most recent frame newer than the last read frame, or
+        // an empty packet if there is no new frame.
+        AkVideoPacket read();
+
+        // Caps of the last written frame.
+        AkVideoCaps caps() const;
+
+        // Wait until a frame newer than the last read frame is written, or
+        // 'timeout' milliseconds passed.
+        bool waitFrame(int timeout);
+
+        static QString objectName(const QString &name);
+
+        // Size of a slot able to hold a frame of the given caps.
+        static size_t frameSize(const AkVideoCaps &caps);
+
+    private:
+        ShmFrameRingPrivate *d;
+};
+
+#endif // SHMFRAMERING_H
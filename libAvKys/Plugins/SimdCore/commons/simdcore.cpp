@@ -124,6 +124,19 @@
         #define SIMD_ALIGN        AKSIMDSCALARI32_ALIGN
 #endif
 
+// Native width kernels for contiguous 8 bits layouts, they need the SSSE3
+// byte shuffles, so use them in the builds that have them.
+
+#if defined(AKSIMD_USE_SSE4_1) || defined(AKSIMD_USE_AVX2)
+        #include <simd/aksse4_1.h>
+
+        #define AKSIMD_PACKED_KERNELS
+
+        using SimdTypeI8 = AkSimdSSE4_1I8;
+        using SimdTypeI16 = AkSimdSSE4_1I16;
+        using SimdTypeI32 = AkSimdSSE4_1I32;
+#endif
+
 class DrawParameters
 {
     public:
@@ -165,6 +178,10 @@ class ConvertParameters
 
             this->colorShift = colorShift;
             this->alphaShift = alphaShift;
+
+#ifdef AKSIMD_PACKED_KERNELS
+            this->loadPackedMatrix();
+#endif
         }
 
 #define M(index) \
@@ -264,7 +281,869 @@ class ConvertParameters
         {
             this->applyAlpha(*p, a, p);
         }
+
+#ifdef AKSIMD_PACKED_KERNELS
+        // Matrix in the layout used by the packed kernels, only valid if
+        // packed16 is true.
+
+        bool packed16 {false};
+        SimdTypeI16::VectorType pm01[3];
+        SimdTypeI16::VectorType pm2[3];
+        SimdTypeI32::VectorType pm3[3];
+        SimdTypeI16::VectorType pvmin[3];
+        SimdTypeI16::VectorType pvmax[3];
+
+        inline void loadPackedMatrix()
+        {
+            // The products are accumulated in 32 bits, so the factors must
+            // fit in 16 bits and the offsets leave room for the sums.
+
+            this->packed16 = this->colorShift < 31;
+
+            for (int i = 0; i < 3; ++i) {
+                auto row = this->m + 4 * i;
+
+                for (int j = 0; j < 3; ++j)
+                    if (row[j] < -32768 || row[j] > 32767)
+                        this->packed16 = false;
+
+                if (row[3] < -(1 << 30) || row[3] > (1 << 30))
+                    this->packed16 = false;
+
+                if (this->vmin[i] < 0 || this->vmax[i] > 255)
+                    this->packed16 = false;
+            }
+
+            if (!this->packed16)
+                return;
+
+            SimdTypeI16 s16;
+            SimdTypeI32 s32;
+
+            for (int i = 0; i < 3; ++i) {
+                auto row = this->m + 4 * i;
+                auto m0 = quint32(quint16(qint16(row[0])));
+                auto m1 = quint32(quint16(qint16(row[1])));
+                auto m2 = quint32(quint16(qint16(row[2])));
+
+                // madd multiplies the interleaved (a, b) and (c, 0) pairs.
+                this->pm01[i] = s32.load(qint32(m0 | (m1 << 16)));
+                this->pm2[i] = s32.load(qint32(m2));
+                this->pm3[i] = s32.load(qint32(row[3]));
+                this->pvmin[i] = s16.load(qint16(this->vmin[i]));
+                this->pvmax[i] = s16.load(qint16(this->vmax[i]));
+            }
+        }
+
+        inline SimdTypeI16::VectorType applyPackedRow(int row,
+                                                      SimdTypeI16::VectorType ab0,
+                                                      SimdTypeI16::VectorType ab1,
+                                                      SimdTypeI16::VectorType c0,
+                                                      SimdTypeI16::VectorType c1) const
+        {
+            SimdTypeI16 s16;
+            SimdTypeI32 s32;
+
+            auto p0 = s32.add(s32.add(s16.madd(ab0, this->pm01[row]),
+                                      s16.madd(c0, this->pm2[row])),
+                              this->pm3[row]);
+            auto p1 = s32.add(s32.add(s16.madd(ab1, this->pm01[row]),
+                                      s16.madd(c1, this->pm2[row])),
+                              this->pm3[row]);
+
+            return s16.bound(this->pvmin[row],
+                             s16.pack(s32.shr(p0, this->colorShift),
+                                      s32.shr(p1, this->colorShift)),
+                             this->pvmax[row]);
+        }
+
+        // Convert 16 pixels at once, the input and the output are 8 bits
+        // vectors.
+        inline void applyPackedMatrix(SimdTypeI8::VectorType a,
+                                      SimdTypeI8::VectorType b,
+                                      SimdTypeI8::VectorType c,
+                                      SimdTypeI8::VectorType *x,
+                                      SimdTypeI8::VectorType *y,
+                                      SimdTypeI8::VectorType *z) const
+        {
+            SimdTypeI8 s8;
+            SimdTypeI16 s16;
+            auto zero = s16.load(qint16(0));
+            SimdTypeI16::VectorType o[3][2];
+
+            for (int half = 0; half < 2; ++half) {
+                auto a16 = half? s8.widenHigh(a): s8.widenLow(a);
+                auto b16 = half? s8.widenHigh(b): s8.widenLow(b);
+                auto c16 = half? s8.widenHigh(c): s8.widenLow(c);
+
+                auto ab0 = s16.unpackLow(a16, b16);
+                auto ab1 = s16.unpackHigh(a16, b16);
+                auto c0 = s16.unpackLow(c16, zero);
+                auto c1 = s16.unpackHigh(c16, zero);
+
+                for (int row = 0; row < 3; ++row)
+                    o[row][half] = this->applyPackedRow(row, ab0, ab1, c0, c1);
+            }
+
+            *x = s8.pack(o[0][0], o[0][1]);
+            *y = s8.pack(o[1][0], o[1][1]);
+            *z = s8.pack(o[2][0], o[2][1]);
+        }
+#endif
+};
+
+#ifdef AKSIMD_PACKED_KERNELS
+// Describes where the bytes of a component are placed inside a line, for
+// formats without scaling where the component of the pixel x is at
+// (x >> widthDiv) * step. The component of 16 consecutive pixels (or 8 for
+// 16 bits components) is gathered with a few contiguous loads and byte
+// shuffles.
+
+#define PACKED_PIXELS  16
+#define PACKED_CHUNKS  4
+
+class PackedComponent
+{
+    public:
+        SimdTypeI8::VectorType masks[PACKED_CHUNKS];
+        SimdTypeI8::VectorType selects[PACKED_CHUNKS];
+        int chunks {0};
+        int step {0};
+        int widthDiv {0};
+        int size {1};
+
+        // 'size' is the size in bytes of the component, the bytes of the
+        // pixel n are the bytes [size * n, size * n + size) of the vector.
+        inline bool setup(int step,
+                          int widthDiv,
+                          bool store,
+                          int pixels=PACKED_PIXELS,
+                          int size=1)
+        {
+            if (step < 1 || widthDiv < 0 || widthDiv > 1)
+                return false;
+
+            // A component can't be split between two chunks.
+            if (size < 1 || size > 2 || step % size || pixels * size > 16)
+                return false;
+
+            auto span = ((pixels - 1) >> widthDiv) * step + size;
+
+            if (span > PACKED_CHUNKS * 16)
+                return false;
+
+            this->step = step;
+            this->widthDiv = widthDiv;
+            this->size = size;
+            this->chunks = (span + 15) / 16;
+
+            alignas(16) quint8 masks[PACKED_CHUNKS][16];
+            alignas(16) quint8 selects[PACKED_CHUNKS][16];
+            memset(masks, 0x80, sizeof(masks));
+            memset(selects, 0, sizeof(selects));
+
+            for (int pixel = 0; pixel < pixels; ++pixel) {
+                auto pos = (pixel >> widthDiv) * step;
+                auto chunk = pos / 16;
+
+                for (int byte = 0; byte < size; ++byte) {
+                    if (store) {
+                        // Subsampled components are shared by consecutive
+                        // pixels, keep the last one as the scalar code does.
+                        masks[chunk][pos % 16 + byte] = quint8(size * pixel + byte);
+                        selects[chunk][pos % 16 + byte] = 0xff;
+                    } else {
+                        // A pixel can only be read from one chunk.
+                        masks[chunk][size * pixel + byte] = quint8(pos % 16 + byte);
+                    }
+                }
+            }
+
+            SimdTypeI8 s8;
+
+            for (int chunk = 0; chunk < this->chunks; ++chunk) {
+                this->masks[chunk] = s8.load(masks[chunk]);
+                this->selects[chunk] = s8.load(selects[chunk]);
+            }
+
+            return true;
+        }
+
+        inline int offset(int x) const
+        {
+            return (x >> this->widthDiv) * this->step;
+        }
+
+        // The pattern only repeats from pixels multiple of the subsampling.
+        inline bool isAligned(int x) const
+        {
+            return (x & ((1 << this->widthDiv) - 1)) == 0;
+        }
+
+        // Check that the chunks read or written for the pixels starting at
+        // x do not go beyond the last component of the line.
+        inline bool fits(int x, int xmax) const
+        {
+            return this->offset(x) + 16 * this->chunks
+                   <= this->offset(xmax - 1) + this->size;
+        }
+
+        inline SimdTypeI8::VectorType read(const quint8 *line, int x) const
+        {
+            SimdTypeI8 s8;
+            auto data = line + this->offset(x);
+            auto result = s8.shuffle(s8.loadu(data), this->masks[0]);
+
+            for (int chunk = 1; chunk < this->chunks; ++chunk)
+                result = s8.bitOr(result,
+                                  s8.shuffle(s8.loadu(data + 16 * chunk),
+                                             this->masks[chunk]));
+
+            return result;
+        }
+
+        inline void write(quint8 *line, int x, SimdTypeI8::VectorType value) const
+        {
+            SimdTypeI8 s8;
+            auto data = line + this->offset(x);
+
+            for (int chunk = 0; chunk < this->chunks; ++chunk) {
+                auto chunkData = data + 16 * chunk;
+                s8.storeu(chunkData,
+                          s8.blend(s8.loadu(chunkData),
+                                   s8.shuffle(value, this->masks[chunk]),
+                                   this->selects[chunk]));
+            }
+        }
+};
+
+// Components of a conversion for the packed kernels, the masks are built
+// once when the converter is configured.
+class PackedLayout
+{
+    public:
+        PackedComponent xi;
+        PackedComponent yi;
+        PackedComponent zi;
+        PackedComponent ai;
+        PackedComponent xo;
+        PackedComponent yo;
+        PackedComponent zo;
+        PackedComponent ao;
+        int pixels {PACKED_PIXELS};
+        bool hasAlphaIn {false};
+        bool hasAlpha {false};
+
+        // The layouts are {step, widthDiv} pairs for X, Y, Z and A. The
+        // 1 component inputs only need X.
+        inline bool setup(const int *srcLayout,
+                          const int *dstLayout,
+                          int pixels=PACKED_PIXELS,
+                          int inputSize=1,
+                          int outputSize=1,
+                          int inputComponents=3)
+        {
+            this->pixels = pixels;
+            PackedComponent *inputs[] {&this->xi, &this->yi, &this->zi};
+            PackedComponent *outputs[] {&this->xo, &this->yo, &this->zo};
+
+            for (int i = 0; i < 3; ++i) {
+                if (i < inputComponents
+                    && !inputs[i]->setup(srcLayout[2 * i],
+                                         srcLayout[2 * i + 1],
+                                         false,
+                                         pixels,
+                                         inputSize))
+                    return false;
+
+                if (!outputs[i]->setup(dstLayout[2 * i],
+                                       dstLayout[2 * i + 1],
+                                       true,
+                                       pixels,
+                                       outputSize))
+                    return false;
+            }
+
+            this->hasAlphaIn = this->ai.setup(srcLayout[6],
+                                              srcLayout[7],
+                                              false,
+                                              pixels,
+                                              inputSize);
+            this->hasAlpha = this->ao.setup(dstLayout[6],
+                                            dstLayout[7],
+                                            true,
+                                            pixels,
+                                            outputSize);
+
+            return true;
+        }
+
+        // The input components that were not set up have no chunks, so they
+        // pass the checks.
+        inline bool isAligned(int x) const
+        {
+            return this->xi.isAligned(x)
+                   && this->yi.isAligned(x)
+                   && this->zi.isAligned(x)
+                   && (!this->hasAlphaIn || this->ai.isAligned(x))
+                   && this->xo.isAligned(x)
+                   && this->yo.isAligned(x)
+                   && this->zo.isAligned(x)
+                   && (!this->hasAlpha || this->ao.isAligned(x));
+        }
+
+        inline bool fits(int x, int xmax) const
+        {
+            return this->xi.fits(x, xmax)
+                   && this->yi.fits(x, xmax)
+                   && this->zi.fits(x, xmax)
+                   && (!this->hasAlphaIn || this->ai.fits(x, xmax))
+                   && this->xo.fits(x, xmax)
+                   && this->yo.fits(x, xmax)
+                   && this->zo.fits(x, xmax)
+                   && (!this->hasAlpha || this->ao.fits(x, xmax));
+        }
+};
+
+// Parameters of the kernels for 16 bits inputs (P010, P016, Y210, RGB48,
+// RGBA64, Y16, etc.). The components are read from 16 bits words with their
+// shift and mask, and written to 8 or 16 bits words.
+//
+// 'layout' contains, in this order: the shifts (4) and the masks (4) of the
+// input components, the shifts (4) and the masks (4) of the output
+// components, the alpha mask, the output depth, and the {step, widthDiv}
+// pairs of the input (4) and the output (4) components. The components are
+// in X, Y, Z, A order.
+class ConvertParameters16bits
+{
+    public:
+        int inputShift[4];
+        quint16 inputMask[4];
+        int inputBits[4];
+        int outputShift[4];
+        quint16 outputMask[4];
+        quint16 alphaMask;
+        int outputDepth;
+        PackedLayout packed;
+
+        // Fixed point matrix, see fitMatrix().
+        qint32 k[3][3];
+        qint32 koffset[3];
+        qint32 kalphaPoint[3];
+        qint32 kalphaRounding[3];
+        qint32 vmin[3];
+        qint32 vmax[3];
+        int shift {0};
+        bool hasAlpha {false};
+
+        ConvertParameters16bits(const qint64 *layout)
+        {
+            for (int i = 0; i < 4; ++i) {
+                this->inputShift[i] = int(layout[i]);
+                this->inputMask[i] = quint16(layout[4 + i]);
+                this->inputBits[i] = 0;
+
+                while (this->inputBits[i] < 16
+                       && (this->inputMask[i] >> this->inputBits[i]) & 1)
+                    ++this->inputBits[i];
+
+                this->outputShift[i] = int(layout[8 + i]);
+                this->outputMask[i] = quint16(layout[12 + i]);
+            }
+
+            this->alphaMask = quint16(layout[16]);
+            this->outputDepth = int(layout[17]);
+            this->hasAlpha = this->inputMask[3] != 0;
+        }
+
+        inline bool setupLayout(const qint64 *layout)
+        {
+            // The vectors are written whole, so the output components can't
+            // share their words with other components.
+            quint16 typeMask = this->outputDepth == 16? 0xffff: 0xff;
+
+            for (int i = 0; i < 3; ++i)
+                if (this->outputShift[i] != 0
+                    || (this->outputMask[i] & typeMask) != 0)
+                    return false;
+
+            // Same for the alpha of the output, if any.
+            if (this->alphaMask != 0 && (this->alphaMask & typeMask) != typeMask)
+                return false;
+
+            // The alpha is expanded to 15 bits by repeating its bits.
+            if (this->hasAlpha && this->inputBits[3] < 8)
+                return false;
+
+            int srcLayout[8];
+            int dstLayout[8];
+
+            for (int i = 0; i < 8; ++i) {
+                srcLayout[i] = int(layout[18 + i]);
+                dstLayout[i] = int(layout[26 + i]);
+            }
+
+            if (!this->packed.setup(srcLayout,
+                                    dstLayout,
+                                    8,
+                                    2,
+                                    this->outputDepth / 8,
+                                    this->inputMask[1]? 3: 1))
+                return false;
+
+            return !this->hasAlpha || this->packed.hasAlphaIn;
+        }
+
+        static inline qint64 scaleRound(qint64 value, int exp)
+        {
+            if (exp >= 0)
+                return value * (qint64(1) << exp);
+
+            return (value + (qint64(1) << (-exp - 1))) >> -exp;
+        }
+
+        /* Convert the matrix to the fixed point format of the kernels, with
+         * the inputs aligned to the top of the 16 bits words:
+         *
+         * - With 8 bits outputs the products are the high half of 16x16
+         *   bits products (mulhi), and the sums are kept in 16 bits with
+         *   'shift' fractional bits. The alpha is applied to the rounded
+         *   value, as a Q15 product (mulhrs).
+         * - With 16 bits outputs the products are accumulated in 32 bits
+         *   (madd), the inputs are biased to fit in signed 16 bits.
+         *
+         * The vectors and the scalar tail of a line use these same numbers,
+         * so a pixel gives the same result wherever it is. Return false if
+         * the matrix can't be represented with enough precision.
+         */
+        inline bool fitMatrix(const qint64 *m,
+                              const qint64 *am,
+                              const qint64 *minValues,
+                              const qint64 *maxValues,
+                              int colorShift,
+                              int alphaShift)
+        {
+            qint64 typeMax = this->outputDepth == 16? 0xffff: 0xff;
+
+            for (int i = 0; i < 3; ++i) {
+                if (minValues[i] < 0 || maxValues[i] > typeMax)
+                    return false;
+
+                this->vmin[i] = qint32(minValues[i]);
+                this->vmax[i] = qint32(maxValues[i]);
+            }
+
+            if (this->outputDepth == 16) {
+                // The alpha would need 32 bits products.
+                if (this->hasAlpha)
+                    return false;
+
+                for (int q = 30; q >= 0; --q)
+                    if (this->fitMatrix32(m, colorShift, q))
+                        return true;
+
+                return false;
+            }
+
+            for (int q = 14; q > 0; --q)
+                if (this->fitMatrix16(m, am, colorShift, alphaShift, q))
+                    return true;
+
+            return false;
+        }
+
+        inline bool fitMatrix16(const qint64 *m,
+                                const qint64 *am,
+                                int colorShift,
+                                int alphaShift,
+                                int q)
+        {
+            static const qint64 maxI16 = 32767;
+
+            for (int i = 0; i < 3; ++i) {
+                auto row = m + 4 * i;
+                qint64 span = 0;
+                int terms = 0;
+
+                for (int j = 0; j < 3; ++j) {
+                    auto c = scaleRound(row[j], 1 + q + this->inputBits[j] - colorShift);
+
+                    if (qAbs(c) > maxI16)
+                        return false;
+
+                    this->k[i][j] = qint32(c);
+                    span += (qAbs(c) * maxI16 + 0xffff) >> 16;
+
+                    if (c)
+                        terms++;
+                }
+
+                // mulhi truncates, add the average of the dropped bits.
+                auto offset = scaleRound(row[3], q - colorShift) + terms / 2;
+
+                if (qAbs(offset) + span > maxI16
+                    || (qint64(this->vmax[i]) << q) > maxI16)
+                    return false;
+
+                this->koffset[i] = qint32(offset);
+
+                if (!this->hasAlpha)
+                    continue;
+
+                // xa = a * (x * a00 + a01) + a02, with a00 ~= 1 / amax.
+                auto arow = am + 3 * i;
+
+                if (arow[0] < 1)
+                    return false;
+
+                auto point = scaleRound(arow[1], q) / arow[0];
+                auto rounding = scaleRound(arow[2], q - alphaShift);
+                auto range = (qint64(this->vmax[i]) << q) + qAbs(point);
+
+                if (range > maxI16 || range + qAbs(rounding) > maxI16)
+                    return false;
+
+                this->kalphaPoint[i] = qint32(point);
+                this->kalphaRounding[i] = qint32(rounding);
+            }
+
+            this->shift = q;
+            this->loadPackedMatrix();
+
+            return true;
+        }
+
+        inline bool fitMatrix32(const qint64 *m, int colorShift, int q)
+        {
+            static const qint64 maxI16 = 32767;
+            static const qint64 maxI32 = 0x7fffffff;
+
+            for (int i = 0; i < 3; ++i) {
+                auto row = m + 4 * i;
+                qint64 span = 0;
+                qint64 bias = 0;
+
+                for (int j = 0; j < 3; ++j) {
+                    auto c = scaleRound(row[j], q + this->inputBits[j] - colorShift - 16);
+
+                    if (qAbs(c) > maxI16)
+                        return false;
+
+                    this->k[i][j] = qint32(c);
+                    span += qAbs(c) * 0x8000;
+                    bias += c * 0x8000;
+                }
+
+                auto offset = scaleRound(row[3], q - colorShift) + bias;
+
+                if (qAbs(offset) + span > maxI32)
+                    return false;
+
+                this->koffset[i] = qint32(offset);
+            }
+
+            this->shift = q;
+            this->loadPackedMatrix();
+
+            return true;
+        }
+
+        // Read a component, aligned to the top of the word.
+        inline quint16 read(int component, const quint8 *data) const
+        {
+            auto value = *reinterpret_cast<const quint16 *>(data);
+            value = (value >> this->inputShift[component])
+                    & this->inputMask[component];
+
+            return quint16(value << (16 - this->inputBits[component]));
+        }
+
+        inline qint32 clamp(int component, qint32 value) const
+        {
+            return qBound(this->vmin[component], value, this->vmax[component]);
+        }
+
+        // Scalar versions of the vector operations.
+
+        static inline qint32 mulhi(qint32 a, qint32 b)
+        {
+            return (a * b) >> 16;
+        }
+
+        static inline qint32 mulhrs(qint32 a, qint32 b)
+        {
+            return (a * b + 0x4000) >> 15;
+        }
+
+        inline void applyMatrix(const quint16 *u, qint32 *o) const
+        {
+            if (this->outputDepth == 16) {
+                for (int i = 0; i < 3; ++i) {
+                    qint32 sum = this->koffset[i];
+
+                    for (int j = 0; j < 3; ++j)
+                        sum += (qint32(u[j]) - 0x8000) * this->k[i][j];
+
+                    o[i] = this->clamp(i, sum >> this->shift);
+                }
+            } else {
+                for (int i = 0; i < 3; ++i) {
+                    qint32 sum = mulhi(u[0] >> 1, this->k[i][0])
+                                 + mulhi(u[1] >> 1, this->k[i][1])
+                                 + mulhi(u[2] >> 1, this->k[i][2])
+                                 + this->koffset[i];
+                    o[i] = this->clamp(i, sum >> this->shift);
+                }
+            }
+        }
+
+        inline void applyPoint(quint16 u, qint32 *o) const
+        {
+            for (int i = 0; i < 3; ++i) {
+                qint32 sum = this->outputDepth == 16?
+                                 (qint32(u) - 0x8000) * this->k[i][0]:
+                                 mulhi(u >> 1, this->k[i][0]);
+                o[i] = this->clamp(i, (sum + this->koffset[i]) >> this->shift);
+            }
+        }
+
+        inline qint32 alpha15(quint16 ua) const
+        {
+            return qint32(ua | (ua >> this->inputBits[3])) >> 1;
+        }
+
+        inline void applyMatrixAlpha(const quint16 *u, quint16 ua, qint32 *o) const
+        {
+            auto a = this->alpha15(ua);
+
+            this->applyMatrix(u, o);
+
+            for (int i = 0; i < 3; ++i) {
+                auto sum = mulhrs((o[i] << this->shift) + this->kalphaPoint[i], a)
+                           + this->kalphaRounding[i];
+                o[i] = this->clamp(i, sum >> this->shift);
+            }
+        }
+
+        template <typename OutputType>
+        inline void write(int component, quint8 *data, qint32 value) const
+        {
+            auto out = reinterpret_cast<OutputType *>(data);
+            *out = OutputType((*out & OutputType(this->outputMask[component]))
+                              | (OutputType(value) << this->outputShift[component]));
+        }
+
+        template <typename OutputType>
+        inline void writeAlpha(quint8 *data) const
+        {
+            auto out = reinterpret_cast<OutputType *>(data);
+            *out = *out | OutputType(this->alphaMask);
+        }
+
+        // Vector versions, 8 pixels at once.
+
+        SimdTypeI16::VectorType pk[3][3];
+        SimdTypeI32::VectorType pk01[3];
+        SimdTypeI32::VectorType pk2[3];
+        SimdTypeI16::VectorType poffset[3];
+        SimdTypeI32::VectorType poffset32[3];
+        SimdTypeI16::VectorType palphaPoint[3];
+        SimdTypeI16::VectorType palphaRounding[3];
+        SimdTypeI16::VectorType pvmin[3];
+        SimdTypeI16::VectorType pvmax[3];
+        SimdTypeI32::VectorType pvmin32[3];
+        SimdTypeI32::VectorType pvmax32[3];
+        SimdTypeI16::VectorType pinputMask[4];
+
+        inline void loadPackedMatrix()
+        {
+            SimdTypeI16 s16;
+            SimdTypeI32 s32;
+
+            for (int i = 0; i < 3; ++i) {
+                for (int j = 0; j < 3; ++j)
+                    this->pk[i][j] = s16.load(qint16(this->k[i][j]));
+
+                // madd multiplies the interleaved (a, b) and (c, 0) pairs.
+                auto k0 = quint32(quint16(qint16(this->k[i][0])));
+                auto k1 = quint32(quint16(qint16(this->k[i][1])));
+                auto k2 = quint32(quint16(qint16(this->k[i][2])));
+                this->pk01[i] = s32.load(qint32(k0 | (k1 << 16)));
+                this->pk2[i] = s32.load(qint32(k2));
+
+                this->poffset[i] = s16.load(qint16(this->koffset[i]));
+                this->poffset32[i] = s32.load(this->koffset[i]);
+                this->pvmin[i] = s16.load(qint16(this->vmin[i]));
+                this->pvmax[i] = s16.load(qint16(this->vmax[i]));
+                this->pvmin32[i] = s32.load(this->vmin[i]);
+                this->pvmax32[i] = s32.load(this->vmax[i]);
+
+                if (this->hasAlpha) {
+                    this->palphaPoint[i] = s16.load(qint16(this->kalphaPoint[i]));
+                    this->palphaRounding[i] = s16.load(qint16(this->kalphaRounding[i]));
+                }
+            }
+
+            for (int i = 0; i < 4; ++i)
+                this->pinputMask[i] =
+                        s16.load(qint16(quint16(this->inputMask[i]
+                                                << (16 - this->inputBits[i]))));
+        }
+
+        // Read the component of 8 pixels, aligned to the top of the words.
+        inline SimdTypeI16::VectorType readPacked(int component,
+                                                  const PackedComponent &packed,
+                                                  const quint8 *line,
+                                                  int x) const
+        {
+            SimdTypeI16 s16;
+            auto words = packed.read(line, x);
+            int shift = 16 - this->inputBits[component] - this->inputShift[component];
+
+            if (shift > 0)
+                words = s16.shl(words, size_t(shift));
+
+            return s16.bitAnd(words, this->pinputMask[component]);
+        }
+
+        inline SimdTypeI16::VectorType clampRow(int row,
+                                                SimdTypeI16::VectorType sum) const
+        {
+            SimdTypeI16 s16;
+
+            return s16.bound(this->pvmin[row],
+                             s16.shr(sum, size_t(this->shift)),
+                             this->pvmax[row]);
+        }
+
+        // Convert the values of a row to the output bytes, they are in the
+        // low half of the vector.
+        inline SimdTypeI16::VectorType packRow(int row,
+                                               SimdTypeI16::VectorType sum) const
+        {
+            SimdTypeI8 s8;
+            auto value = this->clampRow(row, sum);
+
+            return s8.pack(value, value);
+        }
+
+        inline SimdTypeI16::VectorType packRow32(int row,
+                                                 SimdTypeI32::VectorType sum0,
+                                                 SimdTypeI32::VectorType sum1) const
+        {
+            SimdTypeI16 s16;
+            SimdTypeI32 s32;
+            sum0 = s32.bound(this->pvmin32[row],
+                             s32.shr(s32.add(sum0, this->poffset32[row]),
+                                     size_t(this->shift)),
+                             this->pvmax32[row]);
+            sum1 = s32.bound(this->pvmin32[row],
+                             s32.shr(s32.add(sum1, this->poffset32[row]),
+                                     size_t(this->shift)),
+                             this->pvmax32[row]);
+
+            return s16.packu(sum0, sum1);
+        }
+
+        inline SimdTypeI16::VectorType sumRow(int row,
+                                              SimdTypeI16::VectorType a,
+                                              SimdTypeI16::VectorType b,
+                                              SimdTypeI16::VectorType c) const
+        {
+            SimdTypeI16 s16;
+
+            return s16.add(s16.add(s16.mulhi(a, this->pk[row][0]),
+                                   s16.mulhi(b, this->pk[row][1])),
+                           s16.mulhi(c, this->pk[row][2]));
+        }
+
+        inline void applyPackedMatrix(SimdTypeI16::VectorType ux,
+                                      SimdTypeI16::VectorType uy,
+                                      SimdTypeI16::VectorType uz,
+                                      SimdTypeI16::VectorType *o) const
+        {
+            SimdTypeI16 s16;
+
+            if (this->outputDepth == 16) {
+                auto bias = s16.load(qint16(-0x8000));
+                auto zero = s16.load(qint16(0));
+                auto a = s16.bitXor(ux, bias);
+                auto b = s16.bitXor(uy, bias);
+                auto c = s16.bitXor(uz, bias);
+                auto ab0 = s16.unpackLow(a, b);
+                auto ab1 = s16.unpackHigh(a, b);
+                auto c0 = s16.unpackLow(c, zero);
+                auto c1 = s16.unpackHigh(c, zero);
+                SimdTypeI32 s32;
+
+                for (int row = 0; row < 3; ++row)
+                    o[row] = this->packRow32(row,
+                                             s32.add(s16.madd(ab0, this->pk01[row]),
+                                                     s16.madd(c0, this->pk2[row])),
+                                             s32.add(s16.madd(ab1, this->pk01[row]),
+                                                     s16.madd(c1, this->pk2[row])));
+            } else {
+                auto a = s16.shrl(ux, 1);
+                auto b = s16.shrl(uy, 1);
+                auto c = s16.shrl(uz, 1);
+
+                for (int row = 0; row < 3; ++row)
+                    o[row] = this->packRow(row,
+                                           s16.add(this->sumRow(row, a, b, c),
+                                                   this->poffset[row]));
+            }
+        }
+
+        inline void applyPackedPoint(SimdTypeI16::VectorType u,
+                                     SimdTypeI16::VectorType *o) const
+        {
+            SimdTypeI16 s16;
+
+            if (this->outputDepth == 16) {
+                auto zero = s16.load(qint16(0));
+                auto a = s16.bitXor(u, s16.load(qint16(-0x8000)));
+                auto a0 = s16.unpackLow(a, zero);
+                auto a1 = s16.unpackHigh(a, zero);
+
+                for (int row = 0; row < 3; ++row)
+                    o[row] = this->packRow32(row,
+                                             s16.madd(a0, this->pk01[row]),
+                                             s16.madd(a1, this->pk01[row]));
+            } else {
+                auto a = s16.shrl(u, 1);
+
+                for (int row = 0; row < 3; ++row)
+                    o[row] = this->packRow(row,
+                                           s16.add(s16.mulhi(a, this->pk[row][0]),
+                                                   this->poffset[row]));
+            }
+        }
+
+        inline void applyPackedMatrixAlpha(SimdTypeI16::VectorType ux,
+                                           SimdTypeI16::VectorType uy,
+                                           SimdTypeI16::VectorType uz,
+                                           SimdTypeI16::VectorType ua,
+                                           SimdTypeI16::VectorType *o) const
+        {
+            SimdTypeI16 s16;
+            auto a = s16.shrl(ux, 1);
+            auto b = s16.shrl(uy, 1);
+            auto c = s16.shrl(uz, 1);
+            auto alpha = s16.shrl(s16.bitOr(ua, s16.shrl(ua, size_t(this->inputBits[3]))), 1);
+
+            for (int row = 0; row < 3; ++row) {
+                auto value = this->clampRow(row,
+                                            s16.add(this->sumRow(row, a, b, c),
+                                                    this->poffset[row]));
+                value = s16.add(s16.shl(value, size_t(this->shift)),
+                                this->palphaPoint[row]);
+                o[row] = this->packRow(row,
+                                       s16.add(s16.mulhrs(value, alpha),
+                                               this->palphaRounding[row]));
+            }
+        }
 };
+#endif
 
 class SimdCorePrivate
 {
@@ -547,6 +1426,123 @@ class SimdCorePrivate
                                           const quint8 *src_line_a,
                                           quint8 *dst_line_x,
                                           int *x);
+
+#ifdef AKSIMD_PACKED_KERNELS
+        static void *createPackedLayout(const int *srcLayout,
+                                        const int *dstLayout);
+        static void freePackedLayout(void *packedLayout);
+        static void convertFast8bitsPacked3to3(void *convertParameters,
+                                               void *packedLayout,
+                                               int xmax,
+                                               const quint8 *src_line_x,
+                                               const quint8 *src_line_y,
+                                               const quint8 *src_line_z,
+                                               quint8 *dst_line_x,
+                                               quint8 *dst_line_y,
+                                               quint8 *dst_line_z,
+                                               int *x);
+        static void convertFast8bitsPacked3to3A(void *convertParameters,
+                                                void *packedLayout,
+                                                int xmax,
+                                                const quint8 *src_line_x,
+                                                const quint8 *src_line_y,
+                                                const quint8 *src_line_z,
+                                                quint8 *dst_line_x,
+                                                quint8 *dst_line_y,
+                                                quint8 *dst_line_z,
+                                                quint8 *dst_line_a,
+                                                int *x);
+
+        // Optimized convert functions for 16 bits inputs
+
+        static void *createConvertParameters16bits(qint64 *colorMatrix,
+                                                   qint64 *alphaMatrix,
+                                                   qint64 *minValues,
+                                                   qint64 *maxValues,
+                                                   qint64 colorShift,
+                                                   qint64 alphaShift,
+                                                   const qint64 *layout);
+        static void freeConvertParameters16bits(void *convertParameters);
+        static void convertFast16bits3to3(void *convertParameters,
+                                          const int *srcWidthOffsetX,
+                                          const int *srcWidthOffsetY,
+                                          const int *srcWidthOffsetZ,
+                                          const int *dstWidthOffsetX,
+                                          const int *dstWidthOffsetY,
+                                          const int *dstWidthOffsetZ,
+                                          const int *dstWidthOffsetA,
+                                          int xmax,
+                                          const quint8 *src_line_x,
+                                          const quint8 *src_line_y,
+                                          const quint8 *src_line_z,
+                                          quint8 *dst_line_x,
+                                          quint8 *dst_line_y,
+                                          quint8 *dst_line_z,
+                                          quint8 *dst_line_a,
+                                          int *x);
+        static void convertFast16bits3Ato3(void *convertParameters,
+                                           const int *srcWidthOffsetX,
+                                           const int *srcWidthOffsetY,
+                                           const int *srcWidthOffsetZ,
+                                           const int *srcWidthOffsetA,
+                                           const int *dstWidthOffsetX,
+                                           const int *dstWidthOffsetY,
+                                           const int *dstWidthOffsetZ,
+                                           int xmax,
+                                           const quint8 *src_line_x,
+                                           const quint8 *src_line_y,
+                                           const quint8 *src_line_z,
+                                           const quint8 *src_line_a,
+                                           quint8 *dst_line_x,
+                                           quint8 *dst_line_y,
+                                           quint8 *dst_line_z,
+                                           int *x);
+        static void convertFast16bits1to3(void *convertParameters,
+                                          const int *srcWidthOffsetX,
+                                          const int *dstWidthOffsetX,
+                                          const int *dstWidthOffsetY,
+                                          const int *dstWidthOffsetZ,
+                                          const int *dstWidthOffsetA,
+                                          int xmax,
+                                          const quint8 *src_line_x,
+                                          quint8 *dst_line_x,
+                                          quint8 *dst_line_y,
+                                          quint8 *dst_line_z,
+                                          quint8 *dst_line_a,
+                                          int *x);
+        template <typename OutputType>
+        static void convert16bits3to3(const ConvertParameters16bits *params,
+                                      const int *srcWidthOffsetX,
+                                      const int *srcWidthOffsetY,
+                                      const int *srcWidthOffsetZ,
+                                      const int *dstWidthOffsetX,
+                                      const int *dstWidthOffsetY,
+                                      const int *dstWidthOffsetZ,
+                                      const int *dstWidthOffsetA,
+                                      int xmax,
+                                      const quint8 *src_line_x,
+                                      const quint8 *src_line_y,
+                                      const quint8 *src_line_z,
+                                      quint8 *dst_line_x,
+                                      quint8 *dst_line_y,
+                                      quint8 *dst_line_z,
+                                      quint8 *dst_line_a,
+                                      int *x);
+        template <typename OutputType>
+        static void convert16bits1to3(const ConvertParameters16bits *params,
+                                      const int *srcWidthOffsetX,
+                                      const int *dstWidthOffsetX,
+                                      const int *dstWidthOffsetY,
+                                      const int *dstWidthOffsetZ,
+                                      const int *dstWidthOffsetA,
+                                      int xmax,
+                                      const quint8 *src_line_x,
+                                      quint8 *dst_line_x,
+                                      quint8 *dst_line_y,
+                                      quint8 *dst_line_z,
+                                      quint8 *dst_line_a,
+                                      int *x);
+#endif
 };
 
 SimdCore::SimdCore(QObject *parent):
@@ -594,6 +1590,21 @@ QFunctionPointer SimdCore::resolve(const char *functionName) const
     CHECK_FUNCTION(convertFast8bits1Ato3A)
     CHECK_FUNCTION(convertFast8bits1Ato1)
 
+#ifdef AKSIMD_PACKED_KERNELS
+    CHECK_FUNCTION(createPackedLayout)
+    CHECK_FUNCTION(freePackedLayout)
+    CHECK_FUNCTION(convertFast8bitsPacked3to3)
+    CHECK_FUNCTION(convertFast8bitsPacked3to3A)
+
+    // Optimized convert functions for 16 bits inputs
+
+    CHECK_FUNCTION(createConvertParameters16bits)
+    CHECK_FUNCTION(freeConvertParameters16bits)
+    CHECK_FUNCTION(convertFast16bits3to3)
+    CHECK_FUNCTION(convertFast16bits3Ato3)
+    CHECK_FUNCTION(convertFast16bits1to3)
+#endif
+
     return nullptr;
 }
 
@@ -1773,4 +2784,434 @@ void SimdCorePrivate::convertFast8bits1Ato1(void *convertParameters,
     SimdType::end();
 }
 
+#ifdef AKSIMD_PACKED_KERNELS
+void *SimdCorePrivate::createPackedLayout(const int *srcLayout,
+                                          const int *dstLayout)
+{
+    auto layout = new PackedLayout;
+
+    if (!layout->setup(srcLayout, dstLayout)) {
+        delete layout;
+
+        return nullptr;
+    }
+
+    return layout;
+}
+
+void SimdCorePrivate::freePackedLayout(void *packedLayout)
+{
+    if (packedLayout)
+        delete reinterpret_cast<PackedLayout *>(packedLayout);
+}
+
+void SimdCorePrivate::convertFast8bitsPacked3to3(void *convertParameters,
+                                                 void *packedLayout,
+                                                 int xmax,
+                                                 const quint8 *src_line_x,
+                                                 const quint8 *src_line_y,
+                                                 const quint8 *src_line_z,
+                                                 quint8 *dst_line_x,
+                                                 quint8 *dst_line_y,
+                                                 quint8 *dst_line_z,
+                                                 int *x)
+{
+    auto params = reinterpret_cast<ConvertParameters *>(convertParameters);
+    auto layout = reinterpret_cast<const PackedLayout *>(packedLayout);
+    int xLocal = *x;
+
+    if (!params->packed16 || !layout->isAligned(xLocal))
+        return;
+
+    for (; xLocal + PACKED_PIXELS <= xmax; xLocal += PACKED_PIXELS) {
+        if (!layout->fits(xLocal, xmax))
+            break;
+
+        SimdTypeI8::VectorType xv;
+        SimdTypeI8::VectorType yv;
+        SimdTypeI8::VectorType zv;
+        params->applyPackedMatrix(layout->xi.read(src_line_x, xLocal),
+                                  layout->yi.read(src_line_y, xLocal),
+                                  layout->zi.read(src_line_z, xLocal),
+                                  &xv,
+                                  &yv,
+                                  &zv);
+
+        layout->xo.write(dst_line_x, xLocal, xv);
+        layout->yo.write(dst_line_y, xLocal, yv);
+        layout->zo.write(dst_line_z, xLocal, zv);
+    }
+
+    *x = xLocal;
+}
+
+void SimdCorePrivate::convertFast8bitsPacked3to3A(void *convertParameters,
+                                                  void *packedLayout,
+                                                  int xmax,
+                                                  const quint8 *src_line_x,
+                                                  const quint8 *src_line_y,
+                                                  const quint8 *src_line_z,
+                                                  quint8 *dst_line_x,
+                                                  quint8 *dst_line_y,
+                                                  quint8 *dst_line_z,
+                                                  quint8 *dst_line_a,
+                                                  int *x)
+{
+    auto params = reinterpret_cast<ConvertParameters *>(convertParameters);
+    auto layout = reinterpret_cast<const PackedLayout *>(packedLayout);
+    int xLocal = *x;
+
+    if (!params->packed16 || !layout->hasAlpha || !layout->isAligned(xLocal))
+        return;
+
+    SimdTypeI8 s8;
+    auto opaque = s8.load(quint8(0xff));
+
+    for (; xLocal + PACKED_PIXELS <= xmax; xLocal += PACKED_PIXELS) {
+        if (!layout->fits(xLocal, xmax))
+            break;
+
+        SimdTypeI8::VectorType xv;
+        SimdTypeI8::VectorType yv;
+        SimdTypeI8::VectorType zv;
+        params->applyPackedMatrix(layout->xi.read(src_line_x, xLocal),
+                                  layout->yi.read(src_line_y, xLocal),
+                                  layout->zi.read(src_line_z, xLocal),
+                                  &xv,
+                                  &yv,
+                                  &zv);
+
+        layout->xo.write(dst_line_x, xLocal, xv);
+        layout->yo.write(dst_line_y, xLocal, yv);
+        layout->zo.write(dst_line_z, xLocal, zv);
+        layout->ao.write(dst_line_a, xLocal, opaque);
+    }
+
+    *x = xLocal;
+}
+
+void *SimdCorePrivate::createConvertParameters16bits(qint64 *colorMatrix,
+                                                     qint64 *alphaMatrix,
+                                                     qint64 *minValues,
+                                                     qint64 *maxValues,
+                                                     qint64 colorShift,
+                                                     qint64 alphaShift,
+                                                     const qint64 *layout)
+{
+    auto params = new ConvertParameters16bits(layout);
+
+    if (!params->setupLayout(layout)
+        || !params->fitMatrix(colorMatrix,
+                              alphaMatrix,
+                              minValues,
+                              maxValues,
+                              int(colorShift),
+                              int(alphaShift))) {
+        delete params;
+
+        return nullptr;
+    }
+
+    return params;
+}
+
+void SimdCorePrivate::freeConvertParameters16bits(void *convertParameters)
+{
+    if (convertParameters)
+        delete reinterpret_cast<ConvertParameters16bits *>(convertParameters);
+}
+
+void SimdCorePrivate::convertFast16bits3to3(void *convertParameters,
+                                            const int *srcWidthOffsetX,
+                                            const int *srcWidthOffsetY,
+                                            const int *srcWidthOffsetZ,
+                                            const int *dstWidthOffsetX,
+                                            const int *dstWidthOffsetY,
+                                            const int *dstWidthOffsetZ,
+                                            const int *dstWidthOffsetA,
+                                            int xmax,
+                                            const quint8 *src_line_x,
+                                            const quint8 *src_line_y,
+                                            const quint8 *src_line_z,
+                                            quint8 *dst_line_x,
+                                            quint8 *dst_line_y,
+                                            quint8 *dst_line_z,
+                                            quint8 *dst_line_a,
+                                            int *x)
+{
+    auto params = reinterpret_cast<ConvertParameters16bits *>(convertParameters);
+
+    if (params->outputDepth == 16)
+        convert16bits3to3<quint16>(params,
+                                   srcWidthOffsetX,
+                                   srcWidthOffsetY,
+                                   srcWidthOffsetZ,
+                                   dstWidthOffsetX,
+                                   dstWidthOffsetY,
+                                   dstWidthOffsetZ,
+                                   dstWidthOffsetA,
+                                   xmax,
+                                   src_line_x,
+                                   src_line_y,
+                                   src_line_z,
+                                   dst_line_x,
+                                   dst_line_y,
+                                   dst_line_z,
+                                   dst_line_a,
+                                   x);
+    else
+        convert16bits3to3<quint8>(params,
+                                  srcWidthOffsetX,
+                                  srcWidthOffsetY,
+                                  srcWidthOffsetZ,
+                                  dstWidthOffsetX,
+                                  dstWidthOffsetY,
+                                  dstWidthOffsetZ,
+                                  dstWidthOffsetA,
+                                  xmax,
+                                  src_line_x,
+                                  src_line_y,
+                                  src_line_z,
+                                  dst_line_x,
+                                  dst_line_y,
+                                  dst_line_z,
+                                  dst_line_a,
+                                  x);
+}
+
+void SimdCorePrivate::convertFast16bits3Ato3(void *convertParameters,
+                                             const int *srcWidthOffsetX,
+                                             const int *srcWidthOffsetY,
+                                             const int *srcWidthOffsetZ,
+                                             const int *srcWidthOffsetA,
+                                             const int *dstWidthOffsetX,
+                                             const int *dstWidthOffsetY,
+                                             const int *dstWidthOffsetZ,
+                                             int xmax,
+                                             const quint8 *src_line_x,
+                                             const quint8 *src_line_y,
+                                             const quint8 *src_line_z,
+                                             const quint8 *src_line_a,
+                                             quint8 *dst_line_x,
+                                             quint8 *dst_line_y,
+                                             quint8 *dst_line_z,
+                                             int *x)
+{
+    auto params = reinterpret_cast<const ConvertParameters16bits *>(convertParameters);
+
+    // The alpha is only fitted for the 8 bits outputs.
+    if (!params->hasAlpha)
+        return;
+
+    auto &packed = params->packed;
+    int xLocal = *x;
+
+    if (packed.isAligned(xLocal))
+        for (; xLocal + packed.pixels <= xmax; xLocal += packed.pixels) {
+            if (!packed.fits(xLocal, xmax))
+                break;
+
+            SimdTypeI16::VectorType o[3];
+            params->applyPackedMatrixAlpha(params->readPacked(0, packed.xi, src_line_x, xLocal),
+                                           params->readPacked(1, packed.yi, src_line_y, xLocal),
+                                           params->readPacked(2, packed.zi, src_line_z, xLocal),
+                                           params->readPacked(3, packed.ai, src_line_a, xLocal),
+                                           o);
+
+            packed.xo.write(dst_line_x, xLocal, o[0]);
+            packed.yo.write(dst_line_y, xLocal, o[1]);
+            packed.zo.write(dst_line_z, xLocal, o[2]);
+        }
+
+    for (; xLocal < xmax; ++xLocal) {
+        quint16 u[] {
+            params->read(0, src_line_x + srcWidthOffsetX[xLocal]),
+            params->read(1, src_line_y + srcWidthOffsetY[xLocal]),
+            params->read(2, src_line_z + srcWidthOffsetZ[xLocal]),
+        };
+        auto ua = params->read(3, src_line_a + srcWidthOffsetA[xLocal]);
+
+        qint32 o[3];
+        params->applyMatrixAlpha(u, ua, o);
+
+        params->write<quint8>(0, dst_line_x + dstWidthOffsetX[xLocal], o[0]);
+        params->write<quint8>(1, dst_line_y + dstWidthOffsetY[xLocal], o[1]);
+        params->write<quint8>(2, dst_line_z + dstWidthOffsetZ[xLocal], o[2]);
+    }
+
+    *x = xLocal;
+}
+
+void SimdCorePrivate::convertFast16bits1to3(void *convertParameters,
+                                            const int *srcWidthOffsetX,
+                                            const int *dstWidthOffsetX,
+                                            const int *dstWidthOffsetY,
+                                            const int *dstWidthOffsetZ,
+                                            const int *dstWidthOffsetA,
+                                            int xmax,
+                                            const quint8 *src_line_x,
+                                            quint8 *dst_line_x,
+                                            quint8 *dst_line_y,
+                                            quint8 *dst_line_z,
+                                            quint8 *dst_line_a,
+                                            int *x)
+{
+    auto params = reinterpret_cast<ConvertParameters16bits *>(convertParameters);
+
+    if (params->outputDepth == 16)
+        convert16bits1to3<quint16>(params,
+                                   srcWidthOffsetX,
+                                   dstWidthOffsetX,
+                                   dstWidthOffsetY,
+                                   dstWidthOffsetZ,
+                                   dstWidthOffsetA,
+                                   xmax,
+                                   src_line_x,
+                                   dst_line_x,
+                                   dst_line_y,
+                                   dst_line_z,
+                                   dst_line_a,
+                                   x);
+    else
+        convert16bits1to3<quint8>(params,
+                                  srcWidthOffsetX,
+                                  dstWidthOffsetX,
+                                  dstWidthOffsetY,
+                                  dstWidthOffsetZ,
+                                  dstWidthOffsetA,
+                                  xmax,
+                                  src_line_x,
+                                  dst_line_x,
+                                  dst_line_y,
+                                  dst_line_z,
+                                  dst_line_a,
+                                  x);
+}
+
+/* The kernels convert the blocks of 8 pixels that fit in the line with
+ * contiguous loads and stores, and the rest of the line with the offsets
+ * tables. Both use the same fixed point numbers, and they always finish the
+ * line.
+ */
+template <typename OutputType>
+void SimdCorePrivate::convert16bits3to3(const ConvertParameters16bits *params,
+                                        const int *srcWidthOffsetX,
+                                        const int *srcWidthOffsetY,
+                                        const int *srcWidthOffsetZ,
+                                        const int *dstWidthOffsetX,
+                                        const int *dstWidthOffsetY,
+                                        const int *dstWidthOffsetZ,
+                                        const int *dstWidthOffsetA,
+                                        int xmax,
+                                        const quint8 *src_line_x,
+                                        const quint8 *src_line_y,
+                                        const quint8 *src_line_z,
+                                        quint8 *dst_line_x,
+                                        quint8 *dst_line_y,
+                                        quint8 *dst_line_z,
+                                        quint8 *dst_line_a,
+                                        int *x)
+{
+    auto &packed = params->packed;
+    int xLocal = *x;
+
+    if (packed.isAligned(xLocal) && (!dst_line_a || packed.hasAlpha)) {
+        SimdTypeI8 s8;
+        auto opaque = s8.load(quint8(0xff));
+
+        for (; xLocal + packed.pixels <= xmax; xLocal += packed.pixels) {
+            if (!packed.fits(xLocal, xmax))
+                break;
+
+            SimdTypeI16::VectorType o[3];
+            params->applyPackedMatrix(params->readPacked(0, packed.xi, src_line_x, xLocal),
+                                      params->readPacked(1, packed.yi, src_line_y, xLocal),
+                                      params->readPacked(2, packed.zi, src_line_z, xLocal),
+                                      o);
+
+            packed.xo.write(dst_line_x, xLocal, o[0]);
+            packed.yo.write(dst_line_y, xLocal, o[1]);
+            packed.zo.write(dst_line_z, xLocal, o[2]);
+
+            if (dst_line_a)
+                packed.ao.write(dst_line_a, xLocal, opaque);
+        }
+    }
+
+    for (; xLocal < xmax; ++xLocal) {
+        quint16 u[] {
+            params->read(0, src_line_x + srcWidthOffsetX[xLocal]),
+            params->read(1, src_line_y + srcWidthOffsetY[xLocal]),
+            params->read(2, src_line_z + srcWidthOffsetZ[xLocal]),
+        };
+
+        qint32 o[3];
+        params->applyMatrix(u, o);
+
+        params->write<OutputType>(0, dst_line_x + dstWidthOffsetX[xLocal], o[0]);
+        params->write<OutputType>(1, dst_line_y + dstWidthOffsetY[xLocal], o[1]);
+        params->write<OutputType>(2, dst_line_z + dstWidthOffsetZ[xLocal], o[2]);
+
+        if (dst_line_a)
+            params->writeAlpha<OutputType>(dst_line_a + dstWidthOffsetA[xLocal]);
+    }
+
+    *x = xLocal;
+}
+
+template <typename OutputType>
+void SimdCorePrivate::convert16bits1to3(const ConvertParameters16bits *params,
+                                        const int *srcWidthOffsetX,
+                                        const int *dstWidthOffsetX,
+                                        const int *dstWidthOffsetY,
+                                        const int *dstWidthOffsetZ,
+                                        const int *dstWidthOffsetA,
+                                        int xmax,
+                                        const quint8 *src_line_x,
+                                        quint8 *dst_line_x,
+                                        quint8 *dst_line_y,
+                                        quint8 *dst_line_z,
+                                        quint8 *dst_line_a,
+                                        int *x)
+{
+    auto &packed = params->packed;
+    int xLocal = *x;
+
+    if (packed.isAligned(xLocal) && (!dst_line_a || packed.hasAlpha)) {
+        SimdTypeI8 s8;
+        auto opaque = s8.load(quint8(0xff));
+
+        for (; xLocal + packed.pixels <= xmax; xLocal += packed.pixels) {
+            if (!packed.fits(xLocal, xmax))
+                break;
+
+            SimdTypeI16::VectorType o[3];
+            params->applyPackedPoint(params->readPacked(0, packed.xi, src_line_x, xLocal),
+                                     o);
+
+            packed.xo.write(dst_line_x, xLocal, o[0]);
+            packed.yo.write(dst_line_y, xLocal, o[1]);
+            packed.zo.write(dst_line_z, xLocal, o[2]);
+
+            if (dst_line_a)
+                packed.ao.write(dst_line_a, xLocal, opaque);
+        }
+    }
+
+    for (; xLocal < xmax; ++xLocal) {
+        qint32 o[3];
+        params->applyPoint(params->read(0, src_line_x + srcWidthOffsetX[xLocal]), o);
+
+        params->write<OutputType>(0, dst_line_x + dstWidthOffsetX[xLocal], o[0]);
+        params->write<OutputType>(1, dst_line_y + dstWidthOffsetY[xLocal], o[1]);
+        params->write<OutputType>(2, dst_line_z + dstWidthOffsetZ[xLocal], o[2]);
+
+        if (dst_line_a)
+            params->writeAlpha<OutputType>(dst_line_a + dstWidthOffsetA[xLocal]);
+    }
+
+    *x = xLocal;
+}
+#endif
+
 #include "moc_simdcore.cpp"
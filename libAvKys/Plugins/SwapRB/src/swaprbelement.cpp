@@ -42,6 +42,16 @@ SwapRBElement::~SwapRBElement()
     delete this->d;
 }
 
+AkVideoCaps::PixelFormatList SwapRBElement::videoInputFormats() const
+{
+    return {AkVideoCaps::Format_argbpack};
+}
+
+AkVideoCaps::PixelFormatList SwapRBElement::videoOutputFormats() const
+{
+    return {AkVideoCaps::Format_argbpack};
+}
+
 AkPacket SwapRBElement::iVideoStream(const AkVideoPacket &packet)
 {
     if (!packet)
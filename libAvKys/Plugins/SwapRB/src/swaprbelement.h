@@ -32,6 +32,9 @@ class SwapRBElement: public AkElement
         SwapRBElement();
         ~SwapRBElement();
 
+        Q_INVOKABLE AkVideoCaps::PixelFormatList videoInputFormats() const override;
+        Q_INVOKABLE AkVideoCaps::PixelFormatList videoOutputFormats() const override;
+
     private:
         SwapRBElementPrivate *d;
 
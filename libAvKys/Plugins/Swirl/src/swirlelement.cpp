@@ -63,6 +63,16 @@ qreal SwirlElement::degrees() const
     return this->d->m_degrees;
 }
 
+AkVideoCaps::PixelFormatList SwirlElement::videoInputFormats() const
+{
+    return {AkVideoCaps::Format_argbpack};
+}
+
+AkVideoCaps::PixelFormatList SwirlElement::videoOutputFormats() const
+{
+    return {AkVideoCaps::Format_argbpack};
+}
+
 QString SwirlElement::controlInterfaceProvide(const QString &controlId) const
 {
     Q_UNUSED(controlId)
@@ -37,6 +37,8 @@ class SwirlElement: public AkElement
         SwirlElement();
         ~SwirlElement();
 
+        Q_INVOKABLE AkVideoCaps::PixelFormatList videoInputFormats() const override;
+        Q_INVOKABLE AkVideoCaps::PixelFormatList videoOutputFormats() const override;
         Q_INVOKABLE qreal degrees() const;
 
     private:
@@ -87,6 +87,16 @@ qreal TemperatureElement::temperature() const
     return this->d->m_temperature;
 }
 
+AkVideoCaps::PixelFormatList TemperatureElement::videoInputFormats() const
+{
+    return {AkVideoCaps::Format_argbpack};
+}
+
+AkVideoCaps::PixelFormatList TemperatureElement::videoOutputFormats() const
+{
+    return {AkVideoCaps::Format_argbpack};
+}
+
 QString TemperatureElement::controlInterfaceProvide(const QString &controlId) const
 {
     Q_UNUSED(controlId)
@@ -38,6 +38,8 @@ class TemperatureElement:
         TemperatureElement();
         ~TemperatureElement();
 
+        Q_INVOKABLE AkVideoCaps::PixelFormatList videoInputFormats() const override;
+        Q_INVOKABLE AkVideoCaps::PixelFormatList videoOutputFormats() const override;
         Q_INVOKABLE qreal temperature() const;
 
     private:
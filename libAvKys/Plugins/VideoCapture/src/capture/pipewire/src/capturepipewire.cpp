@@ -19,6 +19,7 @@
 
 #include <QDebug>
 #include <QMap>
+#include <QSet>
 #include <QVariant>
 #include <QVector>
 #include <QtConcurrent>
@@ -255,6 +256,47 @@ using PwThreadLoopStopType = void (*)(pw_thread_loop *loop);
 using PwThreadLoopUnlockType = void (*)(pw_thread_loop *loop);
 #endif
 
+/* The frames are copied instead of adopting the buffers when the stream would
+ * be left with less than this number of free buffers.
+ */
+#define MIN_FREE_BUFFERS 2
+
+// Maximum time to wait for the packets using a buffer that is being removed.
+#define REMOVE_BUFFER_TIMEOUT 1000
+
+class CapturePipeWirePrivate;
+
+class StreamBuffersOwner
+{
+    public:
+        QMutex m_mutex;
+        QWaitCondition m_bufferReleased;
+        CapturePipeWirePrivate *m_device {nullptr};
+        pw_stream *m_stream {nullptr};
+        QSet<pw_buffer *> m_adoptedBuffers;
+        QSet<pw_buffer *> m_returningBuffers;
+        QSet<pw_buffer *> m_removedBuffers;
+        int m_nBuffers {0};
+        int m_queueing {0};
+
+        bool adopt(pw_buffer *buffer);
+        void addBuffer();
+        void removeBuffer(pw_buffer *buffer);
+        void invalidate();
+};
+
+using StreamBuffersOwnerPtr = QSharedPointer<StreamBuffersOwner>;
+
+class AdoptedBuffer
+{
+    public:
+        StreamBuffersOwnerPtr owner;
+        pw_stream *stream {nullptr};
+        pw_buffer *buffer {nullptr};
+
+        static void release(void *opaque);
+};
+
 class CapturePipeWirePrivate
 {
     public:
@@ -294,6 +336,7 @@ class CapturePipeWirePrivate
         spa_hook m_deviceHook;
         spa_hook m_streamHook;
         QThreadPool m_threadPool;
+        StreamBuffersOwnerPtr m_streamBuffersOwner;
         AkVideoCaps m_curCaps;
         qint64 m_id {-1};
         int m_nBuffers {32};
@@ -366,6 +409,8 @@ class CapturePipeWirePrivate
         static void onParamChanged(void *userData,
                                    uint32_t id,
                                    const struct spa_pod *param);
+        static void onAddBuffer(void *userData, pw_buffer *buffer);
+        static void onRemoveBuffer(void *userData, pw_buffer *buffer);
         static void onProcess(void *userData);
         void pipewireDevicesLoop();
         QVariantMap controlStatus(const QVariantList &controls) const;
@@ -754,6 +799,8 @@ static const struct pw_registry_events pipewireCameraDeviceEvents = {
 static const struct pw_stream_events pipewireCameraStreamEvents = {
     .version       = PW_VERSION_STREAM_EVENTS              ,
     .param_changed = CapturePipeWirePrivate::onParamChanged,
+    .add_buffer    = CapturePipeWirePrivate::onAddBuffer   ,
+    .remove_buffer = CapturePipeWirePrivate::onRemoveBuffer,
     .process       = CapturePipeWirePrivate::onProcess     ,
 };
 
@@ -1078,6 +1125,9 @@ bool CapturePipeWire::init()
             this->d->pwStreamNew(this->d->m_pwStreamCore,
                                  "Webcamoid Camera Capture",
                                  this->d->pwPropertiesNewDict(&dict));
+    this->d->m_streamBuffersOwner = StreamBuffersOwnerPtr::create();
+    this->d->m_streamBuffersOwner->m_device = this->d;
+    this->d->m_streamBuffersOwner->m_stream = this->d->m_pwStream;
     this->d->pwStreamAddListener(this->d->m_pwStream,
                                   &this->d->m_streamHook,
                                   &pipewireCameraStreamEvents,
@@ -1147,15 +1197,24 @@ bool CapturePipeWire::init()
 
 void CapturePipeWire::uninit()
 {
+    if (this->d->m_streamBuffersOwner)
+        this->d->m_streamBuffersOwner->invalidate();
+
     if (this->d->m_pwStreamLoop)
         this->d->pwThreadLoopStop(this->d->m_pwStreamLoop);
 
+    this->d->m_mutex.lockForWrite();
+    this->d->m_curPacket = {};
+    this->d->m_mutex.unlock();
+
     if (this->d->m_pwStream) {
         this->d->pwStreamDisconnect(this->d->m_pwStream);
         this->d->pwStreamDestroy(this->d->m_pwStream);
         this->d->m_pwStream = nullptr;
     }
 
+    this->d->m_streamBuffersOwner.clear();
+
     if (this->d->m_pwStreamContext) {
         this->d->pwContextDestroy(this->d->m_pwStreamContext);
         this->d->m_pwStreamContext = nullptr;
@@ -2016,6 +2075,30 @@ void CapturePipeWirePrivate::onParamChanged(void *userData,
     }
 }
 
+void CapturePipeWirePrivate::onAddBuffer(void *userData, pw_buffer *buffer)
+{
+    Q_UNUSED(buffer)
+    auto self = reinterpret_cast<CapturePipeWirePrivate *>(userData);
+
+    if (self->m_streamBuffersOwner)
+        self->m_streamBuffersOwner->addBuffer();
+}
+
+void CapturePipeWirePrivate::onRemoveBuffer(void *userData, pw_buffer *buffer)
+{
+    auto self = reinterpret_cast<CapturePipeWirePrivate *>(userData);
+
+    if (!self->m_streamBuffersOwner)
+        return;
+
+    // Don't keep the removed buffer alive in the last unread frame.
+    self->m_mutex.lockForWrite();
+    self->m_curPacket = {};
+    self->m_mutex.unlock();
+
+    self->m_streamBuffersOwner->removeBuffer(buffer);
+}
+
 void CapturePipeWirePrivate::onProcess(void *userData)
 {
     auto self = reinterpret_cast<CapturePipeWirePrivate *>(userData);
@@ -2027,15 +2110,65 @@ void CapturePipeWirePrivate::onProcess(void *userData)
     if (!buffer->buffer->datas[0].data)
         return;
 
-    AkVideoPacket packet(self->m_curCaps);
-    auto iLineSize = buffer->buffer->datas[0].chunk->stride;
-    auto oLineSize = packet.lineSize(0);
-    auto lineSize = qMin<size_t>(iLineSize, oLineSize);
+    auto specs = AkVideoCaps::formatSpecs(self->m_curCaps.format());
+    AkVideoPacket packet;
+    bool adopted = false;
+
+    /* If every plane comes in its own data block, wrap the buffer instead of
+     * copying it. It will be queued back to the stream when the last copy of
+     * the packet is released.
+     */
+    if (self->m_streamBuffersOwner
+        && specs.planes() > 0
+        && specs.planes() <= buffer->buffer->n_datas) {
+        quint8 *planes[4];
+        size_t lineSizes[4];
+        size_t dataSize = 0;
+        adopted = true;
+
+        for (size_t plane = 0; plane < specs.planes() && plane < 4; ++plane) {
+            auto &data = buffer->buffer->datas[plane];
+
+            if (!data.data || !data.chunk) {
+                adopted = false;
 
-    for (int y = 0; y < packet.caps().height(); y++)
-        memcpy(packet.line(0, y),
-               reinterpret_cast<quint8 *>(buffer->buffer->datas[0].data) + y * iLineSize,
-               lineSize);
+                break;
+            }
+
+            planes[plane] = reinterpret_cast<quint8 *>(data.data)
+                            + data.chunk->offset;
+            lineSizes[plane] = data.chunk->stride;
+            dataSize += data.chunk->size;
+        }
+
+        // Copy the frame if the stream is running short of buffers.
+        adopted = adopted && self->m_streamBuffersOwner->adopt(buffer);
+
+        if (adopted) {
+            auto adoptedBuffer = new AdoptedBuffer;
+            adoptedBuffer->owner = self->m_streamBuffersOwner;
+            adoptedBuffer->stream = self->m_pwStream;
+            adoptedBuffer->buffer = buffer;
+            packet = AkVideoPacket(self->m_curCaps,
+                                   planes,
+                                   lineSizes,
+                                   dataSize,
+                                   AdoptedBuffer::release,
+                                   adoptedBuffer);
+        }
+    }
+
+    if (!adopted) {
+        packet = AkVideoPacket(self->m_curCaps);
+        auto iLineSize = buffer->buffer->datas[0].chunk->stride;
+        auto oLineSize = packet.lineSize(0);
+        auto lineSize = qMin<size_t>(iLineSize, oLineSize);
+
+        for (int y = 0; y < packet.caps().height(); y++)
+            memcpy(packet.line(0, y),
+                   reinterpret_cast<quint8 *>(buffer->buffer->datas[0].data) + y * iLineSize,
+                   lineSize);
+    }
 
     auto fps = self->m_curCaps.fps();
     auto pts = qRound64(QTime::currentTime().msecsSinceStartOfDay()
@@ -2051,7 +2184,115 @@ void CapturePipeWirePrivate::onProcess(void *userData)
     self->m_waitCondition.wakeAll();
     self->m_mutex.unlock();
 
-    self->pwStreamQueueBuffer(self->m_pwStream, buffer);
+    if (!adopted)
+        self->pwStreamQueueBuffer(self->m_pwStream, buffer);
+}
+
+void AdoptedBuffer::release(void *opaque)
+{
+    /* This can be called from any thread. The buffer is queued back right
+     * away, so the stream doesn't run out of buffers while the packets wait
+     * in the queues of the pipeline. The loop lock is recursive, so this also
+     * works from the stream thread.
+     */
+    auto self = reinterpret_cast<AdoptedBuffer *>(opaque);
+    auto owner = self->owner;
+    auto device = owner->m_device;
+    owner->m_mutex.lock();
+    owner->m_adoptedBuffers.remove(self->buffer);
+    bool queue = !owner->m_removedBuffers.remove(self->buffer)
+                 && owner->m_stream == self->stream;
+
+    if (queue) {
+        owner->m_returningBuffers << self->buffer;
+        owner->m_queueing++;
+    }
+
+    owner->m_bufferReleased.wakeAll();
+    owner->m_mutex.unlock();
+
+    if (queue) {
+        device->pwThreadLoopLock(device->m_pwStreamLoop);
+
+        /* Check again with the loop locked, the buffer could have been
+         * removed in the meantime.
+         */
+        owner->m_mutex.lock();
+        queue = owner->m_returningBuffers.remove(self->buffer)
+                && owner->m_stream == self->stream;
+        owner->m_mutex.unlock();
+
+        if (queue)
+            device->pwStreamQueueBuffer(self->stream, self->buffer);
+
+        device->pwThreadLoopUnlock(device->m_pwStreamLoop);
+
+        owner->m_mutex.lock();
+        owner->m_queueing--;
+        owner->m_bufferReleased.wakeAll();
+        owner->m_mutex.unlock();
+    }
+
+    delete self;
+}
+
+bool StreamBuffersOwner::adopt(pw_buffer *buffer)
+{
+    this->m_mutex.lock();
+    bool adopt =
+            this->m_nBuffers - this->m_adoptedBuffers.size() - 1 >= MIN_FREE_BUFFERS;
+
+    if (adopt)
+        this->m_adoptedBuffers << buffer;
+
+    this->m_mutex.unlock();
+
+    return adopt;
+}
+
+void StreamBuffersOwner::addBuffer()
+{
+    this->m_mutex.lock();
+    this->m_nBuffers++;
+    this->m_mutex.unlock();
+}
+
+void StreamBuffersOwner::removeBuffer(pw_buffer *buffer)
+{
+    this->m_mutex.lock();
+    this->m_nBuffers--;
+    this->m_returningBuffers.remove(buffer);
+
+    /* The memory of the buffer goes away with it, so wait until the last
+     * packet using it is released.
+     */
+    if (this->m_adoptedBuffers.contains(buffer)) {
+        this->m_removedBuffers << buffer;
+        QDeadlineTimer deadline(REMOVE_BUFFER_TIMEOUT);
+
+        while (this->m_adoptedBuffers.contains(buffer))
+            if (!this->m_bufferReleased.wait(&this->m_mutex, deadline)) {
+                qWarning() << "Timeout waiting for the packets using a removed buffer";
+
+                break;
+            }
+    }
+
+    this->m_mutex.unlock();
+}
+
+void StreamBuffersOwner::invalidate()
+{
+    /* Packets still holding adopted buffers must not give them back to a
+     * stream that is going to be destroyed.
+     */
+    this->m_mutex.lock();
+    this->m_stream = nullptr;
+
+    while (this->m_queueing > 0)
+        this->m_bufferReleased.wait(&this->m_mutex);
+
+    this->m_mutex.unlock();
 }
 
 void CapturePipeWirePrivate::pipewireDevicesLoop()
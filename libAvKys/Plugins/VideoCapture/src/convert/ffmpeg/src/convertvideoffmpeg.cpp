@@ -17,6 +17,7 @@
  * Web-Site: http://webcamoid.github.io/
  */
 
+#include <QElapsedTimer>
 #include <QMetaEnum>
 #include <QtConcurrent>
 #include <QQueue>
@@ -55,6 +56,11 @@ extern "C"
 // no AV correction is done if too big error
 #define AV_NOSYNC_THRESHOLD 10.0
 
+// Maximum number of decoding threads used by default. Frame threading
+// delays each frame by one frame per thread, so keep it low for live
+// streams.
+#define MAX_DECODING_THREADS 4
+
 using FFCodecMap = QMap<AVCodecID, AkCompressedVideoCaps::VideoCodecID>;
 
 inline FFCodecMap initCompressedFFToStr()
@@ -96,6 +102,8 @@ class ConvertVideoFFmpegPrivate
         QQueue<AkPacket> m_packets;
         QQueue<FramePtr> m_frames;
         qint64 m_packetQueueSize {0};
+        std::atomic<qint64> m_decodingTime {0};
+        std::atomic<int> m_activeDecodingThreads {0};
         QFuture<void> m_packetLoopResult;
         QFuture<void> m_dataLoopResult;
         qint64 m_id {-1};
@@ -103,6 +111,7 @@ class ConvertVideoFFmpegPrivate
         AkFrac m_fps;
         qreal m_lastPts {0};
         int m_maxData {3};
+        int m_decodingThreads {0};
         bool m_showLog {false};
         bool m_runPacketLoop {false};
         bool m_runDataLoop {false};
@@ -156,6 +165,32 @@ AkCompressedVideoCaps::VideoCodecList ConvertVideoFFmpeg::supportedCodecs() cons
     return this->d->m_supportedCodecs;
 }
 
+int ConvertVideoFFmpeg::decodingThreads() const
+{
+    return this->d->m_decodingThreads;
+}
+
+QVariantMap ConvertVideoFFmpeg::decodingStats() const
+{
+    // The codec context can be freed at any time from the capture thread,
+    // so read the number of threads cached when the codec was opened.
+    int decodingThreads = this->d->m_activeDecodingThreads;
+
+    if (decodingThreads < 1)
+        return {};
+
+    this->d->m_dataMutex.lockForRead();
+    int frameQueueSize = this->d->m_frames.size();
+    this->d->m_dataMutex.unlock();
+
+    return QVariantMap {
+        {"decodingThreads", decodingThreads                     },
+        {"decodingTime"   , qreal(this->d->m_decodingTime) / 1e6},
+        {"packetQueueSize", this->d->m_packetQueueSize          },
+        {"frameQueueSize" , frameQueueSize                      },
+    };
+}
+
 void ConvertVideoFFmpeg::packetEnqueue(const AkPacket &packet)
 {
     this->d->m_packetMutex.lockForWrite();
@@ -229,6 +264,18 @@ bool ConvertVideoFFmpeg::init(const AkCaps &caps)
     this->d->m_codecContext->idct_algo = FF_IDCT_AUTO;
     this->d->m_codecContext->error_concealment = FF_EC_GUESS_MVS | FF_EC_DEBLOCK;
 
+    auto threads = this->d->m_decodingThreads;
+
+    if (threads < 1)
+        threads = qBound(1, QThread::idealThreadCount(), MAX_DECODING_THREADS);
+
+    if (!(codec->capabilities
+          & (AV_CODEC_CAP_FRAME_THREADS | AV_CODEC_CAP_SLICE_THREADS)))
+        threads = 1;
+
+    this->d->m_codecContext->thread_count = threads;
+    this->d->m_codecContext->thread_type = FF_THREAD_FRAME | FF_THREAD_SLICE;
+
 #if LIBAVUTIL_VERSION_INT < AV_VERSION_INT(57, 10, 100)
     this->d->m_codecContext->time_base.num = int(this->d->m_fps.den());
     this->d->m_codecContext->time_base.den = int(this->d->m_fps.num());
@@ -252,6 +299,8 @@ bool ConvertVideoFFmpeg::init(const AkCaps &caps)
     this->d->m_packets.clear();
     this->d->m_frames.clear();
     this->d->m_lastPts = 0;
+    this->d->m_decodingTime = 0;
+    this->d->m_activeDecodingThreads = this->d->m_codecContext->thread_count;
     this->d->m_id = Ak::id();
     this->d->m_packetQueueSize = 0;
     this->d->m_runPacketLoop = true;
@@ -271,6 +320,8 @@ bool ConvertVideoFFmpeg::init(const AkCaps &caps)
 
 void ConvertVideoFFmpeg::uninit()
 {
+    this->d->m_activeDecodingThreads = 0;
+
     this->d->m_runPacketLoop = false;
     this->d->m_packetLoopResult.waitForFinished();
 
@@ -310,6 +361,15 @@ void ConvertVideoFFmpeg::setShowLog(bool showLog)
     emit this->showLogChanged(showLog);
 }
 
+void ConvertVideoFFmpeg::setDecodingThreads(int decodingThreads)
+{
+    if (this->d->m_decodingThreads == decodingThreads)
+        return;
+
+    this->d->m_decodingThreads = decodingThreads;
+    emit this->decodingThreadsChanged(decodingThreads);
+}
+
 void ConvertVideoFFmpeg::resetMaxPacketQueueSize()
 {
     this->setMaxPacketQueueSize(15 * 1024 * 1024);
@@ -320,6 +380,11 @@ void ConvertVideoFFmpeg::resetShowLog()
     this->setShowLog(false);
 }
 
+void ConvertVideoFFmpeg::resetDecodingThreads()
+{
+    this->setDecodingThreads(0);
+}
+
 ConvertVideoFFmpegPrivate::ConvertVideoFFmpegPrivate(ConvertVideoFFmpeg *self):
     self(self)
 {
@@ -378,6 +443,9 @@ void ConvertVideoFFmpegPrivate::packetLoop(ConvertVideoFFmpeg *stream)
             videoPacket->size = packet.size();
             videoPacket->pts = packet.pts();
 
+            QElapsedTimer timer;
+            timer.start();
+
             if (avcodec_send_packet(stream->d->m_codecContext, videoPacket) >= 0)
                 forever {
                     auto iFrame = av_frame_alloc();
@@ -413,6 +481,12 @@ void ConvertVideoFFmpegPrivate::packetLoop(ConvertVideoFFmpeg *stream)
                         break;
                 }
 
+            // Keep a moving average of the time spent decoding each
+            // packet.
+            qint64 decodingTime = stream->d->m_decodingTime;
+            stream->d->m_decodingTime = decodingTime
+                                      + (timer.nsecsElapsed() - decodingTime) / 16;
+
             av_packet_free(&videoPacket);
             stream->d->m_packetQueueSize -= packet.size();
 
@@ -512,11 +586,13 @@ void ConvertVideoFFmpegPrivate::log(qreal diff)
     if (!this->m_showLog)
         return;
 
-    QString logFmt("%1 %2: %3 vq=%5KB");
+    QString logFmt("%1 %2: %3 vq=%4KB vf=%5 vdt=%6ms");
     QString log = logFmt.arg(this->m_globalClock.clock(), 7, 'f', 2)
                         .arg("M-V")
                         .arg(-diff, 7, 'f', 3)
-                        .arg(this->m_packetQueueSize / 1024, 5);
+                        .arg(this->m_packetQueueSize / 1024, 5)
+                        .arg(this->m_frames.size(), 2)
+                        .arg(qreal(this->m_decodingTime) / 1e6, 6, 'f', 2);
     qDebug() << log.toStdString().c_str();
 }
 
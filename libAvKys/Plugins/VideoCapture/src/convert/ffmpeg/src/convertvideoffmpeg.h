@@ -33,6 +33,11 @@ class ConvertVideoFFmpeg: public ConvertVideo
                WRITE setMaxPacketQueueSize
                RESET resetMaxPacketQueueSize
                NOTIFY maxPacketQueueSizeChanged)
+    Q_PROPERTY(int decodingThreads
+               READ decodingThreads
+               WRITE setDecodingThreads
+               RESET resetDecodingThreads
+               NOTIFY decodingThreadsChanged)
     Q_PROPERTY(bool showLog
                READ showLog
                WRITE setShowLog
@@ -46,6 +51,8 @@ class ConvertVideoFFmpeg: public ConvertVideo
         Q_INVOKABLE qint64 maxPacketQueueSize() const;
         Q_INVOKABLE bool showLog() const;
         Q_INVOKABLE AkCompressedVideoCaps::VideoCodecList supportedCodecs() const override;
+        Q_INVOKABLE int decodingThreads() const override;
+        Q_INVOKABLE QVariantMap decodingStats() const override;
         Q_INVOKABLE void packetEnqueue(const AkPacket &packet) override;
         Q_INVOKABLE void dataEnqueue(AVFrame *frame);
         Q_INVOKABLE bool init(const AkCaps &caps) override;
@@ -61,8 +68,10 @@ class ConvertVideoFFmpeg: public ConvertVideo
     public slots:
         void setMaxPacketQueueSize(qint64 maxPacketQueueSize);
         void setShowLog(bool showLog);
+        void setDecodingThreads(int decodingThreads) override;
         void resetMaxPacketQueueSize();
         void resetShowLog();
+        void resetDecodingThreads() override;
 
         friend class ConvertVideoFFmpegPrivate;
 };
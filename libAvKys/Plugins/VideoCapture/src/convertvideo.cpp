@@ -32,6 +32,16 @@ AkCompressedVideoCaps::VideoCodecList ConvertVideo::supportedCodecs() const
     return {};
 }
 
+int ConvertVideo::decodingThreads() const
+{
+    return 0;
+}
+
+QVariantMap ConvertVideo::decodingStats() const
+{
+    return {};
+}
+
 void ConvertVideo::packetEnqueue(const AkPacket &packet)
 {
     Q_UNUSED(packet)
@@ -48,4 +58,14 @@ void ConvertVideo::uninit()
 {
 }
 
+void ConvertVideo::setDecodingThreads(int decodingThreads)
+{
+    Q_UNUSED(decodingThreads)
+}
+
+void ConvertVideo::resetDecodingThreads()
+{
+    this->setDecodingThreads(0);
+}
+
 #include "moc_convertvideo.cpp"
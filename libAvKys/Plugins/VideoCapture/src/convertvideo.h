@@ -37,12 +37,19 @@ class ConvertVideo: public QObject
         virtual ~ConvertVideo() = default;
 
         Q_INVOKABLE virtual AkCompressedVideoCaps::VideoCodecList supportedCodecs() const;
+        Q_INVOKABLE virtual int decodingThreads() const;
+        Q_INVOKABLE virtual QVariantMap decodingStats() const;
         Q_INVOKABLE virtual void packetEnqueue(const AkPacket &packet);
         Q_INVOKABLE virtual bool init(const AkCaps &caps);
         Q_INVOKABLE virtual void uninit();
 
     signals:
         void frameReady(const AkPacket &packet);
+        void decodingThreadsChanged(int decodingThreads);
+
+    public slots:
+        virtual void setDecodingThreads(int decodingThreads);
+        virtual void resetDecodingThreads();
 };
 
 #endif // CONVERTVIDEO_H
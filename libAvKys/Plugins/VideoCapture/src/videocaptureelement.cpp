@@ -79,11 +79,14 @@ class VideoCaptureElementPrivate
         VideoCaptureElement *self;
         AkVideoConverter m_videoConverter;
         CapturePtr m_capture;
+        ConvertVideoPtr m_convertVideo;
         QString m_captureImpl;
         QMap<QString, StringsCache> m_stringsCache;
         QThreadPool m_threadPool;
         QFuture<void> m_cameraLoopResult;
         QReadWriteLock m_mutex;
+        int m_decodingThreads {0};
+        AkVideoCaps::PixelFormat m_appliedFormat {AkVideoCaps::Format_none};
         bool m_runCameraLoop {false};
         bool m_pause {false};
 
@@ -93,6 +96,9 @@ class VideoCaptureElementPrivate
         void cameraLoop();
         void linksChanged(const AkPluginLinks &links);
         void buildStringCache();
+        int savedStream(const CapturePtr &capture, const QString &media) const;
+        int preferredStream(const CapturePtr &capture, int streamIndex) const;
+        void updatePreferredStream();
 };
 
 VideoCaptureElement::VideoCaptureElement():
@@ -105,6 +111,12 @@ VideoCaptureElement::VideoCaptureElement():
                      [this] (const AkPluginLinks &links) {
                         this->d->linksChanged(links);
                      });
+    QObject::connect(this,
+                     &AkElement::preferredVideoFormatChanged,
+                     this,
+                     [this] () {
+                        this->d->updatePreferredStream();
+                     });
 
     if (this->d->m_capture) {
         this->d->buildStringCache();
@@ -160,34 +172,11 @@ VideoCaptureElement::VideoCaptureElement():
         if (!medias.isEmpty()) {
             auto media = medias.first();
             this->d->m_capture->setDevice(media);
-            QSettings settings;
-            settings.beginGroup("VideoCapture");
-            auto ndevices = settings.beginReadArray("devices");
-            auto deviceDescription = this->d->m_capture->description(media);
-            int streamIndex = 0;
-
-            for (decltype(ndevices) i = 0; i < ndevices; i++) {
-                settings.setArrayIndex(i);
-                auto deviceId = settings.value("id").toString();
-                auto description = settings.value("description").toString();
-
-                if (deviceId == media && description == deviceDescription) {
-                    streamIndex = settings.value("stream", 0).toInt();
-                    auto tracks = this->d->m_capture->listTracks(AkCaps::CapsVideo);
-
-                    if (tracks.isEmpty())
-                        streamIndex = 0;
-                    else
-                        streamIndex = qBound<int>(0,
-                                                  streamIndex,
-                                                  tracks.size() - 1);
-
-                    break;
-                }
-            }
+            auto streamIndex = this->d->savedStream(this->d->m_capture,
+                                                    media);
 
-            settings.endArray();
-            settings.endGroup();
+            if (streamIndex < 0)
+                streamIndex = this->d->preferredStream(this->d->m_capture, 0);
 
             this->d->m_capture->setStreams({streamIndex});
         }
@@ -322,6 +311,39 @@ AkCaps VideoCaptureElement::caps(int stream)
     return caps;
 }
 
+AkVideoCaps::PixelFormatList VideoCaptureElement::videoOutputFormats() const
+{
+    this->d->m_mutex.lockForRead();
+    auto capture = this->d->m_capture;
+    this->d->m_mutex.unlock();
+
+    AkVideoCaps::PixelFormatList formats;
+
+    if (!capture)
+        return formats;
+
+    for (auto &caps: capture->caps(capture->device())) {
+        AkVideoCaps::PixelFormatList streamFormats;
+
+        if (caps.type() == AkCaps::CapsVideoCompressed) {
+            // Formats produced by the decoders.
+            if (AkCompressedVideoCaps(caps).codec() == AkCompressedVideoCaps::VideoCodecID_jpeg)
+                streamFormats = {AkVideoCaps::Format_argbpack,
+                                 AkVideoCaps::Format_rgb24};
+            else
+                streamFormats = {AkVideoCaps::Format_rgb24};
+        } else if (caps.type() == AkCaps::CapsVideo) {
+            streamFormats = {AkVideoCaps(caps).format()};
+        }
+
+        for (auto &format: streamFormats)
+            if (format != AkVideoCaps::Format_none && !formats.contains(format))
+                formats << format;
+    }
+
+    return formats;
+}
+
 AkCaps VideoCaptureElement::rawCaps(int stream) const
 {
     this->d->m_mutex.lockForRead();
@@ -403,6 +425,25 @@ int VideoCaptureElement::nBuffers() const
     return nBuffers;
 }
 
+int VideoCaptureElement::decodingThreads() const
+{
+    return this->d->m_decodingThreads;
+}
+
+QVariantMap VideoCaptureElement::decodingStats() const
+{
+    this->d->m_mutex.lockForRead();
+    auto convertVideo = this->d->m_convertVideo;
+    this->d->m_mutex.unlock();
+
+    QVariantMap stats;
+
+    if (convertVideo)
+        stats = convertVideo->decodingStats();
+
+    return stats;
+}
+
 QVariantList VideoCaptureElement::imageControls() const
 {
     this->d->m_mutex.lockForRead();
@@ -701,37 +742,14 @@ void VideoCaptureElement::setMedia(const QString &media)
         return;
 
     capture->setDevice(media);
-    QSettings settings;
-
-    settings.beginGroup("VideoCapture");
-    auto ndevices = settings.beginReadArray("devices");
-    auto deviceDescription = capture->description(media);
-    int streamIndex = 0;
-
-    for (int i = 0; i < ndevices; i++) {
-        settings.setArrayIndex(i);
-        auto deviceId = settings.value("id").toString();
-        auto description = settings.value("description").toString();
-
-        if (deviceId == media && description == deviceDescription) {
-            streamIndex = settings.value("stream", 0).toInt();
-            auto tracks = capture->listTracks(AkCaps::CapsVideo);
-
-            if (tracks.isEmpty())
-                streamIndex = 0;
-            else
-                streamIndex = qBound<int>(0,
-                                          streamIndex,
-                                          tracks.size() - 1);
+    auto streamIndex = this->d->savedStream(capture, media);
 
-            break;
-        }
+    if (streamIndex < 0) {
+        streamIndex = this->d->preferredStream(capture, 0);
+        this->d->m_appliedFormat = this->preferredVideoFormat();
     }
 
-    settings.endArray();
-    settings.endGroup();
-
-   capture->setStreams({streamIndex});
+    capture->setStreams({streamIndex});
 }
 
 void VideoCaptureElement::setStreams(const QList<int> &streams)
@@ -801,6 +819,23 @@ void VideoCaptureElement::setNBuffers(int nBuffers)
         capture->setNBuffers(nBuffers);
 }
 
+void VideoCaptureElement::setDecodingThreads(int decodingThreads)
+{
+    if (this->d->m_decodingThreads == decodingThreads)
+        return;
+
+    this->d->m_decodingThreads = decodingThreads;
+    emit this->decodingThreadsChanged(decodingThreads);
+
+    // Takes effect the next time the decoder is started.
+    this->d->m_mutex.lockForRead();
+    auto convertVideo = this->d->m_convertVideo;
+    this->d->m_mutex.unlock();
+
+    if (convertVideo)
+        convertVideo->setDecodingThreads(decodingThreads);
+}
+
 void VideoCaptureElement::setTorchMode(TorchMode mode)
 {
     this->d->m_mutex.lockForRead();
@@ -851,6 +886,11 @@ void VideoCaptureElement::resetNBuffers()
         capture->resetNBuffers();
 }
 
+void VideoCaptureElement::resetDecodingThreads()
+{
+    this->setDecodingThreads(0);
+}
+
 void VideoCaptureElement::resetTorchMode()
 {
     this->d->m_mutex.lockForRead();
@@ -1055,10 +1095,18 @@ AkVideoPacket VideoCaptureElementPrivate::decodeJpg(const AkCompressedVideoPacke
     if (image.isNull())
         return {};
 
-    if (image.format() != QImage::Format_ARGB32)
-        image = image.convertToFormat(QImage::Format_ARGB32);
+    // Decode straight to RGB24 if it's what the next element wants.
+    auto format = self->preferredVideoFormat() == AkVideoCaps::Format_rgb24?
+                      AkVideoCaps::Format_rgb24:
+                      AkVideoCaps::Format_argbpack;
+    auto imageFormat = format == AkVideoCaps::Format_rgb24?
+                           QImage::Format_RGB888:
+                           QImage::Format_ARGB32;
 
-    AkVideoCaps videoCaps(AkVideoCaps::Format_argbpack,
+    if (image.format() != imageFormat)
+        image = image.convertToFormat(imageFormat);
+
+    AkVideoCaps videoCaps(format,
                           packet.caps().rawCaps().width(),
                           packet.caps().rawCaps().height(),
                           packet.caps().rawCaps().fps());
@@ -1123,10 +1171,14 @@ void VideoCaptureElementPrivate::cameraLoop()
                                          self,
                                          &VideoCaptureElement::oStream,
                                          Qt::DirectConnection);
+                        convertVideo->setDecodingThreads(this->m_decodingThreads);
 
                         if (!convertVideo->init(caps))
                             break;
 
+                        this->m_mutex.lockForWrite();
+                        this->m_convertVideo = convertVideo;
+                        this->m_mutex.unlock();
                         initConvert = false;
                     }
 
@@ -1137,6 +1189,10 @@ void VideoCaptureElementPrivate::cameraLoop()
             }
         }
 
+        this->m_mutex.lockForWrite();
+        this->m_convertVideo.clear();
+        this->m_mutex.unlock();
+
         if (convertVideo)
             convertVideo->uninit();
 
@@ -1320,4 +1376,112 @@ void VideoCaptureElementPrivate::buildStringCache()
     this->m_stringsCache = cache;
 }
 
+int VideoCaptureElementPrivate::savedStream(const CapturePtr &capture,
+                                            const QString &media) const
+{
+    QSettings settings;
+
+    settings.beginGroup("VideoCapture");
+    auto ndevices = settings.beginReadArray("devices");
+    auto deviceDescription = capture->description(media);
+    int streamIndex = -1;
+
+    for (decltype(ndevices) i = 0; i < ndevices; i++) {
+        settings.setArrayIndex(i);
+        auto deviceId = settings.value("id").toString();
+        auto description = settings.value("description").toString();
+
+        if (deviceId == media && description == deviceDescription) {
+            streamIndex = settings.value("stream", 0).toInt();
+            auto tracks = capture->listTracks(AkCaps::CapsVideo);
+
+            if (tracks.isEmpty())
+                streamIndex = 0;
+            else
+                streamIndex = qBound<int>(0,
+                                          streamIndex,
+                                          tracks.size() - 1);
+
+            break;
+        }
+    }
+
+    settings.endArray();
+    settings.endGroup();
+
+    return streamIndex;
+}
+
+int VideoCaptureElementPrivate::preferredStream(const CapturePtr &capture,
+                                                int streamIndex) const
+{
+    auto format = self->preferredVideoFormat();
+
+    if (format == AkVideoCaps::Format_none)
+        return streamIndex;
+
+    auto streams = capture->caps(capture->device());
+    auto curCaps = streams.value(streamIndex);
+    AkVideoCaps curVideoCaps;
+
+    if (curCaps.type() == AkCaps::CapsVideoCompressed)
+        curVideoCaps = AkCompressedVideoCaps(curCaps).rawCaps();
+    else if (curCaps.type() == AkCaps::CapsVideo)
+        curVideoCaps = curCaps;
+
+    if (!curVideoCaps || curVideoCaps.format() == format)
+        return streamIndex;
+
+    // Look for a stream with the same resolution and frame rate that
+    // delivers the format requested by the next element directly.
+    for (int i = 0; i < streams.size(); i++) {
+        if (streams[i].type() != AkCaps::CapsVideo)
+            continue;
+
+        AkVideoCaps videoCaps(streams[i]);
+
+        if (videoCaps.format() == format
+            && videoCaps.size() == curVideoCaps.size()
+            && videoCaps.fps() == curVideoCaps.fps())
+            return i;
+    }
+
+    return streamIndex;
+}
+
+void VideoCaptureElementPrivate::updatePreferredStream()
+{
+    this->m_mutex.lockForRead();
+    auto capture = this->m_capture;
+    this->m_mutex.unlock();
+
+    if (!capture)
+        return;
+
+    auto media = capture->device();
+
+    // Never override a stream explicitly selected by the user.
+    if (media.isEmpty() || this->savedStream(capture, media) >= 0)
+        return;
+
+    // Only restart the camera when the negotiated format really changed.
+    auto format = self->preferredVideoFormat();
+
+    if (format == this->m_appliedFormat)
+        return;
+
+    this->m_appliedFormat = format;
+    auto streamIndex = this->preferredStream(capture, 0);
+
+    if (capture->streams().value(0, 0) == streamIndex)
+        return;
+
+    bool running = this->m_runCameraLoop;
+    self->setState(AkElement::ElementStateNull);
+    capture->setStreams({streamIndex});
+
+    if (running)
+        self->setState(AkElement::ElementStatePlaying);
+}
+
 #include "moc_videocaptureelement.cpp"
@@ -58,6 +58,11 @@ class VideoCaptureElement: public AkMultimediaSourceElement
                WRITE setNBuffers
                RESET resetNBuffers
                NOTIFY nBuffersChanged)
+    Q_PROPERTY(int decodingThreads
+               READ decodingThreads
+               WRITE setDecodingThreads
+               RESET resetDecodingThreads
+               NOTIFY decodingThreadsChanged)
     Q_PROPERTY(bool isTorchSupported
                READ isTorchSupported
                NOTIFY isTorchSupportedChanged)
@@ -98,10 +103,13 @@ class VideoCaptureElement: public AkMultimediaSourceElement
         Q_INVOKABLE QString description(const QString &media) override;
         Q_INVOKABLE AkCaps caps(int stream) override;
         Q_INVOKABLE AkCaps rawCaps(int stream) const;
+        Q_INVOKABLE AkVideoCaps::PixelFormatList videoOutputFormats() const override;
         Q_INVOKABLE QString streamDescription(int stream) const;
         Q_INVOKABLE QStringList listCapsDescription() const;
         Q_INVOKABLE QString ioMethod() const;
         Q_INVOKABLE int nBuffers() const;
+        Q_INVOKABLE int decodingThreads() const;
+        Q_INVOKABLE QVariantMap decodingStats() const;
         Q_INVOKABLE QVariantList imageControls() const;
         Q_INVOKABLE bool setImageControls(const QVariantMap &imageControls);
         Q_INVOKABLE bool resetImageControls();
@@ -144,6 +152,7 @@ class VideoCaptureElement: public AkMultimediaSourceElement
         void loopChanged(bool loop);
         void ioMethodChanged(const QString &ioMethod);
         void nBuffersChanged(int nBuffers);
+        void decodingThreadsChanged(int decodingThreads);
         void imageControlsChanged(const QVariantMap &imageControls);
         void cameraControlsChanged(const QVariantMap &cameraControls);
         void pictureTaken(int index, const AkPacket &picture);
@@ -156,11 +165,13 @@ class VideoCaptureElement: public AkMultimediaSourceElement
         void setStreams(const QList<int> &streams) override;
         void setIoMethod(const QString &ioMethod);
         void setNBuffers(int nBuffers);
+        void setDecodingThreads(int decodingThreads);
         void setTorchMode(TorchMode mode);
         void resetMedia() override;
         void resetStreams() override;
         void resetIoMethod();
         void resetNBuffers();
+        void resetDecodingThreads();
         void resetTorchMode();
         void reset();
         void takePictures(int count, int delayMsecs=0);
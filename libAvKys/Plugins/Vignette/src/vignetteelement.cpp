@@ -25,7 +25,7 @@
 #include <akpacket.h>
 #include <akvideocaps.h>
 #include <akvideoconverter.h>
-#include <akvideomixer.h>
+#include <akvideooverlay.h>
 #include <akvideopacket.h>
 
 #include "vignetteelement.h"
@@ -38,10 +38,9 @@ class VignetteElementPrivate
         qreal m_scale {0.5};
         qreal m_softness {0.5};
         QSize m_curSize;
-        AkVideoPacket m_vignette;
+        AkVideoOverlay m_vignette;
         QMutex m_mutex;
         AkVideoConverter m_videoConverter {{AkVideoCaps::Format_argbpack, 0, 0, {}}};
-        AkVideoMixer m_videoMixer;
 
         inline qreal radius(qreal x, qreal y) const;
         void updateVignette();
@@ -77,6 +76,16 @@ qreal VignetteElement::softness() const
     return this->d->m_softness;
 }
 
+AkVideoCaps::PixelFormatList VignetteElement::videoInputFormats() const
+{
+    return {AkVideoCaps::Format_argbpack};
+}
+
+AkVideoCaps::PixelFormatList VignetteElement::videoOutputFormats() const
+{
+    return {AkVideoCaps::Format_argbpack};
+}
+
 QString VignetteElement::controlInterfaceProvide(const QString &controlId) const
 {
     Q_UNUSED(controlId)
@@ -111,9 +120,7 @@ AkPacket VignetteElement::iVideoStream(const AkVideoPacket &packet)
         this->d->updateVignette();
     }
 
-    this->d->m_videoMixer.begin(&dst);
-    this->d->m_videoMixer.draw(this->d->m_vignette);
-    this->d->m_videoMixer.end();
+    this->d->m_vignette.draw(dst);
 
     this->d->m_mutex.unlock();
 
@@ -268,7 +275,7 @@ void VignetteElementPrivate::updateVignette()
         }
     }
 
-    this->m_vignette = vignette;
+    this->m_vignette.setOverlay(vignette);
 }
 
 #include "moc_vignetteelement.cpp"
@@ -53,6 +53,8 @@ class VignetteElement: public AkElement
         VignetteElement();
         ~VignetteElement();
 
+        Q_INVOKABLE AkVideoCaps::PixelFormatList videoInputFormats() const override;
+        Q_INVOKABLE AkVideoCaps::PixelFormatList videoOutputFormats() const override;
         Q_INVOKABLE QRgb color() const;
         Q_INVOKABLE qreal aspect() const;
         Q_INVOKABLE qreal scale() const;
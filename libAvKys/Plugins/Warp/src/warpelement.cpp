@@ -65,6 +65,16 @@ int WarpElement::duration() const
     return this->d->m_duration;
 }
 
+AkVideoCaps::PixelFormatList WarpElement::videoInputFormats() const
+{
+    return {AkVideoCaps::Format_argbpack};
+}
+
+AkVideoCaps::PixelFormatList WarpElement::videoOutputFormats() const
+{
+    return {AkVideoCaps::Format_argbpack};
+}
+
 QString WarpElement::controlInterfaceProvide(const QString &controlId) const
 {
     Q_UNUSED(controlId)
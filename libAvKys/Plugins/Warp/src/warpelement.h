@@ -42,6 +42,8 @@ class WarpElement: public AkElement
         WarpElement();
         ~WarpElement();
 
+        Q_INVOKABLE AkVideoCaps::PixelFormatList videoInputFormats() const override;
+        Q_INVOKABLE AkVideoCaps::PixelFormatList videoOutputFormats() const override;
         Q_INVOKABLE qreal ripples() const;
         Q_INVOKABLE int duration() const;
 
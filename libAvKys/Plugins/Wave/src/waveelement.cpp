@@ -93,6 +93,16 @@ qreal WaveElement::phaseY() const
     return this->d->m_phaseY;
 }
 
+AkVideoCaps::PixelFormatList WaveElement::videoInputFormats() const
+{
+    return {AkVideoCaps::Format_argbpack};
+}
+
+AkVideoCaps::PixelFormatList WaveElement::videoOutputFormats() const
+{
+    return {AkVideoCaps::Format_argbpack};
+}
+
 QString WaveElement::controlInterfaceProvide(const QString &controlId) const
 {
     Q_UNUSED(controlId)
@@ -63,6 +63,8 @@ class WaveElement: public AkElement
         WaveElement();
         ~WaveElement();
 
+        Q_INVOKABLE AkVideoCaps::PixelFormatList videoInputFormats() const override;
+        Q_INVOKABLE AkVideoCaps::PixelFormatList videoOutputFormats() const override;
         Q_INVOKABLE qreal amplitudeX() const;
         Q_INVOKABLE qreal amplitudeY() const;
         Q_INVOKABLE qreal frequencyX() const;
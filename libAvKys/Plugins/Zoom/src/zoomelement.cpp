@@ -21,6 +21,7 @@
 #include <QRect>
 #include <akpacket.h>
 #include <akvideoformatspec.h>
+#include <akvideoformattraits.h>
 #include <akvideopacket.h>
 
 #include "zoomelement.h"
@@ -66,6 +67,9 @@ class ZoomElementPrivate
         int *m_srcWidthOffsetA_1 {nullptr};
         int *m_srcHeight_1 {nullptr};
 
+        int *m_srcWidth {nullptr};
+        int *m_srcWidth_1 {nullptr};
+
         int *m_dstWidthOffsetX {nullptr};
         int *m_dstWidthOffsetY {nullptr};
         int *m_dstWidthOffsetZ {nullptr};
@@ -533,6 +537,63 @@ class ZoomElementPrivate
             }
         }
 
+        // Specialized versions of the zoom functions, the layout of the
+        // components is known at compile time.
+
+        template <typename Component>
+        void zoomComponent(const AkVideoPacket &src, AkVideoPacket &dst) const
+        {
+            // The generic functions visit each pixel, and the last pixel of
+            // each subsampled block is the one that stays in the output.
+            // Process only that one.
+            constexpr int widthMask = (1 << Component::widthDiv) - 1;
+            constexpr int heightMask = (1 << Component::heightDiv) - 1;
+            int width = (this->m_inputWidth + widthMask) >> Component::widthDiv;
+
+            for (int y = 0; y < this->m_inputHeight; ++y) {
+                if (((y + 1) & heightMask) && y + 1 < this->m_inputHeight)
+                    continue;
+
+                auto src_line = src.constLine(Component::plane, this->m_srcHeight[y]);
+                auto src_line_1 = src.constLine(Component::plane, this->m_srcHeight_1[y]);
+                auto dst_line = dst.line(Component::plane, y);
+                auto &ky = this->m_ky[y];
+
+                for (int k = 0; k < width; ++k) {
+                    int x = qMin(((k + 1) << Component::widthDiv) - 1,
+                                 this->m_inputWidth - 1);
+                    auto &xs = this->m_srcWidth[x];
+                    auto &xs_1 = this->m_srcWidth_1[x];
+
+                    qint64 xi = Component::read(src_line, xs);
+                    qint64 xi_x = Component::read(src_line, xs_1);
+                    qint64 xi_y = Component::read(src_line_1, xs);
+                    qint64 xib = 0;
+
+                    this->blend<SCALE_EMULT>(xi,
+                                             xi_x, xi_y,
+                                             this->m_kx[x], ky,
+                                             &xib);
+
+                    Component::write(dst_line, x, quint32(xib));
+                }
+            }
+        }
+
+        template <typename Traits>
+        void zoomFast(const AkVideoPacket &src, AkVideoPacket &dst) const
+        {
+            this->zoomComponent<typename Traits::X>(src, dst);
+
+            if (Traits::mainComponents > 1) {
+                this->zoomComponent<typename Traits::Y>(src, dst);
+                this->zoomComponent<typename Traits::Z>(src, dst);
+            }
+
+            if (Traits::hasAlpha)
+                this->zoomComponent<typename Traits::A>(src, dst);
+        }
+
 #define ZOOM_FUNC(components) \
         template <typename DataType> \
         inline void zoomFrame##components(const AkVideoPacket &src, \
@@ -622,10 +683,17 @@ AkPacket ZoomElement::iVideoStream(const AkVideoPacket &packet)
     AkVideoPacket dst(packet.caps());
     dst.copyMetadata(packet);
 
-    switch (this->d->m_zoomDataTypes) {
-    DEFINE_ZOOM_FUNC(8)
-    DEFINE_ZOOM_FUNC(16)
-    DEFINE_ZOOM_FUNC(32)
+    auto isFast =
+        akVideoFormatDispatch(packet.caps().format(), [this, &packet, &dst] (auto traits) {
+            this->d->zoomFast<decltype(traits)>(packet, dst);
+        });
+
+    if (!isFast) {
+        switch (this->d->m_zoomDataTypes) {
+        DEFINE_ZOOM_FUNC(8)
+        DEFINE_ZOOM_FUNC(16)
+        DEFINE_ZOOM_FUNC(32)
+        }
     }
 
     if (dst)
@@ -700,6 +768,16 @@ void ZoomElementPrivate::clearBuffers()
         this->m_srcHeight_1 = nullptr;
     }
 
+    if (this->m_srcWidth) {
+        delete [] this->m_srcWidth;
+        this->m_srcWidth = nullptr;
+    }
+
+    if (this->m_srcWidth_1) {
+        delete [] this->m_srcWidth_1;
+        this->m_srcWidth_1 = nullptr;
+    }
+
     if (this->m_dstWidthOffsetX) {
         delete [] this->m_dstWidthOffsetX;
         this->m_dstWidthOffsetX = nullptr;
@@ -747,6 +825,9 @@ void ZoomElementPrivate::allocateBuffers(const AkVideoCaps &caps)
     this->m_srcWidthOffsetA_1 = new int [caps.width()];
     this->m_srcHeight_1 = new int [caps.height()];
 
+    this->m_srcWidth = new int [caps.width()];
+    this->m_srcWidth_1 = new int [caps.width()];
+
     this->m_dstWidthOffsetX = new int [caps.width()];
     this->m_dstWidthOffsetY = new int [caps.width()];
     this->m_dstWidthOffsetZ = new int [caps.width()];
@@ -885,6 +966,9 @@ void ZoomElementPrivate::configureScaling(const AkVideoCaps &caps, qreal zoom)
         this->m_srcWidthOffsetZ_1[x] = (xs_1 >> this->m_compZi.widthDiv()) * this->m_compZi.step();
         this->m_srcWidthOffsetA_1[x] = (xs_1 >> this->m_compAi.widthDiv()) * this->m_compAi.step();
 
+        this->m_srcWidth[x] = xs;
+        this->m_srcWidth_1[x] = xs_1;
+
         this->m_dstWidthOffsetX[x] = (x >> this->m_compXi.widthDiv()) * this->m_compXi.step();
         this->m_dstWidthOffsetY[x] = (x >> this->m_compYi.widthDiv()) * this->m_compYi.step();
         this->m_dstWidthOffsetZ[x] = (x >> this->m_compZi.widthDiv()) * this->m_compZi.step();
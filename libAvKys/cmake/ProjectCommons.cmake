@@ -65,6 +65,7 @@ set(NOQTCAMERA OFF CACHE BOOL "Disable video capture using QCamera support")
 set(NOQTSCREENCAPTURE OFF CACHE BOOL "Disable screen capture using QScreenCapture")
 set(NOSCREENCAPTURE OFF CACHE BOOL "Disable screen capture")
 set(NOSDL OFF CACHE BOOL "Disable SDL support")
+set(NOSHAREDMEMORY OFF CACHE BOOL "Disable the shared memory frame transport")
 set(NOV4L2 OFF CACHE BOOL "Disable V4L2 support")
 set(NOV4LUTILS OFF CACHE BOOL "Disable V4l-utils support")
 set(NOVIDEOEFFECTS OFF CACHE BOOL "No build video effects")